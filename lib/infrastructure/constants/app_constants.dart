@@ -2,6 +2,8 @@
 ///
 /// 지원 형식:
 /// - ZMQ: tcp://IP:PORT (예: tcp://192.168.0.100:17002)
+/// - ZMQ Topic: tcp://IP:PORT#cam_idx (예: tcp://192.168.0.100:17002#top_1)
+///   - 같은 퍼블리셔의 여러 카메라를 연결 하나로 수신
 /// - HTTP MJPEG: http://IP:PORT/livecam/mjpeg?cam=CAM_ID
 ///   - cam 파라미터: left, right, top_1, top_2, single_1, single_2, ...
 const List<String> defaultCameraAddresses = [
@@ -17,5 +19,21 @@ const int maxLogCount = 50;
 /// FPS 업데이트 간격 (ms)
 const int fpsUpdateIntervalMs = 1000;
 
-/// 수신 타임아웃 (초) - 이 시간 동안 프레임이 없으면 수신 불가로 판단
-const int receiveTimeoutSeconds = 3;
+/// 라이브 모드 - 밀린 프레임을 버리고 항상 최신 프레임만 표시 (ZMQ)
+const bool liveIngestMode = true;
+
+/// 밝기 측정 - 헤더 없는 프레임(HTTP MJPEG)의 밝기를 디코딩된 휘도로 계산
+/// (YUV 디코딩 경로를 사용하여 디코딩 CPU 5~15% 증가)
+const bool measureBrightnessMode = false;
+
+/// 그리드 합성 모드 - 모든 카메라를 네이티브에서 텍스처 하나로 합성하여 표시
+/// (카메라 수와 관계없이 갱신당 GPU 업로드 1회, 화면 비율은 맞춤(contain)만 지원)
+const bool gridCompositorMode = false;
+
+/// 디코딩 메모리 예산 (MB, 0=무제한) - 모든 스트림의 프레임/큐 버퍼 합계가 넘으면
+/// 표시 크기가 작은 스트림부터 디코딩 해상도를 낮춤 (저사양 단말용)
+const int decodedMemoryBudgetMb = 0;
+
+/// 스레드 코어 분할 - 화면 표시(래스터/UI), 네트워크, 디코딩 스레드를 서로 다른 코어에
+/// 고정하고 디코딩 우선순위를 낮춤 (디코딩 부하가 화면 갱신을 밀어내는 경우)
+const bool threadPartitionMode = false;
@@ -39,6 +39,15 @@ class FrameInfo {
     this.width,
     this.height,
     required this.frameCount,
+    this.droppedFrames,
+    this.streamState,
+    this.reconnectCount,
+    this.frameSequence,
+    this.captureTimeUs,
+    this.receivedFrames,
+    this.displayedFrames,
+    this.qualityStep,
+    this.budgetStep,
   });
 
   String? camIdx;
@@ -63,6 +72,24 @@ class FrameInfo {
 
   int frameCount;
 
+  int? droppedFrames;
+
+  int? streamState;
+
+  int? reconnectCount;
+
+  int? frameSequence;
+
+  int? captureTimeUs;
+
+  int? receivedFrames;
+
+  int? displayedFrames;
+
+  int? qualityStep;
+
+  int? budgetStep;
+
   Object encode() {
     return <Object?>[
       camIdx,
@@ -76,6 +103,15 @@ class FrameInfo {
       width,
       height,
       frameCount,
+      droppedFrames,
+      streamState,
+      reconnectCount,
+      frameSequence,
+      captureTimeUs,
+      receivedFrames,
+      displayedFrames,
+      qualityStep,
+      budgetStep,
     ];
   }
 
@@ -93,6 +129,62 @@ class FrameInfo {
       width: result[8] as int?,
       height: result[9] as int?,
       frameCount: result[10]! as int,
+      droppedFrames: result[11] as int?,
+      streamState: result[12] as int?,
+      reconnectCount: result[13] as int?,
+      frameSequence: result[14] as int?,
+      captureTimeUs: result[15] as int?,
+      receivedFrames: result[16] as int?,
+      displayedFrames: result[17] as int?,
+      qualityStep: result[18] as int?,
+      budgetStep: result[19] as int?,
+    );
+  }
+}
+
+/// Decoded memory of all streams against the budget
+class MemoryStats {
+  MemoryStats({
+    required this.budgetBytes,
+    required this.usedBytes,
+    required this.estimatedBytes,
+    required this.cachedBytes,
+    required this.peakBytes,
+    required this.downscaledStreams,
+  });
+
+  int budgetBytes;
+
+  int usedBytes;
+
+  int estimatedBytes;
+
+  int cachedBytes;
+
+  int peakBytes;
+
+  int downscaledStreams;
+
+  Object encode() {
+    return <Object?>[
+      budgetBytes,
+      usedBytes,
+      estimatedBytes,
+      cachedBytes,
+      peakBytes,
+      downscaledStreams,
+    ];
+  }
+
+  static MemoryStats decode(Object result) {
+    result as List<Object?>;
+    return MemoryStats(
+      budgetBytes: result[0]! as int,
+      usedBytes: result[1]! as int,
+      estimatedBytes: result[2]! as int,
+      cachedBytes: result[3]! as int,
+      peakBytes: result[4]! as int,
+      downscaledStreams: result[5]! as int,
     );
   }
 }
@@ -108,6 +200,9 @@ class _PigeonCodec extends StandardMessageCodec {
     }    else if (value is FrameInfo) {
       buffer.putUint8(129);
       writeValue(buffer, value.encode());
+    }    else if (value is MemoryStats) {
+      buffer.putUint8(130);
+      writeValue(buffer, value.encode());
     } else {
       super.writeValue(buffer, value);
     }
@@ -118,6 +213,8 @@ class _PigeonCodec extends StandardMessageCodec {
     switch (type) {
       case 129: 
         return FrameInfo.decode(readValue(buffer)!);
+      case 130: 
+        return MemoryStats.decode(readValue(buffer)!);
       default:
         return super.readValueOfType(type, buffer);
     }
@@ -257,6 +354,338 @@ class NativeVideoHostApi {
       return;
     }
   }
+
+  /// Live mode: decode only the newest pending frame (drops backlog)
+  Future<void> setLiveMode(int textureKey, bool enabled) async {
+    final String pigeonVar_channelName = 'dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.setLiveMode$pigeonVar_messageChannelSuffix';
+    final BasicMessageChannel<Object?> pigeonVar_channel = BasicMessageChannel<Object?>(
+      pigeonVar_channelName,
+      pigeonChannelCodec,
+      binaryMessenger: pigeonVar_binaryMessenger,
+    );
+    final List<Object?>? pigeonVar_replyList =
+        await pigeonVar_channel.send(<Object?>[textureKey, enabled]) as List<Object?>?;
+    if (pigeonVar_replyList == null) {
+      throw _createConnectionError(pigeonVar_channelName);
+    } else if (pigeonVar_replyList.length > 1) {
+      throw PlatformException(
+        code: pigeonVar_replyList[0]! as String,
+        message: pigeonVar_replyList[1] as String?,
+        details: pigeonVar_replyList[2],
+      );
+    } else {
+      return;
+    }
+  }
+
+  /// Physical pixel size the texture is shown at (0 = full resolution)
+  Future<void> setDisplaySize(int textureKey, int width, int height) async {
+    final String pigeonVar_channelName = 'dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.setDisplaySize$pigeonVar_messageChannelSuffix';
+    final BasicMessageChannel<Object?> pigeonVar_channel = BasicMessageChannel<Object?>(
+      pigeonVar_channelName,
+      pigeonChannelCodec,
+      binaryMessenger: pigeonVar_binaryMessenger,
+    );
+    final List<Object?>? pigeonVar_replyList =
+        await pigeonVar_channel.send(<Object?>[textureKey, width, height]) as List<Object?>?;
+    if (pigeonVar_replyList == null) {
+      throw _createConnectionError(pigeonVar_channelName);
+    } else if (pigeonVar_replyList.length > 1) {
+      throw PlatformException(
+        code: pigeonVar_replyList[0]! as String,
+        message: pigeonVar_replyList[1] as String?,
+        details: pigeonVar_replyList[2],
+      );
+    } else {
+      return;
+    }
+  }
+
+  /// Digital zoom: zoom >= 1 around a normalized center; only that region is decoded
+  Future<void> setZoom(int textureKey, double zoom, double centerX, double centerY) async {
+    final String pigeonVar_channelName = 'dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.setZoom$pigeonVar_messageChannelSuffix';
+    final BasicMessageChannel<Object?> pigeonVar_channel = BasicMessageChannel<Object?>(
+      pigeonVar_channelName,
+      pigeonChannelCodec,
+      binaryMessenger: pigeonVar_binaryMessenger,
+    );
+    final List<Object?>? pigeonVar_replyList =
+        await pigeonVar_channel.send(<Object?>[textureKey, zoom, centerX, centerY]) as List<Object?>?;
+    if (pigeonVar_replyList == null) {
+      throw _createConnectionError(pigeonVar_channelName);
+    } else if (pigeonVar_replyList.length > 1) {
+      throw PlatformException(
+        code: pigeonVar_replyList[0]! as String,
+        message: pigeonVar_replyList[1] as String?,
+        details: pigeonVar_replyList[2],
+      );
+    } else {
+      return;
+    }
+  }
+
+  /// Auto-follow: zoom onto the header bbox of each frame
+  Future<void> setZoomFollowBbox(int textureKey, bool enabled) async {
+    final String pigeonVar_channelName = 'dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.setZoomFollowBbox$pigeonVar_messageChannelSuffix';
+    final BasicMessageChannel<Object?> pigeonVar_channel = BasicMessageChannel<Object?>(
+      pigeonVar_channelName,
+      pigeonChannelCodec,
+      binaryMessenger: pigeonVar_binaryMessenger,
+    );
+    final List<Object?>? pigeonVar_replyList =
+        await pigeonVar_channel.send(<Object?>[textureKey, enabled]) as List<Object?>?;
+    if (pigeonVar_replyList == null) {
+      throw _createConnectionError(pigeonVar_channelName);
+    } else if (pigeonVar_replyList.length > 1) {
+      throw PlatformException(
+        code: pigeonVar_replyList[0]! as String,
+        message: pigeonVar_replyList[1] as String?,
+        details: pigeonVar_replyList[2],
+      );
+    } else {
+      return;
+    }
+  }
+
+  /// Grid compositor: one texture showing several streams, returns textureId
+  Future<int> initializeGrid(int gridKey) async {
+    final String pigeonVar_channelName = 'dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.initializeGrid$pigeonVar_messageChannelSuffix';
+    final BasicMessageChannel<Object?> pigeonVar_channel = BasicMessageChannel<Object?>(
+      pigeonVar_channelName,
+      pigeonChannelCodec,
+      binaryMessenger: pigeonVar_binaryMessenger,
+    );
+    final List<Object?>? pigeonVar_replyList =
+        await pigeonVar_channel.send(<Object?>[gridKey]) as List<Object?>?;
+    if (pigeonVar_replyList == null) {
+      throw _createConnectionError(pigeonVar_channelName);
+    } else if (pigeonVar_replyList.length > 1) {
+      throw PlatformException(
+        code: pigeonVar_replyList[0]! as String,
+        message: pigeonVar_replyList[1] as String?,
+        details: pigeonVar_replyList[2],
+      );
+    } else if (pigeonVar_replyList[0] == null) {
+      throw PlatformException(
+        code: 'null-error',
+        message: 'Host platform returned null value for non-null return value.',
+      );
+    } else {
+      return (pigeonVar_replyList[0] as int?)!;
+    }
+  }
+
+  /// Grid of columns x rows cells, each cellWidth x cellHeight physical pixels
+  Future<void> setGridLayout(int gridKey, int columns, int rows, int cellWidth, int cellHeight) async {
+    final String pigeonVar_channelName = 'dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.setGridLayout$pigeonVar_messageChannelSuffix';
+    final BasicMessageChannel<Object?> pigeonVar_channel = BasicMessageChannel<Object?>(
+      pigeonVar_channelName,
+      pigeonChannelCodec,
+      binaryMessenger: pigeonVar_binaryMessenger,
+    );
+    final List<Object?>? pigeonVar_replyList =
+        await pigeonVar_channel.send(<Object?>[gridKey, columns, rows, cellWidth, cellHeight]) as List<Object?>?;
+    if (pigeonVar_replyList == null) {
+      throw _createConnectionError(pigeonVar_channelName);
+    } else if (pigeonVar_replyList.length > 1) {
+      throw PlatformException(
+        code: pigeonVar_replyList[0]! as String,
+        message: pigeonVar_replyList[1] as String?,
+        details: pigeonVar_replyList[2],
+      );
+    } else {
+      return;
+    }
+  }
+
+  /// Shows a stream in a grid cell instead of its own texture (textureKey < 0 empties the cell)
+  Future<void> setGridCell(int gridKey, int cell, int textureKey) async {
+    final String pigeonVar_channelName = 'dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.setGridCell$pigeonVar_messageChannelSuffix';
+    final BasicMessageChannel<Object?> pigeonVar_channel = BasicMessageChannel<Object?>(
+      pigeonVar_channelName,
+      pigeonChannelCodec,
+      binaryMessenger: pigeonVar_binaryMessenger,
+    );
+    final List<Object?>? pigeonVar_replyList =
+        await pigeonVar_channel.send(<Object?>[gridKey, cell, textureKey]) as List<Object?>?;
+    if (pigeonVar_replyList == null) {
+      throw _createConnectionError(pigeonVar_channelName);
+    } else if (pigeonVar_replyList.length > 1) {
+      throw PlatformException(
+        code: pigeonVar_replyList[0]! as String,
+        message: pigeonVar_replyList[1] as String?,
+        details: pigeonVar_replyList[2],
+      );
+    } else {
+      return;
+    }
+  }
+
+  /// Dispose a grid; its streams go back to their own textures
+  Future<void> disposeGrid(int gridKey) async {
+    final String pigeonVar_channelName = 'dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.disposeGrid$pigeonVar_messageChannelSuffix';
+    final BasicMessageChannel<Object?> pigeonVar_channel = BasicMessageChannel<Object?>(
+      pigeonVar_channelName,
+      pigeonChannelCodec,
+      binaryMessenger: pigeonVar_binaryMessenger,
+    );
+    final List<Object?>? pigeonVar_replyList =
+        await pigeonVar_channel.send(<Object?>[gridKey]) as List<Object?>?;
+    if (pigeonVar_replyList == null) {
+      throw _createConnectionError(pigeonVar_channelName);
+    } else if (pigeonVar_replyList.length > 1) {
+      throw PlatformException(
+        code: pigeonVar_replyList[0]! as String,
+        message: pigeonVar_replyList[1] as String?,
+        details: pigeonVar_replyList[2],
+      );
+    } else {
+      return;
+    }
+  }
+
+  /// Budget for decoded memory of all streams, in bytes (0 = unlimited)
+  Future<void> setMemoryBudget(int bytes) async {
+    final String pigeonVar_channelName = 'dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.setMemoryBudget$pigeonVar_messageChannelSuffix';
+    final BasicMessageChannel<Object?> pigeonVar_channel = BasicMessageChannel<Object?>(
+      pigeonVar_channelName,
+      pigeonChannelCodec,
+      binaryMessenger: pigeonVar_binaryMessenger,
+    );
+    final List<Object?>? pigeonVar_replyList =
+        await pigeonVar_channel.send(<Object?>[bytes]) as List<Object?>?;
+    if (pigeonVar_replyList == null) {
+      throw _createConnectionError(pigeonVar_channelName);
+    } else if (pigeonVar_replyList.length > 1) {
+      throw PlatformException(
+        code: pigeonVar_replyList[0]! as String,
+        message: pigeonVar_replyList[1] as String?,
+        details: pigeonVar_replyList[2],
+      );
+    } else {
+      return;
+    }
+  }
+
+  /// Decoded memory of all streams against the budget
+  Future<MemoryStats> getMemoryStats() async {
+    final String pigeonVar_channelName = 'dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.getMemoryStats$pigeonVar_messageChannelSuffix';
+    final BasicMessageChannel<Object?> pigeonVar_channel = BasicMessageChannel<Object?>(
+      pigeonVar_channelName,
+      pigeonChannelCodec,
+      binaryMessenger: pigeonVar_binaryMessenger,
+    );
+    final List<Object?>? pigeonVar_replyList =
+        await pigeonVar_channel.send(null) as List<Object?>?;
+    if (pigeonVar_replyList == null) {
+      throw _createConnectionError(pigeonVar_channelName);
+    } else if (pigeonVar_replyList.length > 1) {
+      throw PlatformException(
+        code: pigeonVar_replyList[0]! as String,
+        message: pigeonVar_replyList[1] as String?,
+        details: pigeonVar_replyList[2],
+      );
+    } else if (pigeonVar_replyList[0] == null) {
+      throw PlatformException(
+        code: 'null-error',
+        message: 'Host platform returned null value for non-null return value.',
+      );
+    } else {
+      return (pigeonVar_replyList[0] as MemoryStats?)!;
+    }
+  }
+
+  /// Core set (bit i = logical core i, 0 = all) and priority (0 = unchanged, 1 low .. 4 highest) of a thread role: 0 network, 1 decode, 2 display, 3 UI
+  Future<void> setThreadPolicy(int role, int coreMask, int priority) async {
+    final String pigeonVar_channelName = 'dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.setThreadPolicy$pigeonVar_messageChannelSuffix';
+    final BasicMessageChannel<Object?> pigeonVar_channel = BasicMessageChannel<Object?>(
+      pigeonVar_channelName,
+      pigeonChannelCodec,
+      binaryMessenger: pigeonVar_binaryMessenger,
+    );
+    final List<Object?>? pigeonVar_replyList =
+        await pigeonVar_channel.send(<Object?>[role, coreMask, priority]) as List<Object?>?;
+    if (pigeonVar_replyList == null) {
+      throw _createConnectionError(pigeonVar_channelName);
+    } else if (pigeonVar_replyList.length > 1) {
+      throw PlatformException(
+        code: pigeonVar_replyList[0]! as String,
+        message: pigeonVar_replyList[1] as String?,
+        details: pigeonVar_replyList[2],
+      );
+    } else {
+      return;
+    }
+  }
+
+  /// Stops every stream at once; textures keep their last frame
+  Future<void> stopAll() async {
+    final String pigeonVar_channelName = 'dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.stopAll$pigeonVar_messageChannelSuffix';
+    final BasicMessageChannel<Object?> pigeonVar_channel = BasicMessageChannel<Object?>(
+      pigeonVar_channelName,
+      pigeonChannelCodec,
+      binaryMessenger: pigeonVar_binaryMessenger,
+    );
+    final List<Object?>? pigeonVar_replyList =
+        await pigeonVar_channel.send(null) as List<Object?>?;
+    if (pigeonVar_replyList == null) {
+      throw _createConnectionError(pigeonVar_channelName);
+    } else if (pigeonVar_replyList.length > 1) {
+      throw PlatformException(
+        code: pigeonVar_replyList[0]! as String,
+        message: pigeonVar_replyList[1] as String?,
+        details: pigeonVar_replyList[2],
+      );
+    } else {
+      return;
+    }
+  }
+
+  /// Disposes every stream and grid at once (e.g. leftovers after a hot restart)
+  Future<void> disposeAll() async {
+    final String pigeonVar_channelName = 'dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.disposeAll$pigeonVar_messageChannelSuffix';
+    final BasicMessageChannel<Object?> pigeonVar_channel = BasicMessageChannel<Object?>(
+      pigeonVar_channelName,
+      pigeonChannelCodec,
+      binaryMessenger: pigeonVar_binaryMessenger,
+    );
+    final List<Object?>? pigeonVar_replyList =
+        await pigeonVar_channel.send(null) as List<Object?>?;
+    if (pigeonVar_replyList == null) {
+      throw _createConnectionError(pigeonVar_channelName);
+    } else if (pigeonVar_replyList.length > 1) {
+      throw PlatformException(
+        code: pigeonVar_replyList[0]! as String,
+        message: pigeonVar_replyList[1] as String?,
+        details: pigeonVar_replyList[2],
+      );
+    } else {
+      return;
+    }
+  }
+
+  /// Headerless frames: measure brightness from the decoded luma (YUV decode, more CPU)
+  Future<void> setMeasureBrightness(int textureKey, bool enabled) async {
+    final String pigeonVar_channelName = 'dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.setMeasureBrightness$pigeonVar_messageChannelSuffix';
+    final BasicMessageChannel<Object?> pigeonVar_channel = BasicMessageChannel<Object?>(
+      pigeonVar_channelName,
+      pigeonChannelCodec,
+      binaryMessenger: pigeonVar_binaryMessenger,
+    );
+    final List<Object?>? pigeonVar_replyList =
+        await pigeonVar_channel.send(<Object?>[textureKey, enabled]) as List<Object?>?;
+    if (pigeonVar_replyList == null) {
+      throw _createConnectionError(pigeonVar_channelName);
+    } else if (pigeonVar_replyList.length > 1) {
+      throw PlatformException(
+        code: pigeonVar_replyList[0]! as String,
+        message: pigeonVar_replyList[1] as String?,
+        details: pigeonVar_replyList[2],
+      );
+    } else {
+      return;
+    }
+  }
 }
 
 /// Flutter API - called from C++, implemented in Dart
@@ -0,0 +1,66 @@
+import 'dart:io';
+import 'dart:math' as math;
+import 'generated/native_video_api.g.dart';
+
+/// 네이티브 파이프라인 스레드 역할 (네이티브 ThreadRole과 같은 순서)
+enum NativeThreadRole {
+  /// ZMQ 폴러, HTTP 이벤트 루프, HTTPS 수신 스레드
+  network,
+
+  /// 디코딩 워커
+  decode,
+
+  /// 엔진 래스터 스레드 (텍스처 복사)
+  display,
+
+  /// 플랫폼 스레드 (윈도우 메시지, 호스트 API 호출)
+  ui,
+}
+
+/// 스레드 우선순위 (unchanged: OS/엔진 설정 유지)
+enum NativeThreadPriority { unchanged, low, normal, high, highest }
+
+/// 네이티브 스레드 배치 (코어 고정 + 우선순위)
+///
+/// 디코딩/수신 스레드가 화면 표시(래스터, UI) 스레드와 같은 코어를
+/// 두고 경쟁하지 않도록 역할별로 코어를 나눕니다.
+/// 실행 중인 스레드는 자기 루프의 다음 반복에서 바뀐 설정을 적용합니다.
+class NativeThreadPolicy {
+  NativeThreadPolicy._();
+
+  static final NativeVideoHostApi _hostApi = NativeVideoHostApi();
+
+  /// 역할별 설정
+  ///
+  /// [coreMask] - 비트 i = 논리 코어 i (0 = 모든 코어)
+  static Future<void> set(
+    NativeThreadRole role, {
+    int coreMask = 0,
+    NativeThreadPriority priority = NativeThreadPriority.unchanged,
+  }) async {
+    await _hostApi.setThreadPolicy(role.index, coreMask, priority.index);
+  }
+
+  /// 코어 분할 적용
+  ///
+  /// - 앞쪽 [displayCores]개: 래스터/UI 스레드 (높은 우선순위)
+  /// - 다음 1개: 네트워크 스레드
+  /// - 나머지: 디코딩 워커 (낮은 우선순위, 워커 수도 코어 수에 맞춤)
+  ///
+  /// 코어가 4개 미만이면 코어는 나누지 않고 우선순위만 적용합니다.
+  /// 디코딩 워커 수는 첫 스트림 초기화 때 정해지므로 그 전에 호출해야 합니다.
+  static Future<void> applyPartition({int displayCores = 1}) async {
+    final cores = math.min(Platform.numberOfProcessors, 64);
+    final partitioned = cores >= 4 && displayCores >= 1 && displayCores <= cores - 2;
+
+    int mask(int first, int count) => ((1 << count) - 1) << first;
+    final displayMask = partitioned ? mask(0, displayCores) : 0;
+    final networkMask = partitioned ? mask(displayCores, 1) : 0;
+    final decodeMask = partitioned ? mask(displayCores + 1, cores - displayCores - 1) : 0;
+
+    await set(NativeThreadRole.display, coreMask: displayMask, priority: NativeThreadPriority.high);
+    await set(NativeThreadRole.ui, coreMask: displayMask, priority: NativeThreadPriority.high);
+    await set(NativeThreadRole.network, coreMask: networkMask, priority: NativeThreadPriority.normal);
+    await set(NativeThreadRole.decode, coreMask: decodeMask, priority: NativeThreadPriority.low);
+  }
+}
@@ -0,0 +1,85 @@
+import 'dart:math' as math;
+import 'generated/native_video_api.g.dart';
+
+/// 네이티브 그리드 합성기
+///
+/// 여러 카메라 스트림을 네이티브에서 텍스처 하나로 합성합니다.
+/// 카메라 수와 관계없이 텍스처 콜백/GPU 업로드가 갱신마다 한 번이며,
+/// 각 타일은 공유 텍스처에서 자기 셀만 잘라 표시합니다.
+///
+/// - 스트림은 셀 크기로 축소 디코딩되고, 원본 비율로 셀 안에 맞춰집니다 (레터박스)
+/// - 새 프레임이 있는 셀만 다시 그립니다
+/// - 셀에 연결된 스트림이 dispose되면 셀은 검은색으로 비워집니다
+class NativeVideoGrid {
+  NativeVideoGrid._();
+
+  /// 분할 화면 페이지가 공유하는 그리드
+  static final NativeVideoGrid shared = NativeVideoGrid._();
+
+  static const int _gridKey = 0;
+
+  final NativeVideoHostApi _hostApi = NativeVideoHostApi();
+  Future<int>? _textureId;
+  int _columns = 1;
+  int _rows = 1;
+  int _cellWidth = 0;
+  int _cellHeight = 0;
+
+  /// 카메라 수에 맞는 배치 (열, 행) - 1: 1x1, 2: 2x1, 4: 2x2
+  static (int, int) layoutFor(int cameraCount) {
+    final columns = math.max(1, math.sqrt(cameraCount).ceil());
+    final rows = math.max(1, (cameraCount / columns).ceil());
+    return (columns, rows);
+  }
+
+  /// 그리드 텍스처 ID (처음 호출 시 네이티브 그리드 생성)
+  Future<int> get textureId => _textureId ??= _hostApi.initializeGrid(_gridKey);
+
+  /// 카메라 수 변경 - 배치를 다시 잡습니다
+  Future<void> setCameraCount(int cameraCount) async {
+    final (columns, rows) = layoutFor(cameraCount);
+    if (columns == _columns && rows == _rows) return;
+    _columns = columns;
+    _rows = rows;
+    await _applyLayout();
+  }
+
+  /// 셀 크기 변경 (물리 픽셀, 타일 영상 영역 크기)
+  Future<void> setCellSize(int width, int height) async {
+    if (width == _cellWidth && height == _cellHeight) return;
+    _cellWidth = width;
+    _cellHeight = height;
+    await _applyLayout();
+  }
+
+  /// 스트림을 셀에 표시
+  ///
+  /// [cell] - 셀 번호 (왼쪽 위부터 행 우선), [textureKey] - 초기화된 스트림의 키.
+  /// 스트림의 프레임은 이후 그리드 텍스처에만 표시됩니다.
+  /// Returns: 타일에서 사용할 그리드 textureId
+  Future<int> attach(int cell, int textureKey) async {
+    final id = await textureId;
+    await _applyLayout();
+    await _hostApi.setGridCell(_gridKey, cell, textureKey);
+    return id;
+  }
+
+  /// 셀 비우기
+  Future<void> detach(int cell) async {
+    if (_textureId == null) return;
+    await _hostApi.setGridCell(_gridKey, cell, -1);
+  }
+
+  /// 리소스 정리 (셀의 스트림은 각자 텍스처로 돌아갑니다)
+  Future<void> dispose() async {
+    if (_textureId == null) return;
+    _textureId = null;
+    await _hostApi.disposeGrid(_gridKey);
+  }
+
+  Future<void> _applyLayout() async {
+    if (_textureId == null || _cellWidth <= 0 || _cellHeight <= 0) return;
+    await textureId;
+    await _hostApi.setGridLayout(_gridKey, _columns, _rows, _cellWidth, _cellHeight);
+  }
+}
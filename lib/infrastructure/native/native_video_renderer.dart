@@ -2,6 +2,32 @@ import 'dart:async';
 import 'package:flutter/widgets.dart';
 import 'generated/native_video_api.g.dart';
 
+/// 네이티브 스트림 상태 ([FrameInfo.streamState] 값과 동일한 순서)
+enum NativeStreamState {
+  /// 연결 후 아직 프레임 없음
+  connecting,
+
+  /// 프레임 수신 중
+  live,
+
+  /// 연결은 유지되나 일정 시간(3초) 프레임 없음
+  stalled,
+
+  /// 연결 끊김 - 네이티브에서 백오프로 재연결 중 (텍스처와 마지막 프레임 유지)
+  reconnecting,
+}
+
+extension FrameInfoStreamState on FrameInfo {
+  /// [streamState]를 [NativeStreamState]로 변환
+  NativeStreamState get nativeStreamState {
+    final index = streamState ?? 0;
+    if (index < 0 || index >= NativeStreamState.values.length) {
+      return NativeStreamState.connecting;
+    }
+    return NativeStreamState.values[index];
+  }
+}
+
 /// Native C++ 기반 비디오 렌더러
 ///
 /// ZMQ 또는 HTTP MJPEG 스트림 수신 및 JPEG 디코딩을 C++에서 처리하여
@@ -9,6 +35,8 @@ import 'generated/native_video_api.g.dart';
 ///
 /// 지원 프로토콜:
 /// - ZMQ: tcp://IP:PORT (예: tcp://192.168.0.100:17002)
+/// - ZMQ Topic: tcp://IP:PORT#cam_idx (예: tcp://192.168.0.100:17002#top_1)
+///   - 같은 IP:PORT의 topic 주소들은 연결 하나를 공유합니다
 /// - HTTP MJPEG: http://IP:PORT/path (예: http://192.168.0.100:18081/livecam/mjpeg?cam=left)
 ///
 /// 주소 형식에 따라 자동으로 프로토콜이 선택됩니다:
@@ -22,6 +50,7 @@ import 'generated/native_video_api.g.dart';
 /// - TextureRegistrar: 제로카피 GPU 텍스처 업데이트
 class NativeVideoRenderer implements NativeVideoFlutterApi {
   final NativeVideoHostApi _hostApi = NativeVideoHostApi();
+  static final NativeVideoHostApi _sharedHostApi = NativeVideoHostApi();
   int? _textureId;
   int? _textureKey;
   bool _isInitialized = false;
@@ -53,6 +82,7 @@ class NativeVideoRenderer implements NativeVideoFlutterApi {
   ///
   /// [address] - 스트림 주소
   ///   - ZMQ: "tcp://IP:PORT" (예: "tcp://192.168.0.100:17002")
+  ///   - ZMQ Topic: "tcp://IP:PORT#cam_idx" (예: "tcp://192.168.0.100:17002#top_1")
   ///   - HTTP MJPEG: "http://IP:PORT/path" (예: "http://192.168.0.100:18081/livecam/mjpeg?cam=left")
   Future<void> startStream(String address) async {
     if (!_isInitialized || _textureKey == null) {
@@ -61,6 +91,89 @@ class NativeVideoRenderer implements NativeVideoFlutterApi {
     await _hostApi.startStream(_textureKey!, address);
   }
 
+  /// 라이브 모드 설정
+  ///
+  /// [enabled] - true면 밀린 프레임을 건너뛰고 가장 최신 프레임만 디코딩합니다.
+  /// 또한 직전 프레임이 화면에 표시되기 전에는 다음 프레임을 디코딩하지 않습니다
+  /// (표시 주기 2회가 지나면 표시 여부와 관계없이 디코딩).
+  /// 건너뛴 프레임 수는 [FrameInfo.droppedFrames], 수신/디코딩/표시 프레임 수는
+  /// [FrameInfo.receivedFrames]/[FrameInfo.frameCount]/[FrameInfo.displayedFrames]로
+  /// 확인할 수 있습니다. startStream 전후 모두 호출 가능합니다.
+  Future<void> setLiveMode(bool enabled) async {
+    if (!_isInitialized || _textureKey == null) return;
+    await _hostApi.setLiveMode(_textureKey!, enabled);
+  }
+
+  /// 밝기 측정 설정
+  ///
+  /// [enabled] - true면 헤더 없는 프레임(HTTP MJPEG 등)의 밝기를 디코딩된 휘도로
+  /// 계산해 [FrameInfo.brightness]에 넣습니다. YUV 디코딩 경로를 쓰므로 CPU를
+  /// 5~15% 더 쓰고, 확대(줌) 중인 프레임은 측정하지 않습니다. 기본값은 false입니다.
+  Future<void> setMeasureBrightness(bool enabled) async {
+    if (!_isInitialized || _textureKey == null) return;
+    await _hostApi.setMeasureBrightness(_textureKey!, enabled);
+  }
+
+  /// 표시 크기 설정 (물리 픽셀)
+  ///
+  /// 텍스처가 실제로 그려지는 크기를 알려주면 네이티브에서 그 크기 이상인 가장 작은
+  /// libjpeg-turbo 축소 비율(1/2, 1/4, 1/8 ...)로 디코딩합니다.
+  /// 0이면 원본 해상도로 디코딩합니다. [FrameInfo.width]/[FrameInfo.height]는 항상 원본 해상도입니다.
+  Future<void> setDisplaySize(int width, int height) async {
+    if (!_isInitialized || _textureKey == null) return;
+    await _hostApi.setDisplaySize(_textureKey!, width, height);
+  }
+
+  /// 디지털 줌 설정
+  ///
+  /// [zoom] - 1.0(전체 화면) ~ 8.0, [centerX]/[centerY] - 확대 중심 (프레임 기준 0.0 ~ 1.0)
+  /// 확대된 영역만 디코딩하므로 (MCU 단위 crop) 고해상도 소스도 확대 시 디코딩 비용이 줄어듭니다.
+  /// 텍스처 크기는 확대 영역의 해상도가 됩니다.
+  Future<void> setZoom(double zoom, double centerX, double centerY) async {
+    if (!_isInitialized || _textureKey == null) return;
+    await _hostApi.setZoom(_textureKey!, zoom, centerX, centerY);
+  }
+
+  /// bbox 자동 추적 설정
+  ///
+  /// [enabled] - true면 매 프레임 헤더의 bbox를 중심으로 확대합니다 ([setZoom] 값 무시).
+  /// bbox가 없는 프레임은 전체 화면으로 표시합니다.
+  Future<void> setZoomFollowBbox(bool enabled) async {
+    if (!_isInitialized || _textureKey == null) return;
+    await _hostApi.setZoomFollowBbox(_textureKey!, enabled);
+  }
+
+  /// 디코딩 메모리 예산 설정 (모든 스트림 공통)
+  ///
+  /// [bytes] - 모든 스트림의 프레임/큐 버퍼 합계 상한, 0이면 무제한.
+  /// 넘으면 표시 크기가 작은(덜 중요한) 스트림부터 디코딩 해상도를 1/2씩 낮추고
+  /// ([FrameInfo.budgetStep]), 여유가 생기면 큰 스트림부터 되돌립니다.
+  /// 중지된 스트림은 화면에 보이는 마지막 프레임만 남기고 버퍼를 반환합니다.
+  static Future<void> setMemoryBudget(int bytes) async {
+    await _sharedHostApi.setMemoryBudget(bytes);
+  }
+
+  /// 디코딩 메모리 사용량 (예산, 실사용, 추정치, 캐시, 최대치)
+  static Future<MemoryStats> getMemoryStats() async {
+    return await _sharedHostApi.getMemoryStats();
+  }
+
+  /// 모든 스트림 동시 중지
+  ///
+  /// 모든 스트림에 먼저 중지 신호를 보낸 뒤 한꺼번에 기다리므로,
+  /// 스트림 수와 관계없이 가장 느린 스트림 하나만큼 걸립니다.
+  /// 텍스처는 마지막 프레임을 유지합니다.
+  static Future<void> stopAll() async {
+    await _sharedHostApi.stopAll();
+  }
+
+  /// 모든 스트림과 그리드 동시 정리
+  ///
+  /// 핫 리스타트 등으로 Dart 쪽 상태만 초기화되어 네이티브에 남은 스트림을 정리합니다.
+  static Future<void> disposeAll() async {
+    await _sharedHostApi.disposeAll();
+  }
+
   /// ZMQ 스트림 중지
   Future<void> stopStream() async {
     if (_textureKey == null) return;
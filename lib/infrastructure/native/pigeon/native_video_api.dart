@@ -20,11 +20,20 @@ class FrameInfo {
     this.width,
     this.height,
     required this.frameCount,
+    this.droppedFrames,
+    this.streamState,
+    this.reconnectCount,
+    this.frameSequence,
+    this.captureTimeUs,
+    this.receivedFrames,
+    this.displayedFrames,
+    this.qualityStep,
+    this.budgetStep,
   });
 
   String? camIdx;
   String? camNum;
-  double? brightness;
+  double? brightness;  // 헤더 밝기 값, 헤더가 없으면(HTTP) 프레임 평균 휘도 (0.0 ~ 100.0)
   bool? motion;
   int? bboxX;
   int? bboxY;
@@ -32,7 +41,35 @@ class FrameInfo {
   int? bboxH;
   int? width;   // 영상 가로 해상도
   int? height;  // 영상 세로 해상도
-  int frameCount;
+  int frameCount;  // 디코딩된 프레임 수 (누적)
+  int? droppedFrames;  // 디코딩하지 않고 버린 프레임 수 (누적): 밀려서 건너뛴 프레임, 표시 대기 중 최신 프레임으로 교체된 프레임, 라이브 모드에서 디코딩 대기열이 가득 차 버린 프레임
+  int? streamState;  // 0=connecting, 1=live, 2=stalled, 3=reconnecting
+  int? reconnectCount;  // 네이티브 재연결 횟수 (누적)
+  int? frameSequence;  // 바이너리 헤더의 프레임 시퀀스 번호
+  int? captureTimeUs;  // 바이너리 헤더의 촬영 시각 (Unix epoch, µs)
+  int? receivedFrames;  // 수신한 프레임 수 (누적)
+  int? displayedFrames;  // 화면에 표시된 프레임 수 (누적)
+  int? qualityStep;  // 부하에 따른 디코딩 품질 단계: 0=원본, 1=1/2, 2=1/4, 3=1/8
+  int? budgetStep;  // 메모리 예산에 따른 디코딩 단계: 0=원본, 1=1/2, 2=1/4, 3=1/8
+}
+
+/// Decoded memory of all streams against the budget
+class MemoryStats {
+  MemoryStats({
+    required this.budgetBytes,
+    required this.usedBytes,
+    required this.estimatedBytes,
+    required this.cachedBytes,
+    required this.peakBytes,
+    required this.downscaledStreams,
+  });
+
+  int budgetBytes;  // 설정된 예산 (0=무제한)
+  int usedBytes;  // 사용 중인 프레임/큐/파서 버퍼 (실측)
+  int estimatedBytes;  // 예산 계산에 쓰인 추정치 (현재 단계 기준)
+  int cachedBytes;  // 재사용을 위해 풀에 남겨둔 버퍼
+  int peakBytes;  // 최대 할당량 (사용 중 + 캐시)
+  int downscaledStreams;  // 예산 때문에 해상도를 낮춘 스트림 수
 }
 
 /// Host API - called from Dart, implemented in C++
@@ -52,6 +89,48 @@ abstract class NativeVideoHostApi {
 
   /// Dispose resources for specific texture
   void dispose(int textureKey);
+
+  /// Live mode: decode only the newest pending frame (drops backlog)
+  void setLiveMode(int textureKey, bool enabled);
+
+  /// Physical pixel size the texture is shown at; decode is scaled down to it
+  void setDisplaySize(int textureKey, int width, int height);
+
+  /// Digital zoom: zoom >= 1 around a normalized center; only that region is decoded
+  void setZoom(int textureKey, double zoom, double centerX, double centerY);
+
+  /// Auto-follow: zoom onto the header bbox of each frame
+  void setZoomFollowBbox(int textureKey, bool enabled);
+
+  /// Grid compositor: one texture showing several streams, returns textureId
+  int initializeGrid(int gridKey);
+
+  /// Grid of columns x rows cells, each cellWidth x cellHeight physical pixels
+  void setGridLayout(int gridKey, int columns, int rows, int cellWidth, int cellHeight);
+
+  /// Shows a stream in a grid cell instead of its own texture (textureKey < 0 empties the cell)
+  void setGridCell(int gridKey, int cell, int textureKey);
+
+  /// Dispose a grid; its streams go back to their own textures
+  void disposeGrid(int gridKey);
+
+  /// Budget for decoded memory of all streams, in bytes (0 = unlimited)
+  void setMemoryBudget(int bytes);
+
+  /// Decoded memory of all streams against the budget
+  MemoryStats getMemoryStats();
+
+  /// Core set (bit i = logical core i, 0 = all) and priority (0 = unchanged, 1 low .. 4 highest) of a thread role: 0 network, 1 decode, 2 display, 3 UI
+  void setThreadPolicy(int role, int coreMask, int priority);
+
+  /// Stops every stream at once; textures keep their last frame
+  void stopAll();
+
+  /// Disposes every stream and grid at once (e.g. leftovers after a hot restart)
+  void disposeAll();
+
+  /// Headerless frames: measure brightness from the decoded luma (YUV decode, more CPU)
+  void setMeasureBrightness(int textureKey, bool enabled);
 }
 
 /// Flutter API - called from C++, implemented in Dart
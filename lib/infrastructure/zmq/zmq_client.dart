@@ -51,8 +51,10 @@ class ZmqClient {
           final frames = message.toList();
           if (frames.isEmpty) return;
 
-          final raw = frames[0].payload;
-          final parsed = _parseFrame(raw);
+          // 2파트: [JSON 헤더][JPEG], 1파트: [4바이트 헤더길이][JSON헤더][JPEG]
+          final parsed = frames.length >= 2
+              ? _parseMultipart(frames[0].payload, frames[1].payload)
+              : _parseFrame(frames[0].payload);
           if (parsed != null) {
             onFrame(parsed);
           }
@@ -78,10 +80,10 @@ class ZmqClient {
       final headerLen = raw[0] | (raw[1] << 8) | (raw[2] << 16) | (raw[3] << 24);
       if (raw.length < 4 + headerLen) return null;
 
-      // JSON 헤더 파싱
-      final headerBytes = raw.sublist(4, 4 + headerLen);
-      final headerStr = utf8.decode(headerBytes);
-      final header = jsonDecode(headerStr) as Map<String, dynamic>;
+      // JSON 또는 바이너리 헤더 파싱
+      final headerBytes = Uint8List.sublistView(raw, 4, 4 + headerLen);
+      final header = _decodeHeader(headerBytes);
+      if (header == null) return null;
 
       // 이미지 데이터 추출
       final imageStart = 4 + headerLen;
@@ -93,6 +95,65 @@ class ZmqClient {
     }
   }
 
+  /// 멀티파트 프레임 파싱: [JSON헤더] [이미지데이터]
+  ZmqFrame? _parseMultipart(Uint8List headerBytes, Uint8List imageData) {
+    try {
+      final header =
+          headerBytes.isEmpty ? <String, dynamic>{} : _decodeHeader(headerBytes);
+      if (header == null) return null;
+      return ZmqFrame(header: header, imageData: imageData);
+    } catch (e) {
+      return null;
+    }
+  }
+
+  /// 헤더 디코딩: "ISBH" 매직으로 시작하면 바이너리 헤더, 아니면 JSON
+  ///
+  /// 바이너리 헤더도 JSON과 같은 `{"header": {...}}` 구조로 변환합니다.
+  Map<String, dynamic>? _decodeHeader(Uint8List bytes) {
+    if (bytes.length >= 4 &&
+        bytes[0] == 0x49 && // 'I'
+        bytes[1] == 0x53 && // 'S'
+        bytes[2] == 0x42 && // 'B'
+        bytes[3] == 0x48) { // 'H'
+      return _decodeBinaryHeader(bytes);
+    }
+    return jsonDecode(utf8.decode(bytes)) as Map<String, dynamic>;
+  }
+
+  /// 바이너리 헤더 v1 (104 bytes, little-endian) - docs/ZMQ_HEADER_FORMAT.md 참고
+  Map<String, dynamic>? _decodeBinaryHeader(Uint8List bytes) {
+    if (bytes.length < 104) return null;
+    final data = ByteData.sublistView(bytes);
+    final version = data.getUint16(4, Endian.little);
+    final headerSize = data.getUint16(6, Endian.little);
+    if (version == 0 || headerSize < 104 || headerSize > bytes.length) {
+      return null;
+    }
+
+    final flags = bytes[8];
+    final camIdxLen = bytes[9] > 32 ? 32 : bytes[9];
+    final camNumLen = bytes[10] > 16 ? 16 : bytes[10];
+
+    final header = <String, dynamic>{
+      'cam_idx': utf8.decode(bytes.sublist(56, 56 + camIdxLen), allowMalformed: true),
+      'cam_num': utf8.decode(bytes.sublist(88, 88 + camNumLen), allowMalformed: true),
+      'brightness': data.getFloat64(32, Endian.little),
+      'motion': (flags & 0x01) != 0,
+      'seq': data.getUint64(16, Endian.little),
+      'capture_time_us': data.getInt64(24, Endian.little),
+    };
+    if ((flags & 0x02) != 0) {
+      header['bbox'] = {
+        'x': data.getInt32(40, Endian.little),
+        'y': data.getInt32(44, Endian.little),
+        'w': data.getInt32(48, Endian.little),
+        'h': data.getInt32(52, Endian.little),
+      };
+    }
+    return {'header': header};
+  }
+
   /// 연결 해제
   void disconnect() {
     _subscription?.cancel();
@@ -2,6 +2,7 @@ import 'package:flutter/material.dart';
 import 'package:flutter_riverpod/flutter_riverpod.dart';
 import 'package:shared_preferences/shared_preferences.dart';
 import 'package:supabase_flutter/supabase_flutter.dart';
+import 'infrastructure/native/native_video_renderer.dart';
 import 'infrastructure/supabase/supabase_config.dart';
 import 'presentation/router/app_router.dart';
 import 'infrastructure/local_storage/shared_preferences.dart';
@@ -9,6 +10,9 @@ import 'infrastructure/local_storage/shared_preferences.dart';
 Future<void> main() async {
   WidgetsFlutterBinding.ensureInitialized();
 
+  // 핫 리스타트 시 이전 Dart 상태의 네이티브 스트림 정리 (새로 시작한 경우 변화 없음)
+  await NativeVideoRenderer.disposeAll().catchError((_) {});
+
   // Supabase 초기화
   await Supabase.initialize(
     url: SupabaseConfig.url,
@@ -1,9 +1,13 @@
 import 'package:flutter/material.dart';
-import 'package:flutter_riverpod/flutter_riverpod.dart';
+import 'package:flutter_hooks/flutter_hooks.dart';
+import 'package:hooks_riverpod/hooks_riverpod.dart';
+import '../../infrastructure/constants/app_constants.dart';
+import '../../infrastructure/native/native_video_grid.dart';
+import '../../infrastructure/native/native_video_renderer.dart';
 import '../widgets/camera_tile.dart';
 import '../viewmodels/camera_viewmodel.dart';
 
-class MultiCameraPage extends ConsumerWidget {
+class MultiCameraPage extends HookConsumerWidget {
   const MultiCameraPage({super.key});
 
   void _showLayoutDialog(BuildContext context, WidgetRef ref) {
@@ -42,6 +46,13 @@ class MultiCameraPage extends ConsumerWidget {
   @override
   Widget build(BuildContext context, WidgetRef ref) {
     final cameraCount = ref.watch(cameraCountProvider);
+    // 처음 표시될 때와 카메라 수가 바뀔 때만 배치 변경 (다시 빌드될 때마다 호출하지 않음)
+    useEffect(() {
+      if (gridCompositorMode) {
+        NativeVideoGrid.shared.setCameraCount(cameraCount).catchError((_) {});
+      }
+      return null;
+    }, [cameraCount]);
 
     return Scaffold(
       backgroundColor: const Color(0xFF0A0A0A),
@@ -62,7 +73,9 @@ class MultiCameraPage extends ConsumerWidget {
           TextButton.icon(
             icon: const Icon(Icons.stop, color: Colors.red, size: 18),
             label: const Text('전체 해제', style: TextStyle(color: Colors.white70, fontSize: 12)),
-            onPressed: () {
+            onPressed: () async {
+              // 전체 스트림을 한 번에 중지한 뒤 각 카메라 정리 (순차 중지 대기 없음)
+              await NativeVideoRenderer.stopAll().catchError((_) {});
               for (int i = 0; i < cameraCount; i++) {
                 ref.read(cameraViewModelProvider(i).notifier).disconnect();
               }
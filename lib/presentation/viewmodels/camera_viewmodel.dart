@@ -4,6 +4,8 @@ import '../../infrastructure/constants/app_constants.dart';
 import '../../infrastructure/logger/logger_provider.dart';
 import '../../domain/entities/camera_state.dart';
 import '../../infrastructure/local_storage/camera_settings.dart';
+import '../../infrastructure/native/native_thread_policy.dart';
+import '../../infrastructure/native/native_video_grid.dart';
 import '../../infrastructure/native/native_video_renderer.dart';
 import '../../infrastructure/native/generated/native_video_api.g.dart';
 
@@ -19,16 +21,31 @@ class CameraViewModel extends _$CameraViewModel {
   int _receiveThisSecond = 0;
   int _lastFrameCount = 0;
 
-  // 수신 타임아웃 체크용 타이머
-  Timer? _timeoutTimer;
+  // 네이티브 스트림 상태 (상태 변화 로그용)
+  NativeStreamState? _lastStreamState;
+
+  // 디코딩 품질 단계 (변화 로그용, 0=원본)
+  int _lastQualityStep = 0;
+  int _lastBudgetStep = 0;
 
   // 프레임 정보 폴링 타이머
   Timer? _pollTimer;
 
+  // 타일 표시 크기 (물리 픽셀) - 축소 디코딩용
+  int _displayWidth = 0;
+  int _displayHeight = 0;
+
+  // 디지털 줌 (네이티브에서 확대 영역만 디코딩)
+  double _zoom = 1.0;
+  double _zoomCenterX = 0.5;
+  double _zoomCenterY = 0.5;
+  bool _zoomFollowBbox = false;
+
+  static const double _maxZoom = 8.0;
+
   @override
   CameraState build(int id) {
     ref.onDispose(() {
-      _timeoutTimer?.cancel();
       _pollTimer?.cancel();
       disconnect();
     });
@@ -47,17 +64,14 @@ class CameraViewModel extends _$CameraViewModel {
   Future<void> updateAddress(String address, {String? presetLabel, bool autoConnect = false}) async {
     // 기존 연결/연결중 상태면 해제
     if (state.isConnected || state.isConnecting) {
+      // stopStream/dispose는 네이티브 정리가 끝난 뒤 반환되므로 별도 대기 불필요
       await disconnect();
-      // 네이티브 리소스 정리 대기 (스레드 종료 등)
-      await Future.delayed(const Duration(milliseconds: 300));
     }
     // 로컬 저장소에 저장
     await ref.read(cameraAddressSettingProvider(state.id).notifier).set(address);
     state = state.copyWith(address: address, presetLabel: presetLabel);
 
     if (autoConnect && address.isNotEmpty) {
-      // 상태 안정화 대기
-      await Future.delayed(const Duration(milliseconds: 100));
       await connect();
     }
   }
@@ -83,7 +97,6 @@ class CameraViewModel extends _$CameraViewModel {
         await _renderer!.dispose();
       } catch (_) {}
       _renderer = null;
-      await Future.delayed(const Duration(milliseconds: 100));
     }
 
     state = state.copyWith(
@@ -104,26 +117,51 @@ class CameraViewModel extends _$CameraViewModel {
 
       // Reset frame count tracking
       _lastFrameCount = 0;
+      _lastStreamState = null;
+      _lastQualityStep = 0;
+      _lastBudgetStep = 0;
+
+      // 디코딩 워커 수가 정해지는 첫 초기화 전에 (같은 값이면 변화 없음)
+      if (threadPartitionMode) {
+        await NativeThreadPolicy.applyPartition();
+      }
 
       // Initialize and get texture ID
       final textureId = await _renderer!.initialize(state.id);
       _addLog('INFO', '텍스처 초기화 완료: $textureId');
 
+      // 모든 스트림 공통 (같은 값이면 변화 없음)
+      await NativeVideoRenderer.setMemoryBudget(decodedMemoryBudgetMb * 1024 * 1024);
+
+      // 지연 누적 방지: 최신 프레임만 디코딩
+      await _renderer!.setLiveMode(liveIngestMode);
+
+      // 헤더 없는 프레임의 밝기 계산 (CPU 추가 사용)
+      await _renderer!.setMeasureBrightness(measureBrightnessMode);
+
+      // 타일 크기에 맞춰 축소 디코딩
+      await _renderer!.setDisplaySize(_displayWidth, _displayHeight);
+      await _renderer!.setZoom(_zoom, _zoomCenterX, _zoomCenterY);
+      await _renderer!.setZoomFollowBbox(_zoomFollowBbox);
+
       // Start ZMQ stream
       await _renderer!.startStream(state.address);
 
       _addLog('INFO', '네이티브 스트림 시작됨');
+
+      // 그리드 합성 모드: 공유 텍스처의 자기 셀에 표시
+      final displayTextureId = gridCompositorMode
+          ? await NativeVideoGrid.shared.attach(state.id, state.id)
+          : textureId;
+
       state = state.copyWith(
         isConnecting: false,
         isConnected: true,
         isReceiveTimeout: false,
         lastFrameTime: DateTime.now(),
-        textureId: textureId,
+        textureId: displayTextureId,
       );
 
-      // 수신 타임아웃 체크 타이머 시작
-      _startTimeoutTimer();
-
       // 프레임 정보 폴링 타이머 시작
       _startPollTimer();
     } catch (e) {
@@ -153,6 +191,11 @@ class CameraViewModel extends _$CameraViewModel {
       final info = await _renderer!.getFrameInfo();
       if (info == null) return;
 
+      // 정지/재연결 감지는 네이티브에서 수행 (같은 텍스처로 자동 복구)
+      _updateStreamState(info.nativeStreamState);
+      _updateQualityStep(info.qualityStep ?? 0);
+      _updateBudgetStep(info.budgetStep ?? 0);
+
       // 새 프레임이 있는 경우에만 업데이트
       if (info.frameCount == _lastFrameCount) return;
 
@@ -213,30 +256,100 @@ class CameraViewModel extends _$CameraViewModel {
     state = state.copyWith(error: error);
   }
 
-  /// 수신 타임아웃 체크 타이머 시작
-  void _startTimeoutTimer() {
-    _timeoutTimer?.cancel();
-    _timeoutTimer = Timer.periodic(
-      const Duration(seconds: 1),
-      (_) => _checkReceiveTimeout(),
-    );
+  /// 네이티브 스트림 상태 반영
+  void _updateStreamState(NativeStreamState streamState) {
+    if (streamState == _lastStreamState) return;
+    final previous = _lastStreamState;
+    _lastStreamState = streamState;
+
+    switch (streamState) {
+      case NativeStreamState.stalled:
+        _addLog('ERR', '수신 타임아웃 - 프레임 없음');
+      case NativeStreamState.reconnecting:
+        _addLog('ERR', '연결 끊김 - 재연결 중');
+      case NativeStreamState.live:
+        if (previous == NativeStreamState.stalled || previous == NativeStreamState.reconnecting) {
+          _addLog('INFO', '수신 복구됨');
+        }
+      case NativeStreamState.connecting:
+        break;
+    }
+
+    final timedOut = streamState == NativeStreamState.stalled ||
+        streamState == NativeStreamState.reconnecting;
+    if (timedOut != state.isReceiveTimeout) {
+      state = state.copyWith(isReceiveTimeout: timedOut);
+    }
+  }
+
+  /// 디코딩 품질 단계 변화 로그 (부하 시 네이티브에서 자동 조정)
+  void _updateQualityStep(int step) {
+    if (step == _lastQualityStep) return;
+    final lowered = step > _lastQualityStep;
+    _lastQualityStep = step;
+
+    final scale = step == 0 ? '원본' : '1/${1 << step}';
+    _addLog('INFO', lowered ? '디코딩 부하 - 해상도 $scale로 낮춤' : '디코딩 여유 - 해상도 $scale로 복구');
   }
 
-  /// 수신 타임아웃 체크
-  void _checkReceiveTimeout() {
-    if (!state.isConnected || state.lastFrameTime == null) return;
+  /// 메모리 예산 단계 변화 로그 (예산 초과 시 네이티브에서 자동 조정)
+  void _updateBudgetStep(int step) {
+    if (step == _lastBudgetStep) return;
+    final lowered = step > _lastBudgetStep;
+    _lastBudgetStep = step;
+
+    final scale = step == 0 ? '원본' : '1/${1 << step}';
+    _addLog('INFO', lowered ? '메모리 예산 초과 - 해상도 $scale로 낮춤' : '메모리 여유 - 해상도 $scale로 복구');
+  }
 
-    final elapsed = DateTime.now().difference(state.lastFrameTime!).inSeconds;
-    if (elapsed >= receiveTimeoutSeconds && !state.isReceiveTimeout) {
-      _addLog('ERR', '수신 타임아웃 - ${receiveTimeoutSeconds}초 동안 프레임 없음');
-      state = state.copyWith(isReceiveTimeout: true);
+  /// 타일 표시 크기 변경 (물리 픽셀)
+  ///
+  /// 같은 크기면 무시하며, 연결 전에 호출되면 다음 연결 시 적용됩니다.
+  void setDisplaySize(int width, int height) {
+    if (width == _displayWidth && height == _displayHeight) return;
+    _displayWidth = width;
+    _displayHeight = height;
+    _renderer?.setDisplaySize(width, height).catchError((_) {});
+    if (gridCompositorMode) {
+      NativeVideoGrid.shared.setCellSize(width, height).catchError((_) {});
     }
   }
 
+  /// 포인터 위치 기준 확대/축소
+  ///
+  /// [factor] - 1보다 크면 확대, [viewX]/[viewY] - 화면 내 포인터 위치 (0.0 ~ 1.0).
+  /// 포인터 아래 지점이 그대로 유지되도록 중심을 옮깁니다.
+  void zoomAt(double factor, double viewX, double viewY) {
+    final newZoom = (_zoom * factor).clamp(1.0, _maxZoom);
+    if (newZoom == _zoom) return;
+
+    final centerX = _zoomCenterX + (viewX - 0.5) / _zoom - (viewX - 0.5) / newZoom;
+    final centerY = _zoomCenterY + (viewY - 0.5) / _zoom - (viewY - 0.5) / newZoom;
+    _setZoom(newZoom, centerX, centerY);
+  }
+
+  /// 줌 초기화 (전체 화면)
+  void resetZoom() => _setZoom(1.0, 0.5, 0.5);
+
+  void _setZoom(double zoom, double centerX, double centerY) {
+    // 확대 영역이 프레임 밖으로 나가지 않게 중심 제한
+    final half = 0.5 / zoom;
+    _zoom = zoom;
+    _zoomCenterX = centerX.clamp(half, 1.0 - half);
+    _zoomCenterY = centerY.clamp(half, 1.0 - half);
+    _renderer?.setZoom(_zoom, _zoomCenterX, _zoomCenterY).catchError((_) {});
+  }
+
+  /// bbox 자동 추적 on/off
+  void setZoomFollowBbox(bool enabled) {
+    if (enabled == _zoomFollowBbox) return;
+    _zoomFollowBbox = enabled;
+    _addLog('INFO', enabled ? 'bbox 자동 추적 켜짐' : 'bbox 자동 추적 꺼짐');
+    _renderer?.setZoomFollowBbox(enabled).catchError((_) {});
+  }
+
   /// 카메라 연결 해제
   Future<void> disconnect() async {
-    _timeoutTimer?.cancel();
-    _timeoutTimer = null;
     _pollTimer?.cancel();
     _pollTimer = null;
 
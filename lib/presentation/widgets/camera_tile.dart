@@ -1,7 +1,10 @@
 import 'dart:convert';
+import 'package:flutter/gestures.dart';
 import 'package:flutter/material.dart';
 import 'package:flutter_hooks/flutter_hooks.dart';
 import 'package:hooks_riverpod/hooks_riverpod.dart';
+import '../../infrastructure/constants/app_constants.dart';
+import '../../infrastructure/native/native_video_grid.dart';
 import '../../infrastructure/supabase/camera_preset.dart';
 import '../viewmodels/camera_viewmodel.dart';
 
@@ -24,6 +27,7 @@ class CameraTile extends HookConsumerWidget {
     final camera = ref.watch(cameraViewModelProvider(cameraId));
     final isLogExpanded = ref.watch(cameraLogExpandedProvider(cameraId));
     final aspectRatio = ref.watch(cameraAspectRatioProvider(cameraId));
+    final cameraCount = ref.watch(cameraCountProvider);
     final notifier = ref.read(cameraViewModelProvider(cameraId).notifier);
 
     // Hooks로 컨트롤러 및 상태 관리
@@ -32,6 +36,9 @@ class CameraTile extends HookConsumerWidget {
     final headerScrollController = useScrollController();
     final isEditing = useState(false);
     final logFontSize = useState(9.0);
+    final followBbox = useState(false);
+    // 마지막으로 네이티브에 전달한 레이아웃 (제약, DPR)
+    final reportedLayout = useRef<(BoxConstraints, double)?>(null);
 
     // 테두리 색상 결정: 수신 타임아웃 시 빨간색
     final borderColor = camera.isReceiveTimeout
@@ -60,6 +67,7 @@ class CameraTile extends HookConsumerWidget {
             addressController,
             isEditing,
             aspectRatio,
+            followBbox,
           ),
           Expanded(
             child: Stack(
@@ -71,7 +79,34 @@ class CameraTile extends HookConsumerWidget {
                         ? Stack(
                             children: [
                               Positioned.fill(
-                                child: _buildImageWithRatio(camera, aspectRatio),
+                                child: LayoutBuilder(
+                                  builder: (context, constraints) {
+                                    _reportDisplaySize(
+                                      context,
+                                      constraints,
+                                      notifier,
+                                      reportedLayout,
+                                    );
+                                    // 휠: 포인터 위치 기준 줌, 더블클릭: 줌 초기화
+                                    return Listener(
+                                      onPointerSignal: (event) {
+                                        if (event is! PointerScrollEvent) return;
+                                        final factor = event.scrollDelta.dy < 0 ? 1.25 : 0.8;
+                                        notifier.zoomAt(
+                                          factor,
+                                          event.localPosition.dx / constraints.maxWidth,
+                                          event.localPosition.dy / constraints.maxHeight,
+                                        );
+                                      },
+                                      child: GestureDetector(
+                                        onDoubleTap: notifier.resetZoom,
+                                        child: gridCompositorMode && camera.textureId != null
+                                            ? _buildGridCell(camera, cameraCount)
+                                            : _buildImageWithRatio(camera, aspectRatio),
+                                      ),
+                                    );
+                                  },
+                                ),
                               ),
                               // 수신 타임아웃 오버레이
                               if (camera.isReceiveTimeout)
@@ -316,6 +351,7 @@ class CameraTile extends HookConsumerWidget {
     TextEditingController addressController,
     ValueNotifier<bool> isEditing,
     String aspectRatioMode,
+    ValueNotifier<bool> followBbox,
   ) {
     final isHttp = _isHttpAddress(addressController.text);
     // 현재 비율 라벨 찾기
@@ -470,6 +506,21 @@ class CameraTile extends HookConsumerWidget {
               constraints: const BoxConstraints(minWidth: 28, minHeight: 28),
               tooltip: '로그 토글',
             ),
+            // bbox 자동 추적 (네이티브 줌)
+            IconButton(
+              icon: Icon(
+                Icons.center_focus_strong,
+                size: 16,
+                color: followBbox.value ? Colors.cyan : Colors.white54,
+              ),
+              onPressed: () {
+                followBbox.value = !followBbox.value;
+                notifier.setZoomFollowBbox(followBbox.value);
+              },
+              padding: EdgeInsets.zero,
+              constraints: const BoxConstraints(minWidth: 28, minHeight: 28),
+              tooltip: followBbox.value ? 'bbox 자동 추적 끄기' : 'bbox 자동 추적',
+            ),
             // 비율 선택 버튼
             PopupMenuButton<String>(
               icon: const Icon(Icons.aspect_ratio, color: Colors.white54, size: 16),
@@ -509,6 +560,59 @@ class CameraTile extends HookConsumerWidget {
     );
   }
 
+  /// 타일 영상 영역의 물리 픽셀 크기를 네이티브에 전달 (축소 디코딩용)
+  ///
+  /// LayoutBuilder는 타일이 다시 빌드될 때마다 호출되므로, 제약이나 DPR이
+  /// 바뀐 경우에만 전달합니다.
+  void _reportDisplaySize(
+    BuildContext context,
+    BoxConstraints constraints,
+    CameraViewModel notifier,
+    ObjectRef<(BoxConstraints, double)?> reported,
+  ) {
+    if (!constraints.hasBoundedWidth || !constraints.hasBoundedHeight) return;
+    final pixelRatio = MediaQuery.devicePixelRatioOf(context);
+    if (reported.value == (constraints, pixelRatio)) return;
+    reported.value = (constraints, pixelRatio);
+    final width = (constraints.maxWidth * pixelRatio).ceil();
+    final height = (constraints.maxHeight * pixelRatio).ceil();
+    // 빌드 중 상태 변경을 피하기 위해 프레임 이후 전달
+    WidgetsBinding.instance.addPostFrameCallback((_) {
+      notifier.setDisplaySize(width, height);
+    });
+  }
+
+  /// 그리드 합성 모드: 공유 텍스처에서 이 카메라의 셀만 잘라 표시
+  ///
+  /// 셀 크기가 타일 영상 영역 크기와 같으므로 텍스처 전체를 (열 x 행) 배로 펼쳐
+  /// 이 카메라의 셀이 영역에 오도록 맞춥니다. 비율은 네이티브에서 맞춤(contain) 처리됩니다.
+  Widget _buildGridCell(camera, int cameraCount) {
+    final (columns, rows) = NativeVideoGrid.layoutFor(cameraCount);
+    final column = cameraId % columns;
+    final row = cameraId ~/ columns;
+
+    return LayoutBuilder(
+      builder: (context, constraints) {
+        return ClipRect(
+          child: OverflowBox(
+            alignment: Alignment(
+              columns > 1 ? -1 + 2 * column / (columns - 1) : 0,
+              rows > 1 ? -1 + 2 * row / (rows - 1) : 0,
+            ),
+            minWidth: constraints.maxWidth * columns,
+            maxWidth: constraints.maxWidth * columns,
+            minHeight: constraints.maxHeight * rows,
+            maxHeight: constraints.maxHeight * rows,
+            child: Texture(
+              textureId: camera.textureId!,
+              filterQuality: FilterQuality.low,
+            ),
+          ),
+        );
+      },
+    );
+  }
+
   /// 비율 모드에 따라 이미지 위젯 빌드
   Widget _buildImageWithRatio(camera, String ratioMode) {
     // 비율 모드별 처리
@@ -0,0 +1,177 @@
+#include "buffer_pool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace {
+
+// Size classes: kMinBlock * {4,5,6,7}/4 * 2^n up to kMaxPooledBlock. Larger
+// blocks are allocated to size and freed on release, never cached.
+constexpr size_t kMinBlock = 16 * 1024;
+constexpr size_t kClassesPerOctave = 4;
+constexpr size_t kClassCount = 13 * kClassesPerOctave;  // up to 112 MB (8K RGBA)
+
+// Cached blocks beyond this are freed on release instead
+constexpr size_t kMaxCachedBytes = 256 * 1024 * 1024;
+
+// Free blocks unused this long go back to the system; checked at most once
+// per kTrimInterval from Recycle
+constexpr auto kIdleTrim = std::chrono::seconds(10);
+constexpr auto kTrimInterval = std::chrono::seconds(1);
+
+}  // namespace
+
+BufferPool& BufferPool::Instance() {
+  // Never destroyed: buffers of objects torn down at exit still come back
+  static BufferPool* pool = new BufferPool();
+  return *pool;
+}
+
+size_t BufferPool::ClassSize(size_t index) {
+  size_t octave = index / kClassesPerOctave;
+  size_t step = index % kClassesPerOctave;
+  return (kMinBlock << octave) / kClassesPerOctave * (kClassesPerOctave + step);
+}
+
+size_t BufferPool::ClassIndex(size_t size) {
+  size_t index = 0;
+  while (index < kClassCount && ClassSize(index) < size) {
+    ++index;
+  }
+  return index;  // kClassCount: too large to pool
+}
+
+uint8_t* BufferPool::Allocate(size_t size) {
+  return static_cast<uint8_t*>(::operator new(size, std::align_val_t(kAlignment)));
+}
+
+void BufferPool::Free(uint8_t* block) {
+  ::operator delete(block, std::align_val_t(kAlignment));
+}
+
+uint8_t* BufferPool::Acquire(size_t size, size_t* capacity) {
+  size_t index = ClassIndex(size);
+  if (index == kClassCount) {
+    *capacity = (size + kAlignment - 1) / kAlignment * kAlignment;
+  } else {
+    *capacity = ClassSize(index);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index < free_.size() && !free_[index].empty()) {
+      uint8_t* block = free_[index].back().data;
+      free_[index].pop_back();
+      stats_.cached_bytes -= *capacity;
+      ++stats_.reuses;
+      return block;
+    }
+  }
+
+  uint8_t* block = Allocate(*capacity);
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.allocated_bytes += *capacity;
+  stats_.high_water_bytes = (std::max)(stats_.high_water_bytes, stats_.allocated_bytes);
+  ++stats_.allocations;
+  return block;
+}
+
+void BufferPool::Recycle(uint8_t* block, size_t capacity) {
+  if (!block) return;
+
+  auto now = std::chrono::steady_clock::now();
+  size_t index = ClassIndex(capacity);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index < kClassCount && stats_.cached_bytes + capacity <= kMaxCachedBytes) {
+      if (free_.size() < kClassCount) free_.resize(kClassCount);
+      free_[index].push_back({block, now});
+      stats_.cached_bytes += capacity;
+      block = nullptr;
+    } else {
+      stats_.allocated_bytes -= capacity;
+    }
+
+    if (now - last_trim_ >= kTrimInterval) {
+      TrimLocked(now, kIdleTrim);
+    }
+  }
+  if (block) Free(block);
+}
+
+void BufferPool::Trim(std::chrono::steady_clock::duration idle) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  TrimLocked(std::chrono::steady_clock::now(), idle);
+}
+
+void BufferPool::TrimLocked(std::chrono::steady_clock::time_point now,
+                            std::chrono::steady_clock::duration idle) {
+  last_trim_ = now;
+  for (size_t index = 0; index < free_.size(); ++index) {
+    // Oldest first: blocks are reused from the back
+    std::vector<FreeBlock>& blocks = free_[index];
+    size_t expired = 0;
+    while (expired < blocks.size() && now - blocks[expired].since >= idle) {
+      Free(blocks[expired].data);
+      ++expired;
+    }
+    if (expired == 0) continue;
+    blocks.erase(blocks.begin(), blocks.begin() + static_cast<std::ptrdiff_t>(expired));
+    size_t bytes = expired * ClassSize(index);
+    stats_.cached_bytes -= bytes;
+    stats_.allocated_bytes -= bytes;
+  }
+}
+
+BufferPool::Stats BufferPool::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+PooledBuffer::PooledBuffer(PooledBuffer&& other) noexcept
+    : data_(other.data_), size_(other.size_), capacity_(other.capacity_) {
+  other.data_ = nullptr;
+  other.size_ = 0;
+  other.capacity_ = 0;
+}
+
+PooledBuffer& PooledBuffer::operator=(PooledBuffer&& other) noexcept {
+  if (this != &other) {
+    reset();
+    data_ = other.data_;
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.capacity_ = 0;
+  }
+  return *this;
+}
+
+void PooledBuffer::resize(size_t size) {
+  if (size > capacity_) {
+    size_t capacity = 0;
+    uint8_t* block = BufferPool::Instance().Acquire(size, &capacity);
+    if (size_ > 0) {
+      memcpy(block, data_, size_);
+    }
+    BufferPool::Instance().Recycle(data_, capacity_);
+    data_ = block;
+    capacity_ = capacity;
+  }
+  size_ = size;
+}
+
+void PooledBuffer::assign(const uint8_t* first, const uint8_t* last) {
+  size_ = 0;  // nothing to keep across a regrow
+  resize(static_cast<size_t>(last - first));
+  if (size_ > 0) {
+    memcpy(data_, first, size_);
+  }
+}
+
+void PooledBuffer::reset() {
+  BufferPool::Instance().Recycle(data_, capacity_);
+  data_ = nullptr;
+  size_ = 0;
+  capacity_ = 0;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Process-wide pool of 64-byte-aligned byte buffers in size classes (four per
+// power of two, so a block wastes at most 25%). Frame, JPEG and parser buffers
+// of every stream come from here and go back on release, so a stream that
+// reconnects or a camera that replaces another reuses the same memory, and
+// steady state makes no allocations. Free blocks idle for too long are trimmed.
+class BufferPool {
+ public:
+  struct Stats {
+    size_t allocated_bytes = 0;   // in use + cached
+    size_t cached_bytes = 0;      // free blocks kept for reuse
+    size_t high_water_bytes = 0;  // peak allocated_bytes
+    uint64_t allocations = 0;     // blocks taken from the system
+    uint64_t reuses = 0;          // blocks served from the cache
+  };
+
+  static constexpr size_t kAlignment = 64;
+
+  static BufferPool& Instance();
+
+  // Block of at least size bytes; *capacity receives its real size
+  uint8_t* Acquire(size_t size, size_t* capacity);
+  // Returns a block from Acquire. Also trims idle blocks now and then.
+  void Recycle(uint8_t* block, size_t capacity);
+
+  // Frees cached blocks unused for at least idle (zero: all of them)
+  void Trim(std::chrono::steady_clock::duration idle);
+
+  Stats stats() const;
+
+ private:
+  struct FreeBlock {
+    uint8_t* data;
+    std::chrono::steady_clock::time_point since;
+  };
+
+  BufferPool() = default;
+
+  static size_t ClassIndex(size_t size);
+  static size_t ClassSize(size_t index);
+  static uint8_t* Allocate(size_t size);
+  static void Free(uint8_t* block);
+
+  void TrimLocked(std::chrono::steady_clock::time_point now, std::chrono::steady_clock::duration idle);
+
+  mutable std::mutex mutex_;
+  std::vector<std::vector<FreeBlock>> free_;  // per size class, newest last
+  Stats stats_;
+  std::chrono::steady_clock::time_point last_trim_;
+};
+
+// Move-only byte buffer backed by BufferPool; the vector-like subset the
+// frame paths use. Shrinking keeps the block, so sizes that go up and down
+// between frames settle on one block.
+class PooledBuffer {
+ public:
+  PooledBuffer() = default;
+  ~PooledBuffer() { reset(); }
+
+  PooledBuffer(PooledBuffer&& other) noexcept;
+  PooledBuffer& operator=(PooledBuffer&& other) noexcept;
+  PooledBuffer(const PooledBuffer&) = delete;
+  PooledBuffer& operator=(const PooledBuffer&) = delete;
+
+  uint8_t* data() { return data_; }
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+  size_t capacity() const { return capacity_; }
+  bool empty() const { return size_ == 0; }
+
+  // Keeps the first min(size(), size) bytes; new bytes are uninitialized
+  void resize(size_t size);
+  void assign(const uint8_t* first, const uint8_t* last);
+  void clear() { size_ = 0; }
+
+  // Returns the block to the pool
+  void reset();
+
+ private:
+  uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  size_t capacity_ = 0;
+};
@@ -0,0 +1,403 @@
+#include "decode_pool.h"
+
+#include "thread_policy.h"
+#include <turbojpeg.h>
+#include <algorithm>
+
+namespace {
+
+// Frames a worker decodes from one lane before moving it to the back of its
+// queue, so a busy stream can't starve the others on the same worker
+constexpr int kLaneRunBudget = 4;
+
+// Worker identity of the current thread, for scheduling onto the local queue
+thread_local const DecodePool* t_pool = nullptr;
+thread_local size_t t_worker = 0;
+
+}  // namespace
+
+DecodeLane::DecodeLane(DecodePool* pool, Handler handler)
+    : pool_(pool), handler_(std::move(handler)) {}
+
+DecodeLane::~DecodeLane() {
+  Close();
+}
+
+EncodedFrame* DecodeLane::BeginPush() {
+  if (closed_.load(std::memory_order_acquire)) return nullptr;
+  size_t tail = tail_.load(std::memory_order_relaxed);
+  if (tail - head_.load(std::memory_order_acquire) >= kCapacity) return nullptr;
+  return &slots_[tail % kCapacity];
+}
+
+void DecodeLane::CommitPush() {
+  tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_seq_cst);
+  if (!scheduled_.exchange(true, std::memory_order_seq_cst)) {
+    pool_->Schedule(this);
+  }
+}
+
+bool DecodeLane::RequestSpace() {
+  space_requested_.store(true, std::memory_order_seq_cst);
+  if (closed_.load(std::memory_order_acquire)) return false;
+
+  // A worker that advanced head_ before the request was visible didn't see it
+  size_t tail = tail_.load(std::memory_order_relaxed);
+  return tail - head_.load(std::memory_order_seq_cst) >= kCapacity;
+}
+
+void DecodeLane::Advance(size_t head) {
+  head_.store(head, std::memory_order_seq_cst);
+  if (space_requested_.load(std::memory_order_seq_cst) &&
+      space_requested_.exchange(false, std::memory_order_seq_cst) && space_handler_) {
+    space_handler_();
+  }
+}
+
+void DecodeLane::Release(size_t index) {
+  // The JPEG buffer keeps its block for the next frame in this slot
+  EncodedFrame& slot = slots_[index % kCapacity];
+  slot.zmq.Reset();
+  slot.jpeg.clear();
+}
+
+void DecodeLane::set_paced(bool enabled, std::chrono::steady_clock::duration deadline) {
+  deadline_.store(deadline.count(), std::memory_order_relaxed);
+  paced_.store(enabled, std::memory_order_relaxed);
+  if (!enabled) {
+    Consumed();  // release a held frame
+  }
+}
+
+void DecodeLane::Consumed() {
+  consumed_.store(true, std::memory_order_seq_cst);
+  if (head_.load(std::memory_order_acquire) != tail_.load(std::memory_order_acquire) &&
+      !scheduled_.exchange(true, std::memory_order_seq_cst)) {
+    pool_->Schedule(this);
+  }
+}
+
+bool DecodeLane::Holding() const {
+  if (!paced_.load(std::memory_order_relaxed) || consumed_.load(std::memory_order_seq_cst)) {
+    return false;
+  }
+  auto deadline = std::chrono::steady_clock::duration(deadline_.load(std::memory_order_relaxed));
+  return std::chrono::steady_clock::now() < last_publish_ + deadline;
+}
+
+bool DecodeLane::Run(tjhandle tj) {
+  bool holding = false;
+  size_t seen_tail = 0;
+
+  for (int decoded = 0; decoded < kLaneRunBudget;) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    size_t tail = tail_.load(std::memory_order_acquire);
+    if (head == tail) break;
+
+    if (closed_.load(std::memory_order_acquire)) {
+      Release(head);
+      head_.store(head + 1, std::memory_order_release);
+      continue;
+    }
+
+    int skipped = held_skipped_;
+    if (latest_only_.load(std::memory_order_relaxed)) {
+      for (; tail - head > 1; ++head, ++skipped) {
+        Release(head);
+      }
+    }
+
+    // The texture still shows the last frame: keep only the newest until
+    // it is pulled, instead of decoding frames that would never be shown
+    if (Holding()) {
+      held_skipped_ = skipped;
+      Advance(head);
+      holding = true;
+      seen_tail = tail;
+      break;
+    }
+    held_skipped_ = 0;
+
+    if (handler_(slots_[head % kCapacity], skipped, tj) && paced_.load(std::memory_order_relaxed)) {
+      consumed_.store(false, std::memory_order_seq_cst);
+      last_publish_ = std::chrono::steady_clock::now();
+    }
+    Release(head);
+    Advance(head + 1);
+    ++decoded;
+  }
+
+  if (holding) {
+    scheduled_.store(false, std::memory_order_seq_cst);
+
+    // A push or Consumed() that landed meanwhile saw scheduled_ still set
+    if ((tail_.load(std::memory_order_seq_cst) != seen_tail ||
+         consumed_.load(std::memory_order_seq_cst)) &&
+        !scheduled_.exchange(true, std::memory_order_seq_cst)) {
+      return true;
+    }
+
+    // Otherwise the deadline is the next thing that can release the frame
+    auto deadline = std::chrono::steady_clock::duration(deadline_.load(std::memory_order_relaxed));
+    pool_->ScheduleAt(this, last_publish_ + deadline);
+    return false;
+  }
+
+  if (head_.load(std::memory_order_relaxed) != tail_.load(std::memory_order_seq_cst)) {
+    return true;
+  }
+  scheduled_.store(false, std::memory_order_seq_cst);
+
+  // A push that landed after the check above saw scheduled_ still set
+  return head_.load(std::memory_order_relaxed) != tail_.load(std::memory_order_seq_cst) &&
+         !scheduled_.exchange(true, std::memory_order_seq_cst);
+}
+
+void DecodeLane::Close() {
+  Cancel();
+  pool_->CancelTimer(this);
+  pool_->WaitLaneIdle(this);
+
+  // Nothing runs the lane any more; drop what was still queued
+  size_t tail = tail_.load(std::memory_order_acquire);
+  for (size_t head = head_.load(std::memory_order_relaxed); head != tail; ++head) {
+    Release(head);
+  }
+  head_.store(tail, std::memory_order_release);
+
+  // A stopped stream keeps no JPEG memory; the blocks go back to the pool
+  for (EncodedFrame& slot : slots_) {
+    slot.jpeg.reset();
+  }
+}
+
+void DecodeLane::Cancel() {
+  closed_.store(true, std::memory_order_release);
+}
+
+DecodePool::DecodePool(size_t thread_count) {
+  if (thread_count == 0 && ThreadPolicy::Instance().Get(ThreadRole::kDecode).core_mask != 0) {
+    thread_count = ThreadPolicy::Instance().CoreCount(ThreadRole::kDecode);
+  } else if (thread_count == 0) {
+    size_t cores = std::thread::hardware_concurrency();
+    thread_count = cores > 1 ? cores - 1 : 1;
+  }
+
+  for (size_t i = 0; i < thread_count; ++i) {
+    auto worker = std::make_unique<Worker>();
+    worker->tj = tjInitDecompress();
+    if (!worker->tj) break;
+    tj3Set(worker->tj, TJPARAM_FASTDCT, 1);  // Use fast DCT for speed
+    workers_.push_back(std::move(worker));
+  }
+
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    workers_[i]->thread = std::thread(&DecodePool::WorkerLoop, this, i);
+  }
+}
+
+DecodePool::~DecodePool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stopping_ = true;
+  }
+  work_cv_.notify_all();
+
+  for (auto& worker : workers_) {
+    if (worker->thread.joinable()) {
+      worker->thread.join();
+    }
+    tjDestroy(worker->tj);
+  }
+}
+
+void DecodePool::Schedule(DecodeLane* lane) {
+  if (workers_.empty()) {
+    lane->scheduled_ = false;
+    return;
+  }
+
+  {
+    // Consumed() may still schedule a closed lane; Close() owns it from here
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    if (lane->closed_.load(std::memory_order_acquire)) {
+      lane->scheduled_ = false;
+      return;
+    }
+    ++lane->runs_;
+  }
+
+  // Workers keep rescheduled lanes local; receive threads spread round robin
+  size_t index = t_pool == this ? t_worker
+                                : next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+  {
+    std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+    workers_[index]->lanes.push_back(lane);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    ++queued_;
+  }
+  work_cv_.notify_one();
+}
+
+void DecodePool::ScheduleAt(DecodeLane* lane, std::chrono::steady_clock::time_point time) {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    if (lane->closed_.load(std::memory_order_acquire)) return;
+    auto it = std::find_if(timers_.begin(), timers_.end(),
+                           [lane](const auto& timer) { return timer.second == lane; });
+    if (it != timers_.end()) {
+      it->first = time;
+    } else {
+      timers_.emplace_back(time, lane);
+    }
+  }
+  // A sleeping worker has to pick up the earlier wakeup time
+  work_cv_.notify_one();
+}
+
+void DecodePool::CancelTimer(DecodeLane* lane) {
+  std::lock_guard<std::mutex> lock(sleep_mutex_);
+  timers_.erase(std::remove_if(timers_.begin(), timers_.end(),
+                               [lane](const auto& timer) { return timer.second == lane; }),
+                timers_.end());
+}
+
+void DecodePool::FireTimers(size_t index) {
+  auto now = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < timers_.size();) {
+    if (timers_[i].first > now) {
+      ++i;
+      continue;
+    }
+    DecodeLane* lane = timers_[i].second;
+    timers_.erase(timers_.begin() + static_cast<std::ptrdiff_t>(i));
+
+    // Counted in runs_ before sleep_mutex_ is released, so Close() waits for it
+    if (lane->closed_.load(std::memory_order_acquire) ||
+        lane->scheduled_.exchange(true, std::memory_order_seq_cst)) {
+      continue;
+    }
+    ++lane->runs_;
+    {
+      std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+      workers_[index]->lanes.push_back(lane);
+    }
+    ++queued_;
+  }
+}
+
+DecodeLane* DecodePool::TakeLane(size_t index) {
+  // Every reserved slot in queued_ has a lane in some queue, so this finds one
+  for (;;) {
+    for (size_t n = 0; n < workers_.size(); ++n) {
+      Worker& worker = *workers_[(index + n) % workers_.size()];
+      std::lock_guard<std::mutex> lock(worker.mutex);
+      if (worker.lanes.empty()) continue;
+
+      DecodeLane* lane = worker.lanes.front();
+      worker.lanes.pop_front();
+      return lane;
+    }
+    std::this_thread::yield();
+  }
+}
+
+void DecodePool::WorkerLoop(size_t index) {
+  t_pool = this;
+  t_worker = index;
+  tjhandle tj = workers_[index]->tj;
+
+  for (;;) {
+    ThreadPolicy::Instance().Apply(ThreadRole::kDecode);
+    {
+      std::unique_lock<std::mutex> lock(sleep_mutex_);
+      for (FireTimers(index); !stopping_ && queued_ == 0 && !OpenJob(); FireTimers(index)) {
+        if (timers_.empty()) {
+          work_cv_.wait(lock);
+          continue;
+        }
+        auto next = std::min_element(timers_.begin(), timers_.end())->first;
+        work_cv_.wait_until(lock, next);
+      }
+      if (stopping_) return;
+
+      // Help a ParallelFor first: its caller holds a frame's texture buffer
+      if (ParallelJob* job = OpenJob()) {
+        ++job->helpers;
+        lock.unlock();
+        RunJob(job, tj);
+        lock.lock();
+        --job->helpers;
+        lock.unlock();
+        idle_cv_.notify_all();
+        continue;
+      }
+      // The job that woke this worker may have been taken up meanwhile
+      if (queued_ == 0) continue;
+      --queued_;
+    }
+
+    DecodeLane* lane = TakeLane(index);
+    if (lane->Run(tj)) {
+      // More frames: back of the local queue, still counted in runs_
+      {
+        std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+        workers_[index]->lanes.push_back(lane);
+      }
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      ++queued_;
+      continue;
+    }
+
+    // Last access to the lane; Close() may free it once this is released
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      --lane->runs_;
+    }
+    idle_cv_.notify_all();
+  }
+}
+
+void DecodePool::WaitLaneIdle(DecodeLane* lane) {
+  std::unique_lock<std::mutex> lock(sleep_mutex_);
+  idle_cv_.wait(lock, [this, lane]() { return lane->runs_ == 0 || stopping_; });
+}
+
+bool DecodePool::ParallelFor(size_t count, tjhandle tj,
+                             const std::function<bool(size_t, tjhandle)>& task) {
+  ParallelJob job;
+  job.task = &task;
+  job.count = count;
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    jobs_.push_back(&job);
+  }
+  work_cv_.notify_all();
+
+  RunJob(&job, tj);
+
+  // No new helpers once the job is off the list; wait out the ones inside
+  std::unique_lock<std::mutex> lock(sleep_mutex_);
+  jobs_.erase(std::find(jobs_.begin(), jobs_.end(), &job));
+  idle_cv_.wait(lock, [&job]() { return job.helpers == 0; });
+  return !job.failed.load(std::memory_order_relaxed);
+}
+
+void DecodePool::RunJob(ParallelJob* job, tjhandle tj) {
+  for (size_t i = job->next.fetch_add(1, std::memory_order_relaxed); i < job->count;
+       i = job->next.fetch_add(1, std::memory_order_relaxed)) {
+    if (!(*job->task)(i, tj)) {
+      job->failed.store(true, std::memory_order_relaxed);
+    }
+  }
+}
+
+DecodePool::ParallelJob* DecodePool::OpenJob() const {
+  for (ParallelJob* job : jobs_) {
+    if (job->next.load(std::memory_order_relaxed) < job->count) return job;
+  }
+  return nullptr;
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "buffer_pool.h"
+#include "zmq_message.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+typedef void* tjhandle;
+
+class DecodePool;
+
+// Compressed frame handed from a receive thread to the decode pool. ZMQ frames
+// share the received zmq_msg_t (no copy); HTTP frames copy the JPEG out of the
+// parser buffer into jpeg, a pooled block reused by later frames.
+struct EncodedFrame {
+  ZmqFrame zmq;
+  PooledBuffer jpeg;
+};
+
+// Per-stream decode lane: a bounded lock-free single-producer/single-consumer
+// ring between the stream's receive thread and the pool. At most one worker
+// drains a lane at a time, so a stream's frames are decoded in order while
+// different streams decode in parallel.
+class DecodeLane {
+ public:
+  // Runs on a pool worker with that worker's TurboJPEG decompressor.
+  // skipped: frames dropped in front of this one in latest-only mode.
+  // Returns true if a new frame was published to the texture.
+  using Handler = std::function<bool(EncodedFrame& frame, int skipped, tjhandle tj)>;
+
+  // Runs on a pool worker when a slot frees up after RequestSpace()
+  using SpaceHandler = std::function<void()>;
+
+  static constexpr size_t kCapacity = 4;
+
+  DecodeLane(DecodePool* pool, Handler handler);
+  ~DecodeLane();
+
+  DecodeLane(const DecodeLane&) = delete;
+  DecodeLane& operator=(const DecodeLane&) = delete;
+
+  // Receive thread only. BeginPush returns the slot to fill, or nullptr if the
+  // ring is full (the decoder is behind) or closed. CommitPush publishes the
+  // slot and schedules the lane.
+  EncodedFrame* BeginPush();
+  void CommitPush();
+
+  // Backpressure. Set the handler before the first push.
+  void set_space_handler(SpaceHandler handler) { space_handler_ = std::move(handler); }
+  // Receive thread, after BeginPush found the ring full: the space handler
+  // runs once a slot frees up. False if one freed up meanwhile (or the lane
+  // is closed), so the caller should try BeginPush again instead of waiting.
+  // The handler can also run after a false return; resuming must tolerate it.
+  bool RequestSpace();
+
+  // Latest-only: a worker decodes just the newest queued frame
+  void set_latest_only(bool enabled) { latest_only_ = enabled; }
+
+  // Render-paced: after publishing a frame, the next one is held (only the
+  // newest kept) until Consumed() or until deadline has passed since the
+  // publish. A held lane arms a pool timer for the deadline, so the frame is
+  // decoded then even if nothing else arrives.
+  void set_paced(bool enabled, std::chrono::steady_clock::duration deadline);
+
+  // Any thread: the texture took the last published frame. Schedules the
+  // held frame, if any. Safe to call during and after Close().
+  void Consumed();
+
+  // Stops decoding and returns once no worker runs this lane. Queued frames
+  // are released. Call after the producer has stopped.
+  void Close();
+
+  // Stops decoding without waiting: a run in progress finishes its current
+  // frame and drops the rest. Cancel several lanes before closing each, so
+  // they wind down together.
+  void Cancel();
+
+ private:
+  friend class DecodePool;
+
+  // Pool worker: decodes up to a budget; true if frames remain
+  bool Run(tjhandle tj);
+  void Release(size_t index);
+  // Advances head_ past freed slots and runs the space handler if requested
+  void Advance(size_t head);
+  // Paced and the last published frame is neither consumed nor overdue
+  bool Holding() const;
+
+  DecodePool* pool_;
+  Handler handler_;
+  SpaceHandler space_handler_;
+  EncodedFrame slots_[kCapacity];
+  std::atomic<size_t> head_{0};  // next slot to decode (consumer)
+  std::atomic<size_t> tail_{0};  // next slot to fill (producer)
+  std::atomic<bool> scheduled_{false};
+  std::atomic<bool> closed_{false};
+  std::atomic<bool> latest_only_{false};
+  std::atomic<bool> space_requested_{false};
+
+  std::atomic<bool> paced_{false};
+  std::atomic<bool> consumed_{true};  // nothing published yet counts as consumed
+  std::atomic<std::chrono::steady_clock::rep> deadline_{0};
+  std::chrono::steady_clock::time_point last_publish_;  // pool worker only
+  int held_skipped_ = 0;  // trimmed while holding, reported with the next frame
+  size_t runs_ = 0;  // queued or running pool runs, guarded by the pool's sleep_mutex_
+};
+
+// Decode workers shared by all streams, each owning a TurboJPEG decompressor.
+// Lanes with pending frames are queued on a worker; idle workers steal from
+// the others, so one busy stream never leaves cores idle behind it.
+class DecodePool {
+ public:
+  // thread_count 0 = one per core, leaving one for the UI (one per core of
+  // the decode role's set if ThreadPolicy pins it)
+  explicit DecodePool(size_t thread_count);
+  ~DecodePool();
+
+  DecodePool(const DecodePool&) = delete;
+  DecodePool& operator=(const DecodePool&) = delete;
+
+  size_t thread_count() const { return workers_.size(); }
+
+  // Runs task(i, tj) for every i in [0, count) on the calling thread (with
+  // its decompressor tj) and on whichever workers are idle, each with their
+  // own decompressor; returns once all are done. False if any task failed.
+  // Idle workers pick tasks up before queued lanes.
+  bool ParallelFor(size_t count, tjhandle tj, const std::function<bool(size_t, tjhandle)>& task);
+
+ private:
+  friend class DecodeLane;
+
+  struct ParallelJob {
+    const std::function<bool(size_t, tjhandle)>* task = nullptr;
+    size_t count = 0;
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    size_t helpers = 0;  // workers inside RunJob, guarded by sleep_mutex_
+  };
+
+  struct Worker {
+    std::thread thread;
+    tjhandle tj = nullptr;
+    std::mutex mutex;
+    std::deque<DecodeLane*> lanes;
+  };
+
+  void Schedule(DecodeLane* lane);
+  // Schedules lane at time unless it is scheduled or closed by then; replaces
+  // the lane's previous timer
+  void ScheduleAt(DecodeLane* lane, std::chrono::steady_clock::time_point time);
+  void CancelTimer(DecodeLane* lane);
+  // Queues every lane whose timer is due on worker index. Caller holds
+  // sleep_mutex_.
+  void FireTimers(size_t index);
+  // Oldest lane of the own queue, else of the next non-empty worker queue
+  DecodeLane* TakeLane(size_t index);
+  void WorkerLoop(size_t index);
+  // Blocks until no run of lane is queued or executing
+  void WaitLaneIdle(DecodeLane* lane);
+  static void RunJob(ParallelJob* job, tjhandle tj);
+  // Job with tasks left, or nullptr. Caller holds sleep_mutex_.
+  ParallelJob* OpenJob() const;
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<size_t> next_worker_{0};  // round robin for receive threads
+
+  std::mutex sleep_mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable idle_cv_;
+  size_t queued_ = 0;  // lanes waiting in any worker queue, guarded by sleep_mutex_
+  std::vector<ParallelJob*> jobs_;  // running ParallelFor calls, guarded by sleep_mutex_
+  // Paced lanes waiting for their deadline, guarded by sleep_mutex_
+  std::vector<std::pair<std::chrono::steady_clock::time_point, DecodeLane*>> timers_;
+  bool stopping_ = false;
+};
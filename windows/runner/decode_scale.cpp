@@ -0,0 +1,19 @@
+#include "decode_scale.h"
+
+tjscalingfactor ChooseScalingFactor(int width, int height, int display_width, int display_height) {
+  tjscalingfactor best = {1, 1};
+  if (display_width <= 0 || display_height <= 0) return best;
+
+  static int factor_count = 0;
+  static const tjscalingfactor* factors = tjGetScalingFactors(&factor_count);
+  if (!factors) return best;
+
+  for (int i = 0; i < factor_count; ++i) {
+    const tjscalingfactor& sf = factors[i];
+    if (sf.num != 1 || (sf.denom & (sf.denom - 1)) != 0) continue;  // 1/2^n only
+    int scaled_width = TJSCALED(width, sf);
+    if (scaled_width < display_width || TJSCALED(height, sf) < display_height) continue;
+    if (scaled_width < TJSCALED(width, best)) best = sf;
+  }
+  return best;
+}
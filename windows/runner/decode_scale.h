@@ -0,0 +1,10 @@
+#pragma once
+
+#include <turbojpeg.h>
+
+// Smallest power-of-two libjpeg-turbo scaling factor (1/1, 1/2, 1/4, 1/8)
+// whose output still covers the display size, so the GPU only ever scales
+// down. The factors in between (7/8 ... 3/8) are skipped: their IDCTs have
+// no SIMD path and decode slower than 1/1 (tests/decode_scale_bench). 1/1
+// when the display size is unknown.
+tjscalingfactor ChooseScalingFactor(int width, int height, int display_width, int display_height);
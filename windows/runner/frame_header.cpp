@@ -0,0 +1,382 @@
+#include "frame_header.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+// Nesting deeper than this is rejected instead of recursing further
+constexpr int kMaxDepth = 16;
+
+// Which header field a value belongs to
+enum class Field { kNone, kCamIdx, kCamNum, kBrightness, kMotion, kBboxX, kBboxY, kBboxW, kBboxH };
+
+// Which object the parser is in
+enum class Scope { kRoot, kHeader, kBbox, kOther };
+
+// Binary header v1 field offsets
+constexpr size_t kOffsetVersion = 4;
+constexpr size_t kOffsetSize = 6;
+constexpr size_t kOffsetFlags = 8;
+constexpr size_t kOffsetCamIdxSize = 9;
+constexpr size_t kOffsetCamNumSize = 10;
+constexpr size_t kOffsetSequence = 16;
+constexpr size_t kOffsetCaptureTime = 24;
+constexpr size_t kOffsetBrightness = 32;
+constexpr size_t kOffsetBbox = 40;
+constexpr size_t kOffsetCamIdx = 56;
+constexpr size_t kOffsetCamNum = 88;
+
+constexpr uint8_t kFlagMotion = 1u << 0;
+constexpr uint8_t kFlagBbox = 1u << 1;
+
+uint64_t ReadLittleEndian(const uint8_t* data, size_t bytes) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < bytes; ++i) {
+    value |= static_cast<uint64_t>(data[i]) << (8 * i);
+  }
+  return value;
+}
+
+// Fixed-capacity sink for decoded string values
+struct StringSink {
+  char* data;
+  size_t capacity;
+  size_t size;
+
+  void Push(char c) {
+    if (size < capacity) data[size++] = c;
+  }
+};
+
+class Tokenizer {
+ public:
+  Tokenizer(std::string_view json, FrameHeader* out) : json_(json), out_(out) {}
+
+  bool Parse() {
+    SkipSpace();
+    if (!ParseValue(Scope::kOther, Field::kNone, 0, /*root=*/true)) return false;
+    SkipSpace();
+    return pos_ == json_.size();
+  }
+
+ private:
+  void SkipSpace() {
+    while (pos_ < json_.size()) {
+      char c = json_[pos_];
+      if (c != ' ' && c != '\t' && c != '\n' && c != '\r') break;
+      ++pos_;
+    }
+  }
+
+  bool Consume(char c) {
+    SkipSpace();
+    if (pos_ < json_.size() && json_[pos_] == c) {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+
+  bool ConsumeLiteral(std::string_view literal) {
+    if (json_.substr(pos_, literal.size()) != literal) return false;
+    pos_ += literal.size();
+    return true;
+  }
+
+  static int HexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+  }
+
+  bool ParseHex4(uint32_t* value) {
+    if (json_.size() - pos_ < 4) return false;
+    uint32_t result = 0;
+    for (int i = 0; i < 4; ++i) {
+      int digit = HexDigit(json_[pos_++]);
+      if (digit < 0) return false;
+      result = (result << 4) | static_cast<uint32_t>(digit);
+    }
+    *value = result;
+    return true;
+  }
+
+  static void PushUtf8(uint32_t cp, StringSink* sink) {
+    if (cp < 0x80) {
+      sink->Push(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+      sink->Push(static_cast<char>(0xC0 | (cp >> 6)));
+      sink->Push(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+      sink->Push(static_cast<char>(0xE0 | (cp >> 12)));
+      sink->Push(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+      sink->Push(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+      sink->Push(static_cast<char>(0xF0 | (cp >> 18)));
+      sink->Push(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+      sink->Push(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+      sink->Push(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+  }
+
+  // Parses a string at pos_ (opening quote included). Escapes are decoded
+  // into sink when given; *raw is set to the undecoded span when the string
+  // has no escapes, which is all keys and numeric values need.
+  bool ParseString(StringSink* sink, std::string_view* raw) {
+    if (pos_ >= json_.size() || json_[pos_] != '"') return false;
+    size_t start = ++pos_;
+    bool escaped = false;
+
+    while (pos_ < json_.size()) {
+      char c = json_[pos_++];
+      if (c == '"') {
+        if (raw) *raw = escaped ? std::string_view() : json_.substr(start, pos_ - 1 - start);
+        return true;
+      }
+      if (c != '\\') {
+        if (sink) sink->Push(c);
+        continue;
+      }
+
+      escaped = true;
+      if (pos_ >= json_.size()) return false;
+      char e = json_[pos_++];
+      char decoded = 0;
+      switch (e) {
+        case '"': decoded = '"'; break;
+        case '\\': decoded = '\\'; break;
+        case '/': decoded = '/'; break;
+        case 'b': decoded = '\b'; break;
+        case 'f': decoded = '\f'; break;
+        case 'n': decoded = '\n'; break;
+        case 'r': decoded = '\r'; break;
+        case 't': decoded = '\t'; break;
+        case 'u': {
+          uint32_t cp = 0;
+          if (!ParseHex4(&cp)) return false;
+          // Surrogate pair
+          if (cp >= 0xD800 && cp <= 0xDBFF && json_.substr(pos_, 2) == "\\u") {
+            size_t mark = pos_;
+            pos_ += 2;
+            uint32_t low = 0;
+            if (ParseHex4(&low) && low >= 0xDC00 && low <= 0xDFFF) {
+              cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+            } else {
+              pos_ = mark;
+            }
+          }
+          if (sink) PushUtf8(cp, sink);
+          continue;
+        }
+        default:
+          return false;
+      }
+      if (sink) sink->Push(decoded);
+    }
+    return false;  // unterminated
+  }
+
+  // Number token span at pos_ (validated by the consumer)
+  std::string_view ScanNumber() {
+    size_t start = pos_;
+    while (pos_ < json_.size()) {
+      char c = json_[pos_];
+      if ((c < '0' || c > '9') && c != '-' && c != '+' && c != '.' && c != 'e' && c != 'E') break;
+      ++pos_;
+    }
+    return json_.substr(start, pos_ - start);
+  }
+
+  static double ToDouble(std::string_view text) {
+    double value = 0.0;
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() ? value : 0.0;
+  }
+
+  // Integers; "284.0" style values are truncated
+  static int ToInt(std::string_view text) {
+    int value = 0;
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (result.ec == std::errc()) return value;
+    double d = ToDouble(text);
+    return (d > -2147483648.0 && d < 2147483648.0) ? static_cast<int>(d) : 0;
+  }
+
+  int* BboxTarget(Field field) {
+    switch (field) {
+      case Field::kBboxX: return &out_->bbox_x;
+      case Field::kBboxY: return &out_->bbox_y;
+      case Field::kBboxW: return &out_->bbox_w;
+      case Field::kBboxH: return &out_->bbox_h;
+      default: return nullptr;
+    }
+  }
+
+  // Stores a scalar (number text, string contents or literal) into field
+  void Assign(Field field, std::string_view text) {
+    if (field == Field::kBrightness) {
+      out_->brightness = ToDouble(text);
+    } else if (field == Field::kMotion) {
+      out_->motion = text == "true";
+    } else if (int* target = BboxTarget(field)) {
+      *target = ToInt(text);
+    }
+  }
+
+  static Field FieldFor(Scope scope, std::string_view key) {
+    if (scope == Scope::kBbox) {
+      if (key == "x") return Field::kBboxX;
+      if (key == "y") return Field::kBboxY;
+      if (key == "w") return Field::kBboxW;
+      if (key == "h") return Field::kBboxH;
+      return Field::kNone;
+    }
+    if (scope != Scope::kRoot && scope != Scope::kHeader) return Field::kNone;
+    if (key == "cam_idx") return Field::kCamIdx;
+    if (key == "cam_num") return Field::kCamNum;
+    if (key == "brightness") return Field::kBrightness;
+    if (key == "motion") return Field::kMotion;
+    return Field::kNone;
+  }
+
+  bool ParseValue(Scope scope, Field field, int depth, bool root) {
+    SkipSpace();
+    if (pos_ >= json_.size()) return false;
+
+    char c = json_[pos_];
+    if (c == '{') return ParseObject(scope, depth + 1, root);
+    if (c == '[') return ParseArray(depth + 1);
+
+    if (c == '"') {
+      StringSink sink{nullptr, 0, 0};
+      if (field == Field::kCamIdx) sink = StringSink{out_->cam_idx, kMaxHeaderStringBytes, 0};
+      if (field == Field::kCamNum) sink = StringSink{out_->cam_num, kMaxHeaderStringBytes, 0};
+
+      std::string_view raw;
+      if (!ParseString(sink.data ? &sink : nullptr, &raw)) return false;
+      if (field == Field::kCamIdx) out_->cam_idx_size = sink.size;
+      else if (field == Field::kCamNum) out_->cam_num_size = sink.size;
+      else if (field != Field::kNone) Assign(field, raw);
+      return true;
+    }
+
+    if (c == 't' || c == 'f' || c == 'n') {
+      std::string_view literal = c == 't' ? "true" : c == 'f' ? "false" : "null";
+      if (!ConsumeLiteral(literal)) return false;
+      if (field != Field::kNone) Assign(field, literal);
+      return true;
+    }
+
+    std::string_view number = ScanNumber();
+    if (number.empty()) return false;
+    if (field != Field::kNone) Assign(field, number);
+    return true;
+  }
+
+  bool ParseObject(Scope scope, int depth, bool root) {
+    if (depth > kMaxDepth) return false;
+    ++pos_;  // '{'
+    Scope own = root ? Scope::kRoot : scope;
+    if (own == Scope::kBbox) out_->has_bbox = true;
+
+    if (Consume('}')) return true;
+    for (;;) {
+      SkipSpace();
+      std::string_view key;
+      if (!ParseString(nullptr, &key)) return false;
+      if (!Consume(':')) return false;
+
+      Scope child = Scope::kOther;
+      Field field = Field::kNone;
+      if (own == Scope::kRoot && key == "header") {
+        // The wrapper wins over any top-level fields
+        SkipSpace();
+        if (pos_ < json_.size() && json_[pos_] == '{') {
+          *out_ = FrameHeader();
+          in_header_ = true;
+        }
+        child = Scope::kHeader;
+      } else if ((own == Scope::kHeader || own == Scope::kRoot) && key == "bbox") {
+        child = Scope::kBbox;
+      } else if (own == Scope::kHeader || (own == Scope::kRoot && !in_header_) || own == Scope::kBbox) {
+        field = FieldFor(own, key);
+      }
+
+      // Top-level fields after the wrapper are ignored
+      if (own == Scope::kRoot && in_header_ && key != "header") {
+        child = Scope::kOther;
+        field = Field::kNone;
+      }
+
+      if (!ParseValue(child, field, depth, false)) return false;
+      if (Consume(',')) continue;
+      return Consume('}');
+    }
+  }
+
+  bool ParseArray(int depth) {
+    if (depth > kMaxDepth) return false;
+    ++pos_;  // '['
+    if (Consume(']')) return true;
+    for (;;) {
+      if (!ParseValue(Scope::kOther, Field::kNone, depth, false)) return false;
+      if (Consume(',')) continue;
+      return Consume(']');
+    }
+  }
+
+  std::string_view json_;
+  FrameHeader* out_;
+  size_t pos_ = 0;
+  bool in_header_ = false;  // "header" wrapper seen
+};
+
+}  // namespace
+
+bool ParseFrameHeader(std::string_view json, FrameHeader* out) {
+  *out = FrameHeader();
+  return Tokenizer(json, out).Parse();
+}
+
+bool IsBinaryFrameHeader(const uint8_t* data, size_t size) {
+  return data != nullptr && size >= sizeof(kBinaryHeaderMagic) &&
+         memcmp(data, kBinaryHeaderMagic, sizeof(kBinaryHeaderMagic)) == 0;
+}
+
+bool ParseBinaryFrameHeader(const uint8_t* data, size_t size, FrameHeader* out) {
+  *out = FrameHeader();
+  if (!IsBinaryFrameHeader(data, size) || size < kBinaryHeaderSize) return false;
+
+  uint16_t version = static_cast<uint16_t>(ReadLittleEndian(data + kOffsetVersion, 2));
+  uint16_t header_size = static_cast<uint16_t>(ReadLittleEndian(data + kOffsetSize, 2));
+  if (version == 0 || header_size < kBinaryHeaderSize || header_size > size) return false;
+
+  size_t cam_idx_size = (std::min)(static_cast<size_t>(data[kOffsetCamIdxSize]), kBinaryHeaderCamIdxBytes);
+  size_t cam_num_size = (std::min)(static_cast<size_t>(data[kOffsetCamNumSize]), kBinaryHeaderCamNumBytes);
+  memcpy(out->cam_idx, data + kOffsetCamIdx, cam_idx_size);
+  out->cam_idx_size = cam_idx_size;
+  memcpy(out->cam_num, data + kOffsetCamNum, cam_num_size);
+  out->cam_num_size = cam_num_size;
+
+  uint64_t brightness_bits = ReadLittleEndian(data + kOffsetBrightness, 8);
+  memcpy(&out->brightness, &brightness_bits, sizeof(out->brightness));
+
+  uint8_t flags = data[kOffsetFlags];
+  out->motion = (flags & kFlagMotion) != 0;
+  if (flags & kFlagBbox) {
+    out->has_bbox = true;
+    out->bbox_x = static_cast<int32_t>(ReadLittleEndian(data + kOffsetBbox, 4));
+    out->bbox_y = static_cast<int32_t>(ReadLittleEndian(data + kOffsetBbox + 4, 4));
+    out->bbox_w = static_cast<int32_t>(ReadLittleEndian(data + kOffsetBbox + 8, 4));
+    out->bbox_h = static_cast<int32_t>(ReadLittleEndian(data + kOffsetBbox + 12, 4));
+  }
+
+  out->has_sequence = true;
+  out->sequence = ReadLittleEndian(data + kOffsetSequence, 8);
+  out->capture_time_us = static_cast<int64_t>(ReadLittleEndian(data + kOffsetCaptureTime, 8));
+  return true;
+}
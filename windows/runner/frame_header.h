@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Longest cam_idx / cam_num kept; longer values are truncated
+constexpr size_t kMaxHeaderStringBytes = 64;
+
+// Longest frame header accepted, JSON or binary. Splitting a message and
+// parsing its header share it, so a header is either parsed or the whole
+// message is treated as a raw JPEG.
+constexpr size_t kMaxFrameHeaderBytes = 64 * 1024;
+
+// Frame header fields, fixed layout so parsing never allocates
+struct FrameHeader {
+  char cam_idx[kMaxHeaderStringBytes] = {};
+  size_t cam_idx_size = 0;
+  char cam_num[kMaxHeaderStringBytes] = {};
+  size_t cam_num_size = 0;
+  double brightness = 0.0;
+  bool motion = false;
+
+  // bbox values may arrive as strings ("284") or numbers (284)
+  bool has_bbox = false;
+  int bbox_x = 0;
+  int bbox_y = 0;
+  int bbox_w = 0;
+  int bbox_h = 0;
+
+  // Binary headers only
+  bool has_sequence = false;
+  uint64_t sequence = 0;
+  int64_t capture_time_us = 0;  // publisher clock, microseconds since the Unix epoch
+
+  std::string_view cam_idx_view() const { return std::string_view(cam_idx, cam_idx_size); }
+  std::string_view cam_num_view() const { return std::string_view(cam_num, cam_num_size); }
+};
+
+// Single-pass JSON tokenizer for the frame header (docs/ZMQ_HEADER_FORMAT.md).
+// Fields are read from the "header" object when present, otherwise from the
+// top level. Unknown keys are skipped, string escapes are decoded, and
+// malformed input stops the parse without throwing. Returns false (with
+// whatever was parsed so far in *out) if the JSON is malformed.
+bool ParseFrameHeader(std::string_view json, FrameHeader* out);
+
+// Binary header v1 (docs/ZMQ_HEADER_FORMAT.md): "ISBH" magic followed by a
+// fixed little-endian struct. Sent in place of the JSON header; the magic
+// can't start a JSON document, so both encodings share the header slot.
+constexpr uint8_t kBinaryHeaderMagic[4] = {'I', 'S', 'B', 'H'};
+constexpr uint16_t kBinaryHeaderVersion = 1;
+constexpr size_t kBinaryHeaderSize = 104;  // v1; newer versions may append fields
+constexpr size_t kBinaryHeaderCamIdxBytes = 32;
+constexpr size_t kBinaryHeaderCamNumBytes = 16;
+
+bool IsBinaryFrameHeader(const uint8_t* data, size_t size);
+
+// Reads the v1 fields; bytes past them (newer versions) are ignored.
+// Returns false if the header is truncated or its version is 0.
+bool ParseBinaryFrameHeader(const uint8_t* data, size_t size, FrameHeader* out);
@@ -0,0 +1,45 @@
+#include "frame_store.h"
+
+void FrameStore::Publish() {
+  uint8_t previous = middle_.exchange(static_cast<uint8_t>(back_ | kFresh), std::memory_order_acq_rel);
+  back_ = previous & kIndexMask;
+}
+
+const DecodedFrame* FrameStore::Acquire(bool* fresh) {
+  *fresh = false;
+
+  // Swap in the newest frame only once Flutter is done with the front
+  if (pins_.load(std::memory_order_acquire) == 0 &&
+      (middle_.load(std::memory_order_relaxed) & kFresh)) {
+    uint8_t previous = middle_.exchange(static_cast<uint8_t>(front_), std::memory_order_acq_rel);
+    front_ = previous & kIndexMask;
+    *fresh = true;
+  }
+
+  const DecodedFrame* frame = &frames_[front_];
+  if (frame->width == 0 || frame->height == 0) {
+    return nullptr;
+  }
+  pins_.fetch_add(1, std::memory_order_relaxed);
+  return frame;
+}
+
+void FrameStore::Release() {
+  pins_.fetch_sub(1, std::memory_order_release);
+}
+
+void FrameStore::ReleaseSpare() {
+  ReleaseFrame(&frames_[back_]);
+
+  // Acquire only swaps in a fresh middle, and nothing publishes any more
+  uint8_t middle = middle_.load(std::memory_order_acquire);
+  if (!(middle & kFresh)) {
+    ReleaseFrame(&frames_[middle & kIndexMask]);
+  }
+}
+
+void FrameStore::ReleaseFrame(DecodedFrame* frame) {
+  frame->pixels.reset();
+  frame->width = 0;
+  frame->height = 0;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "buffer_pool.h"
+#include <atomic>
+#include <cstdint>
+
+// One decoded RGBA frame
+struct DecodedFrame {
+  PooledBuffer pixels;  // width * height * 4, block kept across frames
+  int width = 0;
+  int height = 0;
+};
+
+// Lock-free triple buffer between the decoder and the texture callback.
+// The decoder fills the back buffer and publishes it with one atomic swap;
+// the texture callback takes the newest published frame as its front buffer
+// and keeps it pinned until Flutter's release callback. Neither side ever
+// waits for the other, and the decoder never writes a frame being uploaded.
+class FrameStore {
+ public:
+  // Buffers a decoding stream holds
+  static constexpr int kFrameCount = 3;
+
+  // Decoder only: the buffer to decode into, owned until Publish()
+  DecodedFrame* back() { return &frames_[back_]; }
+
+  // Decoder only: makes back() the newest frame. A published frame the
+  // reader hasn't taken yet is recycled as the next back buffer.
+  void Publish();
+
+  // Texture callback: the newest frame, pinned until Release(); nullptr
+  // before the first frame. fresh is set if it wasn't returned before.
+  // While the front is still pinned it is returned again unchanged.
+  const DecodedFrame* Acquire(bool* fresh);
+
+  // Release callback of the FlutterDesktopPixelBuffer for Acquire()
+  void Release();
+
+  // Decoder side, once no decode can run: hands the back buffer's memory
+  // back to the pool, and the published frame too once it has been shown.
+  // Only the frame on screen (or about to be) stays for the texture.
+  void ReleaseSpare();
+
+ private:
+  static constexpr uint8_t kIndexMask = 0x3;
+  static constexpr uint8_t kFresh = 0x4;  // middle holds a frame not yet acquired
+
+  static void ReleaseFrame(DecodedFrame* frame);
+
+  DecodedFrame frames_[kFrameCount];
+  int back_ = 0;                      // decoder side
+  std::atomic<uint8_t> middle_{1};    // index | kFresh
+  int front_ = 2;                     // reader side
+  std::atomic<int> pins_{0};          // Acquire() calls not yet released
+};
@@ -0,0 +1,166 @@
+#include "grid_compositor.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Common GPU texture size limit
+constexpr int kMaxImageSide = 16384;
+
+constexpr uint8_t kBlack[4] = {0, 0, 0, 255};  // RGBA
+
+}  // namespace
+
+bool GridCompositor::SetLayout(int columns, int rows, int cell_width, int cell_height) {
+  if (columns < 1 || rows < 1 || columns * rows > kMaxGridCells || cell_width < 1 ||
+      cell_height < 1 || cell_width > kMaxImageSide / columns || cell_height > kMaxImageSide / rows) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (columns == columns_ && rows == rows_ && cell_width == cell_width_ && cell_height == cell_height_) {
+    return true;
+  }
+  columns_ = columns;
+  rows_ = rows;
+  cell_width_ = cell_width;
+  cell_height_ = cell_height;
+  layout_changed_ = true;
+  return true;
+}
+
+bool GridCompositor::SetCell(int cell, FrameStore* source, ShownCallback on_shown) {
+  if (cell < 0 || cell >= kMaxGridCells) return false;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (source) {
+    for (Cell& other : cells_) {
+      if (other.source == source) {
+        other.source = nullptr;
+        other.on_shown = nullptr;
+        other.redraw = true;
+      }
+    }
+  }
+  cells_[cell].source = source;
+  cells_[cell].on_shown = source ? std::move(on_shown) : nullptr;
+  cells_[cell].redraw = true;
+  return true;
+}
+
+void GridCompositor::RemoveSource(FrameStore* source) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (Cell& cell : cells_) {
+    if (cell.source == source) {
+      cell.source = nullptr;
+      cell.on_shown = nullptr;
+      cell.redraw = true;
+    }
+  }
+}
+
+size_t GridCompositor::image_bytes() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return static_cast<size_t>(columns_) * cell_width_ * rows_ * cell_height_ * 4;
+}
+
+const DecodedFrame* GridCompositor::Compose() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // Frames published from here on need another compose
+  compose_pending_.store(false, std::memory_order_release);
+
+  if (columns_ == 0) return nullptr;
+
+  if (layout_changed_) {
+    layout_changed_ = false;
+    image_.width = columns_ * cell_width_;
+    image_.height = rows_ * cell_height_;
+    image_.pixels.resize(static_cast<size_t>(image_.width) * image_.height * 4);
+    for (Cell& cell : cells_) {
+      cell.redraw = true;
+    }
+  }
+
+  size_t stride = static_cast<size_t>(image_.width) * 4;
+  for (int i = 0; i < columns_ * rows_; ++i) {
+    Cell& cell = cells_[i];
+    uint8_t* dst = image_.pixels.data() + static_cast<size_t>(i / columns_) * cell_height_ * stride +
+                   static_cast<size_t>(i % columns_) * cell_width_ * 4;
+
+    bool fresh = false;
+    const DecodedFrame* frame = cell.source ? cell.source->Acquire(&fresh) : nullptr;
+    if (frame) {
+      if (fresh || cell.redraw) {
+        DrawFitted(*frame, dst, stride, cell_width_, cell_height_);
+        cell.redraw = false;
+      }
+      cell.source->Release();  // copied; the decoder may reuse it
+      if (fresh && cell.on_shown) {
+        cell.on_shown();
+      }
+    } else if (cell.redraw) {
+      FillBlack(dst, stride, cell_width_, cell_height_);
+      cell.redraw = false;
+    }
+  }
+  return &image_;
+}
+
+void GridCompositor::FillBlack(uint8_t* dst, size_t stride, int width, int height) {
+  if (width <= 0 || height <= 0) return;
+  for (int x = 0; x < width; ++x) {
+    memcpy(dst + static_cast<size_t>(x) * 4, kBlack, 4);
+  }
+  for (int y = 1; y < height; ++y) {
+    memcpy(dst + y * stride, dst, static_cast<size_t>(width) * 4);
+  }
+}
+
+void GridCompositor::DrawFitted(const DecodedFrame& frame, uint8_t* dst, size_t stride, int width, int height) {
+  // Keep the aspect ratio: fit inside the cell, black bars around
+  int fit_width = width;
+  int fit_height = height;
+  if (static_cast<int64_t>(frame.width) * height > static_cast<int64_t>(frame.height) * width) {
+    fit_height = (std::max)(1, static_cast<int>(static_cast<int64_t>(frame.height) * width / frame.width));
+  } else {
+    fit_width = (std::max)(1, static_cast<int>(static_cast<int64_t>(frame.width) * height / frame.height));
+  }
+  int x0 = (width - fit_width) / 2;
+  int y0 = (height - fit_height) / 2;
+
+  FillBlack(dst, stride, width, y0);
+  FillBlack(dst + (y0 + fit_height) * stride, stride, width, height - y0 - fit_height);
+  FillBlack(dst + y0 * stride, stride, x0, fit_height);
+  FillBlack(dst + y0 * stride + static_cast<size_t>(x0 + fit_width) * 4, stride, width - x0 - fit_width,
+            fit_height);
+
+  uint8_t* out = dst + y0 * stride + static_cast<size_t>(x0) * 4;
+  size_t frame_stride = static_cast<size_t>(frame.width) * 4;
+  const uint8_t* in = frame.pixels.data();
+
+  if (frame.width == fit_width && frame.height == fit_height) {
+    for (int y = 0; y < fit_height; ++y) {
+      memcpy(out + y * stride, in + y * frame_stride, frame_stride);
+    }
+    return;
+  }
+
+  // The decode is already scaled close to the cell size (libjpeg-turbo steps
+  // of 1/8), so nearest-pixel sampling of pixel centers is enough here
+  thread_local std::vector<int> source_x;
+  source_x.resize(fit_width);
+  for (int x = 0; x < fit_width; ++x) {
+    source_x[x] = static_cast<int>((2 * static_cast<int64_t>(x) + 1) * frame.width / (2 * fit_width));
+  }
+  for (int y = 0; y < fit_height; ++y) {
+    int sy = static_cast<int>((2 * static_cast<int64_t>(y) + 1) * frame.height / (2 * fit_height));
+    const uint8_t* row = in + sy * frame_stride;
+    uint8_t* out_row = out + y * stride;
+    for (int x = 0; x < fit_width; ++x) {
+      memcpy(out_row + static_cast<size_t>(x) * 4, row + static_cast<size_t>(source_x[x]) * 4, 4);
+    }
+  }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "frame_store.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+// Largest grid, e.g. 8 x 8 cells
+constexpr int kMaxGridCells = 64;
+
+// Composes several streams into one RGBA image, so a multi-camera view is a
+// single texture: one texture callback, one upload and at most one
+// frame-available signal per refresh, however many cameras it shows.
+// Streams still decode at cell size into their own FrameStore; Compose copies
+// only the cells that have a new frame, fitted to the cell and letterboxed.
+class GridCompositor {
+ public:
+  // Called from Compose when a cell's new frame goes into the image
+  using ShownCallback = std::function<void()>;
+
+  // Any thread. Taken up by the next Compose, which redraws every cell.
+  // False if the grid is empty, has too many cells or is too large.
+  bool SetLayout(int columns, int rows, int cell_width, int cell_height);
+
+  // Any thread. A null source empties the cell; a source already shown in
+  // another cell moves. Once this returns Compose no longer reads the
+  // previous source. False if cell is out of range.
+  bool SetCell(int cell, FrameStore* source, ShownCallback on_shown);
+
+  // Any thread: takes source out of every cell (its stream is going away)
+  void RemoveSource(FrameStore* source);
+
+  // Decode side: a shown source has a new frame. True for the first request
+  // since the last Compose, so the caller signals the texture only once.
+  bool RequestCompose() { return !compose_pending_.exchange(true, std::memory_order_acq_rel); }
+
+  // Any thread: size of the image at the current layout
+  size_t image_bytes();
+
+  // Texture callback only: brings the image up to date and returns it, or
+  // nullptr before the first layout. The image stays valid until the next
+  // Compose.
+  const DecodedFrame* Compose();
+
+ private:
+  struct Cell {
+    FrameStore* source = nullptr;
+    ShownCallback on_shown;
+    bool redraw = true;  // draw even without a new frame (layout or source changed)
+  };
+
+  static void FillBlack(uint8_t* dst, size_t stride, int width, int height);
+  static void DrawFitted(const DecodedFrame& frame, uint8_t* dst, size_t stride, int width, int height);
+
+  std::mutex mutex_;  // layout and cells; Compose holds it while reading sources
+  int columns_ = 0;
+  int rows_ = 0;
+  int cell_width_ = 0;
+  int cell_height_ = 0;
+  bool layout_changed_ = false;
+  Cell cells_[kMaxGridCells];
+
+  std::atomic<bool> compose_pending_{false};
+
+  DecodedFrame image_;  // Compose only
+};
@@ -0,0 +1,500 @@
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
+
+#include "http_mjpeg_client.h"
+#include "stream_health.h"
+#include "thread_policy.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+
+#ifdef _WIN32
+using NativeSocket = SOCKET;
+constexpr int kSendFlags = 0;
+#else
+using NativeSocket = int;
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Connect + response head must complete within this
+constexpr int kConnectTimeoutMs = 5000;
+
+// No data for this long counts as a dead connection and is reconnected
+constexpr int kReceiveTimeoutMs = 5000;
+
+// Reconnect backoff: starts at initial, doubles up to max
+constexpr int kReconnectInitialMs = 100;
+constexpr int kReconnectMaxMs = 5000;
+
+// Response status line + headers larger than this are rejected
+constexpr size_t kMaxResponseHeadBytes = 16 * 1024;
+
+// Bytes requested per recv, and recv calls per wakeup so one fast camera
+// can't starve the others on the loop
+constexpr size_t kReadChunkBytes = 64 * 1024;
+constexpr int kMaxReadsPerWakeup = 16;
+
+NativeSocket ToNative(SocketHandle socket) {
+  return static_cast<NativeSocket>(socket);
+}
+
+struct ParsedUrl {
+  std::string host;
+  std::string port = "80";
+  std::string path = "/";
+};
+
+bool ParseHttpUrl(const std::string& url, ParsedUrl* out) {
+  static const char kScheme[] = "http://";
+  constexpr size_t kSchemeSize = sizeof(kScheme) - 1;
+  if (url.size() <= kSchemeSize) return false;
+  for (size_t i = 0; i < kSchemeSize; ++i) {
+    if (std::tolower(static_cast<unsigned char>(url[i])) != kScheme[i]) return false;
+  }
+
+  std::string rest = url.substr(kSchemeSize);
+  size_t path_pos = rest.find('/');
+  if (path_pos != std::string::npos) {
+    out->path = rest.substr(path_pos);
+    rest = rest.substr(0, path_pos);
+  }
+
+  size_t port_pos = rest.find(':');
+  if (port_pos != std::string::npos) {
+    out->port = rest.substr(port_pos + 1);
+    rest = rest.substr(0, port_pos);
+  }
+  out->host = rest;
+  return !out->host.empty() && !out->port.empty();
+}
+
+}  // namespace
+
+struct HttpMjpegClient::Connection {
+  enum class State { kConnecting, kSending, kResponseHead, kStreaming, kBackoff };
+
+  int64_t key = -1;
+  FrameHandler on_frame;
+  StatusHandler on_status;
+
+  sockaddr_storage address;
+  int address_len = 0;
+  std::string request;
+
+  SocketHandle socket = kInvalidSocket;
+  State state = State::kBackoff;
+  size_t request_sent = 0;
+  std::string response_head;
+  std::unique_ptr<MjpegParser> parser;
+  bool connected = false;
+  bool paused = false;  // parser stalled, socket not polled; no receive timeout
+
+  // Connect/receive timeout, or end of backoff in kBackoff
+  Clock::time_point deadline;
+  ReconnectBackoff backoff{kReconnectInitialMs, kReconnectMaxMs};
+};
+
+HttpMjpegClient::HttpMjpegClient() {
+  if (poller_.valid()) {
+    thread_ = std::thread(&HttpMjpegClient::Loop, this);
+  }
+}
+
+HttpMjpegClient::~HttpMjpegClient() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  poller_.Wake();
+
+  // The loop closes its own sockets on the way out
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+bool HttpMjpegClient::Supports(const std::string& url) {
+  ParsedUrl parsed;
+  return ParseHttpUrl(url, &parsed);
+}
+
+bool HttpMjpegClient::Add(int64_t key, const std::string& url, FrameHandler on_frame,
+                          StatusHandler on_status, std::string* error) {
+  if (!poller_.valid()) {
+    if (error) *error = "Failed to initialize socket poller";
+    return false;
+  }
+
+  ParsedUrl parsed;
+  if (!ParseHttpUrl(url, &parsed)) {
+    if (error) *error = "Invalid HTTP URL";
+    return false;
+  }
+
+  // Resolved once; reconnects reuse the address
+  addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* result = nullptr;
+  if (getaddrinfo(parsed.host.c_str(), parsed.port.c_str(), &hints, &result) != 0 || !result) {
+    if (error) *error = "Failed to resolve HTTP host";
+    return false;
+  }
+
+  auto connection = std::make_unique<Connection>();
+  connection->key = key;
+  connection->on_frame = std::move(on_frame);
+  connection->on_status = std::move(on_status);
+  memcpy(&connection->address, result->ai_addr, result->ai_addrlen);
+  connection->address_len = static_cast<int>(result->ai_addrlen);
+  freeaddrinfo(result);
+
+  // HTTP/1.0 so the server never answers with chunked transfer encoding
+  connection->request = "GET " + parsed.path + " HTTP/1.0\r\n" +
+                        "Host: " + parsed.host + ":" + parsed.port + "\r\n" +
+                        "User-Agent: iScan_Live_Viewer/1.0\r\n" +
+                        "Accept: multipart/x-mixed-replace, image/jpeg\r\n\r\n";
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_add_.push_back(std::move(connection));
+    ++commands_posted_;
+  }
+  poller_.Wake();
+  return true;
+}
+
+void HttpMjpegClient::Remove(int64_t key) {
+  Remove(std::vector<int64_t>{key});
+}
+
+void HttpMjpegClient::Resume(int64_t key) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_resume_.push_back(key);
+  }
+  poller_.Wake();
+}
+
+void HttpMjpegClient::Remove(const std::vector<int64_t>& keys) {
+  if (keys.empty()) return;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  pending_remove_.insert(pending_remove_.end(), keys.begin(), keys.end());
+  uint64_t target = ++commands_posted_;
+  poller_.Wake();
+  commands_done_.wait(lock, [this, target]() {
+    return commands_applied_ >= target || stopping_ || !thread_.joinable();
+  });
+}
+
+bool HttpMjpegClient::ApplyCommands() {
+  std::vector<std::unique_ptr<Connection>> added;
+  std::vector<int64_t> resumed;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    added.swap(pending_add_);
+    resumed.swap(pending_resume_);
+
+    for (int64_t key : pending_remove_) {
+      // Might still be queued if Add and Remove land in the same wakeup
+      added.erase(std::remove_if(added.begin(), added.end(),
+                                 [key](const std::unique_ptr<Connection>& c) { return c->key == key; }),
+                  added.end());
+
+      auto it = std::find_if(connections_.begin(), connections_.end(),
+                             [key](const std::unique_ptr<Connection>& c) { return c->key == key; });
+      if (it != connections_.end()) {
+        if ((*it)->socket != kInvalidSocket) {
+          poller_.Remove((*it)->socket);
+          CloseSocket((*it)->socket);
+        }
+        connections_.erase(it);
+      }
+    }
+    pending_remove_.clear();
+
+    commands_applied_ = commands_posted_;
+    if (stopping_) return false;
+  }
+  commands_done_.notify_all();
+
+  for (auto& connection : added) {
+    connections_.push_back(std::move(connection));
+    StartConnect(connections_.back().get());
+  }
+
+  // Handlers run outside mutex_, like the ones called from HandleEvent
+  for (int64_t key : resumed) {
+    auto it = std::find_if(connections_.begin(), connections_.end(),
+                           [key](const std::unique_ptr<Connection>& c) { return c->key == key; });
+    if (it != connections_.end() && (*it)->paused) {
+      ResumeConnection(it->get());
+    }
+  }
+  return true;
+}
+
+void HttpMjpegClient::Loop() {
+  std::vector<SocketPoller::Event> events;
+
+  while (ApplyCommands()) {
+    ThreadPolicy::Instance().Apply(ThreadRole::kNetwork);
+    if (!poller_.Wait(NextTimeoutMs(), &events)) break;
+
+    for (const auto& event : events) {
+      HandleEvent(static_cast<Connection*>(event.token), event.events);
+    }
+    CheckDeadlines();
+  }
+
+  commands_done_.notify_all();
+  for (auto& connection : connections_) {
+    if (connection->socket != kInvalidSocket) {
+      poller_.Remove(connection->socket);
+      CloseSocket(connection->socket);
+    }
+  }
+  connections_.clear();
+}
+
+void HttpMjpegClient::StartConnect(Connection* connection) {
+  connection->request_sent = 0;
+  connection->response_head.clear();
+  connection->parser.reset();
+  connection->deadline = Clock::now() + std::chrono::milliseconds(kConnectTimeoutMs);
+
+  NativeSocket fd = ::socket(connection->address.ss_family, SOCK_STREAM, IPPROTO_TCP);
+  connection->socket = static_cast<SocketHandle>(fd);
+  if (connection->socket == kInvalidSocket) {
+    Fail(connection);
+    return;
+  }
+
+  int no_delay = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&no_delay), sizeof(no_delay));
+
+  if (!SetSocketNonBlocking(connection->socket)) {
+    Fail(connection);
+    return;
+  }
+
+  int rc = ::connect(fd, reinterpret_cast<const sockaddr*>(&connection->address), connection->address_len);
+  if (rc != 0 && !SocketWouldBlock(LastSocketError())) {
+    Fail(connection);
+    return;
+  }
+
+  connection->state = Connection::State::kConnecting;
+  if (!poller_.Add(connection->socket, kSocketWritable, connection)) {
+    Fail(connection);
+  }
+}
+
+void HttpMjpegClient::HandleEvent(Connection* connection, uint32_t events) {
+  if (connection->socket == kInvalidSocket) return;
+
+  switch (connection->state) {
+    case Connection::State::kConnecting: {
+      int error = 0;
+      socklen_t error_len = sizeof(error);
+      getsockopt(ToNative(connection->socket), SOL_SOCKET, SO_ERROR,
+                 reinterpret_cast<char*>(&error), &error_len);
+      if (error != 0 || (events & kSocketError)) {
+        Fail(connection);
+        return;
+      }
+      connection->state = Connection::State::kSending;
+      if (!SendRequest(connection)) Fail(connection);
+      return;
+    }
+
+    case Connection::State::kSending:
+      if (!SendRequest(connection)) Fail(connection);
+      return;
+
+    case Connection::State::kResponseHead:
+      if (!ReadResponseHead(connection)) Fail(connection);
+      return;
+
+    case Connection::State::kStreaming:
+      if (connection->paused) {
+        // Only errors are reported while paused
+        if (events & kSocketError) Fail(connection);
+        return;
+      }
+      if (!ReadBody(connection)) Fail(connection);
+      return;
+
+    case Connection::State::kBackoff:
+      return;
+  }
+}
+
+bool HttpMjpegClient::SendRequest(Connection* connection) {
+  while (connection->request_sent < connection->request.size()) {
+    const char* data = connection->request.data() + connection->request_sent;
+    int size = static_cast<int>(connection->request.size() - connection->request_sent);
+    int sent = static_cast<int>(::send(ToNative(connection->socket), data, size, kSendFlags));
+    if (sent < 0) {
+      return SocketWouldBlock(LastSocketError());
+    }
+    connection->request_sent += static_cast<size_t>(sent);
+  }
+
+  connection->state = Connection::State::kResponseHead;
+  return poller_.Modify(connection->socket, kSocketReadable, connection);
+}
+
+bool HttpMjpegClient::ReadResponseHead(Connection* connection) {
+  char buffer[4096];
+  for (;;) {
+    int received = static_cast<int>(::recv(ToNative(connection->socket), buffer, sizeof(buffer), 0));
+    if (received == 0) return false;
+    if (received < 0) return SocketWouldBlock(LastSocketError());
+
+    connection->response_head.append(buffer, static_cast<size_t>(received));
+    size_t head_end = connection->response_head.find("\r\n\r\n");
+    if (head_end == std::string::npos) {
+      if (connection->response_head.size() > kMaxResponseHeadBytes) return false;
+      continue;
+    }
+
+    // "HTTP/1.x 200 ..."
+    const std::string& head = connection->response_head;
+    size_t space = head.find(' ');
+    if (space == std::string::npos || head.compare(space + 1, 3, "200") != 0) {
+      return false;
+    }
+
+    std::string content_type;
+    for (size_t line = head.find("\r\n"); line != std::string::npos && line < head_end;
+         line = head.find("\r\n", line + 2)) {
+      static const char kKey[] = "content-type:";
+      constexpr size_t kKeySize = sizeof(kKey) - 1;
+      size_t start = line + 2;
+      if (head.size() - start < kKeySize) break;
+
+      bool match = true;
+      for (size_t i = 0; i < kKeySize && match; ++i) {
+        match = std::tolower(static_cast<unsigned char>(head[start + i])) == kKey[i];
+      }
+      if (match) {
+        size_t end = head.find("\r\n", start);
+        content_type = head.substr(start + kKeySize, end - start - kKeySize);
+        break;
+      }
+    }
+
+    connection->parser = std::make_unique<MjpegParser>(MjpegParser::BoundaryFromContentType(content_type));
+    connection->state = Connection::State::kStreaming;
+    connection->deadline = Clock::now() + std::chrono::milliseconds(kReceiveTimeoutMs);
+    connection->backoff.Reset();
+    if (!connection->connected) {
+      connection->connected = true;
+      if (connection->on_status) connection->on_status(true);
+    }
+
+    // Body bytes that arrived with the head
+    size_t body_start = head_end + 4;
+    if (body_start < head.size()) {
+      connection->parser->Feed(reinterpret_cast<const uint8_t*>(head.data()) + body_start,
+                               head.size() - body_start, connection->on_frame);
+    }
+    connection->response_head.clear();
+    connection->response_head.shrink_to_fit();
+    return ReadBody(connection);
+  }
+}
+
+bool HttpMjpegClient::ReadBody(Connection* connection) {
+  for (int n = 0; n < kMaxReadsPerWakeup; ++n) {
+    if (connection->parser->stalled()) return Pause(connection);
+
+    uint8_t* dst = connection->parser->PrepareWrite(kReadChunkBytes);
+    int received = static_cast<int>(::recv(ToNative(connection->socket), reinterpret_cast<char*>(dst),
+                                           static_cast<int>(kReadChunkBytes), 0));
+    if (received == 0) return false;  // server closed the stream
+    if (received < 0) return SocketWouldBlock(LastSocketError());
+
+    connection->deadline = Clock::now() + std::chrono::milliseconds(kReceiveTimeoutMs);
+    connection->parser->Commit(static_cast<size_t>(received), connection->on_frame);
+  }
+  return !connection->parser->stalled() || Pause(connection);
+}
+
+bool HttpMjpegClient::Pause(Connection* connection) {
+  // Unread bytes stay in the socket; once its buffer fills, TCP flow control
+  // holds the camera back instead of this client dropping frames
+  connection->paused = true;
+  return poller_.Modify(connection->socket, 0, connection);
+}
+
+void HttpMjpegClient::ResumeConnection(Connection* connection) {
+  connection->parser->Resume(connection->on_frame);
+  if (connection->parser->stalled()) return;  // still no room
+
+  connection->paused = false;
+  connection->deadline = Clock::now() + std::chrono::milliseconds(kReceiveTimeoutMs);
+  if (!poller_.Modify(connection->socket, kSocketReadable, connection)) {
+    Fail(connection);
+  }
+}
+
+void HttpMjpegClient::Fail(Connection* connection) {
+  if (connection->socket != kInvalidSocket) {
+    poller_.Remove(connection->socket);
+    CloseSocket(connection->socket);
+    connection->socket = kInvalidSocket;
+  }
+  connection->parser.reset();
+  connection->paused = false;
+  connection->state = Connection::State::kBackoff;
+  connection->deadline = Clock::now() + std::chrono::milliseconds(connection->backoff.Next());
+
+  if (connection->connected) {
+    connection->connected = false;
+    if (connection->on_status) connection->on_status(false);
+  }
+}
+
+int HttpMjpegClient::NextTimeoutMs() const {
+  if (connections_.empty()) return -1;
+
+  // A paused connection waits for Resume, not for a deadline
+  Clock::time_point next = Clock::time_point::max();
+  for (const auto& connection : connections_) {
+    if (!connection->paused) next = (std::min)(next, connection->deadline);
+  }
+  if (next == Clock::time_point::max()) return -1;
+  auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next - Clock::now()).count();
+  return static_cast<int>((std::max)(wait, static_cast<decltype(wait)>(0)) + 1);
+}
+
+void HttpMjpegClient::CheckDeadlines() {
+  Clock::time_point now = Clock::now();
+  for (auto& connection : connections_) {
+    if (connection->paused || now < connection->deadline) continue;
+
+    if (connection->state == Connection::State::kBackoff) {
+      StartConnect(connection.get());
+    } else {
+      // Connect timed out or the stream went silent
+      Fail(connection.get());
+    }
+  }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "mjpeg_parser.h"
+#include "socket_poller.h"
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Non-blocking HTTP MJPEG client serving every plain http:// camera from one
+// event-loop thread. Each connection is a small state machine (connect, send
+// request, read response head, stream) driven by SocketPoller readiness;
+// received bytes go straight into a per-connection MjpegParser. Lost or silent
+// connections are reconnected with backoff on the same key.
+//
+// A frame handler that returns false applies backpressure: the connection
+// stops reading (TCP flow control then slows the camera) until Resume(key).
+//
+// https:// is not handled here (no TLS); callers keep using WinHTTP for it.
+class HttpMjpegClient {
+ public:
+  using FrameHandler = MjpegParser::FrameHandler;
+  // Runs on the loop thread when the stream is up (response 200 received) or lost
+  using StatusHandler = std::function<void(bool connected)>;
+
+  HttpMjpegClient();
+  ~HttpMjpegClient();
+
+  HttpMjpegClient(const HttpMjpegClient&) = delete;
+  HttpMjpegClient& operator=(const HttpMjpegClient&) = delete;
+
+  // True for URLs this client can serve (plain http://)
+  static bool Supports(const std::string& url);
+
+  // Resolves url on the calling thread and hands the connection to the loop.
+  // Connection failures after this are retried, not reported.
+  bool Add(int64_t key, const std::string& url, FrameHandler on_frame, StatusHandler on_status,
+           std::string* error);
+
+  // Once this returns, key's handlers are not running and won't be called again
+  void Remove(int64_t key);
+  // Same for several keys, in one loop wakeup
+  void Remove(const std::vector<int64_t>& keys);
+
+  // Any thread, doesn't wait: offers key's refused frame again on the next
+  // loop wakeup and reads on once it is taken. No-op for a key that isn't paused.
+  void Resume(int64_t key);
+
+ private:
+  struct Connection;
+
+  void Loop();
+  // Applies pending commands; returns false once stopping
+  bool ApplyCommands();
+  void StartConnect(Connection* connection);
+  void HandleEvent(Connection* connection, uint32_t events);
+  bool SendRequest(Connection* connection);
+  bool ReadResponseHead(Connection* connection);
+  bool ReadBody(Connection* connection);
+  // Parser stalled on a refused frame: stop polling the socket for reads
+  bool Pause(Connection* connection);
+  void ResumeConnection(Connection* connection);
+  // Closes the socket and schedules a reconnect
+  void Fail(Connection* connection);
+  int NextTimeoutMs() const;
+  void CheckDeadlines();
+
+  SocketPoller poller_;
+  std::thread thread_;
+  std::vector<std::unique_ptr<Connection>> connections_;  // loop thread only
+
+  // Commands from API threads, applied by the loop thread
+  std::mutex mutex_;
+  std::condition_variable commands_done_;
+  std::vector<std::unique_ptr<Connection>> pending_add_;
+  std::vector<int64_t> pending_remove_;
+  std::vector<int64_t> pending_resume_;
+  uint64_t commands_posted_ = 0;
+  uint64_t commands_applied_ = 0;
+  bool stopping_ = false;
+};
@@ -0,0 +1,192 @@
+#include "jpeg_restart.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr uint8_t kSOF0 = 0xC0;  // baseline
+constexpr uint8_t kSOF1 = 0xC1;  // extended sequential, Huffman
+constexpr uint8_t kDHT = 0xC4;
+constexpr uint8_t kDAC = 0xCC;
+constexpr uint8_t kRST0 = 0xD0;
+constexpr uint8_t kRST7 = 0xD7;
+constexpr uint8_t kSOI = 0xD8;
+constexpr uint8_t kEOI = 0xD9;
+constexpr uint8_t kSOS = 0xDA;
+constexpr uint8_t kDRI = 0xDD;
+
+inline int ReadBE16(const uint8_t* p) {
+  return (p[0] << 8) | p[1];
+}
+
+// Header fields needed to find MCU rows, from the segments before SOS
+struct ScanLayout {
+  int width = 0;
+  int height = 0;
+  size_t height_offset = 0;  // of the SOF height field, patched per stripe
+  int components = 0;
+  int max_h = 1;  // sampling factors; the MCU is 8*max_h x 8*max_v pixels
+  int max_v = 1;
+  int restart_interval = 0;  // MCUs per restart interval (DRI)
+  size_t scan_start = 0;     // first byte of entropy-coded data
+};
+
+bool ParseHeaders(const uint8_t* data, size_t size, ScanLayout* layout) {
+  if (size < 4 || data[0] != 0xFF || data[1] != kSOI) return false;
+
+  size_t pos = 2;
+  while (pos + 4 <= size) {
+    if (data[pos] != 0xFF) return false;
+    uint8_t marker = data[pos + 1];
+    if (marker == 0xFF) {  // fill byte
+      ++pos;
+      continue;
+    }
+
+    int length = ReadBE16(data + pos + 2);
+    if (length < 2 || pos + 2 + length > size) return false;
+    const uint8_t* body = data + pos + 4;
+    size_t body_size = static_cast<size_t>(length) - 2;
+
+    if (marker == kSOF0 || marker == kSOF1) {
+      if (layout->components != 0 || body_size < 6 || body[0] != 8) return false;
+      layout->height = ReadBE16(body + 1);
+      layout->width = ReadBE16(body + 3);
+      layout->height_offset = pos + 5;
+      layout->components = body[5];
+      if (layout->width == 0 || layout->height == 0 || layout->components < 1 ||
+          layout->components > 4 || body_size < 6 + 3 * static_cast<size_t>(layout->components)) {
+        return false;
+      }
+      for (int c = 0; c < layout->components; ++c) {
+        uint8_t sampling = body[6 + 3 * c + 1];
+        layout->max_h = (std::max)(layout->max_h, sampling >> 4);
+        layout->max_v = (std::max)(layout->max_v, sampling & 0x0F);
+      }
+      // A single-component scan is non-interleaved: one block per MCU
+      if (layout->components == 1) {
+        layout->max_h = 1;
+        layout->max_v = 1;
+      }
+    } else if (marker >= 0xC2 && marker <= 0xCF && marker != kDHT && marker != kDAC) {
+      return false;  // progressive, lossless, hierarchical or arithmetic coded
+    } else if (marker == kDRI) {
+      if (body_size < 2) return false;
+      layout->restart_interval = ReadBE16(body);
+    } else if (marker == kSOS) {
+      // Interleaved scan of every component, so it is the only scan
+      if (layout->components == 0 || body_size < 1 || body[0] != layout->components) return false;
+      layout->scan_start = pos + 2 + length;
+      return true;
+    } else if (marker == kSOI || marker == kEOI || (marker >= kRST0 && marker <= kRST7)) {
+      return false;
+    }
+
+    pos += 2 + length;
+  }
+  return false;
+}
+
+// Splits the entropy-coded data at restart markers: interval i is
+// [starts[i], ends[i]). False unless the scan ends with EOI.
+bool FindRestartIntervals(const uint8_t* data, size_t size, size_t scan_start,
+                          std::vector<size_t>* starts, std::vector<size_t>* ends) {
+  starts->clear();
+  ends->clear();
+  starts->push_back(scan_start);
+
+  size_t pos = scan_start;
+  for (;;) {
+    const void* found = pos < size ? std::memchr(data + pos, 0xFF, size - pos) : nullptr;
+    if (!found) return false;
+    size_t marker_pos = static_cast<const uint8_t*>(found) - data;
+    if (marker_pos + 1 >= size) return false;
+
+    uint8_t marker = data[marker_pos + 1];
+    if (marker == 0x00) {  // stuffed 0xFF data byte
+      pos = marker_pos + 2;
+    } else if (marker == 0xFF) {  // fill byte before a marker
+      pos = marker_pos + 1;
+    } else if (marker >= kRST0 && marker <= kRST7) {
+      ends->push_back(marker_pos);
+      starts->push_back(marker_pos + 2);
+      pos = marker_pos + 2;
+    } else {
+      ends->push_back(marker_pos);
+      return marker == kEOI;
+    }
+  }
+}
+
+}  // namespace
+
+size_t SplitJpegAtRestarts(const uint8_t* data, size_t size, size_t max_stripes,
+                           std::vector<JpegStripe>* stripes) {
+  if (max_stripes < 2) return 0;
+
+  ScanLayout layout;
+  if (!ParseHeaders(data, size, &layout) || layout.restart_interval == 0) return 0;
+
+  // Per decode thread, so splitting never allocates after warm-up
+  thread_local std::vector<size_t> starts;
+  thread_local std::vector<size_t> ends;
+  if (!FindRestartIntervals(data, size, layout.scan_start, &starts, &ends)) return 0;
+
+  int mcu_width = 8 * layout.max_h;
+  int mcu_height = 8 * layout.max_v;
+  int64_t mcus_per_row = (layout.width + mcu_width - 1) / mcu_width;
+  int64_t mcu_rows = (layout.height + mcu_height - 1) / mcu_height;
+  int64_t intervals = (mcus_per_row * mcu_rows + layout.restart_interval - 1) / layout.restart_interval;
+  if (static_cast<int64_t>(starts.size()) != intervals || intervals < 2) return 0;
+
+  // Stripe boundaries: intervals that start an MCU row, spread evenly
+  struct Boundary {
+    size_t interval;
+    int64_t row;
+  };
+  Boundary boundaries[64];
+  size_t count = 1;
+  boundaries[0] = {0, 0};
+  max_stripes = (std::min)(max_stripes, sizeof(boundaries) / sizeof(boundaries[0]));
+
+  size_t interval = 1;
+  for (size_t s = 1; s < max_stripes; ++s) {
+    int64_t target_row = static_cast<int64_t>(s) * mcu_rows / static_cast<int64_t>(max_stripes);
+    for (; interval < starts.size(); ++interval) {
+      int64_t first_mcu = static_cast<int64_t>(interval) * layout.restart_interval;
+      if (first_mcu % mcus_per_row != 0) continue;
+      int64_t row = first_mcu / mcus_per_row;
+      if (row < target_row || row <= boundaries[count - 1].row) continue;
+      boundaries[count++] = {interval, row};
+      ++interval;
+      break;
+    }
+  }
+  if (count < 2) return 0;
+
+  if (stripes->size() < count) stripes->resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    JpegStripe& stripe = (*stripes)[i];
+    size_t first = boundaries[i].interval;
+    size_t last = i + 1 < count ? boundaries[i + 1].interval : starts.size();
+    stripe.y = static_cast<int>(boundaries[i].row * mcu_height);
+    stripe.height = (i + 1 < count ? static_cast<int>(boundaries[i + 1].row * mcu_height)
+                                   : layout.height) - stripe.y;
+
+    std::vector<uint8_t>& out = stripe.jpeg;
+    out.assign(data, data + layout.scan_start);
+    out[layout.height_offset] = static_cast<uint8_t>(stripe.height >> 8);
+    out[layout.height_offset + 1] = static_cast<uint8_t>(stripe.height & 0xFF);
+    for (size_t n = first; n < last; ++n) {
+      out.insert(out.end(), data + starts[n], data + ends[n]);
+      if (n + 1 < last) {
+        out.push_back(0xFF);
+        out.push_back(static_cast<uint8_t>(kRST0 + (n - first) % 8));
+      }
+    }
+    out.push_back(0xFF);
+    out.push_back(kEOI);
+  }
+  return count;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One horizontal band of a JPEG, rewritten as a standalone JPEG
+struct JpegStripe {
+  std::vector<uint8_t> jpeg;  // capacity reused across frames
+  int y = 0;                  // first pixel row in the full image
+  int height = 0;
+};
+
+// Splits a single-scan Huffman JPEG (baseline or extended sequential) with
+// restart markers into up to max_stripes stripes. Stripes start at restart
+// intervals that begin an MCU row, where the decoder state is reset, so they
+// decode independently into the matching rows of the full image. Each stripe
+// copies the headers (SOF height patched) and its part of the scan (restart
+// markers renumbered from RST0).
+//
+// Returns the number of stripes written to *stripes, or 0 if the JPEG has no
+// usable restart markers or isn't a layout this handles (progressive,
+// arithmetic coded, multi-scan, malformed); decode it whole then.
+size_t SplitJpegAtRestarts(const uint8_t* data, size_t size, size_t max_stripes,
+                           std::vector<JpegStripe>* stripes);
@@ -0,0 +1,67 @@
+#include "memory_budget.h"
+
+#include "quality_governor.h"
+#include <algorithm>
+
+namespace {
+
+// Step back up only if the total then stays this far under the budget, so
+// small estimate changes (zoom, display size) don't flip a step back and forth
+constexpr double kStepUpHeadroom = 0.85;
+
+}  // namespace
+
+size_t MemoryBudget::BytesAt(const Stream& stream, int step) {
+  // Each step caps the decode scale at 1/2, 1/4, 1/8; a smaller display
+  // scale is kept as it is
+  double cap = 1.0 / (1 << (std::max)(step, stream.min_step));
+  double factor = stream.uncapped_scale > cap ? cap / stream.uncapped_scale : 1.0;
+  return static_cast<size_t>(static_cast<double>(stream.frame_bytes) * factor * factor);
+}
+
+size_t MemoryBudget::Rebalance(size_t other_bytes, std::vector<Stream>& streams) const {
+  size_t total = other_bytes;
+  for (Stream& stream : streams) {
+    if (budget_ == 0) stream.step = 0;
+    total += BytesAt(stream, stream.step) + stream.fixed_bytes;
+  }
+  if (budget_ == 0) return total;
+
+  // Least important first; equal streams keep their order
+  std::vector<Stream*> order;
+  order.reserve(streams.size());
+  for (Stream& stream : streams) {
+    order.push_back(&stream);
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [](const Stream* a, const Stream* b) { return a->importance < b->importance; });
+
+  if (total > budget_) {
+    // Take the least important stream all the way down before the next one
+    for (Stream* stream : order) {
+      for (int step = stream->step + 1; step < kQualityStepCount && total > budget_; ++step) {
+        size_t current = BytesAt(*stream, stream->step);
+        size_t lower = BytesAt(*stream, step);
+        if (lower >= current) continue;  // already decoded this small for its display
+        total -= current - lower;
+        stream->step = step;
+      }
+      if (total <= budget_) break;
+    }
+    return total;
+  }
+
+  // Room again: the most important stream first, none ahead of it
+  size_t limit = static_cast<size_t>(static_cast<double>(budget_) * kStepUpHeadroom);
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    Stream* stream = *it;
+    while (stream->step > 0) {
+      size_t current = BytesAt(*stream, stream->step);
+      size_t higher = BytesAt(*stream, stream->step - 1);
+      if (total - current + higher > limit) return total;
+      total = total - current + higher;
+      --stream->step;
+    }
+  }
+  return total;
+}
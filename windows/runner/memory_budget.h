@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Global cap on the decoded memory of all streams. Each running stream's
+// frames are estimated from its decode size, so the effect of a step is known
+// before the next frame arrives. Over budget, the least important streams
+// step their decode scale down (same steps as QualityGovernor); with enough
+// room again the most important ones step back up first.
+class MemoryBudget {
+ public:
+  struct Stream {
+    int64_t importance = 0;     // higher keeps full resolution longer
+    size_t frame_bytes = 0;     // all its frame buffers at uncapped_scale
+    double uncapped_scale = 1;  // decode scale before any step caps it
+    int min_step = 0;           // step the decode load already imposes
+    size_t fixed_bytes = 0;     // queues and parser, not affected by steps
+    int step = 0;               // budget step, updated by Rebalance
+  };
+
+  // 0 = unlimited
+  void set_budget(size_t bytes) { budget_ = bytes; }
+  size_t budget() const { return budget_; }
+
+  // Moves the streams' steps toward fitting the budget, along with
+  // other_bytes held by stopped streams. Returns the estimated total after.
+  size_t Rebalance(size_t other_bytes, std::vector<Stream>& streams) const;
+
+  // Estimated frame bytes of a stream at a budget step
+  static size_t BytesAt(const Stream& stream, int step);
+
+ private:
+  size_t budget_ = 0;
+};
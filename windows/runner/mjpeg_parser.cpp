@@ -0,0 +1,208 @@
+#include "mjpeg_parser.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace {
+
+// A part larger than this can't be a camera frame; drop it and resync
+constexpr size_t kMaxBufferedBytes = 16 * 1024 * 1024;
+
+constexpr char kHeaderEnd[] = "\r\n\r\n";
+constexpr size_t kHeaderEndSize = sizeof(kHeaderEnd) - 1;
+
+bool EqualsIgnoreCase(const char* a, const char* b, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    if (std::tolower(static_cast<unsigned char>(a[i])) !=
+        std::tolower(static_cast<unsigned char>(b[i]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+MjpegParser::MjpegParser(const std::string& boundary) {
+  std::string name = boundary.empty() ? std::string("frame") : boundary;
+
+  // Some cameras put the leading "--" into the Content-Type parameter. Searching
+  // for the parameter itself then still matches either body form.
+  delimiter_ = name.compare(0, 2, "--") == 0 ? name : "--" + name;
+  body_delimiter_ = "\r\n" + delimiter_;
+}
+
+std::string MjpegParser::BoundaryFromContentType(const std::string& content_type) {
+  static const char kKey[] = "boundary=";
+  constexpr size_t kKeySize = sizeof(kKey) - 1;
+
+  size_t pos = std::string::npos;
+  for (size_t i = 0; i + kKeySize <= content_type.size(); ++i) {
+    if (EqualsIgnoreCase(content_type.data() + i, kKey, kKeySize)) {
+      pos = i + kKeySize;
+      break;
+    }
+  }
+  if (pos == std::string::npos) {
+    return std::string();
+  }
+
+  if (pos < content_type.size() && content_type[pos] == '"') {
+    size_t close = content_type.find('"', pos + 1);
+    if (close == std::string::npos) return std::string();
+    return content_type.substr(pos + 1, close - pos - 1);
+  }
+
+  size_t end = content_type.find_first_of("; \t\r\n", pos);
+  return content_type.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+}
+
+uint8_t* MjpegParser::PrepareWrite(size_t min_size) {
+  if (buffer_.size() - end_ < min_size) {
+    // Compact first; grow only if the live bytes really need the room
+    if (begin_ > 0) {
+      memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+      end_ -= begin_;
+      begin_ = 0;
+    }
+    if (buffer_.size() - end_ < min_size) {
+      buffer_.resize((std::max)(buffer_.size() * 2, end_ + min_size));
+      buffer_.resize(buffer_.capacity());  // use the whole pooled block
+    }
+  }
+  return buffer_.data() + end_;
+}
+
+void MjpegParser::Commit(size_t size, const FrameHandler& on_frame) {
+  end_ += (std::min)(size, buffer_.size() - end_);
+  Parse(on_frame);
+
+  if (end_ - begin_ > kMaxBufferedBytes) {
+    Reset();
+  }
+}
+
+void MjpegParser::Resume(const FrameHandler& on_frame) {
+  stalled_ = false;
+  Parse(on_frame);
+}
+
+void MjpegParser::Feed(const uint8_t* data, size_t size, const FrameHandler& on_frame) {
+  memcpy(PrepareWrite(size), data, size);
+  Commit(size, on_frame);
+}
+
+void MjpegParser::Reset() {
+  begin_ = 0;
+  end_ = 0;
+  state_ = State::kSeekBoundary;
+  scan_ = 0;
+  content_length_ = 0;
+  stalled_ = false;
+}
+
+size_t MjpegParser::Find(const char* needle, size_t needle_size, size_t from) const {
+  if (from >= end_ - begin_) return std::string::npos;
+  const uint8_t* first = buffer_.data() + begin_ + from;
+  const uint8_t* last = buffer_.data() + end_;
+
+  const uint8_t* hit = std::search(first, last, needle, needle + needle_size,
+                                   [](uint8_t a, char b) { return a == static_cast<uint8_t>(b); });
+  return hit == last ? std::string::npos : static_cast<size_t>(hit - (buffer_.data() + begin_));
+}
+
+size_t MjpegParser::ParseContentLength(size_t size) const {
+  static const char kKey[] = "content-length:";
+  constexpr size_t kKeySize = sizeof(kKey) - 1;
+
+  const char* headers = reinterpret_cast<const char*>(buffer_.data() + begin_);
+  for (size_t i = 0; i + kKeySize <= size; ++i) {
+    if (!EqualsIgnoreCase(headers + i, kKey, kKeySize)) continue;
+
+    size_t value = 0;
+    size_t p = i + kKeySize;
+    while (p < size && (headers[p] == ' ' || headers[p] == '\t')) ++p;
+    while (p < size && headers[p] >= '0' && headers[p] <= '9') {
+      value = value * 10 + static_cast<size_t>(headers[p] - '0');
+      if (value > kMaxBufferedBytes) return 0;
+      ++p;
+    }
+    return value;
+  }
+  return 0;
+}
+
+void MjpegParser::Consume(size_t size) {
+  begin_ += size;
+  scan_ = 0;
+  if (begin_ == end_) {
+    begin_ = 0;
+    end_ = 0;
+  }
+}
+
+void MjpegParser::Parse(const FrameHandler& on_frame) {
+  for (;;) {
+    size_t available = end_ - begin_;
+
+    switch (state_) {
+      case State::kSeekBoundary: {
+        size_t pos = Find(delimiter_.data(), delimiter_.size(), scan_);
+        if (pos == std::string::npos) {
+          // Keep only what could still be the start of a delimiter
+          size_t keep = (std::min)(available, delimiter_.size() - 1);
+          Consume(available - keep);
+          scan_ = 0;
+          return;
+        }
+        Consume(pos + delimiter_.size());
+        state_ = State::kHeaders;
+        break;
+      }
+
+      case State::kHeaders: {
+        size_t pos = Find(kHeaderEnd, kHeaderEndSize, scan_);
+        if (pos == std::string::npos) {
+          scan_ = available >= kHeaderEndSize ? available - (kHeaderEndSize - 1) : 0;
+          return;
+        }
+        content_length_ = ParseContentLength(pos);
+        Consume(pos + kHeaderEndSize);
+        state_ = State::kBody;
+        break;
+      }
+
+      case State::kBody: {
+        size_t jpeg_size = 0;
+        size_t consumed = 0;
+
+        if (content_length_ > 0) {
+          if (available < content_length_) return;
+          jpeg_size = content_length_;
+          consumed = content_length_;
+        } else {
+          // No Content-Length: the part runs up to the next delimiter
+          size_t pos = Find(body_delimiter_.data(), body_delimiter_.size(), scan_);
+          if (pos == std::string::npos) {
+            scan_ = available >= body_delimiter_.size() ? available - (body_delimiter_.size() - 1) : 0;
+            return;
+          }
+          jpeg_size = pos;
+          consumed = pos;
+        }
+
+        // A refused frame stays in the buffer; the search ends where it is,
+        // so Resume finds the same frame
+        if (jpeg_size > 0 && !on_frame(buffer_.data() + begin_, jpeg_size)) {
+          stalled_ = true;
+          return;
+        }
+        Consume(consumed);
+        content_length_ = 0;
+        state_ = State::kSeekBoundary;
+        break;
+      }
+    }
+  }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "buffer_pool.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Incremental parser for multipart/x-mixed-replace (MJPEG over HTTP).
+//
+// Bytes are read straight into the parser's buffer (PrepareWrite/Commit) and
+// every byte is scanned once: searches resume where the previous chunk ended.
+// Consumed bytes are dropped by moving the read offset; the unconsumed tail
+// (at most one partial frame) is moved to the front only when the free space
+// at the end runs out, which keeps the whole thing linear in the bytes
+// received. Each JPEG is handed out as a span of the buffer, so it stays
+// contiguous and is never copied.
+class MjpegParser {
+ public:
+  // jpeg/size are valid only for the duration of the call. Returning false
+  // leaves the frame unconsumed: the parser stalls (see stalled()) and offers
+  // the same frame again on Resume.
+  using FrameHandler = std::function<bool(const uint8_t* jpeg, size_t size)>;
+
+  // boundary: the Content-Type boundary parameter, with or without the
+  // leading "--"; empty falls back to "frame"
+  explicit MjpegParser(const std::string& boundary);
+
+  // Extracts the boundary parameter from a Content-Type header value, e.g.
+  // "multipart/x-mixed-replace; boundary=frame" -> "frame". Empty if absent.
+  static std::string BoundaryFromContentType(const std::string& content_type);
+
+  // Returns a writable span of at least min_size bytes for the next read
+  uint8_t* PrepareWrite(size_t min_size);
+  // Accounts for size bytes written into the PrepareWrite span and emits
+  // every frame they complete
+  void Commit(size_t size, const FrameHandler& on_frame);
+
+  // A handler refused a frame. Stop reading into the parser until Resume()
+  // got the frame taken, or the buffer grows without bound.
+  bool stalled() const { return stalled_; }
+  // Offers the refused frame again and parses on from there
+  void Resume(const FrameHandler& on_frame);
+
+  // Convenience for callers that already own the bytes (one copy)
+  void Feed(const uint8_t* data, size_t size, const FrameHandler& on_frame);
+
+  void Reset();
+
+  const std::string& delimiter() const { return delimiter_; }
+
+ private:
+  enum class State { kSeekBoundary, kHeaders, kBody };
+
+  // Finds needle in [begin_ + from, end_); returns offset from begin_ or npos
+  size_t Find(const char* needle, size_t needle_size, size_t from) const;
+  // Parses Content-Length from the part headers in [begin_, begin_ + size)
+  size_t ParseContentLength(size_t size) const;
+  void Consume(size_t size);
+  void Parse(const FrameHandler& on_frame);
+
+  std::string delimiter_;        // "--boundary"
+  std::string body_delimiter_;   // "\r\n--boundary", ends a part without Content-Length
+
+  PooledBuffer buffer_;  // back to the pool with the connection
+  size_t begin_ = 0;  // first unconsumed byte
+  size_t end_ = 0;    // one past the last received byte
+
+  State state_ = State::kSeekBoundary;
+  size_t scan_ = 0;            // resume offset (from begin_) for the current search
+  size_t content_length_ = 0;  // 0 = unknown, scan for the next boundary
+  bool stalled_ = false;
+};
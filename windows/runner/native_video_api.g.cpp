@@ -43,7 +43,16 @@ FrameInfo::FrameInfo(
   const int64_t* bbox_h,
   const int64_t* width,
   const int64_t* height,
-  int64_t frame_count)
+  int64_t frame_count,
+  const int64_t* dropped_frames,
+  const int64_t* stream_state,
+  const int64_t* reconnect_count,
+  const int64_t* frame_sequence,
+  const int64_t* capture_time_us,
+  const int64_t* received_frames,
+  const int64_t* displayed_frames,
+  const int64_t* quality_step,
+  const int64_t* budget_step)
  : cam_idx_(cam_idx ? std::optional<std::string>(*cam_idx) : std::nullopt),
     cam_num_(cam_num ? std::optional<std::string>(*cam_num) : std::nullopt),
     brightness_(brightness ? std::optional<double>(*brightness) : std::nullopt),
@@ -54,7 +63,16 @@ FrameInfo::FrameInfo(
     bbox_h_(bbox_h ? std::optional<int64_t>(*bbox_h) : std::nullopt),
     width_(width ? std::optional<int64_t>(*width) : std::nullopt),
     height_(height ? std::optional<int64_t>(*height) : std::nullopt),
-    frame_count_(frame_count) {}
+    frame_count_(frame_count),
+    dropped_frames_(dropped_frames ? std::optional<int64_t>(*dropped_frames) : std::nullopt),
+    stream_state_(stream_state ? std::optional<int64_t>(*stream_state) : std::nullopt),
+    reconnect_count_(reconnect_count ? std::optional<int64_t>(*reconnect_count) : std::nullopt),
+    frame_sequence_(frame_sequence ? std::optional<int64_t>(*frame_sequence) : std::nullopt),
+    capture_time_us_(capture_time_us ? std::optional<int64_t>(*capture_time_us) : std::nullopt),
+    received_frames_(received_frames ? std::optional<int64_t>(*received_frames) : std::nullopt),
+    displayed_frames_(displayed_frames ? std::optional<int64_t>(*displayed_frames) : std::nullopt),
+    quality_step_(quality_step ? std::optional<int64_t>(*quality_step) : std::nullopt),
+    budget_step_(budget_step ? std::optional<int64_t>(*budget_step) : std::nullopt) {}
 
 const std::string* FrameInfo::cam_idx() const {
   return cam_idx_ ? &(*cam_idx_) : nullptr;
@@ -195,9 +213,126 @@ void FrameInfo::set_frame_count(int64_t value_arg) {
 }
 
 
+const int64_t* FrameInfo::dropped_frames() const {
+  return dropped_frames_ ? &(*dropped_frames_) : nullptr;
+}
+
+void FrameInfo::set_dropped_frames(const int64_t* value_arg) {
+  dropped_frames_ = value_arg ? std::optional<int64_t>(*value_arg) : std::nullopt;
+}
+
+void FrameInfo::set_dropped_frames(int64_t value_arg) {
+  dropped_frames_ = value_arg;
+}
+
+
+const int64_t* FrameInfo::stream_state() const {
+  return stream_state_ ? &(*stream_state_) : nullptr;
+}
+
+void FrameInfo::set_stream_state(const int64_t* value_arg) {
+  stream_state_ = value_arg ? std::optional<int64_t>(*value_arg) : std::nullopt;
+}
+
+void FrameInfo::set_stream_state(int64_t value_arg) {
+  stream_state_ = value_arg;
+}
+
+
+const int64_t* FrameInfo::reconnect_count() const {
+  return reconnect_count_ ? &(*reconnect_count_) : nullptr;
+}
+
+void FrameInfo::set_reconnect_count(const int64_t* value_arg) {
+  reconnect_count_ = value_arg ? std::optional<int64_t>(*value_arg) : std::nullopt;
+}
+
+void FrameInfo::set_reconnect_count(int64_t value_arg) {
+  reconnect_count_ = value_arg;
+}
+
+
+const int64_t* FrameInfo::frame_sequence() const {
+  return frame_sequence_ ? &(*frame_sequence_) : nullptr;
+}
+
+void FrameInfo::set_frame_sequence(const int64_t* value_arg) {
+  frame_sequence_ = value_arg ? std::optional<int64_t>(*value_arg) : std::nullopt;
+}
+
+void FrameInfo::set_frame_sequence(int64_t value_arg) {
+  frame_sequence_ = value_arg;
+}
+
+
+const int64_t* FrameInfo::capture_time_us() const {
+  return capture_time_us_ ? &(*capture_time_us_) : nullptr;
+}
+
+void FrameInfo::set_capture_time_us(const int64_t* value_arg) {
+  capture_time_us_ = value_arg ? std::optional<int64_t>(*value_arg) : std::nullopt;
+}
+
+void FrameInfo::set_capture_time_us(int64_t value_arg) {
+  capture_time_us_ = value_arg;
+}
+
+
+const int64_t* FrameInfo::received_frames() const {
+  return received_frames_ ? &(*received_frames_) : nullptr;
+}
+
+void FrameInfo::set_received_frames(const int64_t* value_arg) {
+  received_frames_ = value_arg ? std::optional<int64_t>(*value_arg) : std::nullopt;
+}
+
+void FrameInfo::set_received_frames(int64_t value_arg) {
+  received_frames_ = value_arg;
+}
+
+
+const int64_t* FrameInfo::displayed_frames() const {
+  return displayed_frames_ ? &(*displayed_frames_) : nullptr;
+}
+
+void FrameInfo::set_displayed_frames(const int64_t* value_arg) {
+  displayed_frames_ = value_arg ? std::optional<int64_t>(*value_arg) : std::nullopt;
+}
+
+void FrameInfo::set_displayed_frames(int64_t value_arg) {
+  displayed_frames_ = value_arg;
+}
+
+
+const int64_t* FrameInfo::quality_step() const {
+  return quality_step_ ? &(*quality_step_) : nullptr;
+}
+
+void FrameInfo::set_quality_step(const int64_t* value_arg) {
+  quality_step_ = value_arg ? std::optional<int64_t>(*value_arg) : std::nullopt;
+}
+
+void FrameInfo::set_quality_step(int64_t value_arg) {
+  quality_step_ = value_arg;
+}
+
+
+const int64_t* FrameInfo::budget_step() const {
+  return budget_step_ ? &(*budget_step_) : nullptr;
+}
+
+void FrameInfo::set_budget_step(const int64_t* value_arg) {
+  budget_step_ = value_arg ? std::optional<int64_t>(*value_arg) : std::nullopt;
+}
+
+void FrameInfo::set_budget_step(int64_t value_arg) {
+  budget_step_ = value_arg;
+}
+
+
 EncodableList FrameInfo::ToEncodableList() const {
   EncodableList list;
-  list.reserve(11);
+  list.reserve(20);
   list.push_back(cam_idx_ ? EncodableValue(*cam_idx_) : EncodableValue());
   list.push_back(cam_num_ ? EncodableValue(*cam_num_) : EncodableValue());
   list.push_back(brightness_ ? EncodableValue(*brightness_) : EncodableValue());
@@ -209,6 +344,15 @@ EncodableList FrameInfo::ToEncodableList() const {
   list.push_back(width_ ? EncodableValue(*width_) : EncodableValue());
   list.push_back(height_ ? EncodableValue(*height_) : EncodableValue());
   list.push_back(EncodableValue(frame_count_));
+  list.push_back(dropped_frames_ ? EncodableValue(*dropped_frames_) : EncodableValue());
+  list.push_back(stream_state_ ? EncodableValue(*stream_state_) : EncodableValue());
+  list.push_back(reconnect_count_ ? EncodableValue(*reconnect_count_) : EncodableValue());
+  list.push_back(frame_sequence_ ? EncodableValue(*frame_sequence_) : EncodableValue());
+  list.push_back(capture_time_us_ ? EncodableValue(*capture_time_us_) : EncodableValue());
+  list.push_back(received_frames_ ? EncodableValue(*received_frames_) : EncodableValue());
+  list.push_back(displayed_frames_ ? EncodableValue(*displayed_frames_) : EncodableValue());
+  list.push_back(quality_step_ ? EncodableValue(*quality_step_) : EncodableValue());
+  list.push_back(budget_step_ ? EncodableValue(*budget_step_) : EncodableValue());
   return list;
 }
 
@@ -255,6 +399,135 @@ FrameInfo FrameInfo::FromEncodableList(const EncodableList& list) {
   if (!encodable_height.IsNull()) {
     decoded.set_height(std::get<int64_t>(encodable_height));
   }
+  auto& encodable_dropped_frames = list[11];
+  if (!encodable_dropped_frames.IsNull()) {
+    decoded.set_dropped_frames(std::get<int64_t>(encodable_dropped_frames));
+  }
+  auto& encodable_stream_state = list[12];
+  if (!encodable_stream_state.IsNull()) {
+    decoded.set_stream_state(std::get<int64_t>(encodable_stream_state));
+  }
+  auto& encodable_reconnect_count = list[13];
+  if (!encodable_reconnect_count.IsNull()) {
+    decoded.set_reconnect_count(std::get<int64_t>(encodable_reconnect_count));
+  }
+  auto& encodable_frame_sequence = list[14];
+  if (!encodable_frame_sequence.IsNull()) {
+    decoded.set_frame_sequence(std::get<int64_t>(encodable_frame_sequence));
+  }
+  auto& encodable_capture_time_us = list[15];
+  if (!encodable_capture_time_us.IsNull()) {
+    decoded.set_capture_time_us(std::get<int64_t>(encodable_capture_time_us));
+  }
+  auto& encodable_received_frames = list[16];
+  if (!encodable_received_frames.IsNull()) {
+    decoded.set_received_frames(std::get<int64_t>(encodable_received_frames));
+  }
+  auto& encodable_displayed_frames = list[17];
+  if (!encodable_displayed_frames.IsNull()) {
+    decoded.set_displayed_frames(std::get<int64_t>(encodable_displayed_frames));
+  }
+  auto& encodable_quality_step = list[18];
+  if (!encodable_quality_step.IsNull()) {
+    decoded.set_quality_step(std::get<int64_t>(encodable_quality_step));
+  }
+  auto& encodable_budget_step = list[19];
+  if (!encodable_budget_step.IsNull()) {
+    decoded.set_budget_step(std::get<int64_t>(encodable_budget_step));
+  }
+  return decoded;
+}
+
+// MemoryStats
+
+MemoryStats::MemoryStats(
+  int64_t budget_bytes,
+  int64_t used_bytes,
+  int64_t estimated_bytes,
+  int64_t cached_bytes,
+  int64_t peak_bytes,
+  int64_t downscaled_streams)
+ : budget_bytes_(budget_bytes),
+    used_bytes_(used_bytes),
+    estimated_bytes_(estimated_bytes),
+    cached_bytes_(cached_bytes),
+    peak_bytes_(peak_bytes),
+    downscaled_streams_(downscaled_streams) {}
+
+int64_t MemoryStats::budget_bytes() const {
+  return budget_bytes_;
+}
+
+void MemoryStats::set_budget_bytes(int64_t value_arg) {
+  budget_bytes_ = value_arg;
+}
+
+
+int64_t MemoryStats::used_bytes() const {
+  return used_bytes_;
+}
+
+void MemoryStats::set_used_bytes(int64_t value_arg) {
+  used_bytes_ = value_arg;
+}
+
+
+int64_t MemoryStats::estimated_bytes() const {
+  return estimated_bytes_;
+}
+
+void MemoryStats::set_estimated_bytes(int64_t value_arg) {
+  estimated_bytes_ = value_arg;
+}
+
+
+int64_t MemoryStats::cached_bytes() const {
+  return cached_bytes_;
+}
+
+void MemoryStats::set_cached_bytes(int64_t value_arg) {
+  cached_bytes_ = value_arg;
+}
+
+
+int64_t MemoryStats::peak_bytes() const {
+  return peak_bytes_;
+}
+
+void MemoryStats::set_peak_bytes(int64_t value_arg) {
+  peak_bytes_ = value_arg;
+}
+
+
+int64_t MemoryStats::downscaled_streams() const {
+  return downscaled_streams_;
+}
+
+void MemoryStats::set_downscaled_streams(int64_t value_arg) {
+  downscaled_streams_ = value_arg;
+}
+
+
+EncodableList MemoryStats::ToEncodableList() const {
+  EncodableList list;
+  list.reserve(6);
+  list.push_back(EncodableValue(budget_bytes_));
+  list.push_back(EncodableValue(used_bytes_));
+  list.push_back(EncodableValue(estimated_bytes_));
+  list.push_back(EncodableValue(cached_bytes_));
+  list.push_back(EncodableValue(peak_bytes_));
+  list.push_back(EncodableValue(downscaled_streams_));
+  return list;
+}
+
+MemoryStats MemoryStats::FromEncodableList(const EncodableList& list) {
+  MemoryStats decoded(
+    std::get<int64_t>(list[0]),
+    std::get<int64_t>(list[1]),
+    std::get<int64_t>(list[2]),
+    std::get<int64_t>(list[3]),
+    std::get<int64_t>(list[4]),
+    std::get<int64_t>(list[5]));
   return decoded;
 }
 
@@ -268,6 +541,9 @@ EncodableValue PigeonInternalCodecSerializer::ReadValueOfType(
     case 129: {
         return CustomEncodableValue(FrameInfo::FromEncodableList(std::get<EncodableList>(ReadValue(stream))));
       }
+    case 130: {
+        return CustomEncodableValue(MemoryStats::FromEncodableList(std::get<EncodableList>(ReadValue(stream))));
+      }
     default:
       return flutter::StandardCodecSerializer::ReadValueOfType(type, stream);
     }
@@ -282,6 +558,11 @@ void PigeonInternalCodecSerializer::WriteValue(
       WriteValue(EncodableValue(std::any_cast<FrameInfo>(*custom_value).ToEncodableList()), stream);
       return;
     }
+    if (custom_value->type() == typeid(MemoryStats)) {
+      stream->WriteByte(130);
+      WriteValue(EncodableValue(std::any_cast<MemoryStats>(*custom_value).ToEncodableList()), stream);
+      return;
+    }
   }
   flutter::StandardCodecSerializer::WriteValue(value, stream);
 }
@@ -454,6 +735,473 @@ void NativeVideoHostApi::SetUp(
       channel.SetMessageHandler(nullptr);
     }
   }
+  {
+    BasicMessageChannel<> channel(binary_messenger, "dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.setLiveMode" + prepended_suffix, &GetCodec());
+    if (api != nullptr) {
+      channel.SetMessageHandler([api](const EncodableValue& message, const flutter::MessageReply<EncodableValue>& reply) {
+        try {
+          const auto& args = std::get<EncodableList>(message);
+          const auto& encodable_texture_key_arg = args.at(0);
+          if (encodable_texture_key_arg.IsNull()) {
+            reply(WrapError("texture_key_arg unexpectedly null."));
+            return;
+          }
+          const int64_t texture_key_arg = encodable_texture_key_arg.LongValue();
+          const auto& encodable_enabled_arg = args.at(1);
+          if (encodable_enabled_arg.IsNull()) {
+            reply(WrapError("enabled_arg unexpectedly null."));
+            return;
+          }
+          const auto& enabled_arg = std::get<bool>(encodable_enabled_arg);
+          std::optional<FlutterError> output = api->SetLiveMode(texture_key_arg, enabled_arg);
+          if (output.has_value()) {
+            reply(WrapError(output.value()));
+            return;
+          }
+          EncodableList wrapped;
+          wrapped.push_back(EncodableValue());
+          reply(EncodableValue(std::move(wrapped)));
+        } catch (const std::exception& exception) {
+          reply(WrapError(exception.what()));
+        }
+      });
+    } else {
+      channel.SetMessageHandler(nullptr);
+    }
+  }
+  {
+    BasicMessageChannel<> channel(binary_messenger, "dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.setDisplaySize" + prepended_suffix, &GetCodec());
+    if (api != nullptr) {
+      channel.SetMessageHandler([api](const EncodableValue& message, const flutter::MessageReply<EncodableValue>& reply) {
+        try {
+          const auto& args = std::get<EncodableList>(message);
+          const auto& encodable_texture_key_arg = args.at(0);
+          if (encodable_texture_key_arg.IsNull()) {
+            reply(WrapError("texture_key_arg unexpectedly null."));
+            return;
+          }
+          const int64_t texture_key_arg = encodable_texture_key_arg.LongValue();
+          const auto& encodable_width_arg = args.at(1);
+          if (encodable_width_arg.IsNull()) {
+            reply(WrapError("width_arg unexpectedly null."));
+            return;
+          }
+          const int64_t width_arg = encodable_width_arg.LongValue();
+          const auto& encodable_height_arg = args.at(2);
+          if (encodable_height_arg.IsNull()) {
+            reply(WrapError("height_arg unexpectedly null."));
+            return;
+          }
+          const int64_t height_arg = encodable_height_arg.LongValue();
+          std::optional<FlutterError> output = api->SetDisplaySize(texture_key_arg, width_arg, height_arg);
+          if (output.has_value()) {
+            reply(WrapError(output.value()));
+            return;
+          }
+          EncodableList wrapped;
+          wrapped.push_back(EncodableValue());
+          reply(EncodableValue(std::move(wrapped)));
+        } catch (const std::exception& exception) {
+          reply(WrapError(exception.what()));
+        }
+      });
+    } else {
+      channel.SetMessageHandler(nullptr);
+    }
+  }
+  {
+    BasicMessageChannel<> channel(binary_messenger, "dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.setZoom" + prepended_suffix, &GetCodec());
+    if (api != nullptr) {
+      channel.SetMessageHandler([api](const EncodableValue& message, const flutter::MessageReply<EncodableValue>& reply) {
+        try {
+          const auto& args = std::get<EncodableList>(message);
+          const auto& encodable_texture_key_arg = args.at(0);
+          if (encodable_texture_key_arg.IsNull()) {
+            reply(WrapError("texture_key_arg unexpectedly null."));
+            return;
+          }
+          const int64_t texture_key_arg = encodable_texture_key_arg.LongValue();
+          const auto& encodable_zoom_arg = args.at(1);
+          if (encodable_zoom_arg.IsNull()) {
+            reply(WrapError("zoom_arg unexpectedly null."));
+            return;
+          }
+          const auto& zoom_arg = std::get<double>(encodable_zoom_arg);
+          const auto& encodable_center_x_arg = args.at(2);
+          if (encodable_center_x_arg.IsNull()) {
+            reply(WrapError("center_x_arg unexpectedly null."));
+            return;
+          }
+          const auto& center_x_arg = std::get<double>(encodable_center_x_arg);
+          const auto& encodable_center_y_arg = args.at(3);
+          if (encodable_center_y_arg.IsNull()) {
+            reply(WrapError("center_y_arg unexpectedly null."));
+            return;
+          }
+          const auto& center_y_arg = std::get<double>(encodable_center_y_arg);
+          std::optional<FlutterError> output = api->SetZoom(texture_key_arg, zoom_arg, center_x_arg, center_y_arg);
+          if (output.has_value()) {
+            reply(WrapError(output.value()));
+            return;
+          }
+          EncodableList wrapped;
+          wrapped.push_back(EncodableValue());
+          reply(EncodableValue(std::move(wrapped)));
+        } catch (const std::exception& exception) {
+          reply(WrapError(exception.what()));
+        }
+      });
+    } else {
+      channel.SetMessageHandler(nullptr);
+    }
+  }
+  {
+    BasicMessageChannel<> channel(binary_messenger, "dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.setZoomFollowBbox" + prepended_suffix, &GetCodec());
+    if (api != nullptr) {
+      channel.SetMessageHandler([api](const EncodableValue& message, const flutter::MessageReply<EncodableValue>& reply) {
+        try {
+          const auto& args = std::get<EncodableList>(message);
+          const auto& encodable_texture_key_arg = args.at(0);
+          if (encodable_texture_key_arg.IsNull()) {
+            reply(WrapError("texture_key_arg unexpectedly null."));
+            return;
+          }
+          const int64_t texture_key_arg = encodable_texture_key_arg.LongValue();
+          const auto& encodable_enabled_arg = args.at(1);
+          if (encodable_enabled_arg.IsNull()) {
+            reply(WrapError("enabled_arg unexpectedly null."));
+            return;
+          }
+          const auto& enabled_arg = std::get<bool>(encodable_enabled_arg);
+          std::optional<FlutterError> output = api->SetZoomFollowBbox(texture_key_arg, enabled_arg);
+          if (output.has_value()) {
+            reply(WrapError(output.value()));
+            return;
+          }
+          EncodableList wrapped;
+          wrapped.push_back(EncodableValue());
+          reply(EncodableValue(std::move(wrapped)));
+        } catch (const std::exception& exception) {
+          reply(WrapError(exception.what()));
+        }
+      });
+    } else {
+      channel.SetMessageHandler(nullptr);
+    }
+  }
+  {
+    BasicMessageChannel<> channel(binary_messenger, "dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.initializeGrid" + prepended_suffix, &GetCodec());
+    if (api != nullptr) {
+      channel.SetMessageHandler([api](const EncodableValue& message, const flutter::MessageReply<EncodableValue>& reply) {
+        try {
+          const auto& args = std::get<EncodableList>(message);
+          const auto& encodable_grid_key_arg = args.at(0);
+          if (encodable_grid_key_arg.IsNull()) {
+            reply(WrapError("grid_key_arg unexpectedly null."));
+            return;
+          }
+          const int64_t grid_key_arg = encodable_grid_key_arg.LongValue();
+          ErrorOr<int64_t> output = api->InitializeGrid(grid_key_arg);
+          if (output.has_error()) {
+            reply(WrapError(output.error()));
+            return;
+          }
+          EncodableList wrapped;
+          wrapped.push_back(EncodableValue(std::move(output).TakeValue()));
+          reply(EncodableValue(std::move(wrapped)));
+        } catch (const std::exception& exception) {
+          reply(WrapError(exception.what()));
+        }
+      });
+    } else {
+      channel.SetMessageHandler(nullptr);
+    }
+  }
+  {
+    BasicMessageChannel<> channel(binary_messenger, "dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.setGridLayout" + prepended_suffix, &GetCodec());
+    if (api != nullptr) {
+      channel.SetMessageHandler([api](const EncodableValue& message, const flutter::MessageReply<EncodableValue>& reply) {
+        try {
+          const auto& args = std::get<EncodableList>(message);
+          const auto& encodable_grid_key_arg = args.at(0);
+          if (encodable_grid_key_arg.IsNull()) {
+            reply(WrapError("grid_key_arg unexpectedly null."));
+            return;
+          }
+          const int64_t grid_key_arg = encodable_grid_key_arg.LongValue();
+          const auto& encodable_columns_arg = args.at(1);
+          if (encodable_columns_arg.IsNull()) {
+            reply(WrapError("columns_arg unexpectedly null."));
+            return;
+          }
+          const int64_t columns_arg = encodable_columns_arg.LongValue();
+          const auto& encodable_rows_arg = args.at(2);
+          if (encodable_rows_arg.IsNull()) {
+            reply(WrapError("rows_arg unexpectedly null."));
+            return;
+          }
+          const int64_t rows_arg = encodable_rows_arg.LongValue();
+          const auto& encodable_cell_width_arg = args.at(3);
+          if (encodable_cell_width_arg.IsNull()) {
+            reply(WrapError("cell_width_arg unexpectedly null."));
+            return;
+          }
+          const int64_t cell_width_arg = encodable_cell_width_arg.LongValue();
+          const auto& encodable_cell_height_arg = args.at(4);
+          if (encodable_cell_height_arg.IsNull()) {
+            reply(WrapError("cell_height_arg unexpectedly null."));
+            return;
+          }
+          const int64_t cell_height_arg = encodable_cell_height_arg.LongValue();
+          std::optional<FlutterError> output = api->SetGridLayout(grid_key_arg, columns_arg, rows_arg, cell_width_arg, cell_height_arg);
+          if (output.has_value()) {
+            reply(WrapError(output.value()));
+            return;
+          }
+          EncodableList wrapped;
+          wrapped.push_back(EncodableValue());
+          reply(EncodableValue(std::move(wrapped)));
+        } catch (const std::exception& exception) {
+          reply(WrapError(exception.what()));
+        }
+      });
+    } else {
+      channel.SetMessageHandler(nullptr);
+    }
+  }
+  {
+    BasicMessageChannel<> channel(binary_messenger, "dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.setGridCell" + prepended_suffix, &GetCodec());
+    if (api != nullptr) {
+      channel.SetMessageHandler([api](const EncodableValue& message, const flutter::MessageReply<EncodableValue>& reply) {
+        try {
+          const auto& args = std::get<EncodableList>(message);
+          const auto& encodable_grid_key_arg = args.at(0);
+          if (encodable_grid_key_arg.IsNull()) {
+            reply(WrapError("grid_key_arg unexpectedly null."));
+            return;
+          }
+          const int64_t grid_key_arg = encodable_grid_key_arg.LongValue();
+          const auto& encodable_cell_arg = args.at(1);
+          if (encodable_cell_arg.IsNull()) {
+            reply(WrapError("cell_arg unexpectedly null."));
+            return;
+          }
+          const int64_t cell_arg = encodable_cell_arg.LongValue();
+          const auto& encodable_texture_key_arg = args.at(2);
+          if (encodable_texture_key_arg.IsNull()) {
+            reply(WrapError("texture_key_arg unexpectedly null."));
+            return;
+          }
+          const int64_t texture_key_arg = encodable_texture_key_arg.LongValue();
+          std::optional<FlutterError> output = api->SetGridCell(grid_key_arg, cell_arg, texture_key_arg);
+          if (output.has_value()) {
+            reply(WrapError(output.value()));
+            return;
+          }
+          EncodableList wrapped;
+          wrapped.push_back(EncodableValue());
+          reply(EncodableValue(std::move(wrapped)));
+        } catch (const std::exception& exception) {
+          reply(WrapError(exception.what()));
+        }
+      });
+    } else {
+      channel.SetMessageHandler(nullptr);
+    }
+  }
+  {
+    BasicMessageChannel<> channel(binary_messenger, "dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.disposeGrid" + prepended_suffix, &GetCodec());
+    if (api != nullptr) {
+      channel.SetMessageHandler([api](const EncodableValue& message, const flutter::MessageReply<EncodableValue>& reply) {
+        try {
+          const auto& args = std::get<EncodableList>(message);
+          const auto& encodable_grid_key_arg = args.at(0);
+          if (encodable_grid_key_arg.IsNull()) {
+            reply(WrapError("grid_key_arg unexpectedly null."));
+            return;
+          }
+          const int64_t grid_key_arg = encodable_grid_key_arg.LongValue();
+          std::optional<FlutterError> output = api->DisposeGrid(grid_key_arg);
+          if (output.has_value()) {
+            reply(WrapError(output.value()));
+            return;
+          }
+          EncodableList wrapped;
+          wrapped.push_back(EncodableValue());
+          reply(EncodableValue(std::move(wrapped)));
+        } catch (const std::exception& exception) {
+          reply(WrapError(exception.what()));
+        }
+      });
+    } else {
+      channel.SetMessageHandler(nullptr);
+    }
+  }
+  {
+    BasicMessageChannel<> channel(binary_messenger, "dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.setMemoryBudget" + prepended_suffix, &GetCodec());
+    if (api != nullptr) {
+      channel.SetMessageHandler([api](const EncodableValue& message, const flutter::MessageReply<EncodableValue>& reply) {
+        try {
+          const auto& args = std::get<EncodableList>(message);
+          const auto& encodable_bytes_arg = args.at(0);
+          if (encodable_bytes_arg.IsNull()) {
+            reply(WrapError("bytes_arg unexpectedly null."));
+            return;
+          }
+          const int64_t bytes_arg = encodable_bytes_arg.LongValue();
+          std::optional<FlutterError> output = api->SetMemoryBudget(bytes_arg);
+          if (output.has_value()) {
+            reply(WrapError(output.value()));
+            return;
+          }
+          EncodableList wrapped;
+          wrapped.push_back(EncodableValue());
+          reply(EncodableValue(std::move(wrapped)));
+        } catch (const std::exception& exception) {
+          reply(WrapError(exception.what()));
+        }
+      });
+    } else {
+      channel.SetMessageHandler(nullptr);
+    }
+  }
+  {
+    BasicMessageChannel<> channel(binary_messenger, "dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.getMemoryStats" + prepended_suffix, &GetCodec());
+    if (api != nullptr) {
+      channel.SetMessageHandler([api](const EncodableValue& message, const flutter::MessageReply<EncodableValue>& reply) {
+        try {
+          ErrorOr<MemoryStats> output = api->GetMemoryStats();
+          if (output.has_error()) {
+            reply(WrapError(output.error()));
+            return;
+          }
+          EncodableList wrapped;
+          wrapped.push_back(CustomEncodableValue(std::move(output).TakeValue()));
+          reply(EncodableValue(std::move(wrapped)));
+        } catch (const std::exception& exception) {
+          reply(WrapError(exception.what()));
+        }
+      });
+    } else {
+      channel.SetMessageHandler(nullptr);
+    }
+  }
+  {
+    BasicMessageChannel<> channel(binary_messenger, "dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.setThreadPolicy" + prepended_suffix, &GetCodec());
+    if (api != nullptr) {
+      channel.SetMessageHandler([api](const EncodableValue& message, const flutter::MessageReply<EncodableValue>& reply) {
+        try {
+          const auto& args = std::get<EncodableList>(message);
+          const auto& encodable_role_arg = args.at(0);
+          if (encodable_role_arg.IsNull()) {
+            reply(WrapError("role_arg unexpectedly null."));
+            return;
+          }
+          const int64_t role_arg = encodable_role_arg.LongValue();
+          const auto& encodable_core_mask_arg = args.at(1);
+          if (encodable_core_mask_arg.IsNull()) {
+            reply(WrapError("core_mask_arg unexpectedly null."));
+            return;
+          }
+          const int64_t core_mask_arg = encodable_core_mask_arg.LongValue();
+          const auto& encodable_priority_arg = args.at(2);
+          if (encodable_priority_arg.IsNull()) {
+            reply(WrapError("priority_arg unexpectedly null."));
+            return;
+          }
+          const int64_t priority_arg = encodable_priority_arg.LongValue();
+          std::optional<FlutterError> output = api->SetThreadPolicy(role_arg, core_mask_arg, priority_arg);
+          if (output.has_value()) {
+            reply(WrapError(output.value()));
+            return;
+          }
+          EncodableList wrapped;
+          wrapped.push_back(EncodableValue());
+          reply(EncodableValue(std::move(wrapped)));
+        } catch (const std::exception& exception) {
+          reply(WrapError(exception.what()));
+        }
+      });
+    } else {
+      channel.SetMessageHandler(nullptr);
+    }
+  }
+  {
+    BasicMessageChannel<> channel(binary_messenger, "dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.stopAll" + prepended_suffix, &GetCodec());
+    if (api != nullptr) {
+      channel.SetMessageHandler([api](const EncodableValue& message, const flutter::MessageReply<EncodableValue>& reply) {
+        try {
+          std::optional<FlutterError> output = api->StopAll();
+          if (output.has_value()) {
+            reply(WrapError(output.value()));
+            return;
+          }
+          EncodableList wrapped;
+          wrapped.push_back(EncodableValue());
+          reply(EncodableValue(std::move(wrapped)));
+        } catch (const std::exception& exception) {
+          reply(WrapError(exception.what()));
+        }
+      });
+    } else {
+      channel.SetMessageHandler(nullptr);
+    }
+  }
+  {
+    BasicMessageChannel<> channel(binary_messenger, "dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.disposeAll" + prepended_suffix, &GetCodec());
+    if (api != nullptr) {
+      channel.SetMessageHandler([api](const EncodableValue& message, const flutter::MessageReply<EncodableValue>& reply) {
+        try {
+          std::optional<FlutterError> output = api->DisposeAll();
+          if (output.has_value()) {
+            reply(WrapError(output.value()));
+            return;
+          }
+          EncodableList wrapped;
+          wrapped.push_back(EncodableValue());
+          reply(EncodableValue(std::move(wrapped)));
+        } catch (const std::exception& exception) {
+          reply(WrapError(exception.what()));
+        }
+      });
+    } else {
+      channel.SetMessageHandler(nullptr);
+    }
+  }
+  {
+    BasicMessageChannel<> channel(binary_messenger, "dev.flutter.pigeon.iscan_live_viewer.NativeVideoHostApi.setMeasureBrightness" + prepended_suffix, &GetCodec());
+    if (api != nullptr) {
+      channel.SetMessageHandler([api](const EncodableValue& message, const flutter::MessageReply<EncodableValue>& reply) {
+        try {
+          const auto& args = std::get<EncodableList>(message);
+          const auto& encodable_texture_key_arg = args.at(0);
+          if (encodable_texture_key_arg.IsNull()) {
+            reply(WrapError("texture_key_arg unexpectedly null."));
+            return;
+          }
+          const int64_t texture_key_arg = encodable_texture_key_arg.LongValue();
+          const auto& encodable_enabled_arg = args.at(1);
+          if (encodable_enabled_arg.IsNull()) {
+            reply(WrapError("enabled_arg unexpectedly null."));
+            return;
+          }
+          const auto& enabled_arg = std::get<bool>(encodable_enabled_arg);
+          std::optional<FlutterError> output = api->SetMeasureBrightness(texture_key_arg, enabled_arg);
+          if (output.has_value()) {
+            reply(WrapError(output.value()));
+            return;
+          }
+          EncodableList wrapped;
+          wrapped.push_back(EncodableValue());
+          reply(EncodableValue(std::move(wrapped)));
+        } catch (const std::exception& exception) {
+          reply(WrapError(exception.what()));
+        }
+      });
+    } else {
+      channel.SetMessageHandler(nullptr);
+    }
+  }
 }
 
 EncodableValue NativeVideoHostApi::WrapError(std::string_view error_message) {
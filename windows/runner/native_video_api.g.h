@@ -77,7 +77,16 @@ class FrameInfo {
     const int64_t* bbox_h,
     const int64_t* width,
     const int64_t* height,
-    int64_t frame_count);
+    int64_t frame_count,
+    const int64_t* dropped_frames,
+    const int64_t* stream_state,
+    const int64_t* reconnect_count,
+    const int64_t* frame_sequence,
+    const int64_t* capture_time_us,
+    const int64_t* received_frames,
+    const int64_t* displayed_frames,
+    const int64_t* quality_step,
+    const int64_t* budget_step);
 
   const std::string* cam_idx() const;
   void set_cam_idx(const std::string_view* value_arg);
@@ -122,6 +131,42 @@ class FrameInfo {
   int64_t frame_count() const;
   void set_frame_count(int64_t value_arg);
 
+  const int64_t* dropped_frames() const;
+  void set_dropped_frames(const int64_t* value_arg);
+  void set_dropped_frames(int64_t value_arg);
+
+  const int64_t* stream_state() const;
+  void set_stream_state(const int64_t* value_arg);
+  void set_stream_state(int64_t value_arg);
+
+  const int64_t* reconnect_count() const;
+  void set_reconnect_count(const int64_t* value_arg);
+  void set_reconnect_count(int64_t value_arg);
+
+  const int64_t* frame_sequence() const;
+  void set_frame_sequence(const int64_t* value_arg);
+  void set_frame_sequence(int64_t value_arg);
+
+  const int64_t* capture_time_us() const;
+  void set_capture_time_us(const int64_t* value_arg);
+  void set_capture_time_us(int64_t value_arg);
+
+  const int64_t* received_frames() const;
+  void set_received_frames(const int64_t* value_arg);
+  void set_received_frames(int64_t value_arg);
+
+  const int64_t* displayed_frames() const;
+  void set_displayed_frames(const int64_t* value_arg);
+  void set_displayed_frames(int64_t value_arg);
+
+  const int64_t* quality_step() const;
+  void set_quality_step(const int64_t* value_arg);
+  void set_quality_step(int64_t value_arg);
+
+  const int64_t* budget_step() const;
+  void set_budget_step(const int64_t* value_arg);
+  void set_budget_step(int64_t value_arg);
+
 
  private:
   static FrameInfo FromEncodableList(const flutter::EncodableList& list);
@@ -140,6 +185,64 @@ class FrameInfo {
   std::optional<int64_t> width_;
   std::optional<int64_t> height_;
   int64_t frame_count_;
+  std::optional<int64_t> dropped_frames_;
+  std::optional<int64_t> stream_state_;
+  std::optional<int64_t> reconnect_count_;
+  std::optional<int64_t> frame_sequence_;
+  std::optional<int64_t> capture_time_us_;
+  std::optional<int64_t> received_frames_;
+  std::optional<int64_t> displayed_frames_;
+  std::optional<int64_t> quality_step_;
+  std::optional<int64_t> budget_step_;
+
+};
+
+
+// Decoded memory of all streams against the budget
+//
+// Generated class from Pigeon that represents data sent in messages.
+class MemoryStats {
+ public:
+  // Constructs an object setting all fields.
+  explicit MemoryStats(
+    int64_t budget_bytes,
+    int64_t used_bytes,
+    int64_t estimated_bytes,
+    int64_t cached_bytes,
+    int64_t peak_bytes,
+    int64_t downscaled_streams);
+
+  int64_t budget_bytes() const;
+  void set_budget_bytes(int64_t value_arg);
+
+  int64_t used_bytes() const;
+  void set_used_bytes(int64_t value_arg);
+
+  int64_t estimated_bytes() const;
+  void set_estimated_bytes(int64_t value_arg);
+
+  int64_t cached_bytes() const;
+  void set_cached_bytes(int64_t value_arg);
+
+  int64_t peak_bytes() const;
+  void set_peak_bytes(int64_t value_arg);
+
+  int64_t downscaled_streams() const;
+  void set_downscaled_streams(int64_t value_arg);
+
+
+ private:
+  static MemoryStats FromEncodableList(const flutter::EncodableList& list);
+  flutter::EncodableList ToEncodableList() const;
+  friend class NativeVideoHostApi;
+  friend class NativeVideoFlutterApi;
+  friend class PigeonInternalCodecSerializer;
+  int64_t budget_bytes_;
+  int64_t used_bytes_;
+  int64_t estimated_bytes_;
+  int64_t cached_bytes_;
+  int64_t peak_bytes_;
+  int64_t downscaled_streams_;
 
 };
 
@@ -183,6 +286,58 @@ class NativeVideoHostApi {
   virtual ErrorOr<std::optional<FrameInfo>> GetFrameInfo(int64_t texture_key) = 0;
   // Dispose resources for specific texture
   virtual std::optional<FlutterError> Dispose(int64_t texture_key) = 0;
+  // Live mode: decode only the newest pending frame (drops backlog)
+  virtual std::optional<FlutterError> SetLiveMode(
+    int64_t texture_key,
+    bool enabled) = 0;
+  // Physical pixel size the texture is shown at (0 = full resolution)
+  virtual std::optional<FlutterError> SetDisplaySize(
+    int64_t texture_key,
+    int64_t width,
+    int64_t height) = 0;
+  // Digital zoom: zoom >= 1 around a normalized center; only that region is decoded
+  virtual std::optional<FlutterError> SetZoom(
+    int64_t texture_key,
+    double zoom,
+    double center_x,
+    double center_y) = 0;
+  // Auto-follow: zoom onto the header bbox of each frame
+  virtual std::optional<FlutterError> SetZoomFollowBbox(
+    int64_t texture_key,
+    bool enabled) = 0;
+  // Grid compositor: one texture showing several streams, returns textureId
+  virtual ErrorOr<int64_t> InitializeGrid(int64_t grid_key) = 0;
+  // Grid of columns x rows cells, each cellWidth x cellHeight physical pixels
+  virtual std::optional<FlutterError> SetGridLayout(
+    int64_t grid_key,
+    int64_t columns,
+    int64_t rows,
+    int64_t cell_width,
+    int64_t cell_height) = 0;
+  // Shows a stream in a grid cell instead of its own texture (textureKey < 0 empties the cell)
+  virtual std::optional<FlutterError> SetGridCell(
+    int64_t grid_key,
+    int64_t cell,
+    int64_t texture_key) = 0;
+  // Dispose a grid; its streams go back to their own textures
+  virtual std::optional<FlutterError> DisposeGrid(int64_t grid_key) = 0;
+  // Budget for decoded memory of all streams, in bytes (0 = unlimited)
+  virtual std::optional<FlutterError> SetMemoryBudget(int64_t bytes) = 0;
+  // Decoded memory of all streams against the budget
+  virtual ErrorOr<MemoryStats> GetMemoryStats() = 0;
+  // Core set (bit i = logical core i, 0 = all) and priority (0 = unchanged, 1 low .. 4 highest) of a thread role: 0 network, 1 decode, 2 display, 3 UI
+  virtual std::optional<FlutterError> SetThreadPolicy(
+    int64_t role,
+    int64_t core_mask,
+    int64_t priority) = 0;
+  // Stops every stream at once; textures keep their last frame
+  virtual std::optional<FlutterError> StopAll() = 0;
+  // Disposes every stream and grid at once (e.g. leftovers after a hot restart)
+  virtual std::optional<FlutterError> DisposeAll() = 0;
+  // Headerless frames: measure brightness from the decoded luma (YUV decode, more CPU)
+  virtual std::optional<FlutterError> SetMeasureBrightness(
+    int64_t texture_key,
+    bool enabled) = 0;
 
   // The codec used by NativeVideoHostApi.
   static const flutter::StandardMessageCodec& GetCodec();
@@ -1,4 +1,15 @@
 #include "native_video_handler.h"
+#include "buffer_pool.h"
+#include "decode_pool.h"
+#include "decode_scale.h"
+#include "frame_header.h"
+#include "http_mjpeg_client.h"
+#include "jpeg_restart.h"
+#include "mjpeg_parser.h"
+#include "thread_policy.h"
+#include "yuv_convert.h"
+#include "zmq_message.h"
+#include "zmq_reactor.h"
 #include <windows.h>
 #include <winhttp.h>
 #include <turbojpeg.h>
@@ -7,99 +18,146 @@
 #include <chrono>
 #include <algorithm>
 #include <cctype>
+#include <cmath>
 
 #pragma comment(lib, "winhttp.lib")
 
-// JSON parsing helper (simple implementation for header parsing)
 #include <string>
 #include <map>
+#include <string_view>
 
 namespace {
 
-// Extract the inner content of a JSON object for a given key
-// e.g., for {"header": {"cam_idx": "top_1"}}, ExtractJsonObject(json, "header") returns {"cam_idx": "top_1"}
-std::string ExtractJsonObject(const std::string& json, const std::string& key) {
-  std::string search = "\"" + key + "\"";
-  size_t pos = json.find(search);
-  if (pos == std::string::npos) return "";
+// Shared ZMQ context I/O threads (one is enough for ~1 GB/s of traffic)
+constexpr int kZmqIoThreads = 1;
 
-  // Find the colon after the key
-  pos = json.find(':', pos + search.length());
-  if (pos == std::string::npos) return "";
-  pos++;
+// zmq_poll threads serving all ZMQ streams (0 = derive from core count)
+constexpr int kZmqPollerThreads = 0;
 
-  // Skip whitespace
-  while (pos < json.length() && (json[pos] == ' ' || json[pos] == '\t' || json[pos] == '\n' || json[pos] == '\r')) pos++;
+// JPEG decode workers shared by all streams (0 = one per core, minus one)
+constexpr size_t kDecodeThreads = 0;
 
-  // Check if it's an object
-  if (pos >= json.length() || json[pos] != '{') return "";
+// HTTP: no data for this long aborts the read and triggers a reconnect
+constexpr DWORD kHttpReceiveTimeoutMs = 5000;
 
-  // Find matching closing brace
-  size_t start = pos;
-  int brace_count = 1;
-  pos++;
-  while (pos < json.length() && brace_count > 0) {
-    if (json[pos] == '{') brace_count++;
-    else if (json[pos] == '}') brace_count--;
-    pos++;
-  }
+// HTTP: name resolution, connect and send each give up after this long
+constexpr DWORD kHttpConnectTimeoutMs = 5000;
 
-  return json.substr(start, pos - start);
-}
+// Stopping streams slower than this is logged (see StopStreams)
+constexpr double kSlowStopLogMs = 100.0;
 
-// Simple JSON value extractor for our specific header format
-// Handles both quoted strings ("cam_idx": "top_1") and unquoted values ("brightness": 51.7)
-std::string ExtractJsonString(const std::string& json, const std::string& key) {
-  std::string search = "\"" + key + "\"";
-  size_t pos = json.find(search);
-  if (pos == std::string::npos) return "";
+// Upper bound of one WinHttpReadData call
+constexpr DWORD kHttpReadChunkBytes = 64 * 1024;
 
-  // Find the colon after the key
-  pos = json.find(':', pos + search.length());
-  if (pos == std::string::npos) return "";
-  pos++;
+// HTTP reconnect backoff (ZMQ reconnects inside libzmq)
+constexpr int kHttpReconnectInitialMs = 100;
+constexpr int kHttpReconnectMaxMs = 5000;
 
-  // Skip whitespace
-  while (pos < json.length() && (json[pos] == ' ' || json[pos] == '\t')) pos++;
+// Uncropped frames with at least this many decoded pixels are split at
+// restart markers and decoded across the pool (4K and 12 MP cameras)
+constexpr int64_t kParallelDecodeMinPixels = 4 * 1000 * 1000;
 
-  if (pos >= json.length()) return "";
+// A frame buffer this many times larger than the frame is swapped for a
+// smaller one, so stepping the decode down frees memory
+constexpr size_t kFrameShrinkRatio = 3;
 
-  // Check if value is a quoted string
-  if (json[pos] == '"') {
-    pos++;  // Skip opening quote
-    size_t end = pos;
-    while (end < json.length() && json[end] != '"') end++;
-    return json.substr(pos, end - pos);
-  } else {
-    // Unquoted value (number, boolean, null)
-    size_t end = pos;
-    while (end < json.length() && json[end] != ',' && json[end] != '}' && json[end] != ' ' && json[end] != '\n') end++;
-    return json.substr(pos, end - pos);
+// Memory budget: rebalance at most this often while Dart polls frame info
+constexpr auto kMemoryRebalanceInterval = std::chrono::milliseconds(500);
+
+// Live mode paces decode to the texture: a published frame the compositor
+// hasn't pulled within this many display refreshes is replaced anyway
+constexpr int kPacingDeadlineRefreshes = 2;
+
+std::chrono::steady_clock::duration PacingDeadline() {
+  DWORD hz = 60;
+  DEVMODEW mode = {};
+  mode.dmSize = sizeof(mode);
+  if (EnumDisplaySettingsW(nullptr, ENUM_CURRENT_SETTINGS, &mode) && mode.dmDisplayFrequency > 1) {
+    hz = mode.dmDisplayFrequency;  // 0/1 = hardware default
   }
+  return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(static_cast<double>(kPacingDeadlineRefreshes) / hz));
 }
 
-double ExtractJsonDouble(const std::string& json, const std::string& key) {
-  std::string value = ExtractJsonString(json, key);
-  if (value.empty()) return 0.0;
-  try {
-    return std::stod(value);
-  } catch (...) {
-    return 0.0;
-  }
+// Digital zoom range (1 = whole frame)
+constexpr double kMaxZoom = 8.0;
+
+// Auto-follow: margin kept around the bbox on each side, relative to its size
+constexpr double kFollowBboxMargin = 0.15;
+
+// Auto-follow zoom snaps to these steps so bbox jitter doesn't resize the
+// texture on every frame (the center still follows every frame)
+constexpr double kFollowZoomStep = 0.25;
+
+// Part of the frame to show, in source pixels
+struct ZoomRegion {
+  int x = 0;
+  int y = 0;
+  int width = 0;
+  int height = 0;
+};
+
+// Region of the frame's aspect ratio, 1/zoom of its size, centered on the
+// normalized center and kept inside the frame
+ZoomRegion ComputeZoomRegion(int width, int height, double zoom, double center_x, double center_y) {
+  zoom = (std::min)((std::max)(zoom, 1.0), kMaxZoom);
+
+  ZoomRegion region;
+  region.width = (std::max)(1, static_cast<int>(width / zoom));
+  region.height = (std::max)(1, static_cast<int>(height / zoom));
+  region.x = static_cast<int>(center_x * width - region.width / 2.0);
+  region.y = static_cast<int>(center_y * height - region.height / 2.0);
+  region.x = (std::min)((std::max)(region.x, 0), width - region.width);
+  region.y = (std::min)((std::max)(region.y, 0), height - region.height);
+  return region;
+}
+
+// ConvertYuvToRgba takes YCbCr and grayscale JPEGs; RGB/CMYK ones decode packed
+bool IsYuvDecodable(tjhandle tj, int subsamp) {
+  int colorspace = tj3Get(tj, TJPARAM_COLORSPACE);
+  return (colorspace == TJCS_YCbCr || colorspace == TJCS_GRAY) && subsamp >= 0 &&
+         subsamp < TJ_NUMSAMP;
 }
 
-bool ExtractJsonBool(const std::string& json, const std::string& key) {
-  std::string value = ExtractJsonString(json, key);
-  return value == "true";
+// Decodes to YUV planes, leaving out the colour conversion. The planes are
+// per decode thread and stay valid until its next call.
+bool DecompressToYuv(tjhandle tj, const uint8_t* jpeg_data, size_t jpeg_size, int width,
+                     int height, int subsamp, YuvImage* image) {
+  thread_local std::vector<uint8_t> planes[3];
+  unsigned char* dst[3] = {};
+  int components = subsamp == TJSAMP_GRAY ? 1 : 3;
+  for (int c = 0; c < components; ++c) {
+    int stride = tj3YUVPlaneWidth(c, width, subsamp);
+    size_t size = tj3YUVPlaneSize(c, width, stride, height, subsamp);
+    if (stride <= 0 || size == 0) return false;
+    planes[c].resize(size);
+    dst[c] = planes[c].data();
+    image->planes[c] = planes[c].data();
+    image->strides[c] = stride;
+  }
+  image->width = width;
+  image->height = height;
+  image->chroma_shift_x = tjMCUWidth[subsamp] / 16;  // 8, 16, 32 -> 0, 1, 2
+  image->chroma_shift_y = tjMCUHeight[subsamp] / 16;
+
+  if (tj3DecompressToYUVPlanes8(tj, jpeg_data, jpeg_size, dst, image->strides) != 0) {
+    const char* err = tj3GetErrorStr(tj);
+    char msg[256];
+    sprintf_s(msg, "[NativeVideoHandler] tj3DecompressToYUVPlanes8 failed: %s\n",
+              err ? err : "unknown");
+    OutputDebugStringA(msg);
+    return false;
+  }
+  return true;
 }
 
-int ExtractJsonInt(const std::string& json, const std::string& key) {
-  std::string value = ExtractJsonString(json, key);
-  if (value.empty()) return 0;
-  try {
-    return std::stoi(value);
-  } catch (...) {
-    return 0;
+// First pull of a newly decoded frame (own texture or grid): it reaches the
+// screen, and a paced lane may decode the frame it was holding
+void OnFrameShown(VideoStream* stream) {
+  ++stream->displayed_frames;
+  std::lock_guard<std::mutex> lock(stream->lane_mutex);
+  if (stream->decode_lane) {
+    stream->decode_lane->Consumed();
   }
 }
 
@@ -135,66 +193,53 @@ void NativeVideoHandler::ProcessFrameCallback(FrameCallbackData* data) {
 NativeVideoHandler::~NativeVideoHandler() {
   OutputDebugStringA("[NativeVideoHandler] Destructor called\n");
 
-  // Step 1: Stop all streams first (set is_running = false for all)
-  {
-    std::lock_guard<std::mutex> lock(streams_mutex_);
-    for (auto& pair : streams_) {
-      pair.second->is_running = false;
-    }
-  }
+  // The streams registered now; Step 4 takes them out of the registry
+  std::vector<std::shared_ptr<VideoStream>> streams = AllStreams();
 
-  // Step 2: Close all ZMQ sockets to unblock receive threads
-  {
-    std::lock_guard<std::mutex> lock(streams_mutex_);
-    for (auto& pair : streams_) {
-      auto& stream = pair.second;
-      if (stream->zmq_socket) {
-        zmq_close(stream->zmq_socket);
-        stream->zmq_socket = nullptr;
-      }
-    }
-  }
+  // Step 1: Stop all streams at once: signal every one (closing HTTP handles
+  //         unblocks the receive threads), then wait for them together
+  StopStreams(streams);
 
-  // Step 3: Join all threads (they should exit quickly now)
-  std::vector<std::thread> threads_to_join;
+  // Step 2: Shut down the ZMQ reactor (closes every socket, joins the pollers
+  //         and destroys the shared context) and the http:// event loop
+  zmq_reactor_.reset();
+  http_client_.reset();
+
+  // Step 3: No receive path is left; wait out in-flight decodes and stop
+  //         the decode workers
   {
-    std::lock_guard<std::mutex> lock(streams_mutex_);
-    for (auto& pair : streams_) {
-      auto& stream = pair.second;
-      if (stream->receive_thread.joinable()) {
-        threads_to_join.push_back(std::move(stream->receive_thread));
+    std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+    for (auto& stream : streams) {
+      std::unique_ptr<DecodeLane> lane;
+      {
+        // The texture callback reaches the lane under lane_mutex
+        std::lock_guard<std::mutex> lane_lock(stream->lane_mutex);
+        lane = std::move(stream->decode_lane);
       }
+      lane.reset();
     }
   }
+  decode_pool_.reset();
 
-  for (auto& t : threads_to_join) {
-    if (t.joinable()) {
-      t.join();
-    }
-  }
-
-  // Step 4: Clean up remaining resources
+  // Step 4: Clean up remaining resources; each texture's objects live until
+  //         the engine is done with it
   {
-    std::lock_guard<std::mutex> lock(streams_mutex_);
-    for (auto& pair : streams_) {
-      auto& stream = pair.second;
+    std::lock_guard<std::mutex> lock(lifecycle_mutex_);
 
-      if (stream->zmq_context) {
-        zmq_ctx_destroy(stream->zmq_context);
-        stream->zmq_context = nullptr;
+    // Grids first: they read the streams' frames
+    for (auto& pair : grids_) {
+      if (texture_registrar_) {
+        texture_registrar_->UnregisterTexture(pair.second->texture_id, [grid = pair.second]() {});
       }
+    }
+    grids_.clear();
 
+    for (auto& pair : streams_.Clear()) {
+      const std::shared_ptr<VideoStream>& stream = pair.second;
       if (stream->texture_id >= 0 && texture_registrar_) {
-        texture_registrar_->UnregisterTexture(stream->texture_id);
-        stream->texture_id = -1;
-      }
-
-      if (stream->tj_handle) {
-        tjDestroy(stream->tj_handle);
-        stream->tj_handle = nullptr;
+        texture_registrar_->UnregisterTexture(stream->texture_id, [stream]() {});
       }
     }
-    streams_.clear();
   }
 
   OutputDebugStringA("[NativeVideoHandler] Destructor completed\n");
@@ -206,49 +251,65 @@ ErrorOr<int64_t> NativeVideoHandler::Initialize(int64_t texture_key) {
   OutputDebugStringA(msg);
 
   // If stream already exists, clean it up first (handles rapid reconnection)
-  bool needs_cleanup = false;
-  {
-    std::lock_guard<std::mutex> lock(streams_mutex_);
-    needs_cleanup = (streams_.find(texture_key) != streams_.end());
-  }
-
-  if (needs_cleanup) {
+  if (streams_.Find(texture_key)) {
     OutputDebugStringA("[NativeVideoHandler] Existing stream found, cleaning up first...\n");
     CleanupStream(texture_key);
-    {
-      std::lock_guard<std::mutex> lock(streams_mutex_);
-      streams_.erase(texture_key);
-    }
+    streams_.Remove(texture_key);
     OutputDebugStringA("[NativeVideoHandler] Existing stream cleaned up\n");
   }
 
-  std::lock_guard<std::mutex> lock(streams_mutex_);
+  std::lock_guard<std::mutex> lock(lifecycle_mutex_);
 
   // Create new stream
-  auto stream = std::make_unique<VideoStream>();
+  auto stream = std::make_shared<VideoStream>();
   stream->texture_key = texture_key;
 
-  // Create TurboJPEG decompressor for this stream (thread-safe)
-  stream->tj_handle = tjInitDecompress();
-  if (!stream->tj_handle) {
+  // TurboJPEG decompressors are owned by the decode pool workers
+  if (!decode_pool_) {
+    decode_pool_ = std::make_unique<DecodePool>(kDecodeThreads);
+    sprintf_s(msg, "[NativeVideoHandler] Decode pool started with %zu worker(s), YUV kernel: %s\n",
+              decode_pool_->thread_count(), YuvKernelName());
+    OutputDebugStringA(msg);
+  }
+  if (decode_pool_->thread_count() == 0) {
     OutputDebugStringA("[NativeVideoHandler] Failed to initialize TurboJPEG for stream\n");
     return FlutterError("tj_error", "Failed to initialize TurboJPEG decompressor");
   }
 
-  // Create pixel buffer texture for this stream
-  VideoStream* stream_ptr = stream.get();
+  // Create pixel buffer texture for this stream. The texture belongs to the
+  // stream, so the callback holds it weakly; the engine stops calling it
+  // before the unregistration in CleanupStream lets the stream go, and the
+  // unregistration callback keeps it alive for a pending release_callback.
+  std::weak_ptr<VideoStream> weak_stream = stream;
   stream->texture = std::make_unique<flutter::TextureVariant>(
     flutter::PixelBufferTexture(
-      [stream_ptr](size_t width, size_t height) -> const FlutterDesktopPixelBuffer* {
-        std::lock_guard<std::mutex> lock(stream_ptr->buffer_mutex);
-        if (stream_ptr->bgra_buffer.empty() || stream_ptr->frame_width == 0 || stream_ptr->frame_height == 0) {
+      [weak_stream](size_t width, size_t height) -> const FlutterDesktopPixelBuffer* {
+        // Runs on the engine's raster thread
+        ThreadPolicy::Instance().Apply(ThreadRole::kDisplay);
+
+        std::shared_ptr<VideoStream> stream = weak_stream.lock();
+        if (!stream) {
+          return nullptr;
+        }
+
+        bool fresh = false;
+        const DecodedFrame* frame = stream->frames.Acquire(&fresh);
+        if (!frame) {
           return nullptr;
         }
 
-        static thread_local FlutterDesktopPixelBuffer buffer;
-        buffer.buffer = stream_ptr->bgra_buffer.data();
-        buffer.width = static_cast<size_t>(stream_ptr->frame_width);
-        buffer.height = static_cast<size_t>(stream_ptr->frame_height);
+        if (fresh) {
+          OnFrameShown(stream.get());
+        }
+
+        // The frame stays pinned (never decoded into) until Flutter has
+        // copied it and calls release_callback
+        FlutterDesktopPixelBuffer& buffer = stream->pixel_buffer;
+        buffer.buffer = frame->pixels.data();
+        buffer.width = static_cast<size_t>(frame->width);
+        buffer.height = static_cast<size_t>(frame->height);
+        buffer.release_callback = [](void* context) { static_cast<FrameStore*>(context)->Release(); };
+        buffer.release_context = &stream->frames;
         return &buffer;
       }));
 
@@ -259,8 +320,12 @@ ErrorOr<int64_t> NativeVideoHandler::Initialize(int64_t texture_key) {
   OutputDebugStringA(msg);
 
   int64_t texture_id = stream->texture_id;
+  if (!streams_.Insert(texture_key, stream)) {
+    // Another Initialize for the same key won the race
+    texture_registrar_->UnregisterTexture(texture_id, [stream]() {});
+    return FlutterError("already_initialized", "Stream is already initialized for this key.");
+  }
   current_texture_key_ = texture_key;
-  streams_[texture_key] = std::move(stream);
 
   return texture_id;
 }
@@ -278,70 +343,117 @@ std::optional<FlutterError> NativeVideoHandler::StartStream(int64_t texture_key,
   sprintf_s(msg, "[NativeVideoHandler] StartStream: %s for key: %lld\n", addr.c_str(), texture_key);
   OutputDebugStringA(msg);
 
-  std::lock_guard<std::mutex> lock(streams_mutex_);
+  std::lock_guard<std::mutex> lock(lifecycle_mutex_);
 
-  auto it = streams_.find(texture_key);
-  if (it == streams_.end()) {
+  std::shared_ptr<VideoStream> handle = streams_.Find(texture_key);
+  if (!handle) {
     return FlutterError("not_initialized", "Stream not initialized. Call Initialize first.");
   }
 
-  VideoStream* stream = it->second.get();
+  // Transport callbacks hold the handle, so none of them can outlive the
+  // stream even if it is released while one runs
+  VideoStream* stream = handle.get();
 
   if (stream->is_running) {
     return FlutterError("already_running", "Stream is already running");
   }
 
   stream->stream_address = addr;
+  stream->health.Reset();
+  stream->quality.Reset();
+  StartDecodeLane(handle);
 
   // Detect stream type from address
   std::string addr_lower = addr;
   for (auto& c : addr_lower) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
 
-  if (addr_lower.rfind("http://", 0) == 0 || addr_lower.rfind("https://", 0) == 0) {
-    // HTTP MJPEG
+  if (HttpMjpegClient::Supports(addr)) {
+    // HTTP MJPEG over the shared event loop
     stream->stream_type = StreamType::HTTP_MJPEG;
     OutputDebugStringA("[NativeVideoHandler] Using HTTP MJPEG mode\n");
 
+    if (!http_client_) {
+      http_client_ = std::make_unique<HttpMjpegClient>();
+    }
+
+    // Frames are delivered on the client's loop thread; no per-stream thread.
+    // A frame refused for lack of lane space waits in the client.
+    HttpMjpegClient* client = http_client_.get();
+    stream->decode_lane->set_space_handler([client, texture_key]() { client->Resume(texture_key); });
+    std::string error;
+    stream->is_running = true;
+    bool added = http_client_->Add(
+        texture_key, addr,
+        [this, handle](const uint8_t* jpeg, size_t size) {
+          return OnHttpFrame(handle.get(), jpeg, size);
+        },
+        [handle](bool connected) { OnTransportStatus(handle.get(), connected); },
+        &error);
+    if (!added) {
+      stream->is_running = false;
+      return FlutterError("http_error", error);
+    }
+    stream->http_subscribed = true;
+
+    sprintf_s(msg, "[NativeVideoHandler] Stream started successfully for key: %lld\n", texture_key);
+    OutputDebugStringA(msg);
+    return std::nullopt;
+  } else if (addr_lower.rfind("https://", 0) == 0) {
+    // HTTPS MJPEG via WinHTTP on a dedicated receive thread
+    stream->stream_type = StreamType::HTTP_MJPEG;
+    OutputDebugStringA("[NativeVideoHandler] Using HTTPS MJPEG mode\n");
+
+    // The receive thread waits in ReceiveLoopHttp while the lane is full
+    std::weak_ptr<VideoStream> weak_stream = handle;
+    stream->decode_lane->set_space_handler([weak_stream]() {
+      if (std::shared_ptr<VideoStream> waiting = weak_stream.lock()) SignalSpace(waiting.get());
+    });
+
+    // is_running first: StartHttpStream only publishes handles while running
+    stream->is_running = true;
     if (!StartHttpStream(stream, addr)) {
+      stream->is_running = false;
       return FlutterError("http_error", "Failed to start HTTP stream");
     }
+    stream->health.OnConnected();
   } else {
     // ZMQ (tcp://)
     stream->stream_type = StreamType::ZMQ;
     OutputDebugStringA("[NativeVideoHandler] Using ZMQ mode\n");
 
-    stream->zmq_context = zmq_ctx_new();
-    if (!stream->zmq_context) {
-      return FlutterError("zmq_error", "Failed to create ZMQ context");
+    if (!zmq_reactor_) {
+      zmq_reactor_ = std::make_unique<ZmqReactor>(kZmqIoThreads, kZmqPollerThreads);
+      sprintf_s(msg, "[NativeVideoHandler] ZMQ reactor started with %zu poller thread(s)\n",
+                zmq_reactor_->poller_count());
+      OutputDebugStringA(msg);
     }
 
-    stream->zmq_socket = zmq_socket(stream->zmq_context, ZMQ_SUB);
-    if (!stream->zmq_socket) {
-      zmq_ctx_destroy(stream->zmq_context);
-      stream->zmq_context = nullptr;
-      return FlutterError("zmq_error", "Failed to create ZMQ socket");
+    // Messages are delivered on a shared poller thread; no per-stream thread.
+    // A message refused for lack of lane space waits in the reactor.
+    ZmqReactor* reactor = zmq_reactor_.get();
+    stream->decode_lane->set_space_handler([reactor, texture_key]() { reactor->Resume(texture_key); });
+    std::string error;
+    stream->is_running = true;
+    IngestPolicy policy = stream->live_mode ? IngestPolicy::kLatestOnly : IngestPolicy::kEveryFrame;
+    bool subscribed = zmq_reactor_->Subscribe(
+        texture_key, addr, policy,
+        [this, handle](ZmqFrame& frame, int discarded) {
+          return OnZmqMessage(handle.get(), frame, discarded);
+        },
+        [handle](bool connected) { OnTransportStatus(handle.get(), connected); },
+        &error);
+    if (!subscribed) {
+      stream->is_running = false;
+      return FlutterError("zmq_error", error);
     }
+    stream->zmq_subscribed = true;
 
-    int linger = 0;
-    zmq_setsockopt(stream->zmq_socket, ZMQ_LINGER, &linger, sizeof(linger));
-
-    int rcvtimeo = 100;
-    zmq_setsockopt(stream->zmq_socket, ZMQ_RCVTIMEO, &rcvtimeo, sizeof(rcvtimeo));
-
-    int rc = zmq_connect(stream->zmq_socket, addr.c_str());
-    if (rc != 0) {
-      zmq_close(stream->zmq_socket);
-      zmq_ctx_destroy(stream->zmq_context);
-      stream->zmq_socket = nullptr;
-      stream->zmq_context = nullptr;
-      return FlutterError("zmq_error", "Failed to connect to ZMQ address");
-    }
-
-    zmq_setsockopt(stream->zmq_socket, ZMQ_SUBSCRIBE, "", 0);
+    sprintf_s(msg, "[NativeVideoHandler] Stream started successfully for key: %lld\n", texture_key);
+    OutputDebugStringA(msg);
+    return std::nullopt;
   }
 
-  // Start receive thread
-  stream->is_running = true;
+  // Start HTTPS receive thread
   stream->receive_thread = std::thread(&NativeVideoHandler::ReceiveLoop, this, texture_key);
 
   sprintf_s(msg, "[NativeVideoHandler] Stream started successfully for key: %lld\n", texture_key);
@@ -354,291 +466,538 @@ void NativeVideoHandler::ReceiveLoop(int64_t texture_key) {
   sprintf_s(msg, "[NativeVideoHandler] ReceiveLoop started for key: %lld\n", texture_key);
   OutputDebugStringA(msg);
 
-  VideoStream* stream = nullptr;
-  {
-    std::lock_guard<std::mutex> lock(streams_mutex_);
-    auto it = streams_.find(texture_key);
-    if (it == streams_.end()) {
-      OutputDebugStringA("[NativeVideoHandler] Stream not found in ReceiveLoop\n");
-      return;
-    }
-    stream = it->second.get();
+  // The handle keeps the stream alive for the whole loop
+  std::shared_ptr<VideoStream> handle = streams_.Find(texture_key);
+  if (!handle) {
+    OutputDebugStringA("[NativeVideoHandler] Stream not found in ReceiveLoop\n");
+    return;
   }
-
-  if (stream->stream_type == StreamType::HTTP_MJPEG) {
+  VideoStream* stream = handle.get();
+
+  // Only https:// streams own a receive thread; ZMQ and http:// streams run on
+  // shared event loops.
+  // When the connection drops, reconnect with backoff on the same stream so
+  // the texture keeps showing the last frame.
+  ReconnectBackoff backoff(kHttpReconnectInitialMs, kHttpReconnectMaxMs);
+  while (stream->is_running) {
     ReceiveLoopHttp(stream);
-  } else {
-    ReceiveLoopZmq(stream);
+    if (!stream->is_running) break;
+
+    stream->health.OnDisconnected();
+    StopHttpStream(stream);
+
+    int delay = backoff.Next();
+    sprintf_s(msg, "[NativeVideoHandler] HTTP connection lost for key: %lld, retry in %d ms\n",
+              texture_key, delay);
+    OutputDebugStringA(msg);
+
+    if (!WaitForReconnect(stream, delay)) break;
+    if (StartHttpStream(stream, stream->stream_address)) {
+      stream->health.OnConnected();
+      backoff.Reset();
+    }
   }
 
   sprintf_s(msg, "[NativeVideoHandler] ReceiveLoop ended for key: %lld\n", texture_key);
   OutputDebugStringA(msg);
 }
 
-void NativeVideoHandler::ReceiveLoopZmq(VideoStream* stream) {
-  std::vector<uint8_t> recv_buffer(2 * 1024 * 1024);  // 2MB buffer
+void NativeVideoHandler::StartDecodeLane(const std::shared_ptr<VideoStream>& stream) {
+  // The stream owns the lane, so the handler holds it weakly. ReleaseStream
+  // destroys the lane (waiting out a running decode) before the stream goes,
+  // so the lock here is never the last reference.
+  std::weak_ptr<VideoStream> weak_stream = stream;
+  auto lane = std::make_unique<DecodeLane>(
+      decode_pool_.get(), [this, weak_stream](EncodedFrame& frame, int skipped, tjhandle tj) {
+        std::shared_ptr<VideoStream> locked = weak_stream.lock();
+        return locked && DecodeFrame(locked.get(), frame, skipped, tj);
+      });
+  lane->set_latest_only(stream->live_mode);
+  lane->set_paced(stream->live_mode, PacingDeadline());
+
+  // The previous run's lane is closed already; swap under lane_mutex so
+  // the texture callback never sees it half destroyed
+  {
+    std::lock_guard<std::mutex> lock(stream->lane_mutex);
+    lane.swap(stream->decode_lane);
+  }
+}
 
-  while (stream->is_running && stream->zmq_socket != nullptr) {
-    void* socket = stream->zmq_socket;
-    if (socket == nullptr) break;
+bool NativeVideoHandler::ReserveSlot(VideoStream* stream, EncodedFrame** slot) {
+  DecodeLane* lane = stream->decode_lane.get();
+  *slot = lane->BeginPush();
+  if (*slot || stream->live_mode) return true;
 
-    int size = zmq_recv(socket, recv_buffer.data(), recv_buffer.size(), 0);
+  // Not live: every frame is wanted, so the transport holds it back until a
+  // decode frees a slot (the lane's space handler resumes it). Live mode only
+  // wants the newest frame, so it drops instead.
+  if (lane->RequestSpace()) return false;
+  *slot = lane->BeginPush();  // a slot came free meanwhile
+  return true;
+}
 
-    if (size > 0) {
-      uint32_t header_len;
-      memcpy(&header_len, recv_buffer.data(), sizeof(header_len));
+bool NativeVideoHandler::OnZmqMessage(VideoStream* stream, ZmqFrame& frame, int discarded) {
+  // Refused frames are counted once the reactor offers them again and they
+  // are taken
+  EncodedFrame* slot = nullptr;
+  if (stream->is_running && !ReserveSlot(stream, &slot)) return false;
+
+  // Receive side only queues the frame: the lane slot shares the received
+  // message (no copy, no size limit) and a decode worker takes it from there
+  stream->received_frames += 1 + discarded;
+  stream->quality.OnFramesArrived(1 + discarded);
+  if (discarded > 0) {
+    stream->dropped_frames += discarded;
+  }
+  if (!stream->is_running) return true;
 
-      if (stream->frame_count < 3) {
-        char dbg[128];
-        sprintf_s(dbg, "[NativeVideoHandler] header_len=%u, msg_size=%d\n", header_len, size);
-        OutputDebugStringA(dbg);
-      }
+  if (!slot) {
+    ++stream->dropped_frames;  // live mode and the decoder is behind
+    return true;
+  }
+  slot->zmq.ShareFrom(frame);
+  stream->decode_lane->CommitPush();
+  return true;
+}
 
-      if (header_len > 1024 * 1024) {
-        if (stream->is_running && DecodeJpeg(stream, recv_buffer.data(), size)) {
-          if (texture_registrar_ && stream->texture_id >= 0) {
-            texture_registrar_->MarkTextureFrameAvailable(stream->texture_id);
-          }
-          ++stream->frame_count;
-        }
-      } else {
-        ParseHeader(stream, recv_buffer.data() + sizeof(header_len), header_len);
+bool NativeVideoHandler::OnHttpFrame(VideoStream* stream, const uint8_t* jpeg, size_t size) {
+  EncodedFrame* slot = nullptr;
+  if (stream->is_running && !ReserveSlot(stream, &slot)) return false;
 
-        const uint8_t* jpeg_data = recv_buffer.data() + sizeof(header_len) + header_len;
-        size_t jpeg_size = size - sizeof(header_len) - header_len;
+  // The span points into the parser's buffer, which is reused by the next
+  // read, so it is copied into the slot (the slot keeps its capacity)
+  ++stream->received_frames;
+  stream->quality.OnFramesArrived(1);
+  if (!stream->is_running) return true;
 
-        if (stream->is_running && DecodeJpeg(stream, jpeg_data, jpeg_size)) {
-          if (texture_registrar_ && stream->texture_id >= 0) {
-            texture_registrar_->MarkTextureFrameAvailable(stream->texture_id);
-          }
-          ++stream->frame_count;
-        }
-      }
-    } else if (size == -1) {
-      int err = zmq_errno();
-      if (err == ETERM || err == ENOTSOCK) {
-        break;
-      }
-      if (err != EAGAIN) {
-        char errmsg[128];
-        sprintf_s(errmsg, "[NativeVideoHandler] ZMQ recv error: %d\n", err);
-        OutputDebugStringA(errmsg);
-      }
-    }
+  if (!slot) {
+    ++stream->dropped_frames;
+    return true;
   }
+  slot->jpeg.assign(jpeg, jpeg + size);
+  stream->decode_lane->CommitPush();
+  return true;
 }
 
-void NativeVideoHandler::ReceiveLoopHttp(VideoStream* stream) {
-  std::vector<uint8_t> buffer(64 * 1024);
-  std::vector<uint8_t> accumulator;
-  accumulator.reserve(512 * 1024);
+bool NativeVideoHandler::DecodeFrame(VideoStream* stream, EncodedFrame& frame, int skipped,
+                                     tjhandle tj) {
+  // Both the length-prefixed single-part format and the two-part
+  // [header][JPEG] format are accepted; HTTP frames are bare JPEGs
+  if (skipped > 0) {
+    stream->dropped_frames += skipped;
+  }
+  if (!stream->is_running) return false;
 
-  std::string boundary = "frame";  // Default
+  const uint8_t* jpeg = frame.jpeg.data();
+  size_t jpeg_size = frame.jpeg.size();
+  bool has_header = false;
 
-  while (stream->is_running && stream->http_request) {
-    DWORD bytesAvailable = 0;
-    if (!WinHttpQueryDataAvailable(stream->http_request, &bytesAvailable)) {
-      if (!stream->is_running) break;
-      Sleep(10);
-      continue;
+  if (frame.zmq.part_count > 0) {
+    FrameView view = SplitFrame(frame.zmq);
+    if (view.jpeg_size == 0) return false;
+
+    if (stream->frame_count < 3) {
+      char dbg[128];
+      sprintf_s(dbg, "[NativeVideoHandler] parts=%d, header_len=%zu, jpeg_size=%zu\n",
+                frame.zmq.part_count, view.header_size, view.jpeg_size);
+      OutputDebugStringA(dbg);
     }
 
-    if (bytesAvailable == 0) {
-      Sleep(1);
-      continue;
+    if (view.header_size > 0) {
+      ParseHeader(stream, view.header, static_cast<uint32_t>(view.header_size));
+      has_header = true;
+    }
+    jpeg = view.jpeg;
+    jpeg_size = view.jpeg_size;
+  } else if (stream->meta.cam_idx.empty()) {
+    // HTTP: set cam_idx from URL
+    size_t cam_pos = stream->stream_address.find("cam=");
+    if (cam_pos != std::string::npos) {
+      size_t val_start = cam_pos + 4;
+      size_t val_end = stream->stream_address.find_first_of("&# ", val_start);
+      if (val_end == std::string::npos) val_end = stream->stream_address.size();
+      stream->meta.cam_idx = stream->stream_address.substr(val_start, val_end - val_start);
     }
+  }
 
-    DWORD bytesToRead = (std::min)(bytesAvailable, static_cast<DWORD>(buffer.size()));
-    DWORD bytesRead = 0;
+  stream->jpeg_bytes.store(jpeg_size, std::memory_order_relaxed);
 
-    if (!WinHttpReadData(stream->http_request, buffer.data(), bytesToRead, &bytesRead)) {
-      if (!stream->is_running) break;
-      OutputDebugStringA("[NativeVideoHandler] WinHttpReadData failed\n");
-      break;
+  // Without a header the brightness can be measured from the decoded luma
+  double brightness = -1.0;
+  bool measure = !has_header && stream->measure_brightness.load(std::memory_order_relaxed);
+  auto decode_start = std::chrono::steady_clock::now();
+  if (!stream->is_running ||
+      !DecodeJpeg(stream, tj, jpeg, jpeg_size, measure ? &brightness : nullptr)) {
+    return false;
+  }
+
+  int step = stream->quality.step();
+  stream->quality.OnFrameDecoded(std::chrono::duration_cast<std::chrono::microseconds>(
+                                     std::chrono::steady_clock::now() - decode_start)
+                                     .count(),
+                                 stream->decode_scale);
+  if (stream->quality.step() != step) {
+    char msg[128];
+    sprintf_s(msg, "[NativeVideoHandler] Quality step %d -> %d for key: %lld\n", step,
+              stream->quality.step(), stream->texture_key);
+    OutputDebugStringA(msg);
+  }
+  if (brightness >= 0.0) {
+    stream->meta.brightness = brightness;
+  }
+  {
+    // Copy-assigning reuses the strings' capacity
+    std::lock_guard<std::mutex> meta_lock(stream->meta_mutex);
+    stream->published_meta = stream->meta;
+  }
+
+  // A stream shown in a grid signals the grid texture, at most once per
+  // compose however many of its streams publish meanwhile
+  std::shared_ptr<VideoGrid> grid = std::atomic_load(&stream->grid);
+  if (grid) {
+    if (texture_registrar_ && grid->compositor.RequestCompose()) {
+      texture_registrar_->MarkTextureFrameAvailable(grid->texture_id);
     }
+  } else if (texture_registrar_ && stream->texture_id >= 0) {
+    texture_registrar_->MarkTextureFrameAvailable(stream->texture_id);
+  }
+  ++stream->frame_count;
+  stream->health.OnFrame();
+  return true;
+}
 
-    if (bytesRead == 0) continue;
+void NativeVideoHandler::OnTransportStatus(VideoStream* stream, bool connected) {
+  if (connected) {
+    stream->health.OnConnected();
+  } else {
+    stream->health.OnDisconnected();
+  }
+}
 
-    accumulator.insert(accumulator.end(), buffer.begin(), buffer.begin() + bytesRead);
+void NativeVideoHandler::ReceiveLoopHttp(VideoStream* stream) {
+  // One copy of the handle per connection, taken under http_mutex. A
+  // concurrent StopHttpStream closes it, which fails the blocked call below
+  // instead of racing on the field.
+  HINTERNET request = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(stream->http_mutex);
+    request = stream->http_request;
+  }
+  if (!request) return;
 
-    // Parse MJPEG frames
-    std::string boundaryMarker = "--" + boundary;
-    while (accumulator.size() > 100 && stream->is_running) {
-      std::string acc_str(accumulator.begin(), accumulator.end());
-      size_t boundary_pos = acc_str.find(boundaryMarker);
-      if (boundary_pos == std::string::npos) break;
+  MjpegParser parser(MjpegParser::BoundaryFromContentType(QueryContentType(request)));
 
-      size_t headers_start = boundary_pos + boundaryMarker.size();
-      size_t headers_end = acc_str.find("\r\n\r\n", headers_start);
-      if (headers_end == std::string::npos) break;
+  char dbg[256];
+  sprintf_s(dbg, "[NativeVideoHandler] MJPEG delimiter: %s\n", parser.delimiter().c_str());
+  OutputDebugStringA(dbg);
 
-      std::string headers = acc_str.substr(headers_start, headers_end - headers_start);
+  auto on_frame = [this, stream](const uint8_t* jpeg, size_t size) {
+    return OnHttpFrame(stream, jpeg, size);
+  };
 
-      size_t content_len = 0;
-      size_t cl_pos = headers.find("Content-Length:");
-      if (cl_pos == std::string::npos) cl_pos = headers.find("content-length:");
-      if (cl_pos != std::string::npos) {
-        size_t val_start = cl_pos + 15;
-        while (val_start < headers.size() && (headers[val_start] == ' ' || headers[val_start] == ':')) val_start++;
-        size_t val_end = headers.find_first_of("\r\n", val_start);
-        if (val_end != std::string::npos) {
-          try { content_len = std::stoul(headers.substr(val_start, val_end - val_start)); } catch (...) {}
-        }
-      }
+  // Returns on error, receive timeout or end of stream; ReceiveLoop reconnects
+  while (stream->is_running) {
+    ThreadPolicy::Instance().Apply(ThreadRole::kNetwork);
 
-      size_t jpeg_offset = headers_end + 4;
+    DWORD bytesAvailable = 0;
+    if (!WinHttpQueryDataAvailable(request, &bytesAvailable)) {
+      if (!stream->is_running) break;
+      OutputDebugStringA("[NativeVideoHandler] WinHttpQueryDataAvailable failed\n");
+      break;
+    }
 
-      if (content_len == 0) {
-        size_t next_boundary = acc_str.find(boundaryMarker, jpeg_offset);
-        if (next_boundary != std::string::npos) {
-          size_t jpeg_end = next_boundary;
-          while (jpeg_end > jpeg_offset && (acc_str[jpeg_end - 1] == '\n' || acc_str[jpeg_end - 1] == '\r')) jpeg_end--;
-          content_len = jpeg_end - jpeg_offset;
-        } else {
-          break;
-        }
-      }
+    if (bytesAvailable == 0) {
+      // Server closed the response
+      OutputDebugStringA("[NativeVideoHandler] HTTP stream ended\n");
+      break;
+    }
 
-      if (jpeg_offset + content_len > accumulator.size()) break;
-
-      if (content_len > 0 && stream->is_running) {
-        if (DecodeJpeg(stream, &accumulator[jpeg_offset], content_len)) {
-          if (texture_registrar_ && stream->texture_id >= 0) {
-            texture_registrar_->MarkTextureFrameAvailable(stream->texture_id);
-          }
-          ++stream->frame_count;
-
-          // Set cam_idx from URL
-          if (stream->current_cam_idx.empty()) {
-            size_t cam_pos = stream->stream_address.find("cam=");
-            if (cam_pos != std::string::npos) {
-              size_t val_start = cam_pos + 4;
-              size_t val_end = stream->stream_address.find_first_of("&# ", val_start);
-              if (val_end == std::string::npos) val_end = stream->stream_address.size();
-              stream->current_cam_idx = stream->stream_address.substr(val_start, val_end - val_start);
-            }
-          }
-        }
-      }
+    // Read straight into the parser's buffer
+    DWORD bytesToRead = (std::min)(bytesAvailable, kHttpReadChunkBytes);
+    uint8_t* dst = parser.PrepareWrite(bytesToRead);
+    DWORD bytesRead = 0;
 
-      size_t remove_len = jpeg_offset + content_len;
-      while (remove_len < accumulator.size() && (accumulator[remove_len] == '\r' || accumulator[remove_len] == '\n')) remove_len++;
-      accumulator.erase(accumulator.begin(), accumulator.begin() + remove_len);
+    if (!WinHttpReadData(request, dst, bytesToRead, &bytesRead)) {
+      if (!stream->is_running) break;
+      OutputDebugStringA("[NativeVideoHandler] WinHttpReadData failed\n");
+      break;
     }
 
-    if (accumulator.size() > 2 * 1024 * 1024) {
-      accumulator.clear();
+    parser.Commit(bytesRead, on_frame);
+
+    // Backpressure: stop reading (the server then blocks on a full TCP
+    // window) until a decode frees a lane slot
+    while (parser.stalled() && WaitForSpace(stream)) {
+      parser.Resume(on_frame);
     }
   }
 }
 
+std::string NativeVideoHandler::QueryContentType(HINTERNET request) {
+  wchar_t value[256];
+  DWORD size = sizeof(value);
+  if (!WinHttpQueryHeaders(request, WINHTTP_QUERY_CONTENT_TYPE,
+                           WINHTTP_HEADER_NAME_BY_INDEX, value, &size, WINHTTP_NO_HEADER_INDEX)) {
+    return std::string();
+  }
+
+  // Header values are ASCII
+  std::string content_type;
+  for (DWORD i = 0; i < size / sizeof(wchar_t); ++i) {
+    content_type.push_back(static_cast<char>(value[i]));
+  }
+  return content_type;
+}
+
 void NativeVideoHandler::ParseHeader(VideoStream* stream, const uint8_t* data, uint32_t header_len) {
   // Safety check: skip if no data
-  if (data == nullptr || header_len == 0 || header_len > 10000) {
+  if (data == nullptr || header_len == 0 || header_len > kMaxFrameHeaderBytes) {
     return;
   }
 
-  try {
-    std::string json(reinterpret_cast<const char*>(data), header_len);
+  FrameHeader header;
+  if (IsBinaryFrameHeader(data, header_len)) {
+    // Fixed little-endian struct: a handful of loads, nothing to tokenize
+    if (!ParseBinaryFrameHeader(data, header_len, &header)) {
+      if (stream->frame_count == 0) {
+        OutputDebugStringA("[NativeVideoHandler] Invalid binary header\n");
+      }
+      return;
+    }
+  } else {
+    std::string_view json(reinterpret_cast<const char*>(data), header_len);
 
     // Debug: print first 200 chars of JSON (first frame only)
     if (stream->frame_count == 0) {
       char debug_msg[512];
-      sprintf_s(debug_msg, "[NativeVideoHandler] Raw JSON (len=%u): %.200s\n", header_len, json.c_str());
+      sprintf_s(debug_msg, "[NativeVideoHandler] Raw JSON (len=%u): %.*s\n", header_len,
+                static_cast<int>((std::min)(json.size(), static_cast<size_t>(200))), json.data());
       OutputDebugStringA(debug_msg);
     }
 
-    // Extract inner "header" object from nested structure: {"header": {...}}
-    std::string header_obj = ExtractJsonObject(json, "header");
+    // One pass, no allocations; a malformed header keeps the fields read
+    // before the error
+    if (!ParseFrameHeader(json, &header) && stream->frame_count == 0) {
+      OutputDebugStringA("[NativeVideoHandler] Malformed JSON header\n");
+    }
+  }
 
-    // If no "header" wrapper, use the raw json directly (backwards compatibility)
-    const std::string& header = header_obj.empty() ? json : header_obj;
+  // assign() reuses the strings' capacity, so this doesn't allocate either
+  FrameMeta& meta = stream->meta;
+  meta.cam_idx.assign(header.cam_idx, header.cam_idx_size);
+  meta.cam_num.assign(header.cam_num, header.cam_num_size);
+  meta.brightness = header.brightness;
+  meta.motion = header.motion;
+
+  // Debug: print extracted values (first frame only)
+  if (stream->frame_count == 0) {
+    char debug_msg[512];
+    sprintf_s(debug_msg, "[NativeVideoHandler] Parsed: cam_idx=%.50s, cam_num=%.20s, brightness=%.1f, motion=%d\n",
+              meta.cam_idx.c_str(), meta.cam_num.c_str(), meta.brightness, meta.motion ? 1 : 0);
+    OutputDebugStringA(debug_msg);
+  }
 
-    // Extract header fields
-    stream->current_cam_idx = ExtractJsonString(header, "cam_idx");
-    stream->current_cam_num = ExtractJsonString(header, "cam_num");
-    stream->current_brightness = ExtractJsonDouble(header, "brightness");
-    stream->current_motion = ExtractJsonBool(header, "motion");
+  // Missing bbox clears the previous one
+  meta.bbox_x = header.bbox_x;
+  meta.bbox_y = header.bbox_y;
+  meta.bbox_w = header.bbox_w;
+  meta.bbox_h = header.bbox_h;
 
-    // Debug: print extracted values (first frame only)
-    if (stream->frame_count == 0) {
-      char debug_msg[512];
-      sprintf_s(debug_msg, "[NativeVideoHandler] Parsed: cam_idx=%.50s, cam_num=%.20s, brightness=%.1f, motion=%d\n",
-                stream->current_cam_idx.c_str(), stream->current_cam_num.c_str(),
-                stream->current_brightness, stream->current_motion ? 1 : 0);
-      OutputDebugStringA(debug_msg);
-    }
+  meta.has_sequence = header.has_sequence;
+  meta.sequence = header.sequence;
+  meta.capture_time_us = header.capture_time_us;
+}
 
-    // Extract bbox fields from header object
-    std::string bbox_obj = ExtractJsonObject(header, "bbox");
-    if (!bbox_obj.empty()) {
-      stream->current_bbox_x = ExtractJsonInt(bbox_obj, "x");
-      stream->current_bbox_y = ExtractJsonInt(bbox_obj, "y");
-      stream->current_bbox_w = ExtractJsonInt(bbox_obj, "w");
-      stream->current_bbox_h = ExtractJsonInt(bbox_obj, "h");
-    } else {
-      stream->current_bbox_x = 0;
-      stream->current_bbox_y = 0;
-      stream->current_bbox_w = 0;
-      stream->current_bbox_h = 0;
-    }
-  } catch (...) {
-    // Ignore any parsing errors
-    OutputDebugStringA("[NativeVideoHandler] ParseHeader exception\n");
+bool NativeVideoHandler::DecodeJpeg(VideoStream* stream, tjhandle tj, const uint8_t* jpeg_data,
+                                    size_t jpeg_size, double* brightness) {
+  if (!tj || jpeg_size == 0) {
+    return false;
   }
-}
 
-bool NativeVideoHandler::DecodeJpeg(VideoStream* stream, const uint8_t* jpeg_data, size_t jpeg_size) {
-  if (!stream->tj_handle || jpeg_size == 0) {
+  // Get JPEG header info
+  if (tj3DecompressHeader(tj, jpeg_data, jpeg_size) != 0) {
+    OutputDebugStringA("[NativeVideoHandler] tj3DecompressHeader failed\n");
     return false;
   }
+  int width = tj3Get(tj, TJPARAM_JPEGWIDTH);
+  int height = tj3Get(tj, TJPARAM_JPEGHEIGHT);
+  int subsamp = tj3Get(tj, TJPARAM_SUBSAMP);
 
-  int width, height, subsamp, colorspace;
+  // Zoomed: only the region is decoded (whole frame at zoom 1)
+  double zoom, center_x, center_y;
+  bool follow_bbox;
+  {
+    std::lock_guard<std::mutex> zoom_lock(stream->zoom_mutex);
+    zoom = stream->zoom;
+    center_x = stream->zoom_center_x;
+    center_y = stream->zoom_center_y;
+    follow_bbox = stream->zoom_follow_bbox;
+  }
+  // Auto-follow uses the bbox parsed from this frame's header, if any
+  const FrameMeta& meta = stream->meta;
+  if (follow_bbox && meta.bbox_w > 0 && meta.bbox_h > 0) {
+    double padded_w = meta.bbox_w * (1.0 + 2.0 * kFollowBboxMargin);
+    double padded_h = meta.bbox_h * (1.0 + 2.0 * kFollowBboxMargin);
+    zoom = (std::min)(width / padded_w, height / padded_h);
+    zoom = std::floor(zoom / kFollowZoomStep) * kFollowZoomStep;
+    center_x = (meta.bbox_x + meta.bbox_w / 2.0) / width;
+    center_y = (meta.bbox_y + meta.bbox_h / 2.0) / height;
+  } else if (follow_bbox) {
+    zoom = 1.0;
+  }
+  ZoomRegion region = ComputeZoomRegion(width, height, zoom, center_x, center_y);
+
+  // Decode straight to the displayed size: libjpeg-turbo skips the IDCT and
+  // colour conversion work for the dropped resolution (Huffman decoding
+  // remains, so a quarter-screen 4K tile still costs ~3/4 of a full decode)
+  tjscalingfactor scale = ChooseScalingFactor(region.width, region.height,
+                                              stream->display_width.load(),
+                                              stream->display_height.load());
+  stream->uncapped_scale.store(static_cast<double>(scale.num) / scale.denom, std::memory_order_relaxed);
+  stream->uncapped_frame_bytes.store(static_cast<size_t>(TJSCALED(region.width, scale)) *
+                                         TJSCALED(region.height, scale) * 4,
+                                     std::memory_order_relaxed);
+
+  // Under load the governor caps the scale (1/2, 1/4, 1/8 of the source), and
+  // so does the memory budget
+  int max_denom = (std::max)(stream->quality.max_scale_denom(),
+                             1 << stream->budget_step.load(std::memory_order_relaxed));
+  if (scale.num * max_denom > scale.denom) {
+    scale = {1, max_denom};
+  }
+  stream->decode_scale = static_cast<double>(scale.num) / scale.denom;
+  int scaled_width = TJSCALED(width, scale);
+  int scaled_height = TJSCALED(height, scale);
+
+  // Crop in scaled pixels. The left edge must sit on an iMCU boundary, so the
+  // region shifts left by up to one iMCU instead of changing size; rows above
+  // and below are skipped without being decoded.
+  tjregion crop = TJUNCROPPED;
+  int out_width = scaled_width;
+  int out_height = scaled_height;
+  bool cropped = false;
+  if ((region.width < width || region.height < height) && subsamp >= 0 && subsamp < TJ_NUMSAMP) {
+    cropped = true;
+    int imcu_width = TJSCALED(tjMCUWidth[subsamp], scale);
+    crop.w = (std::min)(TJSCALED(region.width, scale), scaled_width);
+    crop.h = (std::min)(TJSCALED(region.height, scale), scaled_height);
+    crop.x = static_cast<int>(static_cast<int64_t>(region.x) * scale.num / scale.denom);
+    crop.x = (std::min)(crop.x, scaled_width - crop.w);
+    crop.x -= crop.x % imcu_width;
+    crop.y = static_cast<int>(static_cast<int64_t>(region.y) * scale.num / scale.denom);
+    crop.y = (std::min)(crop.y, scaled_height - crop.h);
+    out_width = crop.w;
+    out_height = crop.h;
+  }
 
-  // Get JPEG header info
-  int rc = tjDecompressHeader3(stream->tj_handle, jpeg_data, static_cast<unsigned long>(jpeg_size),
-                                &width, &height, &subsamp, &colorspace);
-  if (rc != 0) {
-    OutputDebugStringA("[NativeVideoHandler] tjDecompressHeader3 failed\n");
+  if (tj3SetScalingFactor(tj, scale) != 0 ||
+      tj3SetCroppingRegion(tj, crop) != 0) {
+    const char* err = tj3GetErrorStr(tj);
+    char msg[256];
+    sprintf_s(msg, "[NativeVideoHandler] scale/crop rejected: %s\n", err ? err : "unknown");
+    OutputDebugStringA(msg);
     return false;
   }
 
-  std::lock_guard<std::mutex> lock(stream->buffer_mutex);
+  // Brightness wanted (opt-in): decode to YUV planes and convert with our own
+  // kernel, which sums the luma in the same pass. This costs more CPU than the
+  // packed decode, so it is only taken when asked for. Zoomed frames keep
+  // libjpeg-turbo's cropped decode, which skips the rows outside the region.
+  YuvImage yuv;
+  bool via_yuv = brightness && !cropped && IsYuvDecodable(tj, subsamp);
+  if (via_yuv && !DecompressToYuv(tj, jpeg_data, jpeg_size, scaled_width, scaled_height,
+                                  subsamp, &yuv)) {
+    return false;
+  }
 
-  // Resize buffer if needed
-  size_t buffer_size = width * height * 4;  // BGRA = 4 bytes per pixel
-  if (stream->bgra_buffer.size() != buffer_size) {
-    stream->bgra_buffer.resize(buffer_size);
-    stream->frame_width = width;
-    stream->frame_height = height;
+  // Large frames: restart intervals that start an MCU row reset the decoder,
+  // so stripes between them decode in parallel into their own rows
+  thread_local std::vector<JpegStripe> stripe_buffers;
+  std::vector<JpegStripe>& stripes = stripe_buffers;  // lambdas see this thread's stripes
+  size_t stripe_count = 0;
+  if (!via_yuv && !cropped && decode_pool_->thread_count() > 1 &&
+      static_cast<int64_t>(scaled_width) * scaled_height >= kParallelDecodeMinPixels) {
+    stripe_count = SplitJpegAtRestarts(jpeg_data, jpeg_size, decode_pool_->thread_count(), &stripes);
+  }
 
-    char msg[128];
-    sprintf_s(msg, "[NativeVideoHandler] Frame size: %dx%d for key: %lld\n",
-              width, height, stream->texture_key);
+  // Decode into the back buffer; the texture keeps showing the last
+  // published frame meanwhile. Each buffer resizes on its own first use.
+  DecodedFrame* frame = stream->frames.back();
+  size_t frame_bytes = static_cast<size_t>(out_width) * out_height * 4;  // RGBA
+  if (frame->pixels.capacity() >= kFrameShrinkRatio * frame_bytes) {
+    frame->pixels.reset();  // a budget or zoom step down gives the large block back
+  }
+  frame->pixels.resize(frame_bytes);
+  stream->frame_bytes.store(frame_bytes, std::memory_order_relaxed);
+  frame->width = out_width;
+  frame->height = out_height;
+  uint8_t* rgba = frame->pixels.data();
+
+  if (stream->frame_width != out_width || stream->frame_height != out_height) {
+    stream->frame_width = out_width;
+    stream->frame_height = out_height;
+
+    char msg[192];
+    sprintf_s(msg, "[NativeVideoHandler] Frame size: %dx%d (decoded %dx%d, %d/%d, zoom %.2f) for key: %lld\n",
+              width, height, out_width, out_height, scale.num, scale.denom,
+              static_cast<double>(width) / region.width, stream->texture_key);
     OutputDebugStringA(msg);
   }
+  stream->source_width = width;
+  stream->source_height = height;
+
+  if (via_yuv) {
+    uint64_t luma = ConvertYuvToRgba(yuv, rgba, static_cast<size_t>(out_width) * 4);
+    *brightness = 100.0 * static_cast<double>(luma) / (255.0 * out_width * out_height);
+    stream->frames.Publish();
+    return true;
+  }
 
-  // Decompress JPEG directly to BGRA (SIMD accelerated, ~1-2ms)
-  rc = tjDecompress2(
-    stream->tj_handle,
-    jpeg_data,
-    static_cast<unsigned long>(jpeg_size),
-    stream->bgra_buffer.data(),
-    width,
-    width * 4,  // pitch (bytes per row)
-    height,
-    TJPF_RGBA,  // Output format: RGBA (Flutter Texture expects RGBA)
-    TJFLAG_FASTDCT  // Use fast DCT for speed
-  );
+  if (stripe_count > 0) {
+    auto start = std::chrono::steady_clock::now();
+    int pitch = out_width * 4;
+    bool decoded = decode_pool_->ParallelFor(
+        stripe_count, tj, [&stripes, rgba, pitch, scale](size_t i, tjhandle stripe_tj) {
+          // Box chroma upsampling: the smooth filter would read across stripe edges
+          const JpegStripe& stripe = stripes[i];
+          uint8_t* rows = rgba + static_cast<size_t>(TJSCALED(stripe.y, scale)) * pitch;
+          tj3Set(stripe_tj, TJPARAM_FASTUPSAMPLE, 1);
+          bool ok = tj3SetScalingFactor(stripe_tj, scale) == 0 &&
+                    tj3SetCroppingRegion(stripe_tj, TJUNCROPPED) == 0 &&
+                    tj3Decompress8(stripe_tj, stripe.jpeg.data(), stripe.jpeg.size(), rows, pitch,
+                                   TJPF_RGBA) == 0;
+          tj3Set(stripe_tj, TJPARAM_FASTUPSAMPLE, 0);
+          return ok;
+        });
+    if (!decoded) {
+      OutputDebugStringA("[NativeVideoHandler] Parallel stripe decode failed\n");
+      return false;
+    }
+
+    if (stream->frame_count < 3) {
+      double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+      char msg[160];
+      sprintf_s(msg, "[NativeVideoHandler] Parallel decode %dx%d: %zu stripes on %zu workers, %.1f ms\n",
+                out_width, out_height, stripe_count, decode_pool_->thread_count(), ms);
+      OutputDebugStringA(msg);
+    }
+    stream->frames.Publish();
+    return true;
+  }
+
+  // Decompress JPEG directly to RGBA (SIMD accelerated, ~1-2ms at full size;
+  // Flutter Texture expects RGBA)
+  int rc = tj3Decompress8(tj, jpeg_data, jpeg_size, rgba, out_width * 4, TJPF_RGBA);
 
   if (rc != 0) {
-    const char* err = tjGetErrorStr2(stream->tj_handle);
+    const char* err = tj3GetErrorStr(tj);
     char msg[256];
-    sprintf_s(msg, "[NativeVideoHandler] tjDecompress2 failed: %s\n", err ? err : "unknown");
+    sprintf_s(msg, "[NativeVideoHandler] tj3Decompress8 failed: %s\n", err ? err : "unknown");
     OutputDebugStringA(msg);
     return false;
   }
 
+  stream->frames.Publish();
   return true;
 }
 
@@ -647,193 +1006,651 @@ std::optional<FlutterError> NativeVideoHandler::StopStream(int64_t texture_key)
   sprintf_s(msg, "[NativeVideoHandler] StopStream called for key: %lld\n", texture_key);
   OutputDebugStringA(msg);
 
-  VideoStream* stream = nullptr;
-  std::thread thread_to_join;
-  StreamType stream_type = StreamType::ZMQ;
+  StopReceiving(texture_key);
+  return std::nullopt;
+}
+
+void NativeVideoHandler::StopReceiving(int64_t texture_key) {
+  std::shared_ptr<VideoStream> stream = streams_.Find(texture_key);
+  if (!stream) {
+    return;  // Already stopped or never started
+  }
+  StopStreams({stream});
+}
+
+void NativeVideoHandler::StopStreams(const std::vector<std::shared_ptr<VideoStream>>& streams) {
+  // Note: This function expects lifecycle_mutex_ to NOT be held by caller
+  // due to thread join / reactor wait requirements
+
+  std::vector<std::thread> threads_to_join;
+  std::vector<int64_t> zmq_keys;
+  std::vector<int64_t> http_keys;
 
   {
-    std::lock_guard<std::mutex> lock(streams_mutex_);
+    std::lock_guard<std::mutex> lock(lifecycle_mutex_);
 
-    auto it = streams_.find(texture_key);
-    if (it == streams_.end()) {
-      return std::nullopt;  // Already stopped or never started
-    }
+    // Signal every stream before waiting for any of them
+    for (const auto& stream : streams) {
+      stream->is_running = false;
+      SignalStop(stream.get());
 
-    stream = it->second.get();
-    stream->is_running = false;
-    stream_type = stream->stream_type;
+      // For HTTPS: close handles FIRST to unblock WinHttp calls (no timeout)
+      if (stream->stream_type == StreamType::HTTP_MJPEG) {
+        StopHttpStream(stream.get());
+      }
 
-    // For HTTP: close handles FIRST to unblock WinHttp calls (no timeout)
-    // For ZMQ: DON'T close yet - it has 100ms timeout, let thread exit naturally
-    if (stream_type == StreamType::HTTP_MJPEG) {
-      StopHttpStream(stream);
-    }
+      if (stream->zmq_subscribed) {
+        zmq_keys.push_back(stream->texture_key);
+        stream->zmq_subscribed = false;
+      }
+      if (stream->http_subscribed) {
+        http_keys.push_back(stream->texture_key);
+        stream->http_subscribed = false;
+      }
 
-    // Move thread out for joining outside the lock
-    if (stream->receive_thread.joinable()) {
-      thread_to_join = std::move(stream->receive_thread);
+      // Move thread out for joining outside the lock
+      if (stream->receive_thread.joinable()) {
+        threads_to_join.push_back(std::move(stream->receive_thread));
+      }
     }
   }
 
-  // Join thread outside of lock to avoid deadlock
-  if (thread_to_join.joinable()) {
-    thread_to_join.join();
+  // ZMQ: returns once the pollers have closed the sockets and the message
+  // handlers can no longer run for these streams; one round trip for all
+  if (!zmq_keys.empty() && zmq_reactor_) {
+    zmq_reactor_->Unsubscribe(zmq_keys);
+  }
+
+  // http://: same guarantee from the HTTP event loop
+  if (!http_keys.empty() && http_client_) {
+    http_client_->Remove(http_keys);
   }
 
+  // Join threads outside of lock to avoid deadlock. All of them are stopping
+  // already, so this waits for the slowest one, not for their sum. Closing the
+  // handles fails a blocked WinHttp call right away; if one doesn't return,
+  // its own timeout (kHttpConnectTimeoutMs / kHttpReceiveTimeoutMs) does.
+  auto join_start = std::chrono::steady_clock::now();
+  for (auto& thread : threads_to_join) {
+    thread.join();
+  }
+  double join_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - join_start).count();
+  if (join_ms >= kSlowStopLogMs) {
+    char msg[128];
+    sprintf_s(msg, "[NativeVideoHandler] StopStreams: %zu receive thread(s) took %.1f ms to stop\n",
+              threads_to_join.size(), join_ms);
+    OutputDebugStringA(msg);
+  }
+
+  // Nothing feeds the lanes any more; wait out decodes in flight. All lanes
+  // stop first, so this waits for one frame per lane side by side.
+  for (const auto& stream : streams) {
+    if (stream->decode_lane) {
+      stream->decode_lane->Cancel();
+    }
+  }
+  for (const auto& stream : streams) {
+    if (stream->decode_lane) {
+      stream->decode_lane->Close();
+    }
+    stream->frames.ReleaseSpare();
+  }
+}
+
+void NativeVideoHandler::CleanupStream(int64_t texture_key) {
+  // Note: This function expects lifecycle_mutex_ to NOT be held by caller
+  StopReceiving(texture_key);
+
   // Cleanup remaining resources
+  std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+  std::shared_ptr<VideoStream> stream = streams_.Find(texture_key);
+  if (stream) {
+    ReleaseStream(stream);
+  }
+}
+
+void NativeVideoHandler::ReleaseStream(const std::shared_ptr<VideoStream>& stream) {
+  DetachFromGrid(stream.get());
+
+  // The lane goes now, while the decode pool is certainly still there
+  std::unique_ptr<DecodeLane> lane;
   {
-    std::lock_guard<std::mutex> lock(streams_mutex_);
+    std::lock_guard<std::mutex> lane_lock(stream->lane_mutex);
+    lane = std::move(stream->decode_lane);
+  }
+  lane.reset();
 
-    auto it = streams_.find(texture_key);
-    if (it != streams_.end()) {
-      stream = it->second.get();
+  // Unregister texture. The stream (texture, frame buffers) is released once
+  // the engine is done with it: a copy may have started before this call.
+  if (stream->texture_id >= 0 && texture_registrar_) {
+    texture_registrar_->UnregisterTexture(stream->texture_id, [stream]() {});
+    stream->texture_id = -1;
+  }
 
-      // Cleanup ZMQ (now safe - thread has exited)
-      if (stream->zmq_socket) {
-        zmq_close(stream->zmq_socket);
-        stream->zmq_socket = nullptr;
-      }
+  stream->source_width = 0;
+  stream->source_height = 0;
+}
 
-      if (stream->zmq_context) {
-        zmq_ctx_destroy(stream->zmq_context);
-        stream->zmq_context = nullptr;
-      }
+ErrorOr<std::optional<FrameInfo>> NativeVideoHandler::GetFrameInfo(int64_t texture_key) {
+  // Dart polls every stream, so this is the budget's clock. A lifecycle call
+  // in progress rebalances by itself; the poll doesn't wait for it.
+  {
+    std::unique_lock<std::mutex> lock(lifecycle_mutex_, std::try_to_lock);
+    if (lock.owns_lock()) {
+      RebalanceMemory(false);
     }
   }
 
-  return std::nullopt;
+  std::shared_ptr<VideoStream> stream = streams_.Find(texture_key);
+  if (!stream) {
+    return std::optional<FrameInfo>(std::nullopt);
+  }
+
+  FrameInfo info(stream->frame_count.load());
+  info.set_dropped_frames(stream->dropped_frames.load());
+  info.set_received_frames(stream->received_frames.load());
+  info.set_displayed_frames(stream->displayed_frames.load());
+  info.set_quality_step(stream->quality.step());
+  info.set_budget_step(stream->budget_step.load(std::memory_order_relaxed));
+  info.set_stream_state(static_cast<int64_t>(stream->health.state()));
+  info.set_reconnect_count(stream->health.reconnect_count());
+
+  // Set resolution (as sent by the camera, not the scaled decode size)
+  int source_width = stream->source_width;
+  int source_height = stream->source_height;
+  if (source_width > 0 && source_height > 0) {
+    info.set_width(source_width);
+    info.set_height(source_height);
+  }
+
+  // Header fields of the last decoded frame, all from the same frame
+  std::lock_guard<std::mutex> meta_lock(stream->meta_mutex);
+  const FrameMeta& meta = stream->published_meta;
+  info.set_cam_idx(meta.cam_idx);
+  info.set_cam_num(meta.cam_num);
+  info.set_brightness(meta.brightness);
+  info.set_motion(meta.motion);
+
+  // Set bbox if available
+  if (meta.bbox_w > 0 && meta.bbox_h > 0) {
+    info.set_bbox_x(meta.bbox_x);
+    info.set_bbox_y(meta.bbox_y);
+    info.set_bbox_w(meta.bbox_w);
+    info.set_bbox_h(meta.bbox_h);
+  }
+
+  // Binary header publishers only
+  if (meta.has_sequence) {
+    info.set_frame_sequence(static_cast<int64_t>(meta.sequence));
+    info.set_capture_time_us(meta.capture_time_us);
+  }
+
+  return std::optional<FrameInfo>(info);
 }
 
-void NativeVideoHandler::CleanupStream(int64_t texture_key) {
-  // Note: This function expects streams_mutex_ to NOT be held by caller
-  // due to thread join requirements
+std::optional<FlutterError> NativeVideoHandler::Dispose(int64_t texture_key) {
+  char msg[128];
+  sprintf_s(msg, "[NativeVideoHandler] Dispose called for key: %lld\n", texture_key);
+  OutputDebugStringA(msg);
 
-  VideoStream* stream = nullptr;
-  std::thread thread_to_join;
-  StreamType stream_type = StreamType::ZMQ;
+  // CleanupStream manages its own locking
+  CleanupStream(texture_key);
 
+  // Erase the stream; its buffers go back to the pool once the engine and
+  // any reader holding it let go
+  bool last_stream = false;
   {
-    std::lock_guard<std::mutex> lock(streams_mutex_);
-    auto it = streams_.find(texture_key);
-    if (it == streams_.end()) {
-      return;
-    }
+    std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+    streams_.Remove(texture_key);
+    last_stream = streams_.empty();
 
-    stream = it->second.get();
-    stream->is_running = false;
-    stream_type = stream->stream_type;
+    // The room it held goes to the streams the budget stepped down
+    RebalanceMemory(true);
+  }
+
+  // No camera left: nothing will reuse the cached blocks soon
+  if (last_stream) {
+    TrimBufferPool();
+  }
+
+  return std::nullopt;
+}
+
+std::optional<FlutterError> NativeVideoHandler::StopAll() {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::shared_ptr<VideoStream>> streams = AllStreams();
+  StopStreams(streams);
 
-    // For HTTP: close handles FIRST to unblock WinHttp calls (no timeout)
-    // For ZMQ: DON'T close yet - it has 100ms timeout, let thread exit naturally
-    if (stream_type == StreamType::HTTP_MJPEG) {
-      StopHttpStream(stream);
+  char msg[128];
+  sprintf_s(msg, "[NativeVideoHandler] StopAll: %zu stream(s) in %.1f ms\n", streams.size(),
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+  OutputDebugStringA(msg);
+  return std::nullopt;
+}
+
+std::optional<FlutterError> NativeVideoHandler::DisposeAll() {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::shared_ptr<VideoStream>> streams = AllStreams();
+  StopStreams(streams);
+
+  {
+    std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+    for (auto& pair : streams_.Clear()) {
+      ReleaseStream(pair.second);
     }
 
-    // Move thread out for joining outside the lock
-    if (stream->receive_thread.joinable()) {
-      thread_to_join = std::move(stream->receive_thread);
+    // Every cell is empty now
+    for (auto& pair : grids_) {
+      if (texture_registrar_) {
+        texture_registrar_->UnregisterTexture(pair.second->texture_id, [grid = pair.second]() {});
+      }
     }
+    grids_.clear();
+    RebalanceMemory(true);
   }
+  TrimBufferPool();
 
-  // Join thread outside of lock to avoid deadlock
-  if (thread_to_join.joinable()) {
-    thread_to_join.join();
+  char msg[128];
+  sprintf_s(msg, "[NativeVideoHandler] DisposeAll: %zu stream(s) in %.1f ms\n", streams.size(),
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+  OutputDebugStringA(msg);
+  return std::nullopt;
+}
+
+std::vector<std::shared_ptr<VideoStream>> NativeVideoHandler::AllStreams() const {
+  std::vector<std::shared_ptr<VideoStream>> streams;
+  for (auto& pair : *streams_.Snapshot()) {
+    streams.push_back(pair.second);
+  }
+  return streams;
+}
+
+void NativeVideoHandler::TrimBufferPool() {
+  BufferPool& pool = BufferPool::Instance();
+  pool.Trim(std::chrono::steady_clock::duration::zero());
+  BufferPool::Stats stats = pool.stats();
+
+  char msg[128];
+  sprintf_s(msg, "[NativeVideoHandler] Buffer pool trimmed: %zu KB left, peak %zu KB\n",
+            stats.allocated_bytes / 1024, stats.high_water_bytes / 1024);
+  OutputDebugStringA(msg);
+}
+
+std::optional<FlutterError> NativeVideoHandler::SetLiveMode(int64_t texture_key, bool enabled) {
+  // Lifecycle lock: StartStream replaces the lane and the subscription
+  std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+
+  std::shared_ptr<VideoStream> stream = streams_.Find(texture_key);
+  if (!stream) {
+    return FlutterError("not_initialized", "Stream not initialized. Call Initialize first.");
+  }
+
+  stream->live_mode = enabled;
+  if (stream->decode_lane) {
+    stream->decode_lane->set_latest_only(enabled);
+    stream->decode_lane->set_paced(enabled, PacingDeadline());
+  }
+
+  // Running ZMQ streams switch on the poller's next wakeup; otherwise the
+  // policy is picked up by StartStream. That wakeup also offers a frame held
+  // back for lane space again, which live mode now drops if need be.
+  if (stream->zmq_subscribed && zmq_reactor_) {
+    zmq_reactor_->SetPolicy(texture_key,
+                            enabled ? IngestPolicy::kLatestOnly : IngestPolicy::kEveryFrame);
+  }
+  if (enabled && stream->http_subscribed && http_client_) {
+    http_client_->Resume(texture_key);
+  } else if (enabled && stream->receive_thread.joinable()) {
+    SignalSpace(stream.get());
+  }
+
+  char msg[128];
+  sprintf_s(msg, "[NativeVideoHandler] Live mode %s for key: %lld\n", enabled ? "on" : "off",
+            texture_key);
+  OutputDebugStringA(msg);
+  return std::nullopt;
+}
+
+std::optional<FlutterError> NativeVideoHandler::SetDisplaySize(int64_t texture_key, int64_t width,
+                                                               int64_t height) {
+  std::shared_ptr<VideoStream> stream = streams_.Find(texture_key);
+  if (!stream) {
+    return FlutterError("not_initialized", "Stream not initialized. Call Initialize first.");
+  }
+
+  // Takes effect on the next decoded frame
+  stream->display_width = static_cast<int>((std::max)(width, int64_t{0}));
+  stream->display_height = static_cast<int>((std::max)(height, int64_t{0}));
+  return std::nullopt;
+}
+
+std::optional<FlutterError> NativeVideoHandler::SetZoom(int64_t texture_key, double zoom,
+                                                        double center_x, double center_y) {
+  std::shared_ptr<VideoStream> stream = streams_.Find(texture_key);
+  if (!stream) {
+    return FlutterError("not_initialized", "Stream not initialized. Call Initialize first.");
+  }
+
+  // Clamped into the frame at decode time; takes effect on the next frame
+  std::lock_guard<std::mutex> zoom_lock(stream->zoom_mutex);
+  stream->zoom = (std::min)((std::max)(zoom, 1.0), kMaxZoom);
+  stream->zoom_center_x = (std::min)((std::max)(center_x, 0.0), 1.0);
+  stream->zoom_center_y = (std::min)((std::max)(center_y, 0.0), 1.0);
+  return std::nullopt;
+}
+
+std::optional<FlutterError> NativeVideoHandler::SetZoomFollowBbox(int64_t texture_key, bool enabled) {
+  std::shared_ptr<VideoStream> stream = streams_.Find(texture_key);
+  if (!stream) {
+    return FlutterError("not_initialized", "Stream not initialized. Call Initialize first.");
   }
 
-  // Cleanup remaining resources
   {
-    std::lock_guard<std::mutex> lock(streams_mutex_);
-    auto it = streams_.find(texture_key);
-    if (it == streams_.end()) {
-      return;
-    }
+    std::lock_guard<std::mutex> zoom_lock(stream->zoom_mutex);
+    stream->zoom_follow_bbox = enabled;
+  }
 
-    stream = it->second.get();
+  char msg[128];
+  sprintf_s(msg, "[NativeVideoHandler] Bbox follow %s for key: %lld\n", enabled ? "on" : "off",
+            texture_key);
+  OutputDebugStringA(msg);
+  return std::nullopt;
+}
+
+std::optional<FlutterError> NativeVideoHandler::SetMeasureBrightness(int64_t texture_key, bool enabled) {
+  std::shared_ptr<VideoStream> stream = streams_.Find(texture_key);
+  if (!stream) {
+    return FlutterError("not_initialized", "Stream not initialized. Call Initialize first.");
+  }
 
-    // Clean up ZMQ (now safe - thread has exited)
-    if (stream->zmq_socket) {
-      zmq_close(stream->zmq_socket);
-      stream->zmq_socket = nullptr;
+  stream->measure_brightness = enabled;
+
+  char msg[128];
+  sprintf_s(msg, "[NativeVideoHandler] Brightness measure %s for key: %lld\n", enabled ? "on" : "off",
+            texture_key);
+  OutputDebugStringA(msg);
+  return std::nullopt;
+}
+
+ErrorOr<int64_t> NativeVideoHandler::InitializeGrid(int64_t grid_key) {
+  std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+
+  auto it = grids_.find(grid_key);
+  if (it != grids_.end()) {
+    return it->second->texture_id;
+  }
+  if (!texture_registrar_) {
+    return FlutterError("no_registrar", "Texture registrar not available");
+  }
+
+  auto grid = std::make_shared<VideoGrid>();
+  grid->grid_key = grid_key;
+
+  // One callback for every stream in the grid: only cells with a new frame
+  // are copied into the image
+  VideoGrid* grid_ptr = grid.get();
+  grid->texture = std::make_unique<flutter::TextureVariant>(
+    flutter::PixelBufferTexture(
+      [grid_ptr](size_t width, size_t height) -> const FlutterDesktopPixelBuffer* {
+        ThreadPolicy::Instance().Apply(ThreadRole::kDisplay);
+        const DecodedFrame* image = grid_ptr->compositor.Compose();
+        if (!image) {
+          return nullptr;
+        }
+
+        FlutterDesktopPixelBuffer& buffer = grid_ptr->pixel_buffer;
+        buffer.buffer = image->pixels.data();
+        buffer.width = static_cast<size_t>(image->width);
+        buffer.height = static_cast<size_t>(image->height);
+        return &buffer;
+      }));
+  grid->texture_id = texture_registrar_->RegisterTexture(grid->texture.get());
+
+  char msg[128];
+  sprintf_s(msg, "[NativeVideoHandler] Grid texture registered with ID: %lld for grid: %lld\n",
+            grid->texture_id, grid_key);
+  OutputDebugStringA(msg);
+
+  int64_t texture_id = grid->texture_id;
+  grids_[grid_key] = std::move(grid);
+  return texture_id;
+}
+
+std::optional<FlutterError> NativeVideoHandler::SetGridLayout(int64_t grid_key, int64_t columns, int64_t rows,
+                                                              int64_t cell_width, int64_t cell_height) {
+  std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+
+  auto it = grids_.find(grid_key);
+  if (it == grids_.end()) {
+    return FlutterError("not_initialized", "Grid not initialized. Call InitializeGrid first.");
+  }
+
+  VideoGrid* grid = it->second.get();
+  if (columns > kMaxGridCells || rows > kMaxGridCells ||
+      !grid->compositor.SetLayout(static_cast<int>(columns), static_cast<int>(rows),
+                                  static_cast<int>((std::min)(cell_width, int64_t{1} << 20)),
+                                  static_cast<int>((std::min)(cell_height, int64_t{1} << 20)))) {
+    return FlutterError("invalid_argument", "Grid layout out of range");
+  }
+  grid->compositor.RequestCompose();
+  texture_registrar_->MarkTextureFrameAvailable(grid->texture_id);
+
+  char msg[128];
+  sprintf_s(msg, "[NativeVideoHandler] Grid %lld layout: %lldx%lld cells of %lldx%lld\n", grid_key,
+            columns, rows, cell_width, cell_height);
+  OutputDebugStringA(msg);
+  return std::nullopt;
+}
+
+std::optional<FlutterError> NativeVideoHandler::SetGridCell(int64_t grid_key, int64_t cell, int64_t texture_key) {
+  std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+
+  auto grid_it = grids_.find(grid_key);
+  if (grid_it == grids_.end()) {
+    return FlutterError("not_initialized", "Grid not initialized. Call InitializeGrid first.");
+  }
+  const std::shared_ptr<VideoGrid>& grid = grid_it->second;
+  if (cell < 0 || cell >= kMaxGridCells) {
+    return FlutterError("invalid_argument", "Grid cell out of range");
+  }
+
+  // Streams can only be removed under the lifecycle lock, so raw pointers
+  // stay valid here; the compositor's callback holds the stream weakly
+  std::shared_ptr<const StreamRegistry<VideoStream>::Map> streams = streams_.Snapshot();
+  std::weak_ptr<VideoStream> weak_stream;
+  VideoStream* stream = nullptr;
+  if (texture_key >= 0) {
+    auto it = streams->find(texture_key);
+    if (it == streams->end()) {
+      return FlutterError("not_initialized", "Stream not initialized. Call Initialize first.");
     }
+    stream = it->second.get();
+    weak_stream = it->second;
+  }
 
-    if (stream->zmq_context) {
-      zmq_ctx_destroy(stream->zmq_context);
-      stream->zmq_context = nullptr;
+  // The cell's current stream goes back to its own texture
+  for (auto& pair : *streams) {
+    VideoStream* shown = pair.second.get();
+    if (shown != stream && shown->grid == grid && shown->grid_cell == cell) {
+      DetachFromGrid(shown);
     }
+  }
 
-    // Unregister texture
-    if (stream->texture_id >= 0 && texture_registrar_) {
-      texture_registrar_->UnregisterTexture(stream->texture_id);
-      stream->texture_id = -1;
+  if (stream) {
+    if (stream->grid != grid) {
+      DetachFromGrid(stream);
     }
+    grid->compositor.SetCell(static_cast<int>(cell), &stream->frames,
+                             [weak_stream]() {
+                               if (std::shared_ptr<VideoStream> shown = weak_stream.lock()) {
+                                 OnFrameShown(shown.get());
+                               }
+                             });
+    stream->grid_cell = static_cast<int>(cell);
+    std::atomic_store(&stream->grid, grid);
+  } else {
+    grid->compositor.SetCell(static_cast<int>(cell), nullptr, nullptr);
+  }
+  grid->compositor.RequestCompose();
+  texture_registrar_->MarkTextureFrameAvailable(grid->texture_id);
+  return std::nullopt;
+}
 
-    stream->texture.reset();
+std::optional<FlutterError> NativeVideoHandler::DisposeGrid(int64_t grid_key) {
+  char msg[128];
+  sprintf_s(msg, "[NativeVideoHandler] DisposeGrid called for grid: %lld\n", grid_key);
+  OutputDebugStringA(msg);
 
-    // Destroy TurboJPEG handle
-    if (stream->tj_handle) {
-      tjDestroy(stream->tj_handle);
-      stream->tj_handle = nullptr;
-    }
+  std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+  auto it = grids_.find(grid_key);
+  if (it == grids_.end()) {
+    return std::nullopt;
+  }
 
-    {
-      std::lock_guard<std::mutex> buffer_lock(stream->buffer_mutex);
-      stream->bgra_buffer.clear();
-      stream->frame_width = 0;
-      stream->frame_height = 0;
+  for (auto& pair : *streams_.Snapshot()) {
+    if (pair.second->grid == it->second) {
+      DetachFromGrid(pair.second.get());
     }
   }
+
+  // A decode worker may still hold the grid for one more (harmless) signal;
+  // the engine holds it until its last compose is done
+  if (texture_registrar_) {
+    texture_registrar_->UnregisterTexture(it->second->texture_id, [grid = it->second]() {});
+  }
+  grids_.erase(it);
+  return std::nullopt;
 }
 
-ErrorOr<std::optional<FrameInfo>> NativeVideoHandler::GetFrameInfo(int64_t texture_key) {
-  std::lock_guard<std::mutex> lock(streams_mutex_);
+void NativeVideoHandler::DetachFromGrid(VideoStream* stream) {
+  if (!stream->grid) return;
 
-  auto it = streams_.find(texture_key);
-  if (it == streams_.end()) {
-    return std::optional<FrameInfo>(std::nullopt);
+  stream->grid->compositor.RemoveSource(&stream->frames);
+  stream->grid->compositor.RequestCompose();
+  if (texture_registrar_) {
+    texture_registrar_->MarkTextureFrameAvailable(stream->grid->texture_id);
   }
+  std::atomic_store(&stream->grid, std::shared_ptr<VideoGrid>());
+  stream->grid_cell = -1;
 
-  VideoStream* stream = it->second.get();
+  // Its own texture shows the newest frame again
+  if (texture_registrar_ && stream->texture_id >= 0) {
+    texture_registrar_->MarkTextureFrameAvailable(stream->texture_id);
+  }
+}
 
-  FrameInfo info(stream->frame_count);
-  info.set_cam_idx(stream->current_cam_idx);
-  info.set_cam_num(stream->current_cam_num);
-  info.set_brightness(stream->current_brightness);
-  info.set_motion(stream->current_motion);
+void NativeVideoHandler::RebalanceMemory(bool force) {
+  auto now = std::chrono::steady_clock::now();
+  if (!force && now - last_rebalance_ < kMemoryRebalanceInterval) return;
+  last_rebalance_ = now;
 
-  // Set resolution
-  if (stream->frame_width > 0 && stream->frame_height > 0) {
-    info.set_width(stream->frame_width);
-    info.set_height(stream->frame_height);
+  // Stopped streams keep only the frame on screen; grid images can't shrink
+  size_t other_bytes = 0;
+  for (auto& pair : grids_) {
+    other_bytes += pair.second->compositor.image_bytes();
   }
 
-  // Set bbox if available
-  if (stream->current_bbox_w > 0 && stream->current_bbox_h > 0) {
-    info.set_bbox_x(stream->current_bbox_x);
-    info.set_bbox_y(stream->current_bbox_y);
-    info.set_bbox_w(stream->current_bbox_w);
-    info.set_bbox_h(stream->current_bbox_h);
+  // Later cameras first among equally important ones
+  std::shared_ptr<const StreamRegistry<VideoStream>::Map> streams = streams_.Snapshot();
+  std::vector<MemoryBudget::Stream> budgeted;
+  std::vector<VideoStream*> running;
+  for (auto it = streams->rbegin(); it != streams->rend(); ++it) {
+    VideoStream* stream = it->second.get();
+    if (!stream->is_running) {
+      other_bytes += stream->frame_bytes.load(std::memory_order_relaxed);
+      continue;
+    }
+
+    MemoryBudget::Stream entry;
+    entry.importance = static_cast<int64_t>(stream->display_width.load()) * stream->display_height.load();
+    entry.frame_bytes = stream->uncapped_frame_bytes.load(std::memory_order_relaxed) * FrameStore::kFrameCount;
+    entry.uncapped_scale = stream->uncapped_scale.load(std::memory_order_relaxed);
+    entry.min_step = stream->quality.step();
+    // Lane slots plus the MJPEG parser's buffer
+    entry.fixed_bytes = stream->jpeg_bytes.load(std::memory_order_relaxed) * (DecodeLane::kCapacity + 1);
+    entry.step = stream->budget_step.load(std::memory_order_relaxed);
+    budgeted.push_back(entry);
+    running.push_back(stream);
+  }
+  memory_estimate_ = memory_budget_.Rebalance(other_bytes, budgeted);
+
+  for (size_t i = 0; i < running.size(); ++i) {
+    int step = running[i]->budget_step.exchange(budgeted[i].step, std::memory_order_relaxed);
+    if (step != budgeted[i].step) {
+      char msg[160];
+      sprintf_s(msg, "[NativeVideoHandler] Budget step %d -> %d for key: %lld (estimate %zu of %zu KB)\n",
+                step, budgeted[i].step, running[i]->texture_key, memory_estimate_ / 1024,
+                memory_budget_.budget() / 1024);
+      OutputDebugStringA(msg);
+    }
   }
 
-  return std::optional<FrameInfo>(info);
+  // Over budget: blocks cached for reuse are the first to go
+  size_t budget = memory_budget_.budget();
+  if (budget > 0 && BufferPool::Instance().stats().allocated_bytes > budget) {
+    BufferPool::Instance().Trim(std::chrono::steady_clock::duration::zero());
+  }
 }
 
-std::optional<FlutterError> NativeVideoHandler::Dispose(int64_t texture_key) {
+std::optional<FlutterError> NativeVideoHandler::SetMemoryBudget(int64_t bytes) {
+  if (bytes < 0) {
+    return FlutterError("invalid_argument", "Memory budget must not be negative");
+  }
+
+  std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+  memory_budget_.set_budget(static_cast<size_t>(bytes));
+  RebalanceMemory(true);
+
   char msg[128];
-  sprintf_s(msg, "[NativeVideoHandler] Dispose called for key: %lld\n", texture_key);
+  sprintf_s(msg, "[NativeVideoHandler] Memory budget: %lld KB\n", bytes / 1024);
   OutputDebugStringA(msg);
+  return std::nullopt;
+}
 
-  // CleanupStream manages its own locking
-  CleanupStream(texture_key);
+ErrorOr<MemoryStats> NativeVideoHandler::GetMemoryStats() {
+  std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+  RebalanceMemory(false);
 
-  // Erase the stream
-  {
-    std::lock_guard<std::mutex> lock(streams_mutex_);
-    auto it = streams_.find(texture_key);
-    if (it != streams_.end()) {
-      streams_.erase(it);
+  int64_t downscaled = 0;
+  for (auto& pair : *streams_.Snapshot()) {
+    if (pair.second->budget_step.load(std::memory_order_relaxed) > 0) {
+      ++downscaled;
     }
   }
 
+  BufferPool::Stats pool = BufferPool::Instance().stats();
+  return MemoryStats(static_cast<int64_t>(memory_budget_.budget()),
+                     static_cast<int64_t>(pool.allocated_bytes - pool.cached_bytes),
+                     static_cast<int64_t>(memory_estimate_), static_cast<int64_t>(pool.cached_bytes),
+                     static_cast<int64_t>(pool.high_water_bytes), downscaled);
+}
+
+std::optional<FlutterError> NativeVideoHandler::SetThreadPolicy(int64_t role, int64_t core_mask,
+                                                                int64_t priority) {
+  if (role < 0 || role >= kThreadRoleCount) {
+    return FlutterError("invalid_argument", "Unknown thread role");
+  }
+  if (priority < static_cast<int64_t>(ThreadPriority::kUnchanged) ||
+      priority > static_cast<int64_t>(ThreadPriority::kHighest)) {
+    return FlutterError("invalid_argument", "Unknown thread priority");
+  }
+
+  ThreadPolicy::Rule rule;
+  rule.core_mask = static_cast<uint64_t>(core_mask);
+  rule.priority = static_cast<ThreadPriority>(priority);
+  ThreadRole thread_role = static_cast<ThreadRole>(role);
+  if (!ThreadPolicy::Instance().Set(thread_role, rule)) {
+    return FlutterError("invalid_argument", "No usable core in the mask");
+  }
+
+  // Host API calls run on the platform thread; the other roles pick the
+  // change up in their own loops
+  bool applied = thread_role != ThreadRole::kUi || ThreadPolicy::Instance().Apply(thread_role);
+
+  char msg[160];
+  sprintf_s(msg, "[NativeVideoHandler] Thread policy for role %lld: cores 0x%llx, priority %lld%s\n", role,
+            static_cast<unsigned long long>(core_mask), priority, applied ? "" : " (refused by the OS)");
+  OutputDebugStringA(msg);
   return std::nullopt;
 }
 
@@ -889,8 +1706,20 @@ bool NativeVideoHandler::StartHttpStream(VideoStream* stream, const std::string&
     wpath.push_back(static_cast<wchar_t>(static_cast<unsigned char>(c)));
   }
 
+  // Each handle is published to the stream as soon as it exists, so a
+  // concurrent stop can close it and abort the blocking calls below
+  auto publish = [stream](HINTERNET* slot, HINTERNET handle) {
+    std::lock_guard<std::mutex> lock(stream->http_mutex);
+    if (!stream->is_running) {
+      WinHttpCloseHandle(handle);
+      return false;
+    }
+    *slot = handle;
+    return true;
+  };
+
   // Create session
-  stream->http_session = WinHttpOpen(
+  HINTERNET session = WinHttpOpen(
     L"iScan_Live_Viewer/1.0",
     WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
     WINHTTP_NO_PROXY_NAME,
@@ -898,35 +1727,43 @@ bool NativeVideoHandler::StartHttpStream(VideoStream* stream, const std::string&
     0
   );
 
-  if (!stream->http_session) {
+  if (!session) {
     OutputDebugStringA("[NativeVideoHandler] WinHttpOpen failed\n");
     return false;
   }
+  if (!publish(&stream->http_session, session)) {
+    return false;
+  }
 
-  // Set timeouts: resolve=5s, connect=5s, send=5s, receive=30s (streaming)
-  WinHttpSetTimeouts(stream->http_session, 5000, 5000, 5000, 30000);
+  // A silent server fails the read after the receive timeout and is
+  // reconnected. These also bound how long StopStreams can wait for this thread.
+  WinHttpSetTimeouts(session, kHttpConnectTimeoutMs, kHttpConnectTimeoutMs, kHttpConnectTimeoutMs,
+                     kHttpReceiveTimeoutMs);
 
   // Connect
-  stream->http_connection = WinHttpConnect(
-    stream->http_session,
+  HINTERNET connection = WinHttpConnect(
+    session,
     whost.c_str(),
     static_cast<INTERNET_PORT>(port),
     0
   );
 
-  if (!stream->http_connection) {
+  if (!connection) {
     DWORD err = GetLastError();
     sprintf_s(dbg, "[NativeVideoHandler] WinHttpConnect failed: %lu\n", err);
     OutputDebugStringA(dbg);
-    WinHttpCloseHandle(stream->http_session);
-    stream->http_session = nullptr;
+    StopHttpStream(stream);
+    return false;
+  }
+  if (!publish(&stream->http_connection, connection)) {
+    StopHttpStream(stream);
     return false;
   }
 
   // Open request
   DWORD flags = is_https ? WINHTTP_FLAG_SECURE : 0;
-  stream->http_request = WinHttpOpenRequest(
-    stream->http_connection,
+  HINTERNET request = WinHttpOpenRequest(
+    connection,
     L"GET",
     wpath.c_str(),
     NULL,
@@ -935,61 +1772,47 @@ bool NativeVideoHandler::StartHttpStream(VideoStream* stream, const std::string&
     flags
   );
 
-  if (!stream->http_request) {
+  if (!request) {
     DWORD err = GetLastError();
     sprintf_s(dbg, "[NativeVideoHandler] WinHttpOpenRequest failed: %lu\n", err);
     OutputDebugStringA(dbg);
-    WinHttpCloseHandle(stream->http_connection);
-    WinHttpCloseHandle(stream->http_session);
-    stream->http_connection = nullptr;
-    stream->http_session = nullptr;
+    StopHttpStream(stream);
+    return false;
+  }
+  if (!publish(&stream->http_request, request)) {
+    StopHttpStream(stream);
     return false;
   }
 
   // Send request
-  if (!WinHttpSendRequest(stream->http_request, WINHTTP_NO_ADDITIONAL_HEADERS, 0, WINHTTP_NO_REQUEST_DATA, 0, 0, 0)) {
+  if (!WinHttpSendRequest(request, WINHTTP_NO_ADDITIONAL_HEADERS, 0, WINHTTP_NO_REQUEST_DATA, 0, 0, 0)) {
     DWORD err = GetLastError();
     sprintf_s(dbg, "[NativeVideoHandler] WinHttpSendRequest failed: %lu\n", err);
     OutputDebugStringA(dbg);
-    WinHttpCloseHandle(stream->http_request);
-    WinHttpCloseHandle(stream->http_connection);
-    WinHttpCloseHandle(stream->http_session);
-    stream->http_request = nullptr;
-    stream->http_connection = nullptr;
-    stream->http_session = nullptr;
+    StopHttpStream(stream);
     return false;
   }
 
   // Receive response
-  if (!WinHttpReceiveResponse(stream->http_request, NULL)) {
+  if (!WinHttpReceiveResponse(request, NULL)) {
     DWORD err = GetLastError();
     sprintf_s(dbg, "[NativeVideoHandler] WinHttpReceiveResponse failed: %lu\n", err);
     OutputDebugStringA(dbg);
-    WinHttpCloseHandle(stream->http_request);
-    WinHttpCloseHandle(stream->http_connection);
-    WinHttpCloseHandle(stream->http_session);
-    stream->http_request = nullptr;
-    stream->http_connection = nullptr;
-    stream->http_session = nullptr;
+    StopHttpStream(stream);
     return false;
   }
 
   // Check status code
   DWORD statusCode = 0;
   DWORD statusCodeSize = sizeof(statusCode);
-  WinHttpQueryHeaders(stream->http_request, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER,
+  WinHttpQueryHeaders(request, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER,
                       WINHTTP_HEADER_NAME_BY_INDEX, &statusCode, &statusCodeSize, WINHTTP_NO_HEADER_INDEX);
 
   sprintf_s(dbg, "[NativeVideoHandler] HTTP status: %lu\n", statusCode);
   OutputDebugStringA(dbg);
 
   if (statusCode != 200) {
-    WinHttpCloseHandle(stream->http_request);
-    WinHttpCloseHandle(stream->http_connection);
-    WinHttpCloseHandle(stream->http_session);
-    stream->http_request = nullptr;
-    stream->http_connection = nullptr;
-    stream->http_session = nullptr;
+    StopHttpStream(stream);
     return false;
   }
 
@@ -998,6 +1821,7 @@ bool NativeVideoHandler::StartHttpStream(VideoStream* stream, const std::string&
 }
 
 void NativeVideoHandler::StopHttpStream(VideoStream* stream) {
+  std::lock_guard<std::mutex> lock(stream->http_mutex);
   if (stream->http_request) {
     WinHttpCloseHandle(stream->http_request);
     stream->http_request = nullptr;
@@ -1011,3 +1835,30 @@ void NativeVideoHandler::StopHttpStream(VideoStream* stream) {
     stream->http_session = nullptr;
   }
 }
+
+bool NativeVideoHandler::WaitForReconnect(VideoStream* stream, int delay_ms) {
+  std::unique_lock<std::mutex> lock(stream->stop_mutex);
+  return !stream->stop_cv.wait_for(lock, std::chrono::milliseconds(delay_ms),
+                                   [stream]() { return !stream->is_running; });
+}
+
+bool NativeVideoHandler::WaitForSpace(VideoStream* stream) {
+  std::unique_lock<std::mutex> lock(stream->stop_mutex);
+  stream->stop_cv.wait(lock, [stream]() { return !stream->is_running || stream->space_ready; });
+  stream->space_ready = false;
+  return stream->is_running;
+}
+
+void NativeVideoHandler::SignalSpace(VideoStream* stream) {
+  {
+    std::lock_guard<std::mutex> lock(stream->stop_mutex);
+    stream->space_ready = true;
+  }
+  stream->stop_cv.notify_all();
+}
+
+void NativeVideoHandler::SignalStop(VideoStream* stream) {
+  // Taking the mutex orders the notify after a waiter's predicate check
+  { std::lock_guard<std::mutex> lock(stream->stop_mutex); }
+  stream->stop_cv.notify_all();
+}
@@ -1,14 +1,22 @@
 #pragma once
 
+#include "frame_store.h"
+#include "grid_compositor.h"
+#include "memory_budget.h"
 #include "native_video_api.g.h"
+#include "quality_governor.h"
+#include "stream_health.h"
+#include "stream_registry.h"
 #include <flutter/texture_registrar.h>
 #include <windows.h>
 #include <winhttp.h>
 #include <thread>
 #include <atomic>
+#include <condition_variable>
 #include <mutex>
 #include <vector>
 #include <map>
+#include <memory>
 #include <queue>
 #include <functional>
 
@@ -30,50 +38,141 @@ struct FrameCallbackData {
 
 // Forward declarations for external libraries
 typedef void* tjhandle;
+struct ZmqFrame;
+struct EncodedFrame;
+class ZmqReactor;
+class HttpMjpegClient;
+class DecodeLane;
+class DecodePool;
+
+// Grid compositor texture: several streams shown through one texture
+struct VideoGrid {
+  int64_t grid_key = -1;
+  int64_t texture_id = -1;  // fixed once registered; decode workers read it
+  std::unique_ptr<flutter::TextureVariant> texture;
+  GridCompositor compositor;
+  FlutterDesktopPixelBuffer pixel_buffer = {};  // texture callback only
+};
+
+// Fields of the current frame: from its header, or the URL and measured
+// luma without one
+struct FrameMeta {
+  std::string cam_idx;
+  std::string cam_num;
+  double brightness = 0.0;
+  bool motion = false;
+  int bbox_x = 0;
+  int bbox_y = 0;
+  int bbox_w = 0;
+  int bbox_h = 0;
+
+  // Binary headers only: publisher sequence number and capture time
+  bool has_sequence = false;
+  uint64_t sequence = 0;
+  int64_t capture_time_us = 0;
+};
 
 // Per-stream data structure
 struct VideoStream {
   int64_t texture_key = -1;
   int64_t texture_id = -1;
   std::unique_ptr<flutter::TextureVariant> texture;
-  std::vector<uint8_t> bgra_buffer;
-  int frame_width = 0;
+  // Decoded frames: the decode worker publishes, the texture callback takes
+  // the newest without either side locking
+  FrameStore frames;
+  FlutterDesktopPixelBuffer pixel_buffer = {};  // texture callback only
+  int frame_width = 0;   // last decoded (texture) size, decode worker only
   int frame_height = 0;
+  std::atomic<int> source_width{0};  // JPEG size as sent by the camera
+  std::atomic<int> source_height{0};
+
+  // Physical pixels the texture is shown at (0 = unknown, decode full size)
+  std::atomic<int> display_width{0};
+  std::atomic<int> display_height{0};
+
+  // Grid the stream is shown in instead of its own texture (SetGridCell);
+  // the grid is then the only reader of frames. Decode workers read it with
+  // std::atomic_load; grid_cell is guarded by lifecycle_mutex_.
+  std::shared_ptr<VideoGrid> grid;
+  int grid_cell = -1;
+
+  // Digital zoom: only the zoomed region is decoded (see DecodeJpeg)
+  std::mutex zoom_mutex;
+  double zoom = 1.0;           // 1 = whole frame
+  double zoom_center_x = 0.5;  // region center, normalized to the frame
+  double zoom_center_y = 0.5;
+  bool zoom_follow_bbox = false;  // center/zoom on the header bbox instead
 
   // Stream type and address
   StreamType stream_type = StreamType::ZMQ;
   std::string stream_address;
 
-  // ZMQ handles (per stream)
-  void* zmq_context = nullptr;
-  void* zmq_socket = nullptr;
+  // ZMQ: socket is owned by the shared ZmqReactor while subscribed
+  bool zmq_subscribed = false;
+
+  // Live mode: decode only the newest queued frame, skipping any backlog, and
+  // no faster than the texture is pulled (render-paced)
+  std::atomic<bool> live_mode{false};
 
-  // HTTP handles (per stream)
+  // Headerless frames: measure brightness from the decoded luma. Off by
+  // default; the YUV decode it needs costs more than the packed one.
+  std::atomic<bool> measure_brightness{false};
+
+  // http://: the connection is owned by the shared HttpMjpegClient while subscribed
+  bool http_subscribed = false;
+
+  // https:// (WinHTTP) handles, guarded by http_mutex. The receive thread
+  // publishes them while (re)connecting and reads through a copy taken under
+  // the mutex; StopHttpStream closes them from any thread to abort blocking
+  // WinHttp calls.
+  std::mutex http_mutex;
   HINTERNET http_session = nullptr;
   HINTERNET http_connection = nullptr;
   HINTERNET http_request = nullptr;
 
-  // TurboJPEG handle (per stream for thread safety)
-  tjhandle tj_handle = nullptr;
+  // Hands received frames to the shared decode pool (created by StartStream).
+  // lane_mutex only guards swapping it against the texture callback.
+  std::unique_ptr<DecodeLane> decode_lane;
+  std::mutex lane_mutex;
 
   // Threading
   std::thread receive_thread;
   std::atomic<bool> is_running{false};
-  std::mutex buffer_mutex;
 
-  // Stats
-  int64_t frame_count = 0;
+  // Signalled when is_running drops, to cut reconnect backoff waits short,
+  // and when space_ready is set (a lane slot freed up, https:// only)
+  std::mutex stop_mutex;
+  std::condition_variable stop_cv;
+  bool space_ready = false;  // guarded by stop_mutex
+
+  // Connecting / live / stalled / reconnecting
+  StreamHealth health;
+
+  // Steps the decode scale down when decode can't keep up with the stream
+  QualityGovernor quality;
+  double decode_scale = 1.0;  // libjpeg-turbo scale of the last decode (decode worker)
+
+  // Memory budget (see RebalanceMemory). The decode worker records the last
+  // frame and the decode at the display-chosen scale, before any step caps it.
+  std::atomic<int> budget_step{0};  // caps the decode scale like quality
+  std::atomic<size_t> frame_bytes{0};
+  std::atomic<size_t> uncapped_frame_bytes{0};
+  std::atomic<double> uncapped_scale{1.0};
+  std::atomic<size_t> jpeg_bytes{0};  // last JPEG
+
+  // Stats: received -> decoded (frame_count) -> displayed, minus dropped
+  std::atomic<int64_t> received_frames{0};
+  std::atomic<int64_t> frame_count{0};
+  std::atomic<int64_t> dropped_frames{0};
+  std::atomic<int64_t> displayed_frames{0};
   std::chrono::steady_clock::time_point last_callback_time;
 
-  // Current frame info
-  std::string current_cam_idx;
-  std::string current_cam_num;
-  double current_brightness = 0.0;
-  bool current_motion = false;
-  int current_bbox_x = 0;
-  int current_bbox_y = 0;
-  int current_bbox_w = 0;
-  int current_bbox_h = 0;
+  // Current frame info. The decode worker fills meta (a lane runs one decode
+  // at a time) and copies it to published_meta once the frame is decoded;
+  // GetFrameInfo reads that copy under meta_mutex.
+  FrameMeta meta;
+  std::mutex meta_mutex;
+  FrameMeta published_meta;
 };
 
 class NativeVideoHandler : public NativeVideoHostApi {
@@ -95,16 +194,70 @@ class NativeVideoHandler : public NativeVideoHostApi {
   std::optional<FlutterError> StopStream(int64_t texture_key) override;
   ErrorOr<std::optional<FrameInfo>> GetFrameInfo(int64_t texture_key) override;
   std::optional<FlutterError> Dispose(int64_t texture_key) override;
+  std::optional<FlutterError> SetLiveMode(int64_t texture_key, bool enabled) override;
+  std::optional<FlutterError> SetDisplaySize(int64_t texture_key, int64_t width, int64_t height) override;
+  std::optional<FlutterError> SetZoom(int64_t texture_key, double zoom, double center_x,
+                                      double center_y) override;
+  std::optional<FlutterError> SetZoomFollowBbox(int64_t texture_key, bool enabled) override;
+  ErrorOr<int64_t> InitializeGrid(int64_t grid_key) override;
+  std::optional<FlutterError> SetGridLayout(int64_t grid_key, int64_t columns, int64_t rows,
+                                            int64_t cell_width, int64_t cell_height) override;
+  std::optional<FlutterError> SetGridCell(int64_t grid_key, int64_t cell, int64_t texture_key) override;
+  std::optional<FlutterError> DisposeGrid(int64_t grid_key) override;
+  std::optional<FlutterError> SetMemoryBudget(int64_t bytes) override;
+  ErrorOr<MemoryStats> GetMemoryStats() override;
+  std::optional<FlutterError> SetThreadPolicy(int64_t role, int64_t core_mask, int64_t priority) override;
+  std::optional<FlutterError> StopAll() override;
+  std::optional<FlutterError> DisposeAll() override;
+  std::optional<FlutterError> SetMeasureBrightness(int64_t texture_key, bool enabled) override;
 
  private:
   void ReceiveLoop(int64_t texture_key);
-  void ReceiveLoopZmq(VideoStream* stream);
+  // Transport frame handlers; false leaves the frame with the transport
+  // (backpressure) until the lane's space handler resumes it
+  bool OnZmqMessage(VideoStream* stream, ZmqFrame& frame, int discarded);
+  bool OnHttpFrame(VideoStream* stream, const uint8_t* jpeg, size_t size);
+  // Lane slot for a received frame. False if the frame must wait in the
+  // transport; otherwise *slot is null when the frame is dropped.
+  static bool ReserveSlot(VideoStream* stream, EncodedFrame** slot);
+  // Decode pool worker: parse, decode and publish one queued frame.
+  // True if the texture got a new frame.
+  bool DecodeFrame(VideoStream* stream, EncodedFrame& frame, int skipped, tjhandle tj);
+  void StartDecodeLane(const std::shared_ptr<VideoStream>& stream);
+  static void OnTransportStatus(VideoStream* stream, bool connected);
   void ReceiveLoopHttp(VideoStream* stream);
-  bool DecodeJpeg(VideoStream* stream, const uint8_t* jpeg_data, size_t jpeg_size);
+  static std::string QueryContentType(HINTERNET request);
+  // brightness: if set, also measure the frame's mean luma (0-100)
+  bool DecodeJpeg(VideoStream* stream, tjhandle tj, const uint8_t* jpeg_data, size_t jpeg_size,
+                  double* brightness);
   void ParseHeader(VideoStream* stream, const uint8_t* data, uint32_t header_len);
+  void StopReceiving(int64_t texture_key);
+  // Signals every stream first, then waits for all of their transports,
+  // threads and decodes together, so it takes as long as the slowest stream:
+  // a loop round trip for ZMQ and http://, the frame in flight for decodes.
+  // An https:// thread stops once its closed handles fail the blocked WinHttp
+  // call; the WinHttp timeouts (5 s) bound it should the call not return.
+  // tests/stream_shutdown_test times the same phases for 16 streams.
+  void StopStreams(const std::vector<std::shared_ptr<VideoStream>>& streams);
   void CleanupStream(int64_t texture_key);
+  // Lane, grid cell and texture of a stopped stream; lifecycle_mutex_ held
+  void ReleaseStream(const std::shared_ptr<VideoStream>& stream);
+  std::vector<std::shared_ptr<VideoStream>> AllStreams() const;
+  void TrimBufferPool();
+  // Back to the stream's own texture; lifecycle_mutex_ held
+  void DetachFromGrid(VideoStream* stream);
+  // Steps streams' decode scale down or back up to fit the memory budget;
+  // lifecycle_mutex_ held. Unless forced, at most once per interval.
+  void RebalanceMemory(bool force);
   bool StartHttpStream(VideoStream* stream, const std::string& url);
   void StopHttpStream(VideoStream* stream);
+  // Waits delay_ms unless the stream stops first; false if it stopped
+  static bool WaitForReconnect(VideoStream* stream, int delay_ms);
+  static void SignalStop(VideoStream* stream);
+  // https://: the receive thread waits for a free lane slot; false if the
+  // stream stopped first
+  static bool WaitForSpace(VideoStream* stream);
+  static void SignalSpace(VideoStream* stream);
 
   flutter::TextureRegistrar* texture_registrar_;
   std::unique_ptr<NativeVideoFlutterApi> flutter_api_;
@@ -112,9 +265,30 @@ class NativeVideoHandler : public NativeVideoHostApi {
   // Window handle for PostMessage (set from main thread)
   HWND hwnd_ = nullptr;
 
-  // Multiple streams indexed by texture_key
-  std::map<int64_t, std::unique_ptr<VideoStream>> streams_;
-  std::mutex streams_mutex_;
+  // Shared ZMQ context and poller threads for all ZMQ streams (created on first use)
+  std::unique_ptr<ZmqReactor> zmq_reactor_;
+
+  // Event-loop thread serving every plain http:// stream (created on first use)
+  std::unique_ptr<HttpMjpegClient> http_client_;
+
+  // Decode workers shared by all streams (created on first use)
+  std::unique_ptr<DecodePool> decode_pool_;
+
+  // Streams indexed by texture_key. Lookups (frame info polling, receive
+  // threads, per-stream settings) never wait for lifecycle operations.
+  StreamRegistry<VideoStream> streams_;
+
+  // Serializes stream lifecycle (initialize, start, stop, dispose) and
+  // guards the grid and memory budget state below
+  std::mutex lifecycle_mutex_;
+
+  // Grid textures indexed by grid_key, guarded by lifecycle_mutex_
+  std::map<int64_t, std::shared_ptr<VideoGrid>> grids_;
+
+  // Decoded memory cap for all streams, guarded by lifecycle_mutex_
+  MemoryBudget memory_budget_;
+  size_t memory_estimate_ = 0;  // estimated total at the last rebalance
+  std::chrono::steady_clock::time_point last_rebalance_;
 
   // Current active stream key (for StartStream/StopStream)
   int64_t current_texture_key_ = -1;
@@ -0,0 +1,91 @@
+#include "quality_governor.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+// Weight of a new sample in the smoothed interval and load
+constexpr double kSmoothing = 0.125;
+
+// Step down once decode takes most of the frame interval; step up only when
+// the next step's larger decode (roughly 2-4x the work) would still fit
+constexpr double kStepDownLoad = 0.8;
+constexpr double kStepUpLoad = 0.25;
+
+// Consecutive frames past a threshold before the step changes (~0.3 s down,
+// ~3 s up at 30 fps)
+constexpr int kStepDownFrames = 10;
+constexpr int kStepUpFrames = 90;
+
+// Arrival gaps longer than this are outages, not the frame interval
+constexpr int64_t kMaxIntervalUs = 1000000;
+
+}  // namespace
+
+void QualityGovernor::Reset() {
+  last_arrival_us_ = 0;
+  interval_us_ = 0;
+  load_ = 0.0;
+  has_load_ = false;
+  over_frames_ = 0;
+  under_frames_ = 0;
+  step_ = 0;
+}
+
+void QualityGovernor::OnFramesArrived(int count) {
+  int64_t now = NowUs();
+  if (last_arrival_us_ != 0 && count > 0) {
+    int64_t gap = (now - last_arrival_us_) / count;
+    if (gap > 0 && gap <= kMaxIntervalUs) {
+      int64_t interval = interval_us_.load(std::memory_order_relaxed);
+      interval = interval == 0
+                     ? gap
+                     : interval + static_cast<int64_t>(static_cast<double>(gap - interval) * kSmoothing);
+      interval_us_.store(interval, std::memory_order_relaxed);
+    }
+  }
+  last_arrival_us_ = now;
+}
+
+void QualityGovernor::OnFrameDecoded(int64_t decode_us, double scale) {
+  int64_t interval = interval_us_.load(std::memory_order_relaxed);
+  if (interval <= 0) return;
+
+  double sample = static_cast<double>(decode_us) / static_cast<double>(interval);
+  load_ = has_load_ ? load_ + (sample - load_) * kSmoothing : sample;
+  has_load_ = true;
+
+  int step = step_.load(std::memory_order_relaxed);
+  if (load_ > kStepDownLoad && step + 1 < kQualityStepCount) {
+    under_frames_ = 0;
+    if (++over_frames_ < kStepDownFrames) return;
+
+    // The display size may already have scaled the decode down; skip the
+    // steps that wouldn't lower it further
+    int current = 0;
+    while (current + 1 < kQualityStepCount && scale <= 1.0 / (2 << current)) {
+      ++current;
+    }
+    int next = (std::min)((std::max)(step, current) + 1, kQualityStepCount - 1);
+    step_.store(next, std::memory_order_relaxed);
+    over_frames_ = 0;
+    has_load_ = false;  // measure afresh at the new scale
+  } else if (load_ < kStepUpLoad && step > 0) {
+    over_frames_ = 0;
+    if (++under_frames_ < kStepUpFrames) return;
+
+    step_.store(step - 1, std::memory_order_relaxed);
+    under_frames_ = 0;
+    has_load_ = false;
+  } else {
+    over_frames_ = 0;
+    under_frames_ = 0;
+  }
+}
+
+int64_t QualityGovernor::NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
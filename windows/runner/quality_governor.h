@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Decode steps, each halving the largest decode scale: 1/1, 1/2, 1/4, 1/8
+// (1/8 is DC only). Values match FrameInfo.qualityStep on the Dart side.
+constexpr int kQualityStepCount = 4;
+
+// Per-stream decode quality controller. Decode time is measured against the
+// stream's frame interval; sustained overload steps the decode scale down,
+// sustained headroom steps it back up. Step-up needs far lower load and far
+// more frames than step-down, so the step doesn't oscillate.
+class QualityGovernor {
+ public:
+  // New stream: full quality, measurements cleared. Not while frames flow.
+  void Reset();
+
+  // Receive thread: frames arrived, including ones dropped before decode
+  void OnFramesArrived(int count);
+
+  // Decode worker: one frame was decoded at scale (num/denom) in decode_us
+  void OnFrameDecoded(int64_t decode_us, double scale);
+
+  int step() const { return step_.load(std::memory_order_relaxed); }
+
+  // Largest scale the current step allows is 1 / max_scale_denom()
+  int max_scale_denom() const { return 1 << step(); }
+
+ private:
+  static int64_t NowUs();
+
+  // Receive side
+  int64_t last_arrival_us_ = 0;
+  std::atomic<int64_t> interval_us_{0};  // smoothed frame interval, 0 = unknown
+
+  // Decode side (one worker at a time)
+  double load_ = 0.0;  // smoothed decode time / frame interval
+  bool has_load_ = false;
+  int over_frames_ = 0;
+  int under_frames_ = 0;
+
+  std::atomic<int> step_{0};
+};
@@ -0,0 +1,263 @@
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
+#include "socket_poller.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+#pragma comment(lib, "ws2_32.lib")
+using NativeSocket = SOCKET;
+using PollFd = WSAPOLLFD;
+#define poll WSAPoll
+#else
+using NativeSocket = int;
+using PollFd = pollfd;
+#endif
+
+namespace {
+
+NativeSocket ToNative(SocketHandle socket) {
+  return static_cast<NativeSocket>(socket);
+}
+
+#ifdef __linux__
+uint32_t ToEpollEvents(uint32_t events) {
+  uint32_t result = 0;
+  if (events & kSocketReadable) result |= EPOLLIN;
+  if (events & kSocketWritable) result |= EPOLLOUT;
+  return result;
+}
+#else
+short ToPollEvents(uint32_t events) {
+  short result = 0;
+  if (events & kSocketReadable) result |= POLLIN;
+  if (events & kSocketWritable) result |= POLLOUT;
+  return result;
+}
+
+uint32_t FromPollEvents(short revents) {
+  uint32_t result = 0;
+  if (revents & POLLIN) result |= kSocketReadable;
+  if (revents & POLLOUT) result |= kSocketWritable;
+  if (revents & (POLLERR | POLLHUP | POLLNVAL)) result |= kSocketError;
+  return result;
+}
+#endif
+
+}  // namespace
+
+bool SocketStartup() {
+#ifdef _WIN32
+  WSADATA data;
+  return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+#else
+  return true;
+#endif
+}
+
+void SocketCleanup() {
+#ifdef _WIN32
+  WSACleanup();
+#endif
+}
+
+void CloseSocket(SocketHandle socket) {
+  if (socket == kInvalidSocket) return;
+#ifdef _WIN32
+  closesocket(ToNative(socket));
+#else
+  close(ToNative(socket));
+#endif
+}
+
+bool SetSocketNonBlocking(SocketHandle socket) {
+#ifdef _WIN32
+  u_long mode = 1;
+  return ioctlsocket(ToNative(socket), FIONBIO, &mode) == 0;
+#else
+  int flags = fcntl(ToNative(socket), F_GETFL, 0);
+  return flags >= 0 && fcntl(ToNative(socket), F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+}
+
+int LastSocketError() {
+#ifdef _WIN32
+  return WSAGetLastError();
+#else
+  return errno;
+#endif
+}
+
+bool SocketWouldBlock(int error) {
+#ifdef _WIN32
+  return error == WSAEWOULDBLOCK || error == WSAEINPROGRESS;
+#else
+  return error == EAGAIN || error == EWOULDBLOCK || error == EINPROGRESS;
+#endif
+}
+
+SocketPoller::SocketPoller() {
+  started_ = SocketStartup();
+  if (!started_) return;
+
+  // Wake channel: a UDP socket bound to an ephemeral loopback port and
+  // connected to itself
+  NativeSocket wake = ::socket(AF_INET, SOCK_DGRAM, 0);
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = 0;
+  socklen_t addr_len = sizeof(addr);
+
+  wake_socket_ = static_cast<SocketHandle>(wake);
+  if (wake_socket_ == kInvalidSocket ||
+      bind(wake, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      getsockname(wake, reinterpret_cast<sockaddr*>(&addr), &addr_len) != 0 ||
+      connect(wake, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      !SetSocketNonBlocking(wake_socket_)) {
+    CloseSocket(wake_socket_);
+    wake_socket_ = kInvalidSocket;
+    return;
+  }
+
+#ifdef __linux__
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd_ < 0) return;
+#endif
+
+  valid_ = Add(wake_socket_, kSocketReadable, nullptr);
+}
+
+SocketPoller::~SocketPoller() {
+#ifdef __linux__
+  if (epoll_fd_ >= 0) close(epoll_fd_);
+#endif
+  CloseSocket(wake_socket_);
+  if (started_) SocketCleanup();
+}
+
+bool SocketPoller::Add(SocketHandle socket, uint32_t events, void* token) {
+#ifdef __linux__
+  epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = ToEpollEvents(events);
+  ev.data.ptr = token;
+  return epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, ToNative(socket), &ev) == 0;
+#else
+  entries_.push_back(Entry{socket, events, token});
+  return true;
+#endif
+}
+
+bool SocketPoller::Modify(SocketHandle socket, uint32_t events, void* token) {
+#ifdef __linux__
+  epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = ToEpollEvents(events);
+  ev.data.ptr = token;
+  return epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, ToNative(socket), &ev) == 0;
+#else
+  for (auto& entry : entries_) {
+    if (entry.socket == socket) {
+      entry.events = events;
+      entry.token = token;
+      return true;
+    }
+  }
+  return false;
+#endif
+}
+
+void SocketPoller::Remove(SocketHandle socket) {
+#ifdef __linux__
+  epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, ToNative(socket), nullptr);
+#else
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    if (entries_[i].socket == socket) {
+      entries_[i] = entries_.back();
+      entries_.pop_back();
+      return;
+    }
+  }
+#endif
+}
+
+bool SocketPoller::Wait(int timeout_ms, std::vector<Event>* events) {
+  events->clear();
+
+#ifdef __linux__
+  epoll_event ready[64];
+  int count = epoll_wait(epoll_fd_, ready, 64, timeout_ms);
+  if (count < 0) return errno == EINTR;
+
+  for (int i = 0; i < count; ++i) {
+    if (ready[i].data.ptr == nullptr) {
+      DrainWake();
+      continue;
+    }
+    uint32_t flags = 0;
+    if (ready[i].events & EPOLLIN) flags |= kSocketReadable;
+    if (ready[i].events & EPOLLOUT) flags |= kSocketWritable;
+    if (ready[i].events & (EPOLLERR | EPOLLHUP)) flags |= kSocketError;
+    events->push_back(Event{ready[i].data.ptr, flags});
+  }
+  return true;
+#else
+  // Rebuilt per call; a handful of camera sockets makes this cheaper than
+  // keeping a second array in sync
+  std::vector<PollFd> fds(entries_.size());
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    fds[i].fd = ToNative(entries_[i].socket);
+    fds[i].events = ToPollEvents(entries_[i].events);
+    fds[i].revents = 0;
+  }
+
+  int count = poll(fds.data(), static_cast<unsigned long>(fds.size()), timeout_ms);
+  if (count < 0) {
+#ifdef _WIN32
+    return false;
+#else
+    return errno == EINTR;
+#endif
+  }
+
+  for (size_t i = 0; i < fds.size() && count > 0; ++i) {
+    if (fds[i].revents == 0) continue;
+    --count;
+    if (entries_[i].token == nullptr) {
+      DrainWake();
+      continue;
+    }
+    events->push_back(Event{entries_[i].token, FromPollEvents(fds[i].revents)});
+  }
+  return true;
+#endif
+}
+
+void SocketPoller::Wake() {
+  if (wake_socket_ == kInvalidSocket) return;
+  // A full socket buffer means a wakeup is already pending
+  char byte = 0;
+  send(ToNative(wake_socket_), &byte, 1, 0);
+}
+
+void SocketPoller::DrainWake() {
+  char buffer[64];
+  while (recv(ToNative(wake_socket_), buffer, sizeof(buffer), 0) > 0) {
+  }
+}
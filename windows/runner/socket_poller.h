@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Native socket handle: SOCKET on Windows, a file descriptor elsewhere.
+// Kept as an integer so this header doesn't pull in winsock2.h, which must
+// not follow the windows.h included by the rest of the runner.
+using SocketHandle = uintptr_t;
+constexpr SocketHandle kInvalidSocket = ~static_cast<SocketHandle>(0);
+
+// Socket helpers that hide the Winsock / BSD differences
+bool SocketStartup();   // WSAStartup on Windows, no-op elsewhere
+void SocketCleanup();   // pairs with a successful SocketStartup
+void CloseSocket(SocketHandle socket);
+bool SetSocketNonBlocking(SocketHandle socket);
+int LastSocketError();
+// True for "try again later" errors, including a non-blocking connect in progress
+bool SocketWouldBlock(int error);
+
+// Readiness flags for SocketPoller
+enum SocketEvent : uint32_t {
+  kSocketReadable = 1u << 0,
+  kSocketWritable = 1u << 1,
+  kSocketError = 1u << 2,  // error or hangup; always reported
+};
+
+// Level-triggered readiness poller over non-blocking sockets. Backed by epoll
+// on Linux and by WSAPoll / poll elsewhere. Not thread-safe except Wake().
+class SocketPoller {
+ public:
+  struct Event {
+    void* token;
+    uint32_t events;
+  };
+
+  SocketPoller();
+  ~SocketPoller();
+
+  SocketPoller(const SocketPoller&) = delete;
+  SocketPoller& operator=(const SocketPoller&) = delete;
+
+  bool valid() const { return valid_; }
+
+  // token is returned with every event of socket
+  bool Add(SocketHandle socket, uint32_t events, void* token);
+  bool Modify(SocketHandle socket, uint32_t events, void* token);
+  void Remove(SocketHandle socket);
+
+  // Blocks until a socket is ready, Wake() is called or timeout_ms passes
+  // (-1 = no timeout). Replaces events; returns false on a poller error.
+  bool Wait(int timeout_ms, std::vector<Event>* events);
+
+  // Makes a blocked (or the next) Wait return. Callable from any thread.
+  void Wake();
+
+ private:
+  struct Entry {
+    SocketHandle socket;
+    uint32_t events;
+    void* token;
+  };
+
+  void DrainWake();
+
+  bool valid_ = false;
+  bool started_ = false;
+
+  // Loopback UDP socket connected to itself; Wake() sends a datagram to it
+  SocketHandle wake_socket_ = kInvalidSocket;
+
+#ifdef __linux__
+  int epoll_fd_ = -1;
+#else
+  std::vector<Entry> entries_;
+#endif
+};
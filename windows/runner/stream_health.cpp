@@ -0,0 +1,63 @@
+#include "stream_health.h"
+
+#include <algorithm>
+#include <chrono>
+
+StreamHealth::StreamHealth(int64_t stall_timeout_ms) : stall_timeout_ms_(stall_timeout_ms) {}
+
+void StreamHealth::Reset() {
+  disconnected_ = false;
+  last_frame_ms_ = 0;
+  reconnect_count_ = 0;
+}
+
+void StreamHealth::OnConnected() {
+  disconnected_ = false;
+}
+
+void StreamHealth::OnDisconnected() {
+  // Count each loss once, however many times the transport reports it
+  if (!disconnected_.exchange(true)) {
+    ++reconnect_count_;
+  }
+}
+
+void StreamHealth::OnFrame() {
+  // Leaves disconnected_ alone: decodes lag the transport, so a frame queued
+  // before the loss may finish after OnDisconnected. Only OnConnected clears it.
+  last_frame_ms_.store(NowMs(), std::memory_order_relaxed);
+}
+
+StreamState StreamHealth::state() const {
+  if (disconnected_) {
+    return StreamState::kReconnecting;
+  }
+
+  int64_t last_frame = last_frame_ms_.load(std::memory_order_relaxed);
+  if (last_frame == 0) {
+    return StreamState::kConnecting;
+  }
+  if (NowMs() - last_frame >= stall_timeout_ms_) {
+    return StreamState::kStalled;
+  }
+  return StreamState::kLive;
+}
+
+int64_t StreamHealth::NowMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+ReconnectBackoff::ReconnectBackoff(int initial_ms, int max_ms)
+    : initial_ms_(initial_ms), max_ms_(max_ms), next_ms_(initial_ms) {}
+
+int ReconnectBackoff::Next() {
+  int delay = next_ms_;
+  next_ms_ = (std::min)(next_ms_ * 2, max_ms_);
+  return delay;
+}
+
+void ReconnectBackoff::Reset() {
+  next_ms_ = initial_ms_;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// No frame for this long marks a connected stream as stalled
+constexpr int64_t kDefaultStallTimeoutMs = 3000;
+
+// Values match FrameInfo.streamState on the Dart side
+enum class StreamState : int {
+  kConnecting = 0,    // no frame yet since the stream started
+  kLive = 1,          // frames arriving
+  kStalled = 2,       // connected, but no frame for the stall timeout
+  kReconnecting = 3,  // transport lost; the native layer is reconnecting
+};
+
+// Per-stream health state machine. Transport threads report events, any
+// thread can read the current state; everything is atomic so neither side
+// takes a lock. Stalls are derived from the last frame time when read.
+class StreamHealth {
+ public:
+  explicit StreamHealth(int64_t stall_timeout_ms = kDefaultStallTimeoutMs);
+
+  // New stream: back to kConnecting, counters cleared
+  void Reset();
+
+  // Transport connected / lost. A lost transport reports kReconnecting until
+  // OnConnected; the last frame stays on the texture meanwhile.
+  void OnConnected();
+  void OnDisconnected();
+
+  // Frame decoded. Doesn't end kReconnecting; that takes OnConnected.
+  void OnFrame();
+
+  StreamState state() const;
+  int64_t reconnect_count() const { return reconnect_count_.load(std::memory_order_relaxed); }
+
+ private:
+  static int64_t NowMs();
+
+  const int64_t stall_timeout_ms_;
+  std::atomic<bool> disconnected_{false};
+  std::atomic<int64_t> last_frame_ms_{0};  // 0 = no frame yet
+  std::atomic<int64_t> reconnect_count_{0};
+};
+
+// Exponential reconnect delay: initial, doubling on each failure, capped
+class ReconnectBackoff {
+ public:
+  ReconnectBackoff(int initial_ms, int max_ms);
+
+  // Returns the delay to wait before the next attempt
+  int Next();
+  // Call after a successful connect
+  void Reset();
+
+ private:
+  const int initial_ms_;
+  const int max_ms_;
+  int next_ms_;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+
+// Key -> stream map for hot-path readers (RCU style). Readers take the
+// current immutable snapshot and never wait for a writer; writers are
+// serialized, copy the map and publish the copy. A handle keeps its stream
+// alive after removal for as long as the holder uses it, so a reader racing
+// a dispose can't touch freed memory.
+template <typename Stream>
+class StreamRegistry {
+ public:
+  using Handle = std::shared_ptr<Stream>;
+  using Map = std::map<int64_t, Handle>;
+
+  // Any thread, never blocks on writers. Null if key isn't registered.
+  Handle Find(int64_t key) const {
+    std::shared_ptr<const Map> map = Snapshot();
+    auto it = map->find(key);
+    return it != map->end() ? it->second : nullptr;
+  }
+
+  // Any thread: every stream registered at one point in time
+  std::shared_ptr<const Map> Snapshot() const { return std::atomic_load(&map_); }
+
+  // False if key is taken
+  bool Insert(int64_t key, Handle stream) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    std::shared_ptr<const Map> current = Snapshot();
+    if (current->count(key)) return false;
+    auto next = std::make_shared<Map>(*current);
+    next->emplace(key, std::move(stream));
+    std::atomic_store(&map_, std::shared_ptr<const Map>(std::move(next)));
+    return true;
+  }
+
+  // The removed stream, or null; readers holding it keep it alive
+  Handle Remove(int64_t key) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    std::shared_ptr<const Map> current = Snapshot();
+    auto it = current->find(key);
+    if (it == current->end()) return nullptr;
+    Handle removed = it->second;
+    auto next = std::make_shared<Map>(*current);
+    next->erase(key);
+    std::atomic_store(&map_, std::shared_ptr<const Map>(std::move(next)));
+    return removed;
+  }
+
+  // Removes every stream and returns them
+  Map Clear() {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    Map removed = *Snapshot();
+    std::atomic_store(&map_, std::make_shared<const Map>());
+    return removed;
+  }
+
+  bool empty() const { return Snapshot()->empty(); }
+
+ private:
+  std::mutex write_mutex_;
+  std::shared_ptr<const Map> map_ = std::make_shared<const Map>();
+};
@@ -0,0 +1,89 @@
+// Render-paced DecodeLane: once a frame is published and not yet shown, the
+// next one is held, and must still be decoded when the pacing deadline
+// passes even though no other frame arrives and the texture never pulls.
+// Also checks that Consumed() releases a held frame at once.
+//
+//   decode_pacing_test
+#include "decode_pool.h"
+
+#include <atomic>
+#include <cstdint>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto kDeadline = std::chrono::milliseconds(40);
+constexpr auto kSlack = std::chrono::milliseconds(200);  // scheduling noise on a loaded machine
+
+bool Push(DecodeLane* lane) {
+  EncodedFrame* slot = lane->BeginPush();
+  if (!slot) return false;
+  static const uint8_t kJpeg[] = {0xFF, 0xD8, 0xFF, 0xD9};  // never decoded
+  slot->jpeg.assign(kJpeg, kJpeg + sizeof(kJpeg));
+  lane->CommitPush();
+  return true;
+}
+
+// Waits until decoded reaches count; returns how long that took
+Clock::duration WaitDecoded(const std::atomic<int>& decoded, int count, Clock::time_point since) {
+  while (decoded.load() < count && Clock::now() - since < kDeadline + kSlack * 2) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return Clock::now() - since;
+}
+
+long long Ms(Clock::duration duration) {
+  return static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
+}
+
+}  // namespace
+
+int main() {
+  DecodePool pool(1);
+  std::atomic<int> decoded{0};
+  DecodeLane lane(&pool, [&](EncodedFrame&, int, tjhandle) {
+    ++decoded;
+    return true;  // published
+  });
+  lane.set_latest_only(true);
+  lane.set_paced(true, kDeadline);
+
+  bool ok = true;
+
+  // First frame: nothing published yet, decoded at once
+  Push(&lane);
+  WaitDecoded(decoded, 1, Clock::now());
+
+  // Second frame is held behind the unshown first one until the deadline
+  Clock::time_point pushed = Clock::now();
+  Push(&lane);
+  Clock::duration waited = WaitDecoded(decoded, 2, pushed);
+  if (decoded != 2) {
+    std::printf("FAIL: held frame never decoded after the deadline (%lld ms)\n", Ms(waited));
+    ok = false;
+  } else if (waited > kDeadline + kSlack) {
+    std::printf("FAIL: held frame decoded after %lld ms, deadline %lld ms\n", Ms(waited), Ms(kDeadline));
+    ok = false;
+  } else {
+    std::printf("held frame decoded after %lld ms (deadline %lld ms)\n", Ms(waited), Ms(kDeadline));
+  }
+
+  // Third frame is held again, and released by the texture pulling the second
+  Push(&lane);
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  Clock::time_point consumed = Clock::now();
+  lane.Consumed();
+  waited = WaitDecoded(decoded, 3, consumed);
+  if (decoded != 3 || waited > kDeadline) {
+    std::printf("FAIL: Consumed() did not release the held frame (%lld ms)\n", Ms(waited));
+    ok = false;
+  }
+
+  lane.Close();
+  std::printf(ok ? "PASS\n" : "FAIL\n");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+// Decoded frames/s against stream count and decode worker count. Each stream
+// has a producer thread standing in for its receive thread, pushing the same
+// real JPEG into its DecodeLane as fast as the lane takes it (backpressure
+// through the space handler, as outside live mode). The "inline" column
+// decodes on the producer threads themselves, one stream per thread, the way
+// ReceiveLoop worked before the pool.
+//
+//   decode_pool_bench [width] [height] [milliseconds per run]
+#include "decode_pool.h"
+#include "test_support.h"
+
+#include <turbojpeg.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct BenchStream {
+  std::unique_ptr<DecodeLane> lane;
+  std::vector<uint8_t> rgba;  // decode target, lane's worker only
+  std::mutex mutex;
+  std::condition_variable space;
+  bool space_ready = false;
+};
+
+bool DecodeInto(tjhandle tj, const std::vector<uint8_t>& jpeg, std::vector<uint8_t>* rgba) {
+  return tj3Decompress8(tj, jpeg.data(), jpeg.size(), rgba->data(), 0, TJPF_RGBA) == 0;
+}
+
+double RunPool(const std::vector<uint8_t>& jpeg, size_t rgba_bytes, int streams, size_t workers,
+               int run_ms) {
+  DecodePool pool(workers);
+  std::atomic<int64_t> decoded{0};
+  std::atomic<bool> stop{false};
+  std::vector<std::unique_ptr<BenchStream>> lanes;
+  for (int i = 0; i < streams; ++i) {
+    auto stream = std::make_unique<BenchStream>();
+    BenchStream* s = stream.get();
+    s->rgba.resize(rgba_bytes);
+    s->lane = std::make_unique<DecodeLane>(&pool, [s, &decoded](EncodedFrame& frame, int, tjhandle tj) {
+      bool ok = tj3Decompress8(tj, frame.jpeg.data(), frame.jpeg.size(), s->rgba.data(), 0, TJPF_RGBA) == 0;
+      if (ok) ++decoded;
+      return ok;
+    });
+    s->lane->set_space_handler([s]() {
+      {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        s->space_ready = true;
+      }
+      s->space.notify_one();
+    });
+    lanes.push_back(std::move(stream));
+  }
+
+  std::vector<std::thread> producers;
+  for (auto& stream : lanes) {
+    BenchStream* s = stream.get();
+    producers.emplace_back([s, &jpeg, &stop]() {
+      while (!stop.load(std::memory_order_relaxed)) {
+        EncodedFrame* slot = s->lane->BeginPush();
+        if (!slot && s->lane->RequestSpace()) {
+          std::unique_lock<std::mutex> lock(s->mutex);
+          s->space.wait_for(lock, std::chrono::milliseconds(50), [s]() { return s->space_ready; });
+          s->space_ready = false;
+          continue;
+        }
+        if (!slot) continue;
+        slot->jpeg.assign(jpeg.data(), jpeg.data() + jpeg.size());
+        s->lane->CommitPush();
+      }
+    });
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::this_thread::sleep_for(std::chrono::milliseconds(run_ms));
+  int64_t count = decoded.load();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  stop = true;
+  for (std::thread& producer : producers) producer.join();
+  for (auto& stream : lanes) stream->lane->Close();
+  return count / seconds;
+}
+
+double RunInline(const std::vector<uint8_t>& jpeg, size_t rgba_bytes, int streams, int run_ms) {
+  std::atomic<int64_t> decoded{0};
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < streams; ++i) {
+    threads.emplace_back([&]() {
+      tjhandle tj = tj3Init(TJINIT_DECOMPRESS);
+      tj3Set(tj, TJPARAM_FASTDCT, 1);
+      std::vector<uint8_t> rgba(rgba_bytes);
+      while (!stop.load(std::memory_order_relaxed)) {
+        if (DecodeInto(tj, jpeg, &rgba)) ++decoded;
+      }
+      tj3Destroy(tj);
+    });
+  }
+  auto start = std::chrono::steady_clock::now();
+  std::this_thread::sleep_for(std::chrono::milliseconds(run_ms));
+  int64_t count = decoded.load();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  stop = true;
+  for (std::thread& thread : threads) thread.join();
+  return count / seconds;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int width = argc > 1 ? std::atoi(argv[1]) : 1920;
+  int height = argc > 2 ? std::atoi(argv[2]) : 1080;
+  int run_ms = argc > 3 ? std::atoi(argv[3]) : 1000;
+  if (width <= 0 || height <= 0 || run_ms <= 0) {
+    std::fprintf(stderr, "usage: decode_pool_bench [width] [height] [milliseconds]\n");
+    return 1;
+  }
+
+  std::vector<uint8_t> jpeg = EncodeTestJpeg(width, height);
+  if (jpeg.empty()) {
+    std::fprintf(stderr, "JPEG encode failed\n");
+    return 1;
+  }
+  size_t rgba_bytes = static_cast<size_t>(width) * height * 4;
+
+  size_t cores = (std::max)(1u, std::thread::hardware_concurrency());
+  std::vector<size_t> worker_counts;
+  for (size_t n = 1; n <= cores; n *= 2) worker_counts.push_back(n);
+  if (worker_counts.back() != cores) worker_counts.push_back(cores);
+
+  std::printf("%dx%d JPEG, %zu bytes, %zu hardware thread(s), %d ms per run\n", width, height,
+              jpeg.size(), cores, run_ms);
+  std::printf("streams   inline fps");
+  for (size_t workers : worker_counts) std::printf("   pool x%-2zu fps", workers);
+  std::printf("\n");
+
+  for (int streams : {1, 2, 4, 8, 16}) {
+    std::printf("%7d  %11.1f", streams, RunInline(jpeg, rgba_bytes, streams, run_ms));
+    for (size_t workers : worker_counts) {
+      std::printf("  %13.1f", RunPool(jpeg, rgba_bytes, streams, workers, run_ms));
+    }
+    std::printf("\n");
+  }
+  return 0;
+}
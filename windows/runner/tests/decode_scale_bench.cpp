@@ -0,0 +1,112 @@
+// ms per frame of the scaled decode DecodeJpeg does, at every libjpeg-turbo
+// scaling factor up to 1/1, for 1080p and 4K sources; then, per tile size of
+// the usual grid layouts, the factor ChooseScalingFactor picks and what it
+// saves against a full-size decode.
+//
+//   decode_scale_bench [seconds per case]
+#include "decode_scale.h"
+#include "test_support.h"
+
+#include <turbojpeg.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kMinIterations = 3;
+
+struct Source {
+  const char* name;
+  int width;
+  int height;
+};
+
+// Tile sizes in physical pixels on a 4K monitor: full screen, then 2x2, 3x3
+// and 4x4 grids
+struct Tile {
+  const char* name;
+  int width;
+  int height;
+};
+
+double DecodeMs(tjhandle tj, const std::vector<uint8_t>& jpeg, tjscalingfactor scale,
+                std::vector<uint8_t>* rgba, double seconds) {
+  if (tj3DecompressHeader(tj, jpeg.data(), jpeg.size()) != 0 ||
+      tj3SetScalingFactor(tj, scale) != 0) {
+    return -1.0;
+  }
+  int width = TJSCALED(tj3Get(tj, TJPARAM_JPEGWIDTH), scale);
+  int height = TJSCALED(tj3Get(tj, TJPARAM_JPEGHEIGHT), scale);
+  rgba->resize(static_cast<size_t>(width) * height * 4);
+
+  int iterations = 0;
+  Clock::time_point start = Clock::now();
+  double elapsed = 0.0;
+  while (iterations < kMinIterations || elapsed < seconds) {
+    if (tj3Decompress8(tj, jpeg.data(), jpeg.size(), rgba->data(), width * 4, TJPF_RGBA) != 0) {
+      return -1.0;
+    }
+    ++iterations;
+    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  }
+  return elapsed * 1000.0 / iterations;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  double seconds = argc > 1 ? std::atof(argv[1]) : 0.3;
+
+  const Source sources[] = {{"1080p", 1920, 1080}, {"4K", 3840, 2160}};
+  const Tile tiles[] = {{"1x1 3840x2160", 3840, 2160},
+                        {"2x2 1920x1080", 1920, 1080},
+                        {"3x3 1280x720", 1280, 720},
+                        {"4x4 960x540", 960, 540}};
+
+  int factor_count = 0;
+  const tjscalingfactor* factors = tjGetScalingFactors(&factor_count);
+  tjhandle tj = tj3Init(TJINIT_DECOMPRESS);
+  if (!factors || !tj) {
+    std::printf("FAIL: libjpeg-turbo not usable\n");
+    return 1;
+  }
+  std::vector<uint8_t> rgba;
+
+  for (const Source& source : sources) {
+    std::vector<uint8_t> jpeg = EncodeTestJpeg(source.width, source.height);
+    if (jpeg.empty()) {
+      std::printf("FAIL: could not encode the %s test JPEG\n", source.name);
+      return 1;
+    }
+
+    std::printf("\n%s source (%zu KB)\n", source.name, jpeg.size() / 1024);
+    std::printf("scale   output        ms/frame\n");
+    std::map<std::pair<int, int>, double> ms;
+    for (int i = 0; i < factor_count; ++i) {
+      tjscalingfactor sf = factors[i];
+      if (sf.num > sf.denom) continue;
+      double t = DecodeMs(tj, jpeg, sf, &rgba, seconds);
+      ms[{sf.num, sf.denom}] = t;
+      std::printf("%2d/%-2d   %5dx%-5d %10.2f\n", sf.num, sf.denom, TJSCALED(source.width, sf),
+                  TJSCALED(source.height, sf), t);
+    }
+
+    double full = ms[{1, 1}];
+    std::printf("tile             chosen   ms/frame   vs 1/1\n");
+    for (const Tile& tile : tiles) {
+      tjscalingfactor sf = ChooseScalingFactor(source.width, source.height, tile.width, tile.height);
+      double t = ms[{sf.num, sf.denom}];
+      std::printf("%-16s %2d/%-2d %10.2f %8.0f%%\n", tile.name, sf.num, sf.denom, t,
+                  full > 0.0 ? 100.0 * t / full : 0.0);
+    }
+  }
+
+  tj3Destroy(tj);
+  return 0;
+}
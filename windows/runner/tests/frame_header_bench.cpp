@@ -0,0 +1,89 @@
+// Microbenchmark of the frame header parsers on the documented header
+// (docs/ZMQ_HEADER_FORMAT.md), JSON and binary v1.
+//   frame_header_bench [iterations]
+#include "frame_header.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+namespace {
+
+constexpr char kDocumentedJson[] =
+    R"({"header": {"cam_idx": "top_1", "cam_num": "1", "brightness": 51.7, "motion": true, )"
+    R"("bbox": {"x": "284", "y": "0", "w": "712", "h": "480"}}})";
+
+void PutLittleEndian(uint8_t* dst, uint64_t value, size_t bytes) {
+  for (size_t i = 0; i < bytes; ++i) {
+    dst[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+}
+
+// Same fields as kDocumentedJson, plus sequence and capture time
+void BuildBinaryHeader(uint8_t* out) {
+  std::memset(out, 0, kBinaryHeaderSize);
+  std::memcpy(out, kBinaryHeaderMagic, sizeof(kBinaryHeaderMagic));
+  PutLittleEndian(out + 4, kBinaryHeaderVersion, 2);
+  PutLittleEndian(out + 6, kBinaryHeaderSize, 2);
+  out[8] = 0x3;  // motion, bbox
+  out[9] = 5;
+  out[10] = 1;
+  PutLittleEndian(out + 16, 42, 8);
+  PutLittleEndian(out + 24, 1700000000000000, 8);
+  double brightness = 51.7;
+  uint64_t bits;
+  std::memcpy(&bits, &brightness, sizeof(bits));
+  PutLittleEndian(out + 32, bits, 8);
+  PutLittleEndian(out + 40, 284, 4);
+  PutLittleEndian(out + 44, 0, 4);
+  PutLittleEndian(out + 48, 712, 4);
+  PutLittleEndian(out + 52, 480, 4);
+  std::memcpy(out + 56, "top_1", 5);
+  std::memcpy(out + 88, "1", 1);
+}
+
+template <typename Parse>
+double NanosPerParse(long iterations, Parse parse) {
+  auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; ++i) {
+    parse();
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  long iterations = argc > 1 ? std::atol(argv[1]) : 2000000;
+  if (iterations <= 0) iterations = 1;
+
+  std::string_view json(kDocumentedJson);
+  uint8_t binary[kBinaryHeaderSize];
+  BuildBinaryHeader(binary);
+
+  FrameHeader header;
+  if (!ParseFrameHeader(json, &header) || header.bbox_w != 712 ||
+      !ParseBinaryFrameHeader(binary, sizeof(binary), &header) || header.bbox_w != 712) {
+    std::fprintf(stderr, "documented header did not parse\n");
+    return 1;
+  }
+
+  // volatile sink so the loops aren't optimized away
+  volatile int sink = 0;
+  double json_ns = NanosPerParse(iterations, [&] {
+    ParseFrameHeader(json, &header);
+    sink = sink + header.bbox_w;
+  });
+  double binary_ns = NanosPerParse(iterations, [&] {
+    ParseBinaryFrameHeader(binary, sizeof(binary), &header);
+    sink = sink + header.bbox_w;
+  });
+
+  std::printf("JSON header   (%zu bytes): %7.1f ns/parse\n", json.size(), json_ns);
+  std::printf("binary header (%zu bytes): %7.1f ns/parse\n", sizeof(binary), binary_ns);
+  return 0;
+}
@@ -0,0 +1,90 @@
+// Fuzz entry point for the frame header parsers (JSON and binary).
+//
+// libFuzzer: cmake -DNATIVE_TESTS_LIBFUZZER=ON with clang, then
+//   frame_header_fuzz corpus/frame_header
+// Otherwise main() below replays every file under the given paths once.
+#include "frame_header.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+namespace {
+
+void Check(bool condition, const char* what) {
+  if (!condition) {
+    std::fprintf(stderr, "frame_header_fuzz: %s\n", what);
+    std::abort();
+  }
+}
+
+void CheckHeader(const FrameHeader& header) {
+  Check(header.cam_idx_size <= kMaxHeaderStringBytes, "cam_idx overflow");
+  Check(header.cam_num_size <= kMaxHeaderStringBytes, "cam_num overflow");
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  // Same gate as the receive path
+  if (size > kMaxFrameHeaderBytes) return 0;
+
+  FrameHeader header;
+  if (IsBinaryFrameHeader(data, size)) {
+    bool ok = ParseBinaryFrameHeader(data, size, &header);
+    CheckHeader(header);
+    Check(!ok || size >= kBinaryHeaderSize, "short binary header accepted");
+    Check(header.cam_idx_size <= kBinaryHeaderCamIdxBytes, "binary cam_idx overflow");
+    Check(header.cam_num_size <= kBinaryHeaderCamNumBytes, "binary cam_num overflow");
+    return 0;
+  }
+
+  std::string_view json(reinterpret_cast<const char*>(data), size);
+  bool ok = ParseFrameHeader(json, &header);
+  CheckHeader(header);
+
+  // Parsing is a pure function of the input
+  FrameHeader again;
+  Check(ParseFrameHeader(json, &again) == ok, "result differs between runs");
+  Check(std::memcmp(header.cam_idx, again.cam_idx, sizeof(header.cam_idx)) == 0 &&
+            header.cam_idx_size == again.cam_idx_size && header.motion == again.motion &&
+            header.has_bbox == again.has_bbox && header.bbox_x == again.bbox_x &&
+            header.bbox_y == again.bbox_y && header.bbox_w == again.bbox_w &&
+            header.bbox_h == again.bbox_h,
+        "fields differ between runs");
+  return 0;
+}
+
+#ifdef FUZZ_REPLAY_MAIN
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+int main(int argc, char** argv) {
+  namespace fs = std::filesystem;
+  size_t count = 0;
+  for (int i = 1; i < argc; ++i) {
+    std::vector<fs::path> files;
+    if (fs::is_directory(argv[i])) {
+      for (const auto& entry : fs::recursive_directory_iterator(argv[i])) {
+        if (entry.is_regular_file()) files.push_back(entry.path());
+      }
+    } else {
+      files.push_back(argv[i]);
+    }
+    for (const fs::path& file : files) {
+      std::ifstream in(file, std::ios::binary);
+      std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+      LLVMFuzzerTestOneInput(data.data(), data.size());
+      ++count;
+    }
+  }
+  std::printf("frame_header_fuzz: %zu input(s) replayed\n", count);
+  return count > 0 ? 0 : 1;
+}
+
+#endif
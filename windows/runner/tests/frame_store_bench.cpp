@@ -0,0 +1,139 @@
+// FrameStore under contention: for 1, 4 and 16 streams, a decoder thread per
+// stream publishes tiny frames as fast as it can while one texture thread
+// acquires and releases every stream's newest frame in turn (the raster
+// thread's pattern). Compared with the same triple buffer guarded by a
+// mutex. Reports publishes/s, acquires/s and the share of acquires that got
+// a new frame.
+//
+//   frame_store_bench [milliseconds per case]
+#include "frame_store.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// FrameStore's protocol with every call under one mutex
+class LockedFrameStore {
+ public:
+  DecodedFrame* back() { return &frames_[back_]; }
+
+  void Publish() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::swap(back_, middle_);
+    fresh_ = true;
+  }
+
+  const DecodedFrame* Acquire(bool* fresh) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    *fresh = false;
+    if (pins_ == 0 && fresh_) {
+      std::swap(front_, middle_);
+      fresh_ = false;
+      *fresh = true;
+    }
+    const DecodedFrame* frame = &frames_[front_];
+    if (frame->width == 0) return nullptr;
+    ++pins_;
+    return frame;
+  }
+
+  void Release() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --pins_;
+  }
+
+ private:
+  std::mutex mutex_;
+  DecodedFrame frames_[FrameStore::kFrameCount];
+  int back_ = 0;
+  int middle_ = 1;
+  int front_ = 2;
+  bool fresh_ = false;
+  int pins_ = 0;
+};
+
+struct Result {
+  double publishes_per_second = 0.0;
+  double acquires_per_second = 0.0;
+  double fresh_share = 0.0;
+};
+
+template <typename Store>
+Result Run(int streams, int run_ms) {
+  std::vector<std::unique_ptr<Store>> stores;
+  for (int i = 0; i < streams; ++i) stores.push_back(std::make_unique<Store>());
+
+  std::atomic<bool> stop{false};
+  std::atomic<int64_t> publishes{0};
+  std::vector<std::thread> decoders;
+  for (auto& store : stores) {
+    Store* s = store.get();
+    decoders.emplace_back([s, &stop, &publishes]() {
+      int64_t count = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        DecodedFrame* frame = s->back();
+        if (frame->pixels.empty()) frame->pixels.resize(4);
+        frame->pixels.data()[0] = static_cast<uint8_t>(count);
+        frame->width = 1;
+        frame->height = 1;
+        s->Publish();
+        ++count;
+      }
+      publishes += count;
+    });
+  }
+
+  int64_t acquires = 0;
+  int64_t fresh_count = 0;
+  Clock::time_point start = Clock::now();
+  Clock::time_point end = start + std::chrono::milliseconds(run_ms);
+  while (Clock::now() < end) {
+    for (auto& store : stores) {
+      bool fresh = false;
+      if (store->Acquire(&fresh)) {
+        ++acquires;
+        if (fresh) ++fresh_count;
+        store->Release();
+      }
+    }
+  }
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  stop = true;
+  for (auto& decoder : decoders) decoder.join();
+
+  Result result;
+  result.publishes_per_second = publishes / seconds;
+  result.acquires_per_second = acquires / seconds;
+  result.fresh_share = acquires > 0 ? static_cast<double>(fresh_count) / acquires : 0.0;
+  return result;
+}
+
+void Print(const char* store, int streams, const Result& r) {
+  std::printf("%-10s %7d %14.2f %14.2f %8.3f%%\n", store, streams, r.publishes_per_second / 1e6,
+              r.acquires_per_second / 1e6, 100.0 * r.fresh_share);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int run_ms = argc > 1 ? std::atoi(argv[1]) : 1000;
+  if (run_ms < 1) run_ms = 1;
+
+  std::printf("%u hardware threads, %d ms per case\n", std::thread::hardware_concurrency(), run_ms);
+  std::printf("store      streams  publishes M/s   acquires M/s   fresh\n");
+  for (int streams : {1, 4, 16}) {
+    Print("lock-free", streams, Run<FrameStore>(streams, run_ms));
+    Print("mutex", streams, Run<LockedFrameStore>(streams, run_ms));
+  }
+  return 0;
+}
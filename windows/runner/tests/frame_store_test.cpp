@@ -0,0 +1,174 @@
+// Stress test of FrameStore: a decoder thread publishes numbered frames as
+// fast as it can while a texture thread acquires them and a release thread
+// drops the pins later, the way Flutter's release callback does. Every frame
+// is filled with its number, so a torn or overwritten frame fails the check.
+// The texture thread holds each pin for a while, takes extra pins on the
+// same frame and checks the frame stays intact. A fresh frame must be newer
+// than the last one, a repeated one the same. Each round ends with
+// ReleaseSpare while the texture thread keeps going; the frame it then gets
+// must still be whole. Build with NATIVE_TESTS_TSAN to also catch data races.
+//
+//   frame_store_test [milliseconds]
+#include "frame_store.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto kRoundTime = std::chrono::milliseconds(20);
+
+// Sizes cycle so buffers are resized in place too
+constexpr int kSizes[][2] = {{64, 32}, {128, 64}, {32, 16}};
+
+void Fill(DecodedFrame* frame, uint64_t sequence) {
+  const int* size = kSizes[sequence % 3];
+  frame->pixels.resize(static_cast<size_t>(size[0]) * size[1] * 4);
+  memcpy(frame->pixels.data(), &sequence, sizeof(sequence));
+  memset(frame->pixels.data() + sizeof(sequence), static_cast<int>(sequence & 0xFF),
+         frame->pixels.size() - sizeof(sequence));
+  frame->width = size[0];
+  frame->height = size[1];
+}
+
+// The frame's number, or 0 if it isn't whole
+uint64_t Check(const DecodedFrame* frame) {
+  size_t size = static_cast<size_t>(frame->width) * frame->height * 4;
+  if (frame->pixels.size() != size || size <= sizeof(uint64_t)) return 0;
+  uint64_t sequence = 0;
+  memcpy(&sequence, frame->pixels.data(), sizeof(sequence));
+  const uint8_t* p = frame->pixels.data();
+  for (size_t i = sizeof(sequence); i < size; ++i) {
+    if (p[i] != static_cast<uint8_t>(sequence & 0xFF)) return 0;
+  }
+  return sequence;
+}
+
+struct Counters {
+  std::atomic<int64_t> failures{0};
+  std::atomic<int64_t> published{0};
+  std::atomic<int64_t> fresh{0};
+  std::atomic<int64_t> repeated{0};
+};
+
+void Fail(Counters* counters, const char* what, uint64_t a, uint64_t b) {
+  if (counters->failures++ < 10) {
+    std::printf("FAIL: %s (%llu, %llu)\n", what, static_cast<unsigned long long>(a),
+                static_cast<unsigned long long>(b));
+  }
+}
+
+void RunRound(Counters* counters, uint32_t seed) {
+  FrameStore store;
+  std::atomic<bool> decoding{true};
+  std::atomic<bool> reading{true};
+  std::atomic<int> pending_releases{0};
+
+  std::thread decoder([&]() {
+    uint64_t sequence = 1;
+    while (decoding.load(std::memory_order_relaxed)) {
+      Fill(store.back(), sequence++);
+      store.Publish();
+      ++counters->published;
+      std::this_thread::yield();  // interleave with the reader on few cores
+    }
+  });
+
+  std::thread releaser([&]() {
+    while (reading.load(std::memory_order_relaxed) || pending_releases.load() > 0) {
+      if (pending_releases.load() > 0) {
+        --pending_releases;
+        store.Release();
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  uint64_t last = 0;
+  uint32_t random = seed;
+  auto reader_step = [&]() {
+    bool fresh = false;
+    const DecodedFrame* frame = store.Acquire(&fresh);
+    if (!frame) {
+      if (last != 0) Fail(counters, "no frame after one was shown", last, 0);
+      return;
+    }
+    uint64_t sequence = Check(frame);
+    if (sequence == 0) Fail(counters, "torn frame", last, 0);
+    if (fresh && sequence <= last) Fail(counters, "fresh frame not newer", sequence, last);
+    if (!fresh && sequence != last) Fail(counters, "repeated frame changed", sequence, last);
+    ++(fresh ? counters->fresh : counters->repeated);
+    last = sequence;
+
+    // Hold the pin (and maybe take more) while the decoder keeps publishing
+    random = random * 1664525u + 1013904223u;
+    int pins = 1 + static_cast<int>((random >> 16) % 3);
+    for (int i = 1; i < pins; ++i) {
+      std::this_thread::yield();
+      bool again = false;
+      if (store.Acquire(&again) != frame || again) Fail(counters, "pinned front swapped", i, 0);
+    }
+    for (int i = 0; i < static_cast<int>((random >> 8) % 4); ++i) std::this_thread::yield();
+    if (Check(frame) != sequence) Fail(counters, "pinned frame overwritten", sequence, Check(frame));
+    pending_releases += pins;
+    std::this_thread::yield();
+  };
+
+  Clock::time_point end = Clock::now() + kRoundTime;
+  while (Clock::now() < end) reader_step();
+
+  // The decoder stops; ReleaseSpare runs while frames are still being shown
+  decoding = false;
+  decoder.join();
+  store.ReleaseSpare();
+  for (int i = 0; i < 50; ++i) reader_step();
+
+  reading = false;
+  releaser.join();
+
+  bool fresh = false;
+  const DecodedFrame* frame = store.Acquire(&fresh);
+  if (!frame || Check(frame) < last) {
+    Fail(counters, "no whole frame left after ReleaseSpare", last, frame ? Check(frame) : 0);
+  }
+  if (frame) store.Release();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int run_ms = argc > 1 ? std::atoi(argv[1]) : 1000;
+  if (run_ms < 1) run_ms = 1;
+
+  Counters counters;
+  int rounds = 0;
+  Clock::time_point end = Clock::now() + std::chrono::milliseconds(run_ms);
+  while (Clock::now() < end) {
+    RunRound(&counters, static_cast<uint32_t>(rounds) * 2654435761u);
+    ++rounds;
+  }
+
+  std::printf("%d rounds: %lld published, %lld fresh acquires, %lld repeated\n", rounds,
+              static_cast<long long>(counters.published.load()),
+              static_cast<long long>(counters.fresh.load()),
+              static_cast<long long>(counters.repeated.load()));
+  if (counters.failures > 0) {
+    std::printf("FAIL: %lld checks\n", static_cast<long long>(counters.failures.load()));
+    return 1;
+  }
+  if (counters.fresh == 0 || counters.repeated == 0) {
+    std::printf("FAIL: the run never hit both fresh and repeated acquires\n");
+    return 1;
+  }
+  std::printf("PASS\n");
+  return 0;
+}
@@ -0,0 +1,103 @@
+// GridCompositor::Compose cost for the 4, 9 and 16 camera layouts (2x2, 3x3,
+// 4x4) of a 1920x1080 and a 3840x2160 grid. Each stream's frame is either
+// exactly the cell size (row copies) or 1.25x the cell at 4:3 (sampled and
+// letterboxed, what a 1/2^n decode scale leaves). Every refresh has either
+// every cell or just one cell with a new frame. Also counts the
+// frame-available signals left after RequestCompose coalescing, with every
+// stream publishing once per refresh; separate textures would signal once per
+// stream.
+//
+//   grid_compositor_bench [refreshes per case]
+#include "grid_compositor.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Result {
+  double compose_ms = 0.0;  // average per refresh
+  int signals = 0;          // RequestCompose calls that returned true
+  int publishes = 0;
+};
+
+// Fills every buffer of store with a width x height frame
+void FillStore(FrameStore* store, int width, int height) {
+  for (int i = 0; i < FrameStore::kFrameCount; ++i) {
+    DecodedFrame* frame = store->back();
+    frame->pixels.resize(static_cast<size_t>(width) * height * 4);
+    for (size_t p = 0; p < frame->pixels.size(); ++p) {
+      frame->pixels.data()[p] = static_cast<uint8_t>(p * 7 + i);
+    }
+    frame->width = width;
+    frame->height = height;
+    store->Publish();
+  }
+}
+
+Result Run(int side, int grid_width, int grid_height, bool scaled, bool all_new, int refreshes) {
+  int cells = side * side;
+  int cell_width = grid_width / side;
+  int cell_height = grid_height / side;
+  int frame_width = scaled ? cell_width * 5 / 4 : cell_width;
+  int frame_height = scaled ? frame_width * 3 / 4 : cell_height;
+
+  std::vector<std::unique_ptr<FrameStore>> stores;
+  GridCompositor compositor;
+  compositor.SetLayout(side, side, cell_width, cell_height);
+  for (int i = 0; i < cells; ++i) {
+    stores.push_back(std::make_unique<FrameStore>());
+    FillStore(stores.back().get(), frame_width, frame_height);
+    compositor.SetCell(i, stores.back().get(), nullptr);
+  }
+  compositor.Compose();  // first draw of every cell, not timed
+
+  Result result;
+  Clock::duration total{};
+  for (int r = 0; r < refreshes; ++r) {
+    for (int i = 0; i < cells; ++i) {
+      if (!all_new && i != r % cells) continue;
+      stores[i]->Publish();
+      ++result.publishes;
+      if (compositor.RequestCompose()) ++result.signals;
+    }
+    Clock::time_point start = Clock::now();
+    compositor.Compose();
+    total += Clock::now() - start;
+  }
+  result.compose_ms = std::chrono::duration<double, std::milli>(total).count() / refreshes;
+
+  for (auto& store : stores) compositor.RemoveSource(store.get());
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int refreshes = argc > 1 ? std::atoi(argv[1]) : 200;
+  if (refreshes < 1) refreshes = 1;
+
+  std::printf("%u hardware threads, %d refreshes per case\n", std::thread::hardware_concurrency(),
+              refreshes);
+  std::printf("grid        cells  frames  new    compose ms  signals/publishes\n");
+  const int grids[][2] = {{1920, 1080}, {3840, 2160}};
+  for (const auto& grid : grids) {
+    for (int side : {2, 3, 4}) {
+      for (bool scaled : {false, true}) {
+        for (bool all_new : {true, false}) {
+          Result r = Run(side, grid[0], grid[1], scaled, all_new, refreshes);
+          std::printf("%4dx%-4d  %6d  %-6s  %-5s  %10.3f  %7d/%d\n", grid[0], grid[1], side * side,
+                      scaled ? "scaled" : "exact", all_new ? "all" : "one", r.compose_ms, r.signals,
+                      r.publishes);
+        }
+      }
+    }
+  }
+  return 0;
+}
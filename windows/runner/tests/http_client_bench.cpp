@@ -0,0 +1,134 @@
+// Receive-side cost of N plain-http MJPEG cameras: HttpMjpegClient (every
+// connection on one event-loop thread) against a blocking receive thread per
+// stream, which is how the WinHTTP path reads. An MjpegServer sends each
+// stream ~30 fps of 20 KB frames.
+//
+// Reported per model: threads, context switches/s and CPU of the whole
+// process (Linux; "-" elsewhere), frames/s, and frame latency from the
+// server's send to the frame handler (p50/p99). The server's own threads
+// and CPU are the same in both models.
+//
+//   http_client_bench [seconds per run] [max streams]
+#include "http_mjpeg_client.h"
+#include "test_support.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr auto kConnectTime = std::chrono::milliseconds(500);
+
+// Handler side of a run: frames and their latencies
+class Latencies {
+ public:
+  bool Record(const uint8_t* jpeg, size_t size) {
+    int64_t age = TestFrameAgeUs(jpeg, size);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (recording_ && age >= 0) ages_us_.push_back(age);
+    return true;
+  }
+  void Start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    recording_ = true;
+  }
+  std::vector<int64_t> Stop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    recording_ = false;
+    return std::move(ages_us_);
+  }
+
+ private:
+  std::mutex mutex_;
+  bool recording_ = false;
+  std::vector<int64_t> ages_us_;
+};
+
+void Measure(const char* model, int streams, double seconds, Latencies* latencies) {
+  std::this_thread::sleep_for(kConnectTime);
+  ProcessUsage before = SampleProcessUsage();
+  latencies->Start();
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+  std::vector<int64_t> ages = latencies->Stop();
+  ProcessUsage after = SampleProcessUsage();
+
+  double p50 = 0.0;
+  double p99 = 0.0;
+  if (!ages.empty()) {
+    std::sort(ages.begin(), ages.end());
+    p50 = ages[ages.size() / 2] / 1000.0;
+    p99 = ages[(ages.size() * 99) / 100] / 1000.0;
+  }
+  double fps = ages.size() / seconds;
+  if (after.threads < 0) {
+    std::printf("%-16s %7d %8s %8s %7s %9.0f %8.3f %8.3f\n", model, streams, "-", "-", "-", fps,
+                p50, p99);
+    return;
+  }
+  std::printf("%-16s %7d %8d %8.0f %6.1f%% %9.0f %8.3f %8.3f\n", model, streams, after.threads,
+              (after.context_switches - before.context_switches) / seconds,
+              100.0 * (after.cpu_seconds - before.cpu_seconds) / seconds, fps, p50, p99);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  double seconds = argc > 1 ? std::atof(argv[1]) : 3.0;
+  int max_streams = argc > 2 ? std::atoi(argv[2]) : 64;
+  if (seconds <= 0.0) seconds = 3.0;
+
+  std::printf("%u hardware threads, %.1f s per run\n", std::thread::hardware_concurrency(), seconds);
+  std::printf("model            streams  threads   csw/s     CPU  frames/s  p50 ms   p99 ms\n");
+
+  for (int streams : {4, 16, 64}) {
+    if (streams > max_streams) break;
+
+    {
+      MjpegServer server;
+      if (!server.ok()) {
+        std::printf("FAIL: server did not start\n");
+        return 1;
+      }
+      Latencies latencies;
+      std::vector<std::unique_ptr<BlockingReceiver>> receivers;
+      for (int i = 0; i < streams; ++i) {
+        receivers.push_back(std::make_unique<BlockingReceiver>());
+        receivers.back()->Start(server.port(), [&latencies](const uint8_t* jpeg, size_t size) {
+          return latencies.Record(jpeg, size);
+        });
+      }
+      Measure("thread/stream", streams, seconds, &latencies);
+      for (auto& receiver : receivers) receiver->Signal();
+      for (auto& receiver : receivers) receiver->Join();
+    }
+
+    {
+      MjpegServer server;
+      Latencies latencies;
+      HttpMjpegClient client;
+      std::vector<int64_t> keys;
+      for (int i = 0; i < streams; ++i) {
+        std::string error;
+        if (!client.Add(i, server.url(),
+                        [&latencies](const uint8_t* jpeg, size_t size) {
+                          return latencies.Record(jpeg, size);
+                        },
+                        [](bool) {}, &error)) {
+          std::printf("FAIL: add %d: %s\n", i, error.c_str());
+          return 1;
+        }
+        keys.push_back(i);
+      }
+      Measure("event loop", streams, seconds, &latencies);
+      client.Remove(keys);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,127 @@
+// MjpegParser throughput against read sizes, for parts with and without
+// Content-Length (the latter are found by scanning for the delimiter). Reads
+// go through PrepareWrite/Commit as in HttpMjpegClient. Besides fixed read
+// sizes from 1 byte to 256 KB, "straddling" cuts every read in the middle of
+// a delimiter, so each search has to resume across a read.
+//
+//   mjpeg_parser_bench [jpeg bytes] [seconds per case]
+#include "mjpeg_parser.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr char kBoundary[] = "benchboundary";
+constexpr int kFramesPerStream = 32;
+
+std::vector<uint8_t> BuildStream(size_t jpeg_bytes, bool content_length,
+                                 std::vector<size_t>* delimiter_offsets) {
+  std::vector<uint8_t> stream;
+  auto append = [&stream](const std::string& text) {
+    stream.insert(stream.end(), text.begin(), text.end());
+  };
+  for (int i = 0; i < kFramesPerStream; ++i) {
+    delimiter_offsets->push_back(stream.size());
+    append(std::string("--") + kBoundary + "\r\nContent-Type: image/jpeg\r\n");
+    if (content_length) append("Content-Length: " + std::to_string(jpeg_bytes) + "\r\n");
+    append("\r\n");
+    // Compressed data looks random; '-' and '\r' show up as often as any byte
+    size_t start = stream.size();
+    stream.resize(start + jpeg_bytes);
+    uint32_t state = 2463534242u + i;
+    for (size_t b = 0; b < jpeg_bytes; ++b) {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      stream[start + b] = static_cast<uint8_t>(state);
+    }
+    stream[start] = 0xFF;
+    stream[start + 1] = 0xD8;
+    stream[start + jpeg_bytes - 2] = 0xFF;
+    stream[start + jpeg_bytes - 1] = 0xD9;
+    append("\r\n");
+  }
+  return stream;
+}
+
+struct Result {
+  double megabytes_per_second = 0.0;
+  double frames_per_second = 0.0;
+  bool ok = true;
+};
+
+Result Run(const std::vector<uint8_t>& stream, const std::vector<size_t>& read_sizes, double seconds) {
+  MjpegParser parser(kBoundary);
+  int64_t frames = 0;
+  MjpegParser::FrameHandler on_frame = [&frames](const uint8_t*, size_t) {
+    ++frames;
+    return true;
+  };
+
+  int64_t passes = 0;
+  Clock::time_point start = Clock::now();
+  double elapsed = 0.0;
+  while (elapsed < seconds) {
+    size_t offset = 0;
+    for (size_t i = 0; offset < stream.size(); ++i) {
+      size_t size = (std::min)(read_sizes[i % read_sizes.size()], stream.size() - offset);
+      memcpy(parser.PrepareWrite(size), stream.data() + offset, size);  // the recv()
+      parser.Commit(size, on_frame);
+      offset += size;
+    }
+    ++passes;
+    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  }
+
+  Result result;
+  result.megabytes_per_second = passes * stream.size() / elapsed / (1024.0 * 1024.0);
+  result.frames_per_second = frames / elapsed;
+  // The last part of a pass is completed by the next pass's delimiter when
+  // it has no Content-Length
+  result.ok = frames >= passes * (kFramesPerStream - 1);
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t jpeg_bytes = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 200 * 1024;
+  double seconds = argc > 2 ? std::atof(argv[2]) : 0.5;
+  if (jpeg_bytes < 4) jpeg_bytes = 4;
+
+  std::printf("%zu-byte JPEGs\n", jpeg_bytes);
+  std::printf("framing          reads           MB/s   frames/s\n");
+  for (bool content_length : {true, false}) {
+    std::vector<size_t> delimiters;
+    std::vector<uint8_t> stream = BuildStream(jpeg_bytes, content_length, &delimiters);
+    const char* framing = content_length ? "Content-Length" : "delimiter scan";
+
+    for (size_t read : {size_t{1}, size_t{7}, size_t{64}, size_t{1460}, size_t{16384},
+                        size_t{65536}, size_t{262144}}) {
+      Result result = Run(stream, {read}, seconds);
+      std::printf("%-16s %-12zu %9.1f %10.0f%s\n", framing, read, result.megabytes_per_second,
+                  result.frames_per_second, result.ok ? "" : "  (frames lost)");
+    }
+
+    // One read per part, each ending halfway through the next delimiter
+    std::vector<size_t> straddling;
+    size_t previous = 0;
+    for (size_t offset : delimiters) {
+      size_t cut = offset + 1 + std::strlen(kBoundary) / 2;
+      if (cut > previous) straddling.push_back(cut - previous);
+      previous = cut;
+    }
+    straddling.push_back(stream.size() - previous);
+    Result result = Run(stream, straddling, seconds);
+    std::printf("%-16s %-12s %9.1f %10.0f%s\n", framing, "straddling", result.megabytes_per_second,
+                result.frames_per_second, result.ok ? "" : "  (frames lost)");
+  }
+  return 0;
+}
@@ -0,0 +1,189 @@
+// MjpegParser against every way a TCP stream can be cut into reads. One
+// multipart body (preamble, parts with and without Content-Length, JPEGs that
+// contain partial and whole delimiters) is fed as one chunk, 1-byte chunks,
+// every fixed chunk size up to 64, split in two at every offset, and in
+// seeded random chunks; through Feed and through PrepareWrite/Commit. Each
+// way must yield exactly the original JPEGs. The 1-byte feed is repeated
+// with a handler that refuses every frame once, resuming before each read.
+//
+//   mjpeg_parser_test
+#include "mjpeg_parser.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr char kBoundary[] = "testboundary";
+
+int failures = 0;
+
+using Frames = std::vector<std::vector<uint8_t>>;
+
+std::vector<uint8_t> Bytes(const std::string& text) {
+  return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+// JPEG-looking body carrying byte sequences that look like the start of a
+// delimiter, or (only where Content-Length frames the part) a whole one
+std::vector<uint8_t> Body(int index, bool with_full_delimiter) {
+  std::vector<uint8_t> body = {0xFF, 0xD8};
+  for (int i = 0; i < 40 + index * 13; ++i) body.push_back(static_cast<uint8_t>(index * 31 + i));
+  for (const char* tricky : {"\r", "\r\n", "\r\n-", "\r\n--", "\r\n--test", "\r\n--testboundar",
+                             "--testboundar", "\r\n\r"}) {
+    std::vector<uint8_t> t = Bytes(tricky);
+    body.insert(body.end(), t.begin(), t.end());
+    body.push_back(static_cast<uint8_t>(index));
+  }
+  if (with_full_delimiter) {
+    std::vector<uint8_t> t = Bytes(std::string("\r\n--") + kBoundary + "\r\n\r\n");
+    body.insert(body.end(), t.begin(), t.end());
+  }
+  body.push_back(0xFF);
+  body.push_back(0xD9);
+  return body;
+}
+
+// The stream and the JPEGs it carries
+void BuildStream(std::vector<uint8_t>* stream, Frames* frames) {
+  auto append = [stream](const std::string& text) {
+    stream->insert(stream->end(), text.begin(), text.end());
+  };
+  append("preamble the parser must skip\r\n");
+  for (int i = 0; i < 8; ++i) {
+    bool content_length = i % 2 == 0;
+    std::vector<uint8_t> body = Body(i, content_length);
+    append(std::string("--") + kBoundary + "\r\nContent-Type: image/jpeg\r\n");
+    if (content_length) {
+      // Header names are case-insensitive
+      append(std::string(i % 4 == 0 ? "Content-Length" : "content-LENGTH") + ":  " +
+             std::to_string(body.size()) + "\r\n");
+    }
+    append("\r\n");
+    stream->insert(stream->end(), body.begin(), body.end());
+    append("\r\n");
+    frames->push_back(body);
+  }
+  append(std::string("--") + kBoundary + "--\r\n");
+}
+
+// Feeds stream cut at the given offsets (ascending, excluding 0 and size)
+Frames Parse(const std::vector<uint8_t>& stream, const std::vector<size_t>& cuts, bool feed) {
+  MjpegParser parser(kBoundary);
+  Frames frames;
+  MjpegParser::FrameHandler on_frame = [&frames](const uint8_t* jpeg, size_t size) {
+    frames.emplace_back(jpeg, jpeg + size);
+    return true;
+  };
+  size_t begin = 0;
+  for (size_t i = 0; i <= cuts.size(); ++i) {
+    size_t end = i < cuts.size() ? cuts[i] : stream.size();
+    size_t size = end - begin;
+    if (feed) {
+      parser.Feed(stream.data() + begin, size, on_frame);
+    } else {
+      memcpy(parser.PrepareWrite(size), stream.data() + begin, size);
+      parser.Commit(size, on_frame);
+    }
+    begin = end;
+  }
+  return frames;
+}
+
+void Expect(const Frames& got, const Frames& expected, const std::string& what) {
+  if (got == expected) return;
+  std::printf("FAIL: %s: %zu frames, expected %zu\n", what.c_str(), got.size(), expected.size());
+  ++failures;
+}
+
+void FeedBothWays(const std::vector<uint8_t>& stream, const std::vector<size_t>& cuts,
+                  const Frames& expected, const std::string& what) {
+  Expect(Parse(stream, cuts, true), expected, what + " (Feed)");
+  Expect(Parse(stream, cuts, false), expected, what + " (PrepareWrite/Commit)");
+}
+
+}  // namespace
+
+int main() {
+  std::vector<uint8_t> stream;
+  Frames expected;
+  BuildStream(&stream, &expected);
+
+  FeedBothWays(stream, {}, expected, "one chunk");
+
+  for (size_t chunk = 1; chunk <= 64; ++chunk) {
+    std::vector<size_t> cuts;
+    for (size_t offset = chunk; offset < stream.size(); offset += chunk) cuts.push_back(offset);
+    FeedBothWays(stream, cuts, expected, std::to_string(chunk) + "-byte chunks");
+  }
+
+  // Every offset, so each delimiter, header end and Content-Length value is
+  // straddled at each of its bytes
+  for (size_t offset = 1; offset < stream.size(); ++offset) {
+    FeedBothWays(stream, {offset}, expected, "split at " + std::to_string(offset));
+  }
+
+  std::mt19937 random(12345);
+  for (int round = 0; round < 200; ++round) {
+    std::vector<size_t> cuts;
+    for (size_t offset = 1 + random() % 100; offset < stream.size(); offset += 1 + random() % 100) {
+      cuts.push_back(offset);
+    }
+    FeedBothWays(stream, cuts, expected, "random chunks, round " + std::to_string(round));
+  }
+
+  // The "--" may come with the Content-Type parameter
+  {
+    MjpegParser parser(std::string("--") + kBoundary);
+    Frames frames;
+    parser.Feed(stream.data(), stream.size(), [&frames](const uint8_t* jpeg, size_t size) {
+      frames.emplace_back(jpeg, jpeg + size);
+      return true;
+    });
+    Expect(frames, expected, "boundary given with its leading --");
+  }
+
+  // Refusals: every frame is refused on its first offer; Resume before the
+  // next byte must hand out the same frame
+  {
+    MjpegParser parser(kBoundary);
+    Frames frames;
+    bool refuse = true;
+    MjpegParser::FrameHandler on_frame = [&](const uint8_t* jpeg, size_t size) {
+      if (refuse) {
+        refuse = false;
+        return false;
+      }
+      refuse = true;
+      frames.emplace_back(jpeg, jpeg + size);
+      return true;
+    };
+    int stalls = 0;
+    for (uint8_t byte : stream) {
+      while (parser.stalled()) {
+        ++stalls;
+        parser.Resume(on_frame);
+      }
+      parser.Feed(&byte, 1, on_frame);
+    }
+    while (parser.stalled()) {
+      ++stalls;
+      parser.Resume(on_frame);
+    }
+    Expect(frames, expected, "1-byte chunks with refusals");
+    if (stalls != static_cast<int>(expected.size())) {
+      std::printf("FAIL: %d stalls, expected %zu\n", stalls, expected.size());
+      ++failures;
+    }
+  }
+
+  if (failures > 0) {
+    std::printf("FAIL: %d checks\n", failures);
+    return 1;
+  }
+  std::printf("PASS\n");
+  return 0;
+}
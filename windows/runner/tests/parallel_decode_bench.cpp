@@ -0,0 +1,127 @@
+// Latency of one frame against decode thread count: the whole-frame
+// tj3Decompress8 against DecodeJpeg's striped decode (SplitJpegAtRestarts,
+// then DecodePool::ParallelFor with box upsampling), for sources around
+// kParallelDecodeMinPixels (4 MP). Test JPEGs carry a restart marker every
+// MCU row. Stripe splitting is included in the striped time.
+//
+// ParallelFor runs on the calling thread plus idle workers, so N threads
+// here is a pool of N - 1 workers and the caller, as on a decode worker.
+//
+//   parallel_decode_bench [frames per case] [max threads]
+#include "decode_pool.h"
+#include "jpeg_restart.h"
+#include "test_support.h"
+
+#include <turbojpeg.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Same value as native_video_handler.cpp
+constexpr int64_t kParallelDecodeMinPixels = 4 * 1000 * 1000;
+
+struct Source {
+  const char* name;
+  int width;
+  int height;
+};
+
+struct Latency {
+  double median_ms = 0.0;
+  double p95_ms = 0.0;
+};
+
+Latency Summarize(std::vector<double> ms) {
+  std::sort(ms.begin(), ms.end());
+  return {ms[ms.size() / 2], ms[(ms.size() * 95) / 100]};
+}
+
+double MsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int frames = argc > 1 ? std::atoi(argv[1]) : 20;
+  size_t max_threads = argc > 2 ? static_cast<size_t>(std::atoi(argv[2]))
+                                : (std::max)(4u, std::thread::hardware_concurrency());
+  if (frames < 1) frames = 1;
+
+  const Source sources[] = {{"1080p", 1920, 1080},
+                            {"1440p", 2560, 1440},
+                            {"4K", 3840, 2160},
+                            {"12MP", 4000, 3000}};
+
+  std::printf("%u hardware threads, %d frames per case\n", std::thread::hardware_concurrency(),
+              frames);
+  std::printf("source  MP    threads  stripes  median ms  p95 ms  vs whole\n");
+
+  tjhandle tj = tj3Init(TJINIT_DECOMPRESS);
+  for (const Source& source : sources) {
+    std::vector<uint8_t> jpeg = EncodeTestJpeg(source.width, source.height, 85, 1);
+    if (jpeg.empty()) {
+      std::printf("FAIL: could not encode the %s test JPEG\n", source.name);
+      return 1;
+    }
+    int pitch = source.width * 4;
+    std::vector<uint8_t> rgba(static_cast<size_t>(pitch) * source.height);
+    double megapixels = static_cast<double>(source.width) * source.height / 1e6;
+    const char* mark =
+        static_cast<int64_t>(source.width) * source.height >= kParallelDecodeMinPixels ? "*" : " ";
+
+    std::vector<double> whole_ms;
+    for (int i = 0; i < frames; ++i) {
+      Clock::time_point start = Clock::now();
+      tj3Decompress8(tj, jpeg.data(), jpeg.size(), rgba.data(), pitch, TJPF_RGBA);
+      whole_ms.push_back(MsSince(start));
+    }
+    Latency whole = Summarize(whole_ms);
+    std::printf("%-6s %5.1f%s %7d %8s %10.2f %7.2f %8s\n", source.name, megapixels, mark, 1, "-",
+                whole.median_ms, whole.p95_ms, "1.00x");
+
+    for (size_t threads = 2; threads <= max_threads; threads *= 2) {
+      DecodePool pool(threads - 1);
+      std::vector<JpegStripe> stripes;
+      std::vector<double> striped_ms;
+      size_t stripe_count = 0;
+      for (int i = 0; i < frames; ++i) {
+        Clock::time_point start = Clock::now();
+        stripe_count = SplitJpegAtRestarts(jpeg.data(), jpeg.size(), threads, &stripes);
+        if (stripe_count == 0) break;
+        bool ok = pool.ParallelFor(stripe_count, tj, [&](size_t s, tjhandle stripe_tj) {
+          const JpegStripe& stripe = stripes[s];
+          tj3Set(stripe_tj, TJPARAM_FASTUPSAMPLE, 1);
+          bool decoded = tj3Decompress8(stripe_tj, stripe.jpeg.data(), stripe.jpeg.size(),
+                                        rgba.data() + static_cast<size_t>(stripe.y) * pitch, pitch,
+                                        TJPF_RGBA) == 0;
+          tj3Set(stripe_tj, TJPARAM_FASTUPSAMPLE, 0);
+          return decoded;
+        });
+        if (!ok) {
+          std::printf("FAIL: striped decode of %s failed\n", source.name);
+          return 1;
+        }
+        striped_ms.push_back(MsSince(start));
+      }
+      if (striped_ms.empty()) {
+        std::printf("FAIL: %s test JPEG has no usable restart markers\n", source.name);
+        return 1;
+      }
+      Latency striped = Summarize(striped_ms);
+      std::printf("%-6s %5.1f%s %7zu %8zu %10.2f %7.2f %7.2fx\n", source.name, megapixels, mark,
+                  threads, stripe_count, striped.median_ms, striped.p95_ms,
+                  whole.median_ms / striped.median_ms);
+    }
+  }
+  std::printf("* at or above kParallelDecodeMinPixels: DecodeJpeg stripes these\n");
+  tj3Destroy(tj);
+  return 0;
+}
@@ -0,0 +1,166 @@
+// Backpressure from a slow decode lane into both shared transports. Each
+// stream decodes slower than its camera sends and pushes the way
+// NativeVideoHandler does outside live mode: a full lane refuses the frame,
+// the transport stops reading and the lane's space handler resumes it. No
+// frame may be lost on the way (the fake JPEGs carry a sequence byte), and
+// nothing may be dropped by the handler.
+//
+//   stream_backpressure_test [milliseconds]
+#include "decode_pool.h"
+#include "http_mjpeg_client.h"
+#include "test_support.h"
+#include "zmq_reactor.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace {
+
+constexpr int64_t kZmqKey = 1;
+constexpr int64_t kHttpKey = 2;
+constexpr int kDecodeMs = kTestFrameIntervalMs * 3 / 2;  // 1.5x slower than the camera
+constexpr size_t kSequenceOffset = 2;                    // FakeJpeg fills the body with the index
+
+struct TestStream {
+  const char* name = "";
+  std::unique_ptr<DecodeLane> lane;
+  std::atomic<int64_t> refused{0};
+  std::atomic<int64_t> dropped{0};
+  std::atomic<int64_t> decoded{0};
+  std::atomic<int64_t> gaps{0};
+  int last_sequence = -1;  // decode worker only
+};
+
+// Same decision as NativeVideoHandler::ReserveSlot outside live mode
+EncodedFrame* Reserve(TestStream* stream, bool* wait) {
+  EncodedFrame* slot = stream->lane->BeginPush();
+  *wait = false;
+  if (slot) return slot;
+  if (stream->lane->RequestSpace()) {
+    ++stream->refused;
+    *wait = true;
+    return nullptr;
+  }
+  slot = stream->lane->BeginPush();
+  if (!slot) ++stream->dropped;
+  return slot;
+}
+
+bool Decode(TestStream* stream, const uint8_t* jpeg, size_t size) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(kDecodeMs));  // decode stand-in
+  if (size <= kSequenceOffset) return false;
+  int sequence = jpeg[kSequenceOffset];
+  if (stream->last_sequence >= 0 && sequence != ((stream->last_sequence + 1) & 0xFF)) {
+    ++stream->gaps;
+  }
+  stream->last_sequence = sequence;
+  ++stream->decoded;
+  return true;
+}
+
+bool Check(const TestStream& stream, int run_ms) {
+  // The decode bounds the rate; allow for connect time and the first frames
+  int64_t expected = run_ms / kDecodeMs / 2;
+  std::printf("%-5s decoded %lld, refused %lld, dropped %lld, gaps %lld\n", stream.name,
+              static_cast<long long>(stream.decoded.load()), static_cast<long long>(stream.refused.load()),
+              static_cast<long long>(stream.dropped.load()), static_cast<long long>(stream.gaps.load()));
+  bool ok = true;
+  if (stream.refused == 0) {
+    std::printf("FAIL: %s never pushed back (decode not slower than the camera?)\n", stream.name);
+    ok = false;
+  }
+  if (stream.dropped != 0 || stream.gaps != 0) {
+    std::printf("FAIL: %s lost frames under backpressure\n", stream.name);
+    ok = false;
+  }
+  if (stream.decoded < expected) {
+    std::printf("FAIL: %s decoded %lld frames, expected at least %lld (stuck after a pause?)\n",
+                stream.name, static_cast<long long>(stream.decoded.load()),
+                static_cast<long long>(expected));
+    ok = false;
+  }
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int run_ms = argc > 1 ? std::atoi(argv[1]) : 1500;
+  if (run_ms < 500) run_ms = 500;
+
+  ZmqPublisher publisher;
+  MjpegServer server;
+  if (!publisher.Start() || !server.ok()) {
+    std::printf("test publisher or server failed to start\n");
+    return 1;
+  }
+
+  DecodePool pool(2);
+  ZmqReactor reactor(1, 1);
+  HttpMjpegClient http;
+
+  TestStream zmq_stream;
+  zmq_stream.name = "zmq";
+  TestStream http_stream;
+  http_stream.name = "http";
+
+  zmq_stream.lane = std::make_unique<DecodeLane>(&pool, [&](EncodedFrame& frame, int, tjhandle) {
+    FrameView view = SplitFrame(frame.zmq);
+    return Decode(&zmq_stream, view.jpeg, view.jpeg_size);
+  });
+  zmq_stream.lane->set_space_handler([&reactor]() { reactor.Resume(kZmqKey); });
+  http_stream.lane = std::make_unique<DecodeLane>(&pool, [&](EncodedFrame& frame, int, tjhandle) {
+    return Decode(&http_stream, frame.jpeg.data(), frame.jpeg.size());
+  });
+  http_stream.lane->set_space_handler([&http]() { http.Resume(kHttpKey); });
+
+  std::string error;
+  bool started = reactor.Subscribe(
+      kZmqKey, publisher.address(), IngestPolicy::kEveryFrame,
+      [&](ZmqFrame& frame, int) {
+        bool wait = false;
+        EncodedFrame* slot = Reserve(&zmq_stream, &wait);
+        if (wait) return false;
+        if (slot) {
+          slot->zmq.ShareFrom(frame);
+          zmq_stream.lane->CommitPush();
+        }
+        return true;
+      },
+      [](bool) {}, &error);
+  started = started && http.Add(
+      kHttpKey, server.url(),
+      [&](const uint8_t* jpeg, size_t size) {
+        bool wait = false;
+        EncodedFrame* slot = Reserve(&http_stream, &wait);
+        if (wait) return false;
+        if (slot) {
+          slot->jpeg.assign(jpeg, jpeg + size);
+          http_stream.lane->CommitPush();
+        }
+        return true;
+      },
+      [](bool) {}, &error);
+  if (!started) {
+    std::printf("subscribe failed: %s\n", error.c_str());
+    return 1;
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(run_ms));
+
+  // Transports first, then the lanes, as NativeVideoHandler::StopStreams does
+  reactor.Unsubscribe(kZmqKey);
+  http.Remove(kHttpKey);
+  zmq_stream.lane->Close();
+  http_stream.lane->Close();
+
+  bool ok = Check(zmq_stream, run_ms);
+  ok = Check(http_stream, run_ms) && ok;
+  std::printf(ok ? "PASS\n" : "FAIL\n");
+  return ok ? 0 : 1;
+}
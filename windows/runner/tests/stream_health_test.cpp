@@ -0,0 +1,139 @@
+// StreamHealth across a killed and restarted ZMQ publisher. A ZmqReactor
+// subscription feeds the health state the way NativeVideoHandler does: the
+// socket monitor reports connect/disconnect, decodes on a DecodeLane report
+// frames. Each cycle kills the publisher, checks the stream shows
+// kReconnecting and stays there through a late decode, then restarts the
+// publisher and checks it goes back to kLive with one more reconnect counted.
+//
+//   stream_health_test [cycles]
+#include "decode_pool.h"
+#include "stream_health.h"
+#include "test_support.h"
+#include "zmq_reactor.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int64_t kStreamKey = 1;
+constexpr int kDecodeMs = 5;
+constexpr auto kStateTimeout = std::chrono::seconds(5);
+
+const char* StateName(StreamState state) {
+  switch (state) {
+    case StreamState::kConnecting:
+      return "connecting";
+    case StreamState::kLive:
+      return "live";
+    case StreamState::kStalled:
+      return "stalled";
+    case StreamState::kReconnecting:
+      return "reconnecting";
+  }
+  return "?";
+}
+
+bool WaitFor(const std::function<bool()>& done) {
+  Clock::time_point deadline = Clock::now() + kStateTimeout;
+  while (!done()) {
+    if (Clock::now() > deadline) return false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  return true;
+}
+
+bool Expect(bool condition, const char* what, const StreamHealth& health) {
+  if (!condition) {
+    std::printf("FAIL: %s (state %s, reconnects %lld)\n", what, StateName(health.state()),
+                static_cast<long long>(health.reconnect_count()));
+  }
+  return condition;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int cycles = argc > 1 ? std::atoi(argv[1]) : 2;
+  if (cycles < 1) cycles = 1;
+
+  ZmqPublisher publisher;
+  if (!publisher.Start()) {
+    std::printf("ZMQ publisher failed to start\n");
+    return 1;
+  }
+
+  StreamHealth health;
+  std::atomic<int64_t> decoded{0};
+  DecodePool pool(1);
+  DecodeLane lane(&pool, [&](EncodedFrame&, int, tjhandle) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(kDecodeMs));  // decode stand-in
+    ++decoded;
+    health.OnFrame();
+    return true;
+  });
+
+  ZmqReactor reactor(1, 0);
+  std::string error;
+  bool subscribed = reactor.Subscribe(
+      kStreamKey, publisher.address(), IngestPolicy::kEveryFrame,
+      [&](ZmqFrame& frame, int) {
+        EncodedFrame* slot = lane.BeginPush();
+        if (!slot) return true;  // dropped
+        slot->zmq.ShareFrom(frame);
+        lane.CommitPush();
+        return true;
+      },
+      [&](bool connected) {
+        if (connected) {
+          health.OnConnected();
+        } else {
+          health.OnDisconnected();
+        }
+      },
+      &error);
+  if (!subscribed) {
+    std::printf("subscribe failed: %s\n", error.c_str());
+    return 1;
+  }
+
+  bool ok = Expect(WaitFor([&] { return health.state() == StreamState::kLive; }), "stream never went live",
+                   health);
+  for (int cycle = 0; cycle < cycles && ok; ++cycle) {
+    publisher.Stop();
+    ok = Expect(WaitFor([&] { return health.state() == StreamState::kReconnecting; }),
+                "killed publisher not reported", health) &&
+         Expect(health.reconnect_count() == cycle + 1, "loss not counted once", health);
+    if (!ok) break;
+
+    // A decode queued before the loss finishing now must not end kReconnecting
+    health.OnFrame();
+    std::this_thread::sleep_for(std::chrono::milliseconds(3 * kTestFrameIntervalMs));
+    ok = Expect(health.state() == StreamState::kReconnecting, "late frame cleared kReconnecting", health);
+    if (!ok) break;
+
+    int64_t before = decoded;
+    ok = Expect(publisher.Start(), "publisher failed to restart", health) &&
+         Expect(WaitFor([&] { return decoded > before && health.state() == StreamState::kLive; }),
+                "restarted publisher not live again", health) &&
+         Expect(health.reconnect_count() == cycle + 1, "reconnect counted twice", health);
+  }
+
+  reactor.Unsubscribe(kStreamKey);
+  lane.Close();
+  publisher.Stop();
+
+  if (ok) {
+    std::printf("%d kill/restart cycle(s): reconnecting while down, live after restart, %lld reconnect(s)\n",
+                cycles, static_cast<long long>(health.reconnect_count()));
+  }
+  return ok ? 0 : 1;
+}
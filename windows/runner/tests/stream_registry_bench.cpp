@@ -0,0 +1,112 @@
+// Lookup throughput of StreamRegistry against the mutex-guarded std::map it
+// replaced, with 1..N reader threads, with and without a writer inserting and
+// removing streams the whole time (Initialize/Dispose churn).
+//   stream_registry_bench [milliseconds per run] [max readers]
+#include "stream_registry.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int64_t kStreams = 16;
+
+struct BenchStream {
+  std::atomic<int64_t> hits{0};
+};
+
+// The previous lookup: one lock shared by readers and writers
+class LockedMap {
+ public:
+  std::shared_ptr<BenchStream> Find(int64_t key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = map_.find(key);
+    return it != map_.end() ? it->second : nullptr;
+  }
+  bool Insert(int64_t key, std::shared_ptr<BenchStream> stream) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return map_.emplace(key, std::move(stream)).second;
+  }
+  void Remove(int64_t key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    map_.erase(key);
+  }
+
+ private:
+  std::mutex mutex_;
+  std::map<int64_t, std::shared_ptr<BenchStream>> map_;
+};
+
+// Million lookups per second summed over all readers
+template <typename Map>
+double Run(Map& map, int readers, bool churn, int run_ms) {
+  for (int64_t key = 0; key < kStreams; ++key) map.Insert(key, std::make_shared<BenchStream>());
+
+  std::atomic<bool> stop{false};
+  std::atomic<int64_t> lookups{0};
+  std::vector<std::thread> threads;
+  for (int r = 0; r < readers; ++r) {
+    threads.emplace_back([&, r] {
+      int64_t local = 0;
+      int64_t key = r;
+      while (!stop.load(std::memory_order_relaxed)) {
+        std::shared_ptr<BenchStream> stream = map.Find(key % kStreams);
+        if (stream) stream->hits.fetch_add(1, std::memory_order_relaxed);
+        ++key;
+        ++local;
+      }
+      lookups += local;
+    });
+  }
+  if (churn) {
+    // One extra key disposed and initialized again and again
+    threads.emplace_back([&] {
+      while (!stop.load(std::memory_order_relaxed)) {
+        map.Insert(kStreams, std::make_shared<BenchStream>());
+        map.Remove(kStreams);
+      }
+    });
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::this_thread::sleep_for(std::chrono::milliseconds(run_ms));
+  stop = true;
+  for (std::thread& thread : threads) thread.join();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  for (int64_t key = 0; key < kStreams; ++key) map.Remove(key);
+  return lookups / seconds / 1e6;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int run_ms = argc > 1 ? std::atoi(argv[1]) : 300;
+  if (run_ms < 1) run_ms = 1;
+  int max_readers = argc > 2 ? std::atoi(argv[2])
+                             : static_cast<int>((std::max)(2u, std::thread::hardware_concurrency()));
+  if (max_readers < 1) max_readers = 1;
+
+  std::printf("%u hardware thread(s), %lld streams, %d ms per run\n",
+              std::thread::hardware_concurrency(), static_cast<long long>(kStreams), run_ms);
+  std::printf("readers  churn   registry Mlookup/s   mutex+map Mlookup/s\n");
+  for (int readers = 1; readers <= max_readers; readers *= 2) {
+    for (bool churn : {false, true}) {
+      StreamRegistry<BenchStream> registry;
+      LockedMap locked;
+      double rcu = Run(registry, readers, churn, run_ms);
+      double mutex = Run(locked, readers, churn, run_ms);
+      std::printf("%7d  %-5s  %19.2f  %20.2f\n", readers, churn ? "yes" : "no", rcu, mutex);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,126 @@
+// Stress test of StreamRegistry: reader threads look streams up (Find and
+// Snapshot) while writer threads insert and remove them, the way frame info
+// polling and per-stream settings race Initialize/Dispose. Every stream
+// carries a canary that its destructor clears, so a reader that got a freed
+// stream fails the check; build with NATIVE_TESTS_TSAN to also catch any
+// data race. At the end every stream must have been destroyed exactly once.
+//
+//   stream_registry_test [milliseconds]
+#include "stream_registry.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kReaders = 4;
+constexpr int kWriters = 2;
+constexpr int64_t kKeys = 32;  // shared by all writers, so inserts collide
+constexpr uint32_t kAlive = 0x5eedcafe;
+
+std::atomic<int64_t> g_live{0};
+
+struct TestStream {
+  explicit TestStream(int64_t stream_key) : key(stream_key) { ++g_live; }
+  ~TestStream() {
+    canary = 0;
+    --g_live;
+  }
+  TestStream(const TestStream&) = delete;
+  TestStream& operator=(const TestStream&) = delete;
+
+  int64_t key;
+  uint32_t canary = kAlive;
+  std::atomic<int64_t> reads{0};  // written by readers, like a stream's stats
+};
+
+using Registry = StreamRegistry<TestStream>;
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int run_ms = argc > 1 ? std::atoi(argv[1]) : 500;
+  if (run_ms < 1) run_ms = 1;
+
+  std::atomic<bool> stop{false};
+  std::atomic<int64_t> failures{0};
+  std::atomic<int64_t> lookups{0};
+  std::atomic<int64_t> inserts{0};
+  std::atomic<int64_t> removes{0};
+
+  {
+    Registry registry;
+    std::vector<std::thread> threads;
+
+    for (int r = 0; r < kReaders; ++r) {
+      threads.emplace_back([&, r] {
+        std::minstd_rand rng(static_cast<unsigned>(r + 1));
+        int64_t local = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+          int64_t key = static_cast<int64_t>(rng() % kKeys);
+          Registry::Handle stream = registry.Find(key);
+          if (stream) {
+            if (stream->canary != kAlive || stream->key != key) ++failures;
+            stream->reads.fetch_add(1, std::memory_order_relaxed);
+          }
+          // Every few lookups walk a whole snapshot, as StopAll and the
+          // memory rebalance do
+          if ((++local & 63) == 0) {
+            std::shared_ptr<const Registry::Map> map = registry.Snapshot();
+            for (const auto& pair : *map) {
+              if (pair.second->canary != kAlive || pair.second->key != pair.first) ++failures;
+            }
+          }
+        }
+        lookups += local;
+      });
+    }
+
+    for (int w = 0; w < kWriters; ++w) {
+      threads.emplace_back([&, w] {
+        std::minstd_rand rng(static_cast<unsigned>(100 + w));
+        while (!stop.load(std::memory_order_relaxed)) {
+          int64_t key = static_cast<int64_t>(rng() % kKeys);
+          if (rng() & 1) {
+            if (registry.Insert(key, std::make_shared<TestStream>(key))) ++inserts;
+          } else {
+            Registry::Handle removed = registry.Remove(key);
+            if (removed) {
+              ++removes;
+              // A removed stream must be gone from the registry
+              Registry::Handle again = registry.Find(key);
+              if (again == removed) ++failures;
+            }
+          }
+        }
+      });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(run_ms));
+    stop = true;
+    for (std::thread& thread : threads) thread.join();
+
+    Registry::Map rest = registry.Clear();
+    if (static_cast<int64_t>(rest.size()) != inserts - removes) ++failures;
+    if (!registry.empty()) ++failures;
+  }
+
+  std::printf("%lld lookups, %lld inserts, %lld removes\n", static_cast<long long>(lookups.load()),
+              static_cast<long long>(inserts.load()), static_cast<long long>(removes.load()));
+  if (g_live != 0) {
+    std::printf("FAIL: %lld stream(s) never destroyed\n", static_cast<long long>(g_live.load()));
+    return 1;
+  }
+  if (failures != 0 || inserts == 0 || removes == 0) {
+    std::printf("FAIL: %lld bad lookup(s)\n", static_cast<long long>(failures.load()));
+    return 1;
+  }
+  std::printf("PASS\n");
+  return 0;
+}
@@ -0,0 +1,249 @@
+// 16-stream shutdown timing. Builds the same transports and decode lanes as
+// NativeVideoHandler (ZmqReactor for tcp://, HttpMjpegClient for http://, a
+// blocking receive thread per https:// stream, DecodeLanes on a shared
+// DecodePool) and stops them in StopStreams' phases:
+//   1. signal every stream and abort its blocking read
+//   2. one batched ZmqReactor::Unsubscribe and HttpMjpegClient::Remove
+//   3. join every receive thread
+//   4. cancel every lane, then close each
+// Fails if any round takes kBudgetMs or more, if a stream got no frames, or
+// if a handler runs after the stop returned. The one-at-a-time stop that
+// StopStreams replaced is timed too, for reference.
+//
+//   stream_shutdown_test [rounds] [decode_ms]
+#include "decode_pool.h"
+#include "http_mjpeg_client.h"
+#include "test_support.h"
+#include "zmq_reactor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kZmqStreams = 6;
+constexpr int kHttpStreams = 5;
+constexpr int kBlockingStreams = 5;
+constexpr size_t kDecodeThreads = 4;
+constexpr double kBudgetMs = 100.0;
+constexpr auto kFirstFrameTimeout = std::chrono::seconds(5);
+
+enum class Transport { kZmq, kHttp, kBlocking };
+
+struct TestStream {
+  int64_t key = 0;
+  Transport transport = Transport::kZmq;
+  std::atomic<bool> running{true};
+  std::atomic<int64_t> received{0};
+  std::atomic<int64_t> decoded{0};
+  std::unique_ptr<DecodeLane> lane;
+  BlockingReceiver receiver;
+};
+
+// Both drop when the lane is full, like a live-mode stream
+bool PushCopy(TestStream* stream, const uint8_t* jpeg, size_t size) {
+  ++stream->received;
+  if (!stream->running) return true;
+  EncodedFrame* slot = stream->lane->BeginPush();
+  if (!slot) return true;
+  slot->jpeg.assign(jpeg, jpeg + size);
+  stream->lane->CommitPush();
+  return true;
+}
+
+bool PushShared(TestStream* stream, ZmqFrame& frame) {
+  ++stream->received;
+  if (!stream->running) return true;
+  EncodedFrame* slot = stream->lane->BeginPush();
+  if (!slot) return true;
+  slot->zmq.ShareFrom(frame);
+  stream->lane->CommitPush();
+  return true;
+}
+
+struct Fixture {
+  MjpegServer server;
+  std::vector<std::unique_ptr<ZmqPublisher>> publishers;
+  DecodePool pool{kDecodeThreads};
+  ZmqReactor reactor{1, 0};
+  HttpMjpegClient http;
+};
+
+bool StartStreams(Fixture* fixture, int decode_ms, std::vector<std::unique_ptr<TestStream>>* streams) {
+  for (int i = 0; i < kZmqStreams + kHttpStreams + kBlockingStreams; ++i) {
+    auto stream = std::make_unique<TestStream>();
+    TestStream* s = stream.get();
+    s->key = i;
+    s->transport = i < kZmqStreams ? Transport::kZmq
+                   : i < kZmqStreams + kHttpStreams ? Transport::kHttp
+                                                    : Transport::kBlocking;
+    s->lane = std::make_unique<DecodeLane>(&fixture->pool, [s, decode_ms](EncodedFrame&, int, tjhandle) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(decode_ms));  // decode stand-in
+      ++s->decoded;
+      return true;
+    });
+
+    std::string error;
+    bool started = true;
+    switch (s->transport) {
+      case Transport::kZmq:
+        started = fixture->reactor.Subscribe(
+            s->key, fixture->publishers[i]->address(), IngestPolicy::kEveryFrame,
+            [s](ZmqFrame& frame, int) { return PushShared(s, frame); }, [](bool) {}, &error);
+        break;
+      case Transport::kHttp:
+        started = fixture->http.Add(
+            s->key, fixture->server.url(),
+            [s](const uint8_t* jpeg, size_t size) { return PushCopy(s, jpeg, size); }, [](bool) {}, &error);
+        break;
+      case Transport::kBlocking:
+        s->receiver.Start(fixture->server.port(),
+                          [s](const uint8_t* jpeg, size_t size) { return PushCopy(s, jpeg, size); });
+        break;
+    }
+    if (!started) {
+      std::printf("stream %d failed to start: %s\n", i, error.c_str());
+      return false;
+    }
+    streams->push_back(std::move(stream));
+  }
+
+  // Every stream has to be decoding before the stop is timed
+  Clock::time_point deadline = Clock::now() + kFirstFrameTimeout;
+  for (const auto& stream : *streams) {
+    while (stream->decoded == 0) {
+      if (Clock::now() > deadline) {
+        std::printf("stream %lld got no frames\n", static_cast<long long>(stream->key));
+        return false;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+  }
+  return true;
+}
+
+// StopStreams' phases
+void StopTogether(Fixture* fixture, const std::vector<std::unique_ptr<TestStream>>& streams) {
+  std::vector<int64_t> zmq_keys;
+  std::vector<int64_t> http_keys;
+  for (const auto& stream : streams) {
+    stream->running = false;
+    stream->receiver.Signal();
+    if (stream->transport == Transport::kZmq) zmq_keys.push_back(stream->key);
+    if (stream->transport == Transport::kHttp) http_keys.push_back(stream->key);
+  }
+  fixture->reactor.Unsubscribe(zmq_keys);
+  fixture->http.Remove(http_keys);
+  for (const auto& stream : streams) {
+    stream->receiver.Join();
+  }
+  for (const auto& stream : streams) {
+    stream->lane->Cancel();
+  }
+  for (const auto& stream : streams) {
+    stream->lane->Close();
+  }
+}
+
+// What StopReceiving did per stream before StopStreams
+void StopOneByOne(Fixture* fixture, const std::vector<std::unique_ptr<TestStream>>& streams) {
+  for (const auto& stream : streams) {
+    stream->running = false;
+    stream->receiver.Signal();
+    if (stream->transport == Transport::kZmq) fixture->reactor.Unsubscribe(stream->key);
+    if (stream->transport == Transport::kHttp) fixture->http.Remove(stream->key);
+    stream->receiver.Join();
+    stream->lane->Close();
+  }
+}
+
+// No transport handler may run once the stop has returned
+bool QuietAfterStop(const std::vector<std::unique_ptr<TestStream>>& streams) {
+  std::vector<int64_t> received;
+  for (const auto& stream : streams) {
+    received.push_back(stream->received);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(3 * kTestFrameIntervalMs));
+  for (size_t i = 0; i < streams.size(); ++i) {
+    if (streams[i]->received != received[i]) {
+      std::printf("stream %zu received a frame after the stop\n", i);
+      return false;
+    }
+  }
+  return true;
+}
+
+struct Timing {
+  double median_ms = 0.0;
+  double max_ms = 0.0;
+};
+
+Timing Summarize(std::vector<double> times) {
+  std::sort(times.begin(), times.end());
+  return {times[times.size() / 2], times.back()};
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int rounds = argc > 1 ? std::atoi(argv[1]) : 5;
+  int decode_ms = argc > 2 ? std::atoi(argv[2]) : 10;
+  if (rounds < 1) rounds = 1;
+
+  Fixture fixture;
+  if (!fixture.server.ok()) {
+    std::printf("MJPEG server failed to start\n");
+    return 1;
+  }
+  for (int i = 0; i < kZmqStreams; ++i) {
+    fixture.publishers.push_back(std::make_unique<ZmqPublisher>());
+    if (!fixture.publishers.back()->Start()) {
+      std::printf("ZMQ publisher failed to start\n");
+      return 1;
+    }
+  }
+
+  bool ok = true;
+  std::vector<double> together;
+  std::vector<double> one_by_one;
+  for (int round = 0; round < rounds && ok; ++round) {
+    for (int mode = 0; mode < 2 && ok; ++mode) {
+      std::vector<std::unique_ptr<TestStream>> streams;
+      ok = StartStreams(&fixture, decode_ms, &streams);
+      if (!ok) break;
+
+      Clock::time_point start = Clock::now();
+      if (mode == 0) {
+        StopTogether(&fixture, streams);
+      } else {
+        StopOneByOne(&fixture, streams);
+      }
+      double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+      (mode == 0 ? together : one_by_one).push_back(ms);
+
+      ok = QuietAfterStop(streams);
+      if (mode == 0 && ms >= kBudgetMs) {
+        std::printf("round %d: stop took %.2f ms (budget %.0f ms)\n", round, ms, kBudgetMs);
+        ok = false;
+      }
+    }
+  }
+  if (together.empty() || one_by_one.empty()) return 1;
+
+  Timing fast = Summarize(together);
+  Timing slow = Summarize(one_by_one);
+  std::printf("%d streams (%d zmq, %d http, %d blocking), %d ms decode, %zu round(s):\n",
+              kZmqStreams + kHttpStreams + kBlockingStreams, kZmqStreams, kHttpStreams,
+              kBlockingStreams, decode_ms, together.size());
+  std::printf("  StopStreams phases: median %7.2f ms, max %7.2f ms\n", fast.median_ms, fast.max_ms);
+  std::printf("  one by one:         median %7.2f ms, max %7.2f ms\n", slow.median_ms, slow.max_ms);
+  return ok ? 0 : 1;
+}
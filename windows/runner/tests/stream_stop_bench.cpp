@@ -0,0 +1,185 @@
+// Stop latency of N ZMQ streams. The model StopStream used before the
+// reactor (a context, SUB socket and receive thread per stream, polling
+// is_running every ZMQ_RCVTIMEO=100 ms, stopped one stream at a time) against
+// ZmqReactor, whose pollers are woken through their inproc pair: one
+// Unsubscribe per stream, and one batched Unsubscribe for all of them.
+// Every stream has received a frame before its stop is timed.
+//
+//   stream_stop_bench [rounds] [max streams]
+#include "test_support.h"
+#include "zmq_message.h"
+#include "zmq_reactor.h"
+
+#include <zmq.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kOldReceiveTimeoutMs = 100;
+constexpr size_t kOldBufferBytes = 2 * 1024 * 1024;
+constexpr auto kFirstFrameTimeout = std::chrono::seconds(10);
+
+double MsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// One stream of the old model
+struct PollingStream {
+  std::atomic<bool> running{true};
+  std::atomic<int64_t> received{0};
+  std::thread thread;
+
+  void Start(const std::string& address) {
+    thread = std::thread([this, address]() {
+      void* context = zmq_ctx_new();
+      void* socket = zmq_socket(context, ZMQ_SUB);
+      int linger = 0;
+      int timeout = kOldReceiveTimeoutMs;
+      zmq_setsockopt(socket, ZMQ_LINGER, &linger, sizeof(linger));
+      zmq_setsockopt(socket, ZMQ_RCVTIMEO, &timeout, sizeof(timeout));
+      zmq_connect(socket, address.c_str());
+      zmq_setsockopt(socket, ZMQ_SUBSCRIBE, "", 0);
+
+      std::vector<uint8_t> buffer(kOldBufferBytes);
+      while (running) {
+        if (zmq_recv(socket, buffer.data(), buffer.size(), 0) >= 0) ++received;
+      }
+      zmq_close(socket);
+      zmq_ctx_term(context);
+    });
+  }
+
+  void Stop() {
+    running = false;
+    thread.join();
+  }
+};
+
+template <typename Received>
+bool WaitForFrames(int streams, Received received) {
+  Clock::time_point deadline = Clock::now() + kFirstFrameTimeout;
+  for (int i = 0; i < streams; ++i) {
+    while (received(i) == 0) {
+      if (Clock::now() > deadline) return false;
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+  }
+  return true;
+}
+
+struct Stops {
+  std::vector<double> per_stream_ms;
+  std::vector<double> total_ms;
+};
+
+void Print(const char* model, int streams, Stops stops) {
+  std::sort(stops.per_stream_ms.begin(), stops.per_stream_ms.end());
+  std::sort(stops.total_ms.begin(), stops.total_ms.end());
+  if (stops.per_stream_ms.empty()) {
+    std::printf("%-18s %7d %12s %10s %11.3f\n", model, streams, "-", "-",
+                stops.total_ms[stops.total_ms.size() / 2]);
+    return;
+  }
+  std::printf("%-18s %7d %12.3f %10.3f %11.3f\n", model, streams,
+              stops.per_stream_ms[stops.per_stream_ms.size() / 2], stops.per_stream_ms.back(),
+              stops.total_ms[stops.total_ms.size() / 2]);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int rounds = argc > 1 ? std::atoi(argv[1]) : 3;
+  int max_streams = argc > 2 ? std::atoi(argv[2]) : 64;
+  if (rounds < 1) rounds = 1;
+
+  std::printf("model              streams  median ms/stream  max ms  total ms (median of %d)\n",
+              rounds);
+  for (int streams : {1, 4, 16, 64}) {
+    if (streams > max_streams) break;
+
+    std::vector<std::unique_ptr<ZmqPublisher>> publishers;
+    for (int i = 0; i < streams; ++i) {
+      publishers.push_back(std::make_unique<ZmqPublisher>());
+      if (!publishers.back()->Start()) {
+        std::printf("FAIL: publisher %d did not start\n", i);
+        return 1;
+      }
+    }
+
+    Stops polling;
+    Stops reactor_each;
+    Stops reactor_batch;
+    for (int round = 0; round < rounds; ++round) {
+      {
+        std::vector<std::unique_ptr<PollingStream>> old_streams;
+        for (int i = 0; i < streams; ++i) {
+          old_streams.push_back(std::make_unique<PollingStream>());
+          old_streams.back()->Start(publishers[i]->address());
+        }
+        if (!WaitForFrames(streams, [&](int i) { return old_streams[i]->received.load(); })) {
+          std::printf("FAIL: polling streams got no frames\n");
+          return 1;
+        }
+        Clock::time_point all = Clock::now();
+        for (auto& stream : old_streams) {
+          Clock::time_point start = Clock::now();
+          stream->Stop();
+          polling.per_stream_ms.push_back(MsSince(start));
+        }
+        polling.total_ms.push_back(MsSince(all));
+      }
+
+      for (bool batch : {false, true}) {
+        ZmqReactor reactor(1, 0);
+        std::vector<std::atomic<int64_t>> received(static_cast<size_t>(streams));
+        std::vector<int64_t> keys;
+        for (int i = 0; i < streams; ++i) {
+          std::string error;
+          std::atomic<int64_t>* counter = &received[i];
+          if (!reactor.Subscribe(i, publishers[i]->address(), IngestPolicy::kEveryFrame,
+                                 [counter](ZmqFrame&, int) {
+                                   ++*counter;
+                                   return true;
+                                 },
+                                 nullptr, &error)) {
+            std::printf("FAIL: subscribe %d: %s\n", i, error.c_str());
+            return 1;
+          }
+          keys.push_back(i);
+        }
+        if (!WaitForFrames(streams, [&](int i) { return received[i].load(); })) {
+          std::printf("FAIL: reactor streams got no frames\n");
+          return 1;
+        }
+
+        Stops* stops = batch ? &reactor_batch : &reactor_each;
+        Clock::time_point all = Clock::now();
+        if (batch) {
+          reactor.Unsubscribe(keys);
+        } else {
+          for (int64_t key : keys) {
+            Clock::time_point start = Clock::now();
+            reactor.Unsubscribe(key);
+            stops->per_stream_ms.push_back(MsSince(start));
+          }
+        }
+        stops->total_ms.push_back(MsSince(all));
+      }
+    }
+
+    Print("RCVTIMEO polling", streams, polling);
+    Print("reactor, each", streams, reactor_each);
+    Print("reactor, batched", streams, reactor_batch);
+  }
+  return 0;
+}
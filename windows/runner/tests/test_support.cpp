@@ -0,0 +1,430 @@
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <dirent.h>
+#include <sys/resource.h>
+#endif
+
+#include "test_support.h"
+
+#include "mjpeg_parser.h"
+#include <turbojpeg.h>
+#include <zmq.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+using NativeSocket = SOCKET;
+constexpr int kSendFlags = 0;
+constexpr int kShutdownBoth = SD_BOTH;
+#else
+using NativeSocket = int;
+constexpr int kSendFlags = MSG_NOSIGNAL;
+constexpr int kShutdownBoth = SHUT_RDWR;
+#endif
+
+namespace {
+
+NativeSocket ToNative(SocketHandle socket) {
+  return static_cast<NativeSocket>(socket);
+}
+
+sockaddr_in Loopback(int port) {
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(static_cast<uint16_t>(port));
+  return addr;
+}
+
+bool SendAll(SocketHandle socket, const char* data, size_t size) {
+  while (size > 0) {
+    int sent = send(ToNative(socket), data, static_cast<int>(size), kSendFlags);
+    if (sent <= 0) return false;
+    data += sent;
+    size -= static_cast<size_t>(sent);
+  }
+  return true;
+}
+
+// Where FakeJpeg puts the send time (steady clock, microseconds)
+constexpr size_t kSendTimeOffset = 8;
+
+int64_t NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+std::vector<uint8_t> FakeJpeg(int64_t index) {
+  std::vector<uint8_t> jpeg(kTestJpegBytes, static_cast<uint8_t>(index));
+  int64_t now = NowUs();
+  memcpy(jpeg.data() + kSendTimeOffset, &now, sizeof(now));
+  jpeg[0] = 0xFF;
+  jpeg[1] = 0xD8;
+  jpeg[jpeg.size() - 2] = 0xFF;
+  jpeg[jpeg.size() - 1] = 0xD9;
+  return jpeg;
+}
+
+}  // namespace
+
+// =============================================================================
+// MjpegServer
+// =============================================================================
+
+MjpegServer::MjpegServer() {
+  started_ = SocketStartup();
+  if (!started_) return;
+
+  NativeSocket listen_socket = ::socket(AF_INET, SOCK_STREAM, 0);
+  listen_ = static_cast<SocketHandle>(listen_socket);
+  sockaddr_in addr = Loopback(0);
+  socklen_t addr_len = sizeof(addr);
+  if (listen_ == kInvalidSocket ||
+      bind(listen_socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      listen(listen_socket, 64) != 0 ||
+      getsockname(listen_socket, reinterpret_cast<sockaddr*>(&addr), &addr_len) != 0) {
+    CloseSocket(listen_);
+    listen_ = kInvalidSocket;
+    return;
+  }
+  port_ = ntohs(addr.sin_port);
+  accept_thread_ = std::thread(&MjpegServer::AcceptLoop, this);
+}
+
+MjpegServer::~MjpegServer() {
+  stopping_ = true;
+  if (accept_thread_.joinable()) accept_thread_.join();
+  {
+    // Unblocks client threads stuck in send to a reader that went away
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (SocketHandle client : client_sockets_) {
+      shutdown(ToNative(client), kShutdownBoth);
+    }
+  }
+  for (std::thread& client : clients_) {
+    client.join();
+  }
+  for (SocketHandle client : client_sockets_) {
+    CloseSocket(client);
+  }
+  CloseSocket(listen_);
+  if (started_) SocketCleanup();
+}
+
+std::string MjpegServer::url() const {
+  return "http://127.0.0.1:" + std::to_string(port_) + "/stream";
+}
+
+void MjpegServer::AcceptLoop() {
+  while (!stopping_) {
+    // Short select timeout so the destructor never waits on accept
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(ToNative(listen_), &readable);
+    timeval timeout = {0, 50 * 1000};
+    if (select(static_cast<int>(ToNative(listen_)) + 1, &readable, nullptr, nullptr, &timeout) <= 0) {
+      continue;
+    }
+    SocketHandle client = static_cast<SocketHandle>(accept(ToNative(listen_), nullptr, nullptr));
+    if (client == kInvalidSocket) continue;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    client_sockets_.push_back(client);
+    clients_.emplace_back(&MjpegServer::Serve, this, client);
+  }
+}
+
+void MjpegServer::Serve(SocketHandle client) {
+  // Request head; its content doesn't matter
+  char request[1024];
+  recv(ToNative(client), request, sizeof(request), 0);
+
+  std::string head = std::string("HTTP/1.0 200 OK\r\nContent-Type: multipart/x-mixed-replace; boundary=") +
+                     kBoundary + "\r\n\r\n";
+  bool ok = SendAll(client, head.data(), head.size());
+  for (int64_t index = 0; ok && !stopping_; ++index) {
+    std::vector<uint8_t> jpeg = FakeJpeg(index);
+    char part[128];
+    snprintf(part, sizeof(part), "--%s\r\nContent-Type: image/jpeg\r\nContent-Length: %zu\r\n\r\n",
+             kBoundary, jpeg.size());
+    ok = SendAll(client, part, strlen(part)) &&
+         SendAll(client, reinterpret_cast<const char*>(jpeg.data()), jpeg.size()) &&
+         SendAll(client, "\r\n", 2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(kTestFrameIntervalMs));
+  }
+  // The destructor closes the socket once every client thread is done
+}
+
+// =============================================================================
+// ZmqPublisher
+// =============================================================================
+
+ZmqPublisher::~ZmqPublisher() {
+  Stop();
+}
+
+bool ZmqPublisher::Start() {
+  if (running_) return true;
+
+  context_ = zmq_ctx_new();
+  socket_ = context_ ? zmq_socket(context_, ZMQ_PUB) : nullptr;
+  if (!socket_) {
+    Stop();
+    return false;
+  }
+  int linger = 0;
+  zmq_setsockopt(socket_, ZMQ_LINGER, &linger, sizeof(linger));
+
+  std::string endpoint = port_ ? address() : std::string("tcp://127.0.0.1:*");
+  if (zmq_bind(socket_, endpoint.c_str()) != 0) {
+    Stop();
+    return false;
+  }
+  if (port_ == 0) {
+    char bound[128] = {};
+    size_t size = sizeof(bound);
+    zmq_getsockopt(socket_, ZMQ_LAST_ENDPOINT, bound, &size);
+    const char* colon = strrchr(bound, ':');
+    port_ = colon ? atoi(colon + 1) : 0;
+  }
+
+  running_ = true;
+  thread_ = std::thread(&ZmqPublisher::Loop, this);
+  return port_ != 0;
+}
+
+void ZmqPublisher::Stop() {
+  running_ = false;
+  if (thread_.joinable()) thread_.join();
+  if (socket_) {
+    zmq_close(socket_);
+    socket_ = nullptr;
+  }
+  if (context_) {
+    zmq_ctx_term(context_);
+    context_ = nullptr;
+  }
+}
+
+std::string ZmqPublisher::address() const {
+  return "tcp://127.0.0.1:" + std::to_string(port_);
+}
+
+void ZmqPublisher::Loop() {
+  while (running_) {
+    int64_t index = sent_.load();
+    std::vector<uint8_t> header;
+    if (encoding_ == FrameHeaderEncoding::kBinary) {
+      FrameHeader fields;
+      int cam_num_size = snprintf(fields.cam_num, sizeof(fields.cam_num), "%lld",
+                                  static_cast<long long>(index));
+      memcpy(fields.cam_idx, "test", 4);
+      fields.cam_idx_size = 4;
+      fields.cam_num_size = static_cast<size_t>(cam_num_size);
+      fields.has_sequence = true;
+      fields.sequence = static_cast<uint64_t>(index);
+      fields.capture_time_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                                   std::chrono::system_clock::now().time_since_epoch())
+                                   .count();
+      header = EncodeBinaryFrameHeader(fields);
+    } else {
+      char json[128];
+      int json_size = snprintf(json, sizeof(json),
+                               "{\"header\": {\"cam_idx\": \"test\", \"cam_num\": \"%lld\"}}",
+                               static_cast<long long>(index));
+      header.assign(json, json + json_size);
+    }
+    std::vector<uint8_t> jpeg = FakeJpeg(index);
+    if (format_ == ZmqWireFormat::kTwoPart) {
+      zmq_send(socket_, header.data(), header.size(), ZMQ_SNDMORE);
+      zmq_send(socket_, jpeg.data(), jpeg.size(), 0);
+    } else {
+      uint32_t header_len = static_cast<uint32_t>(header.size());
+      std::vector<uint8_t> message(sizeof(header_len) + header_len + jpeg.size());
+      memcpy(message.data(), &header_len, sizeof(header_len));
+      memcpy(message.data() + sizeof(header_len), header.data(), header_len);
+      memcpy(message.data() + sizeof(header_len) + header_len, jpeg.data(), jpeg.size());
+      bytes_copied_ += static_cast<int64_t>(message.size());
+      zmq_send(socket_, message.data(), message.size(), 0);
+    }
+    ++sent_;
+    std::this_thread::sleep_for(std::chrono::milliseconds(kTestFrameIntervalMs));
+  }
+}
+
+// =============================================================================
+// BlockingReceiver
+// =============================================================================
+
+BlockingReceiver::~BlockingReceiver() {
+  Signal();
+  Join();
+}
+
+void BlockingReceiver::Start(int port, FrameHandler on_frame) {
+  running_ = true;
+  thread_ = std::thread(&BlockingReceiver::Loop, this, port, std::move(on_frame));
+}
+
+void BlockingReceiver::Signal() {
+  running_ = false;
+  std::lock_guard<std::mutex> lock(socket_mutex_);
+  if (socket_ != kInvalidSocket) {
+    shutdown(ToNative(socket_), kShutdownBoth);
+  }
+}
+
+void BlockingReceiver::Join() {
+  if (thread_.joinable()) thread_.join();
+}
+
+void BlockingReceiver::Loop(int port, FrameHandler on_frame) {
+  SocketHandle socket = static_cast<SocketHandle>(::socket(AF_INET, SOCK_STREAM, 0));
+  {
+    std::lock_guard<std::mutex> lock(socket_mutex_);
+    if (!running_ || socket == kInvalidSocket) {
+      CloseSocket(socket);
+      return;
+    }
+    socket_ = socket;
+  }
+
+  sockaddr_in addr = Loopback(port);
+  const char request[] = "GET /stream HTTP/1.0\r\n\r\n";
+  if (connect(ToNative(socket), reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0 &&
+      SendAll(socket, request, sizeof(request) - 1)) {
+    MjpegParser parser(MjpegServer::kBoundary);
+    while (running_) {
+      uint8_t* dst = parser.PrepareWrite(64 * 1024);
+      int received = recv(ToNative(socket), reinterpret_cast<char*>(dst), 64 * 1024, 0);  // blocks
+      if (received <= 0) break;
+      parser.Commit(static_cast<size_t>(received), on_frame);
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(socket_mutex_);
+  socket_ = kInvalidSocket;
+  CloseSocket(socket);
+}
+
+// =============================================================================
+// EncodeBinaryFrameHeader
+// =============================================================================
+
+namespace {
+
+void WriteLittleEndian(uint8_t* out, uint64_t value, size_t bytes) {
+  for (size_t i = 0; i < bytes; ++i) {
+    out[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+}
+
+}  // namespace
+
+std::vector<uint8_t> EncodeBinaryFrameHeader(const FrameHeader& header, uint16_t version,
+                                             size_t header_size) {
+  std::vector<uint8_t> out((std::max)(header_size, kBinaryHeaderSize), 0);
+  size_t cam_idx_size = (std::min)(header.cam_idx_size, kBinaryHeaderCamIdxBytes);
+  size_t cam_num_size = (std::min)(header.cam_num_size, kBinaryHeaderCamNumBytes);
+
+  memcpy(out.data(), kBinaryHeaderMagic, sizeof(kBinaryHeaderMagic));
+  WriteLittleEndian(&out[4], version, 2);
+  WriteLittleEndian(&out[6], out.size(), 2);
+  out[8] = static_cast<uint8_t>((header.motion ? 1 : 0) | (header.has_bbox ? 2 : 0));
+  out[9] = static_cast<uint8_t>(cam_idx_size);
+  out[10] = static_cast<uint8_t>(cam_num_size);
+  WriteLittleEndian(&out[16], header.sequence, 8);
+  WriteLittleEndian(&out[24], static_cast<uint64_t>(header.capture_time_us), 8);
+  uint64_t brightness_bits = 0;
+  memcpy(&brightness_bits, &header.brightness, sizeof(brightness_bits));
+  WriteLittleEndian(&out[32], brightness_bits, 8);
+  if (header.has_bbox) {
+    WriteLittleEndian(&out[40], static_cast<uint32_t>(header.bbox_x), 4);
+    WriteLittleEndian(&out[44], static_cast<uint32_t>(header.bbox_y), 4);
+    WriteLittleEndian(&out[48], static_cast<uint32_t>(header.bbox_w), 4);
+    WriteLittleEndian(&out[52], static_cast<uint32_t>(header.bbox_h), 4);
+  }
+  memcpy(&out[56], header.cam_idx, cam_idx_size);
+  memcpy(&out[88], header.cam_num, cam_num_size);
+  return out;
+}
+
+// =============================================================================
+// Measurement helpers
+// =============================================================================
+
+int64_t TestFrameAgeUs(const uint8_t* jpeg, size_t size) {
+  int64_t sent = 0;
+  if (size < kSendTimeOffset + sizeof(sent)) return -1;
+  memcpy(&sent, jpeg + kSendTimeOffset, sizeof(sent));
+  return NowUs() - sent;
+}
+
+ProcessUsage SampleProcessUsage() {
+  ProcessUsage usage;
+#ifdef __linux__
+  if (DIR* dir = opendir("/proc/self/task")) {
+    usage.threads = 0;
+    while (dirent* entry = readdir(dir)) {
+      if (entry->d_name[0] != '.') ++usage.threads;
+    }
+    closedir(dir);
+  }
+  rusage ru{};
+  getrusage(RUSAGE_SELF, &ru);
+  usage.cpu_seconds = ru.ru_utime.tv_sec + ru.ru_stime.tv_sec +
+                      (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e6;
+  usage.context_switches = ru.ru_nvcsw + ru.ru_nivcsw;
+#endif
+  return usage;
+}
+
+// =============================================================================
+// EncodeTestJpeg
+// =============================================================================
+
+std::vector<uint8_t> EncodeTestJpeg(int width, int height, int quality, int restart_rows) {
+  std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+  uint32_t noise = 12345;
+  for (int y = 0; y < height; ++y) {
+    uint8_t* row = rgba.data() + static_cast<size_t>(y) * width * 4;
+    for (int x = 0; x < width; ++x) {
+      noise = noise * 1103515245u + 12345u;
+      int grain = static_cast<int>((noise >> 16) & 0x1F) - 16;
+      row[x * 4 + 0] = static_cast<uint8_t>((std::min)(255, (std::max)(0, x * 255 / width + grain)));
+      row[x * 4 + 1] = static_cast<uint8_t>((std::min)(255, (std::max)(0, y * 255 / height + grain)));
+      row[x * 4 + 2] = static_cast<uint8_t>(((x / 64 + y / 64) & 1) ? 200 : 60);
+      row[x * 4 + 3] = 255;
+    }
+  }
+
+  std::vector<uint8_t> jpeg;
+  tjhandle tj = tj3Init(TJINIT_COMPRESS);
+  if (!tj) return jpeg;
+  tj3Set(tj, TJPARAM_QUALITY, quality);
+  tj3Set(tj, TJPARAM_SUBSAMP, TJSAMP_420);
+  tj3Set(tj, TJPARAM_RESTARTROWS, restart_rows);
+  unsigned char* data = nullptr;
+  size_t size = 0;
+  if (tj3Compress8(tj, rgba.data(), width, 0, height, TJPF_RGBA, &data, &size) == 0) {
+    jpeg.assign(data, data + size);
+  }
+  tj3Free(data);
+  tj3Destroy(tj);
+  return jpeg;
+}
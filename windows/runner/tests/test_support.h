@@ -0,0 +1,150 @@
+#pragma once
+
+#include "frame_header.h"
+#include "mjpeg_parser.h"
+#include "socket_poller.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Loopback camera stand-ins for the native video tests. Both stream small
+// fake JPEGs (SOI, filler, send time, EOI) at about 30 fps; decoding is simulated by
+// the tests, so the payload never goes through libjpeg-turbo.
+
+constexpr int kTestFrameIntervalMs = 33;
+constexpr size_t kTestJpegBytes = 20000;
+
+// HTTP MJPEG server on 127.0.0.1 (any free port), one thread per client
+class MjpegServer {
+ public:
+  MjpegServer();
+  ~MjpegServer();
+
+  MjpegServer(const MjpegServer&) = delete;
+  MjpegServer& operator=(const MjpegServer&) = delete;
+
+  bool ok() const { return port_ != 0; }
+  int port() const { return port_; }
+  std::string url() const;  // http://127.0.0.1:port/stream
+
+  static constexpr const char* kBoundary = "testboundary";
+
+ private:
+  void AcceptLoop();
+  void Serve(SocketHandle client);
+
+  bool started_ = false;
+  SocketHandle listen_ = kInvalidSocket;
+  int port_ = 0;
+  std::atomic<bool> stopping_{false};
+  std::thread accept_thread_;
+  std::mutex mutex_;
+  std::vector<std::thread> clients_;
+  std::vector<SocketHandle> client_sockets_;
+};
+
+// Wire formats of docs/ZMQ_HEADER_FORMAT.md
+enum class ZmqWireFormat {
+  kTwoPart,         // "[JSON header]" "[JPEG]"
+  kLengthPrefixed,  // "[4-byte header_len][JSON header][JPEG]" in one part
+};
+
+// Header encodings of docs/ZMQ_HEADER_FORMAT.md
+enum class FrameHeaderEncoding {
+  kJson,
+  kBinary,  // v1: sequence = frame index, capture time = send time
+};
+
+// Reference encoder for the binary header: header's fields at their v1
+// offsets, little-endian. header_size > kBinaryHeaderSize appends zeros the
+// way a newer version would append fields.
+std::vector<uint8_t> EncodeBinaryFrameHeader(const FrameHeader& header,
+                                             uint16_t version = kBinaryHeaderVersion,
+                                             size_t header_size = kBinaryHeaderSize);
+
+// ZMQ PUB socket sending [header][JPEG] messages in either wire format and
+// header encoding, with its own context so Stop() looks like the publisher
+// process going away
+class ZmqPublisher {
+ public:
+  explicit ZmqPublisher(ZmqWireFormat format = ZmqWireFormat::kTwoPart,
+                        FrameHeaderEncoding encoding = FrameHeaderEncoding::kJson)
+      : format_(format), encoding_(encoding) {}
+  ~ZmqPublisher();
+
+  ZmqPublisher(const ZmqPublisher&) = delete;
+  ZmqPublisher& operator=(const ZmqPublisher&) = delete;
+
+  // Binds (the same port again after Stop) and starts publishing
+  bool Start();
+  // Closes the socket and terminates the context; subscribers see the TCP
+  // connection drop and keep reconnecting until Start() binds again
+  void Stop();
+
+  std::string address() const;  // tcp://127.0.0.1:port
+  int64_t sent() const { return sent_.load(); }
+  // Bytes the publisher copied to put its messages together (the
+  // length-prefixed format concatenates header and JPEG)
+  int64_t bytes_copied() const { return bytes_copied_.load(); }
+
+ private:
+  void Loop();
+
+  ZmqWireFormat format_;
+  FrameHeaderEncoding encoding_;
+  int port_ = 0;
+  void* context_ = nullptr;
+  void* socket_ = nullptr;
+  std::atomic<bool> running_{false};
+  std::atomic<int64_t> sent_{0};
+  std::atomic<int64_t> bytes_copied_{0};
+  std::thread thread_;
+};
+
+// Receive thread doing blocking reads from an MjpegServer, standing in for
+// the WinHTTP receive thread of an https:// stream. Signal() aborts a blocked
+// read the way closing the WinHTTP handles does.
+class BlockingReceiver {
+ public:
+  using FrameHandler = MjpegParser::FrameHandler;
+
+  BlockingReceiver() = default;
+  ~BlockingReceiver();
+
+  void Start(int port, FrameHandler on_frame);
+  // Any thread: stops the loop and unblocks its read
+  void Signal();
+  void Join();
+
+ private:
+  void Loop(int port, FrameHandler on_frame);
+
+  std::atomic<bool> running_{false};
+  std::mutex socket_mutex_;
+  SocketHandle socket_ = kInvalidSocket;  // guarded by socket_mutex_
+  std::thread thread_;
+};
+
+// Microseconds since a test server sent this fake JPEG (MjpegServer and
+// ZmqPublisher stamp the send time into each); -1 if it carries no stamp
+int64_t TestFrameAgeUs(const uint8_t* jpeg, size_t size);
+
+// Whole-process counters for the benchmarks (Linux; threads is -1 and the
+// rest 0 elsewhere)
+struct ProcessUsage {
+  int threads = -1;
+  double cpu_seconds = 0.0;  // user + system
+  long context_switches = 0;  // voluntary + involuntary
+};
+ProcessUsage SampleProcessUsage();
+
+// Real JPEG for the decode benchmarks: a gradient with some noise, so it
+// compresses like a camera frame rather than a flat image. restart_rows > 0
+// puts a restart marker every that many MCU rows (see jpeg_restart.h).
+// Empty if encoding failed.
+std::vector<uint8_t> EncodeTestJpeg(int width, int height, int quality = 85, int restart_rows = 0);
@@ -0,0 +1,190 @@
+// Tail latency of the display work under decode load, per ThreadPolicy setup.
+// A display thread ticks at 120 Hz and does 1 ms of work per tick while one
+// decode thread per hardware thread (at least 3) and a bursty network thread
+// compete for the cores. Setups:
+//   default    every role at normal priority, no core sets
+//   priority   display high, network normal, decode low (what applyPartition
+//              sets on fewer than 4 cores)
+//   partition  applyPartition's core sets too: display on core 0, network on
+//              core 1, decode on the rest (4+ cores only)
+// Reports how late the display thread woke for its ticks, the ticks whose
+// work ran past the next tick, and the decode work done. Raising the display
+// priority needs CAP_SYS_NICE on Linux; a refused Apply is reported.
+//
+//   thread_policy_bench [seconds per setup]
+#include "thread_policy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto kTickPeriod = std::chrono::microseconds(8333);  // 120 Hz
+constexpr double kDisplayWorkMs = 1.0;
+constexpr double kDecodeChunkMs = 0.2;
+constexpr double kNetworkBurstMs = 0.1;
+constexpr auto kNetworkInterval = std::chrono::milliseconds(1);
+
+std::atomic<uint64_t> g_sink{0};
+
+// Fixed amount of CPU work, so preemption shows up as elapsed time
+void Spin(int64_t iterations) {
+  uint64_t x = g_sink.load(std::memory_order_relaxed) | 1;
+  for (int64_t i = 0; i < iterations; ++i) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+  }
+  g_sink.store(x, std::memory_order_relaxed);
+}
+
+// Iterations of Spin per millisecond on an idle core
+int64_t CalibrateIterationsPerMs() {
+  int64_t iterations = 1 << 16;
+  while (true) {
+    Clock::time_point start = Clock::now();
+    Spin(iterations);
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    if (ms >= 50.0) return static_cast<int64_t>(iterations / ms);
+    iterations *= 2;
+  }
+}
+
+uint64_t CoreMask(int first, int count) {
+  return count >= 64 ? ~uint64_t{0} << first : ((uint64_t{1} << count) - 1) << first;
+}
+
+struct Setup {
+  const char* name;
+  ThreadPolicy::Rule display;
+  ThreadPolicy::Rule network;
+  ThreadPolicy::Rule decode;
+};
+
+struct Result {
+  std::vector<double> late_ms;  // per tick, wakeup minus deadline
+  int missed = 0;               // ticks whose work ended past the next deadline
+  int64_t decode_chunks = 0;
+  bool applied = true;          // every Apply succeeded
+};
+
+Result Run(const Setup& setup, int decode_threads, int seconds, int64_t per_ms) {
+  ThreadPolicy& policy = ThreadPolicy::Instance();
+  policy.Set(ThreadRole::kDisplay, setup.display);
+  policy.Set(ThreadRole::kNetwork, setup.network);
+  policy.Set(ThreadRole::kDecode, setup.decode);
+
+  Result result;
+  std::atomic<bool> stop{false};
+  std::atomic<bool> applied{true};
+  std::atomic<int64_t> chunks{0};
+
+  std::vector<std::thread> load;
+  for (int i = 0; i < decode_threads; ++i) {
+    load.emplace_back([&]() {
+      if (!policy.Apply(ThreadRole::kDecode)) applied = false;
+      int64_t count = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        Spin(static_cast<int64_t>(per_ms * kDecodeChunkMs));
+        ++count;
+      }
+      chunks += count;
+    });
+  }
+  load.emplace_back([&]() {
+    if (!policy.Apply(ThreadRole::kNetwork)) applied = false;
+    while (!stop.load(std::memory_order_relaxed)) {
+      std::this_thread::sleep_for(kNetworkInterval);
+      Spin(static_cast<int64_t>(per_ms * kNetworkBurstMs));
+    }
+  });
+
+  std::thread display([&]() {
+    if (!policy.Apply(ThreadRole::kDisplay)) applied = false;
+    Clock::time_point end = Clock::now() + std::chrono::seconds(seconds);
+    Clock::time_point deadline = Clock::now() + kTickPeriod;
+    while (deadline < end) {
+      std::this_thread::sleep_until(deadline);
+      Clock::duration late = Clock::now() - deadline;
+      result.late_ms.push_back(std::chrono::duration<double, std::milli>(late).count());
+      Spin(static_cast<int64_t>(per_ms * kDisplayWorkMs));
+      deadline += kTickPeriod;
+      // A tick that overran is dropped, as a display would skip a vsync
+      while (Clock::now() > deadline) {
+        ++result.missed;
+        deadline += kTickPeriod;
+      }
+    }
+  });
+  display.join();
+  stop = true;
+  for (auto& thread : load) thread.join();
+
+  result.decode_chunks = chunks;
+  result.applied = applied;
+  return result;
+}
+
+double Percentile(const std::vector<double>& sorted, double p) {
+  if (sorted.empty()) return 0.0;
+  size_t index = static_cast<size_t>(p * (sorted.size() - 1));
+  return sorted[index];
+}
+
+// ns per Apply call when the role hasn't changed
+double ApplyCostNs() {
+  constexpr int kCalls = 10000000;
+  ThreadPolicy& policy = ThreadPolicy::Instance();
+  policy.Apply(ThreadRole::kDecode);
+  Clock::time_point start = Clock::now();
+  for (int i = 0; i < kCalls; ++i) {
+    policy.Apply(ThreadRole::kDecode);
+  }
+  return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / kCalls;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int seconds = argc > 1 ? std::atoi(argv[1]) : 10;
+  if (seconds < 1) seconds = 1;
+
+  int cores = static_cast<int>((std::min)(ThreadPolicy::Instance().CoreCount(ThreadRole::kDecode),
+                                          size_t{64}));
+  int decode_threads = (std::max)(3, cores);
+  int64_t per_ms = CalibrateIterationsPerMs();
+
+  const ThreadPriority normal = ThreadPriority::kNormal;
+  std::vector<Setup> setups = {
+      {"default", {0, normal}, {0, normal}, {0, normal}},
+      {"priority", {0, ThreadPriority::kHigh}, {0, normal}, {0, ThreadPriority::kLow}},
+  };
+  if (cores >= 4) {
+    setups.push_back({"partition",
+                      {CoreMask(0, 1), ThreadPriority::kHigh},
+                      {CoreMask(1, 1), normal},
+                      {CoreMask(2, cores - 2), ThreadPriority::kLow}});
+  }
+
+  std::printf("%d cores, %d decode threads, %d s per setup\n", cores, decode_threads, seconds);
+  std::printf("setup      late ms: p50    p99  p99.9    max  missed  decode chunks\n");
+  for (const Setup& setup : setups) {
+    Result r = Run(setup, decode_threads, seconds, per_ms);
+    std::sort(r.late_ms.begin(), r.late_ms.end());
+    std::printf("%-10s %14.2f %6.2f %6.2f %6.2f  %6d  %13lld%s\n", setup.name,
+                Percentile(r.late_ms, 0.5), Percentile(r.late_ms, 0.99),
+                Percentile(r.late_ms, 0.999), r.late_ms.empty() ? 0.0 : r.late_ms.back(), r.missed,
+                static_cast<long long>(r.decode_chunks), r.applied ? "" : "  (Apply refused)");
+  }
+  if (cores < 4) std::printf("partition skipped: needs 4 cores\n");
+
+  std::printf("Apply() with no change: %.1f ns\n", ApplyCostNs());
+  return 0;
+}
@@ -0,0 +1,132 @@
+// The two decode paths of DecodeJpeg when brightness is measured, against
+// the one-call decode it uses otherwise:
+//   rgba       tj3Decompress8 to RGBA (no brightness)
+//   rgba+luma  the same, then a separate pass summing BT.601 luma over RGBA
+//   yuv        tj3DecompressToYUVPlanes8 + ConvertYuvToRgba, which converts
+//              and sums the luma in one pass (split into its two steps)
+// Unscaled 4:2:0 test JPEGs at 1080p and 4K.
+//
+//   yuv_decode_bench [seconds per case]
+#include "test_support.h"
+#include "yuv_convert.h"
+
+#include <turbojpeg.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kMinIterations = 3;
+
+struct Timing {
+  double decode_ms = 0.0;   // libjpeg-turbo call
+  double convert_ms = 0.0;  // our pass afterwards, if any
+  bool ok = true;
+};
+
+template <typename Decode, typename Convert>
+Timing Run(double seconds, Decode decode, Convert convert) {
+  Timing timing;
+  Clock::duration decode_time{};
+  Clock::duration convert_time{};
+  int iterations = 0;
+  Clock::time_point start = Clock::now();
+  std::chrono::duration<double> run_for(seconds);
+  while (iterations < kMinIterations || Clock::now() - start < run_for) {
+    Clock::time_point t0 = Clock::now();
+    if (!decode()) {
+      timing.ok = false;
+      return timing;
+    }
+    Clock::time_point t1 = Clock::now();
+    convert();
+    decode_time += t1 - t0;
+    convert_time += Clock::now() - t1;
+    ++iterations;
+  }
+  timing.decode_ms = std::chrono::duration<double, std::milli>(decode_time).count() / iterations;
+  timing.convert_ms = std::chrono::duration<double, std::milli>(convert_time).count() / iterations;
+  return timing;
+}
+
+uint64_t SumRgbaLuma(const uint8_t* rgba, size_t pixels) {
+  uint64_t sum = 0;
+  for (size_t i = 0; i < pixels; ++i, rgba += 4) {
+    sum += (77u * rgba[0] + 150u * rgba[1] + 29u * rgba[2]) >> 8;
+  }
+  return sum;
+}
+
+void Print(const char* path, const Timing& timing) {
+  if (!timing.ok) {
+    std::printf("%-10s %9s\n", path, "failed");
+    return;
+  }
+  std::printf("%-10s %9.2f %9.2f %9.2f\n", path, timing.decode_ms, timing.convert_ms,
+              timing.decode_ms + timing.convert_ms);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  double seconds = argc > 1 ? std::atof(argv[1]) : 0.5;
+
+  tjhandle tj = tj3Init(TJINIT_DECOMPRESS);
+  if (!tj) {
+    std::printf("FAIL: libjpeg-turbo not usable\n");
+    return 1;
+  }
+  std::printf("YUV kernel: %s\n", YuvKernelName());
+
+  volatile uint64_t sink = 0;
+  for (auto size : {std::make_pair(1920, 1080), std::make_pair(3840, 2160)}) {
+    int width = size.first;
+    int height = size.second;
+    std::vector<uint8_t> jpeg = EncodeTestJpeg(width, height);
+    if (jpeg.empty() || tj3DecompressHeader(tj, jpeg.data(), jpeg.size()) != 0) {
+      std::printf("FAIL: could not encode a %dx%d test JPEG\n", width, height);
+      return 1;
+    }
+    tj3SetScalingFactor(tj, TJUNSCALED);
+    int subsamp = tj3Get(tj, TJPARAM_SUBSAMP);
+    size_t pixels = static_cast<size_t>(width) * height;
+    std::vector<uint8_t> rgba(pixels * 4);
+
+    std::vector<uint8_t> planes[3];
+    unsigned char* dst[3] = {};
+    YuvImage yuv;
+    for (int c = 0; c < 3; ++c) {
+      int stride = tj3YUVPlaneWidth(c, width, subsamp);
+      planes[c].resize(tj3YUVPlaneSize(c, width, stride, height, subsamp));
+      dst[c] = planes[c].data();
+      yuv.planes[c] = planes[c].data();
+      yuv.strides[c] = stride;
+    }
+    yuv.width = width;
+    yuv.height = height;
+    yuv.chroma_shift_x = tjMCUWidth[subsamp] / 16;
+    yuv.chroma_shift_y = tjMCUHeight[subsamp] / 16;
+
+    auto decode_rgba = [&]() {
+      return tj3Decompress8(tj, jpeg.data(), jpeg.size(), rgba.data(), width * 4, TJPF_RGBA) == 0;
+    };
+    auto decode_yuv = [&]() {
+      return tj3DecompressToYUVPlanes8(tj, jpeg.data(), jpeg.size(), dst, yuv.strides) == 0;
+    };
+
+    std::printf("\n%dx%d (%zu KB)\n", width, height, jpeg.size() / 1024);
+    std::printf("path        decode ms  ours ms  total ms\n");
+    Print("rgba", Run(seconds, decode_rgba, []() {}));
+    Print("rgba+luma", Run(seconds, decode_rgba,
+                           [&]() { sink = sink + SumRgbaLuma(rgba.data(), pixels); }));
+    Print("yuv", Run(seconds, decode_yuv,
+                     [&]() { sink = sink + ConvertYuvToRgba(yuv, rgba.data(), width * 4u); }));
+  }
+
+  tj3Destroy(tj);
+  return 0;
+}
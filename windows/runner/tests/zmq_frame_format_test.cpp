@@ -0,0 +1,379 @@
+// Both ZMQ wire formats of docs/ZMQ_HEADER_FORMAT.md:
+//   1. SplitLengthPrefixedFrame on hand-built buffers, including the cases
+//      that fall back to a raw JPEG
+//   2. SplitFrame on messages received over an inproc pair, one and two parts
+//   3. binary headers from the reference encoder read back field for field,
+//      including a longer (newer version) header; bad ones are rejected
+//   4. ZmqPublisher in each format and header encoding feeding a ZmqReactor:
+//      every frame must split into its header and JPEG with the JPEG span
+//      pointing into the received message (no copy on the receive side), and
+//      binary headers must carry consecutive sequence numbers and a current
+//      capture time
+// Prints the bytes each side copies per frame.
+//
+//   zmq_frame_format_test
+#include "frame_header.h"
+#include "test_support.h"
+#include "zmq_message.h"
+#include "zmq_reactor.h"
+
+#include <zmq.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kFramesPerFormat = 10;
+constexpr auto kReceiveTimeout = std::chrono::seconds(5);
+constexpr char kHeader[] = R"({"header": {"cam_idx": "a", "cam_num": "7"}})";
+constexpr size_t kHeaderSize = sizeof(kHeader) - 1;
+
+int failures = 0;
+
+void Check(bool ok, const char* what) {
+  if (!ok) {
+    std::printf("FAIL: %s\n", what);
+    ++failures;
+  }
+}
+
+std::vector<uint8_t> Jpeg(size_t size) {
+  std::vector<uint8_t> jpeg(size, 0x11);
+  jpeg[0] = 0xFF;
+  jpeg[1] = 0xD8;
+  jpeg[size - 2] = 0xFF;
+  jpeg[size - 1] = 0xD9;
+  return jpeg;
+}
+
+std::vector<uint8_t> LengthPrefixed(uint32_t header_len, const void* header, size_t header_size,
+                                    const std::vector<uint8_t>& jpeg) {
+  std::vector<uint8_t> message(sizeof(header_len) + header_size + jpeg.size());
+  memcpy(message.data(), &header_len, sizeof(header_len));
+  if (header_size > 0) memcpy(message.data() + sizeof(header_len), header, header_size);
+  memcpy(message.data() + sizeof(header_len) + header_size, jpeg.data(), jpeg.size());
+  return message;
+}
+
+void TestLengthPrefixed() {
+  std::vector<uint8_t> jpeg = Jpeg(1000);
+
+  std::vector<uint8_t> message = LengthPrefixed(kHeaderSize, kHeader, kHeaderSize, jpeg);
+  FrameView view = SplitLengthPrefixedFrame(message.data(), message.size());
+  Check(view.header == message.data() + 4 && view.header_size == kHeaderSize,
+        "length-prefixed: header span");
+  Check(view.jpeg == message.data() + 4 + kHeaderSize && view.jpeg_size == jpeg.size(),
+        "length-prefixed: JPEG span");
+
+  // Each of these is a raw JPEG: the whole message is the JPEG
+  struct RawCase {
+    const char* name;
+    std::vector<uint8_t> message;
+  };
+  RawCase cases[] = {
+      {"header_len 0", LengthPrefixed(0, nullptr, 0, jpeg)},
+      {"header_len past the end", LengthPrefixed(5000, kHeader, kHeaderSize, jpeg)},
+      {"header_len over the limit",
+       LengthPrefixed(static_cast<uint32_t>(kMaxFrameHeaderBytes + 1), kHeader, kHeaderSize, jpeg)},
+      {"raw JPEG", jpeg},
+      {"shorter than the prefix", std::vector<uint8_t>{0xFF, 0xD8, 0xFF}},
+  };
+  for (const RawCase& c : cases) {
+    view = SplitLengthPrefixedFrame(c.message.data(), c.message.size());
+    if (view.header != nullptr || view.jpeg != c.message.data() ||
+        view.jpeg_size != c.message.size()) {
+      std::printf("FAIL: length-prefixed: %s not taken as a raw JPEG\n", c.name);
+      ++failures;
+    }
+  }
+
+  view = SplitLengthPrefixedFrame(nullptr, 0);
+  Check(view.header == nullptr && view.jpeg == nullptr, "length-prefixed: empty message");
+}
+
+// Sends parts on one end of an inproc pair and receives them into frame the
+// way the reactor does (first two parts)
+bool RoundTrip(void* send, void* recv, const std::vector<std::vector<uint8_t>>& parts,
+               ZmqFrame* frame) {
+  for (size_t i = 0; i < parts.size(); ++i) {
+    int flags = i + 1 < parts.size() ? ZMQ_SNDMORE : 0;
+    if (zmq_send(send, parts[i].data(), parts[i].size(), flags) < 0) return false;
+  }
+  frame->Reset();
+  if (!frame->parts[0].Receive(recv, 0)) return false;
+  frame->part_count = 1;
+  if (frame->parts[0].more()) {
+    if (!frame->parts[1].Receive(recv, 0)) return false;
+    frame->part_count = 2;
+  }
+  return true;
+}
+
+void TestSplitFrame() {
+  void* context = zmq_ctx_new();
+  void* recv = zmq_socket(context, ZMQ_PAIR);
+  void* send = zmq_socket(context, ZMQ_PAIR);
+  zmq_bind(recv, "inproc://split-frame");
+  zmq_connect(send, "inproc://split-frame");
+
+  std::vector<uint8_t> jpeg = Jpeg(50000);
+  std::vector<uint8_t> header(kHeader, kHeader + kHeaderSize);
+  ZmqFrame frame;
+
+  if (RoundTrip(send, recv, {header, jpeg}, &frame)) {
+    FrameView view = SplitFrame(frame);
+    Check(frame.part_count == 2, "two-part: part count");
+    Check(view.header == frame.parts[0].data() && view.header_size == kHeaderSize,
+          "two-part: header is the first part");
+    Check(view.jpeg == frame.parts[1].data() && view.jpeg_size == jpeg.size() &&
+              memcmp(view.jpeg, jpeg.data(), jpeg.size()) == 0,
+          "two-part: JPEG is the second part, in place");
+  } else {
+    Check(false, "two-part: round trip");
+  }
+
+  if (RoundTrip(send, recv, {std::vector<uint8_t>(), jpeg}, &frame)) {
+    FrameView view = SplitFrame(frame);
+    Check(view.header == nullptr && view.jpeg == frame.parts[1].data(),
+          "two-part: empty header part means no header");
+  } else {
+    Check(false, "two-part empty header: round trip");
+  }
+
+  if (RoundTrip(send, recv, {std::vector<uint8_t>(kMaxFrameHeaderBytes + 1, '{'), jpeg}, &frame)) {
+    FrameView view = SplitFrame(frame);
+    Check(view.header == nullptr && view.jpeg_size == jpeg.size(),
+          "two-part: oversized header part is ignored");
+  } else {
+    Check(false, "two-part oversized header: round trip");
+  }
+
+  std::vector<uint8_t> message = LengthPrefixed(kHeaderSize, kHeader, kHeaderSize, jpeg);
+  if (RoundTrip(send, recv, {message}, &frame)) {
+    FrameView view = SplitFrame(frame);
+    Check(frame.part_count == 1, "length-prefixed: part count");
+    Check(view.header == frame.parts[0].data() + 4 && view.header_size == kHeaderSize &&
+              view.jpeg == frame.parts[0].data() + 4 + kHeaderSize &&
+              view.jpeg_size == jpeg.size(),
+          "length-prefixed: spans point into the received part");
+  } else {
+    Check(false, "length-prefixed: round trip");
+  }
+
+  frame.Reset();
+  zmq_close(send);
+  zmq_close(recv);
+  zmq_ctx_term(context);
+}
+
+bool SameFields(const FrameHeader& a, const FrameHeader& b) {
+  return a.cam_idx_view() == b.cam_idx_view() && a.cam_num_view() == b.cam_num_view() &&
+         a.brightness == b.brightness && a.motion == b.motion && a.has_bbox == b.has_bbox &&
+         a.bbox_x == b.bbox_x && a.bbox_y == b.bbox_y && a.bbox_w == b.bbox_w &&
+         a.bbox_h == b.bbox_h && a.has_sequence && b.has_sequence && a.sequence == b.sequence &&
+         a.capture_time_us == b.capture_time_us;
+}
+
+void TestBinaryHeader() {
+  FrameHeader fields;
+  memcpy(fields.cam_idx, "top_1", 5);
+  fields.cam_idx_size = 5;
+  memcpy(fields.cam_num, "1", 1);
+  fields.cam_num_size = 1;
+  fields.brightness = 51.7;
+  fields.motion = true;
+  fields.has_bbox = true;
+  fields.bbox_x = 284;
+  fields.bbox_y = -1;
+  fields.bbox_w = 712;
+  fields.bbox_h = 480;
+  fields.has_sequence = true;
+
+  struct Case {
+    uint64_t sequence;
+    int64_t capture_time_us;
+  };
+  const Case cases[] = {{0, 0},
+                        {1, 1760000000000000},
+                        {0xFFFFFFFFull, -1},
+                        {UINT64_MAX, INT64_MAX},
+                        {UINT64_MAX - 1, INT64_MIN}};
+  for (const Case& c : cases) {
+    fields.sequence = c.sequence;
+    fields.capture_time_us = c.capture_time_us;
+    for (uint16_t version : {kBinaryHeaderVersion, static_cast<uint16_t>(2)}) {
+      // A newer version appends fields; v1 readers skip them
+      size_t size = version == kBinaryHeaderVersion ? kBinaryHeaderSize : kBinaryHeaderSize + 16;
+      std::vector<uint8_t> header = EncodeBinaryFrameHeader(fields, version, size);
+      FrameHeader parsed;
+      uint16_t written_version = static_cast<uint16_t>(header[4] | (header[5] << 8));
+      if (header.size() != size || written_version != version ||
+          !IsBinaryFrameHeader(header.data(), header.size()) ||
+          !ParseBinaryFrameHeader(header.data(), header.size(), &parsed) ||
+          !SameFields(parsed, fields)) {
+        std::printf("FAIL: binary header v%u, sequence %llu, capture time %lld did not read back\n",
+                    version, static_cast<unsigned long long>(c.sequence),
+                    static_cast<long long>(c.capture_time_us));
+        ++failures;
+      }
+    }
+  }
+
+  FrameHeader parsed;
+  std::vector<uint8_t> header = EncodeBinaryFrameHeader(fields, 0);
+  Check(!ParseBinaryFrameHeader(header.data(), header.size(), &parsed),
+        "binary header: version 0 accepted");
+  header = EncodeBinaryFrameHeader(fields);
+  Check(!ParseBinaryFrameHeader(header.data(), header.size() - 1, &parsed),
+        "binary header: truncated header accepted");
+  header = EncodeBinaryFrameHeader(fields, 2, kBinaryHeaderSize + 16);
+  Check(!ParseBinaryFrameHeader(header.data(), kBinaryHeaderSize, &parsed),
+        "binary header: header_size past the data accepted");
+}
+
+struct Received {
+  std::mutex mutex;
+  int frames = 0;
+  int bad = 0;
+  int out_of_sequence = 0;
+  bool in_place = true;
+  bool has_last = false;
+  uint64_t last_sequence = 0;
+};
+
+bool ReadHeader(const FrameView& view, FrameHeaderEncoding encoding, FrameHeader* header) {
+  if (view.header == nullptr) return false;
+  if (encoding == FrameHeaderEncoding::kBinary) {
+    return IsBinaryFrameHeader(view.header, view.header_size) &&
+           ParseBinaryFrameHeader(view.header, view.header_size, header);
+  }
+  return !IsBinaryFrameHeader(view.header, view.header_size) &&
+         ParseFrameHeader(
+             std::string_view(reinterpret_cast<const char*>(view.header), view.header_size), header);
+}
+
+// Capture times written by the publisher a moment ago, on the same clock
+bool CurrentCaptureTime(int64_t capture_time_us) {
+  int64_t now = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::system_clock::now().time_since_epoch())
+                    .count();
+  return capture_time_us <= now && now - capture_time_us < 5 * 1000 * 1000;
+}
+
+void TestPublisher(ZmqReactor* reactor, int64_t key, ZmqWireFormat format,
+                   FrameHeaderEncoding encoding, const char* name) {
+  ZmqPublisher publisher(format, encoding);
+  if (!publisher.Start()) {
+    std::printf("FAIL: %s: publisher did not start\n", name);
+    ++failures;
+    return;
+  }
+
+  Received received;
+  std::string error;
+  bool subscribed = reactor->Subscribe(
+      key, publisher.address(), IngestPolicy::kEveryFrame,
+      [&](ZmqFrame& frame, int) {
+        FrameView view = SplitFrame(frame);
+        FrameHeader header;
+        bool ok = ReadHeader(view, encoding, &header) && header.cam_idx_view() == "test" &&
+                  view.jpeg_size == kTestJpegBytes &&
+                  view.jpeg[0] == 0xFF && view.jpeg[1] == 0xD8 &&
+                  view.jpeg[view.jpeg_size - 2] == 0xFF && view.jpeg[view.jpeg_size - 1] == 0xD9;
+        // The JPEG must be read where libzmq received it
+        const uint8_t* part = frame.parts[frame.part_count - 1].data();
+        size_t part_size = frame.parts[frame.part_count - 1].size();
+        bool in_place = view.jpeg >= part && view.jpeg + view.jpeg_size == part + part_size;
+
+        bool binary = encoding == FrameHeaderEncoding::kBinary;
+        if (ok && binary) {
+          ok = header.has_sequence && CurrentCaptureTime(header.capture_time_us) &&
+               header.cam_num_view() == std::to_string(header.sequence);
+        }
+
+        std::lock_guard<std::mutex> lock(received.mutex);
+        ++received.frames;
+        if (!ok) ++received.bad;
+        if (!in_place) received.in_place = false;
+        if (ok && binary) {
+          if (received.has_last && header.sequence != received.last_sequence + 1) {
+            ++received.out_of_sequence;
+          }
+          received.has_last = true;
+          received.last_sequence = header.sequence;
+        }
+        return true;
+      },
+      nullptr, &error);
+  if (!subscribed) {
+    std::printf("FAIL: %s: subscribe: %s\n", name, error.c_str());
+    ++failures;
+    return;
+  }
+
+  auto deadline = std::chrono::steady_clock::now() + kReceiveTimeout;
+  for (;;) {
+    {
+      std::lock_guard<std::mutex> lock(received.mutex);
+      if (received.frames >= kFramesPerFormat) break;
+    }
+    if (std::chrono::steady_clock::now() > deadline) break;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  reactor->Unsubscribe(key);
+  int64_t sent = publisher.sent();
+  int64_t copied = publisher.bytes_copied();
+  publisher.Stop();
+
+  std::lock_guard<std::mutex> lock(received.mutex);
+  if (received.frames < kFramesPerFormat) {
+    std::printf("FAIL: %s: %d of %d frames received\n", name, received.frames, kFramesPerFormat);
+    ++failures;
+  }
+  if (received.bad > 0) {
+    std::printf("FAIL: %s: %d frames did not split into header and JPEG\n", name, received.bad);
+    ++failures;
+  }
+  if (received.out_of_sequence > 0) {
+    std::printf("FAIL: %s: %d sequence gaps\n", name, received.out_of_sequence);
+    ++failures;
+  }
+  if (!received.in_place) {
+    std::printf("FAIL: %s: JPEG span not inside the received part\n", name);
+    ++failures;
+  }
+  std::printf("%-16s %4d frames  publisher copied %6.0f B/frame, receiver 0 B/frame\n", name,
+              received.frames, sent > 0 ? static_cast<double>(copied) / sent : 0.0);
+}
+
+}  // namespace
+
+int main() {
+  TestLengthPrefixed();
+  TestSplitFrame();
+
+  TestBinaryHeader();
+
+  ZmqReactor reactor(1, 1);
+  TestPublisher(&reactor, 1, ZmqWireFormat::kTwoPart, FrameHeaderEncoding::kJson, "two-part JSON");
+  TestPublisher(&reactor, 2, ZmqWireFormat::kLengthPrefixed, FrameHeaderEncoding::kJson,
+                "prefixed JSON");
+  TestPublisher(&reactor, 3, ZmqWireFormat::kTwoPart, FrameHeaderEncoding::kBinary,
+                "two-part binary");
+  TestPublisher(&reactor, 4, ZmqWireFormat::kLengthPrefixed, FrameHeaderEncoding::kBinary,
+                "prefixed binary");
+
+  if (failures > 0) {
+    std::printf("FAIL: %d checks\n", failures);
+    return 1;
+  }
+  std::printf("PASS\n");
+  return 0;
+}
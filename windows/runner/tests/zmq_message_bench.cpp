@@ -0,0 +1,136 @@
+// Receive cost per frame at 4K JPEG sizes, over TCP loopback: the zmq_msg_t
+// path (ZmqMessage, SplitFrame, the lane slot sharing the message as
+// OnZmqMessage does) against the zmq_recv into a fixed 2 MB buffer that
+// ReceiveLoopZmq used. Reports frames/s, MB/s, the bytes our code copies per
+// frame (libzmq's own socket read is the same for both) and frames the fixed
+// buffer truncated.
+//
+//   zmq_message_bench [frames per size]
+#include "decode_pool.h"
+#include "zmq_message.h"
+
+#include <zmq.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t kOldBufferBytes = 2 * 1024 * 1024;  // ReceiveLoopZmq's recv_buffer
+constexpr char kHeader[] = R"({"header": {"cam_idx": "bench", "cam_num": "1"}})";
+
+struct Result {
+  double frames_per_second = 0.0;
+  double megabytes_per_second = 0.0;
+  double copied_per_frame = 0.0;
+  int truncated = 0;
+};
+
+// "[4-byte header_len][JSON header][JPEG]" as in docs/ZMQ_HEADER_FORMAT.md
+std::vector<uint8_t> LengthPrefixedFrame(size_t jpeg_size) {
+  uint32_t header_len = sizeof(kHeader) - 1;
+  std::vector<uint8_t> message(sizeof(header_len) + header_len + jpeg_size, 0x5A);
+  memcpy(message.data(), &header_len, sizeof(header_len));
+  memcpy(message.data() + sizeof(header_len), kHeader, header_len);
+  uint8_t* jpeg = message.data() + sizeof(header_len) + header_len;
+  jpeg[0] = 0xFF;
+  jpeg[1] = 0xD8;
+  jpeg[jpeg_size - 2] = 0xFF;
+  jpeg[jpeg_size - 1] = 0xD9;
+  return message;
+}
+
+// PUSH/PULL so no frame is dropped on the way; the receive calls are the
+// ones a SUB socket uses
+template <typename Receive>
+Result Run(void* context, const std::vector<uint8_t>& message, int frames, Receive receive) {
+  void* pull = zmq_socket(context, ZMQ_PULL);
+  void* push = zmq_socket(context, ZMQ_PUSH);
+  int hwm = 8;
+  zmq_setsockopt(pull, ZMQ_RCVHWM, &hwm, sizeof(hwm));
+  zmq_setsockopt(push, ZMQ_SNDHWM, &hwm, sizeof(hwm));
+  zmq_bind(pull, "tcp://127.0.0.1:*");
+  char endpoint[256];
+  size_t endpoint_size = sizeof(endpoint);
+  zmq_getsockopt(pull, ZMQ_LAST_ENDPOINT, endpoint, &endpoint_size);
+  zmq_connect(push, endpoint);
+
+  std::thread sender([&]() {
+    for (int i = 0; i < frames + 1; ++i) {
+      zmq_send(push, message.data(), message.size(), 0);
+    }
+  });
+
+  Result result;
+  size_t copied = 0;
+  receive(pull, &copied, &result.truncated);  // first frame: connection setup
+  copied = 0;
+  result.truncated = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < frames; ++i) {
+    receive(pull, &copied, &result.truncated);
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  sender.join();
+
+  zmq_close(push);
+  zmq_close(pull);
+  result.frames_per_second = frames / seconds;
+  result.megabytes_per_second = result.frames_per_second * message.size() / (1024.0 * 1024.0);
+  result.copied_per_frame = static_cast<double>(copied) / frames;
+  return result;
+}
+
+void Print(const char* path, size_t size, const Result& result, int frames) {
+  std::printf("%-10s %9.2f MB  %9.1f  %9.1f  %14.0f  %5d/%d\n", path, size / (1024.0 * 1024.0),
+              result.frames_per_second, result.megabytes_per_second, result.copied_per_frame,
+              result.truncated, frames);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int frames = argc > 1 ? std::atoi(argv[1]) : 200;
+  if (frames < 1) frames = 1;
+
+  void* context = zmq_ctx_new();
+  std::vector<uint8_t> old_buffer(kOldBufferBytes);
+  volatile uint8_t sink = 0;
+
+  std::printf("path          message    frames/s      MB/s  copied B/frame  truncated\n");
+  // 4K JPEGs: ~1 MB at moderate quality up to ~6 MB for a detailed scene
+  for (size_t jpeg_size : {size_t{1} << 20, size_t{5} << 19, size_t{4} << 20, size_t{6} << 20}) {
+    std::vector<uint8_t> message = LengthPrefixedFrame(jpeg_size);
+
+    Result old_result = Run(context, message, frames, [&](void* socket, size_t* copied, int* truncated) {
+      int size = zmq_recv(socket, old_buffer.data(), old_buffer.size(), 0);
+      if (size < 0) return;
+      if (static_cast<size_t>(size) > old_buffer.size()) ++*truncated;
+      size_t kept = (std::min)(static_cast<size_t>(size), old_buffer.size());
+      *copied += kept;
+      FrameView view = SplitLengthPrefixedFrame(old_buffer.data(), kept);
+      sink = sink + view.jpeg[view.jpeg_size - 1];
+    });
+    Print("zmq_recv", message.size(), old_result, frames);
+
+    ZmqFrame frame;
+    EncodedFrame slot;
+    Result new_result = Run(context, message, frames, [&](void* socket, size_t*, int*) {
+      if (!frame.parts[0].Receive(socket, 0)) return;
+      frame.part_count = 1;
+      slot.zmq.ShareFrom(frame);  // what the lane slot holds until decode
+      FrameView view = SplitFrame(slot.zmq);
+      sink = sink + view.jpeg[view.jpeg_size - 1];
+      slot.zmq.Reset();
+    });
+    Print("zmq_msg_t", message.size(), new_result, frames);
+  }
+
+  zmq_ctx_term(context);
+  return 0;
+}
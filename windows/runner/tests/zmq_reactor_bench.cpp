@@ -0,0 +1,175 @@
+// Receive-side cost of N ZMQ cameras: the shared context and zmq_poll
+// reactor (ZmqReactor, as NativeVideoHandler sets it up) against the model it
+// replaced, a context, SUB socket and zmq_recv thread per stream with
+// ZMQ_RCVTIMEO=100. Every stream is fed by a ZmqPublisher at ~30 fps.
+//
+// Each stream count is measured three times for the same duration: the
+// publishers alone, then each receive model on top. The table shows the
+// difference to the publishers alone: threads added, context switches/s and
+// CPU time (Linux; "-" elsewhere), plus frames/s received.
+//
+//   zmq_reactor_bench [seconds per run] [max streams]
+#include "test_support.h"
+#include "zmq_message.h"
+#include "zmq_reactor.h"
+
+#include <zmq.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// NativeVideoHandler's reactor settings
+constexpr int kIoThreads = 1;
+constexpr int kPollerThreads = 0;  // one per two hardware threads
+
+constexpr int kOldReceiveTimeoutMs = 100;
+constexpr size_t kOldBufferBytes = 2 * 1024 * 1024;
+
+struct Measurement {
+  int threads = 0;  // at the end of the run
+  double cpu_seconds = 0.0;
+  long context_switches = 0;
+  double frames_per_second = 0.0;
+};
+
+// Samples usage around a run of the given length, with the receivers up
+template <typename Received>
+Measurement Measure(double seconds, Received received) {
+  int64_t frames_before = received();
+  ProcessUsage before = SampleProcessUsage();
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+  ProcessUsage after = SampleProcessUsage();
+  Measurement m;
+  m.threads = after.threads;
+  m.cpu_seconds = after.cpu_seconds - before.cpu_seconds;
+  m.context_switches = after.context_switches - before.context_switches;
+  m.frames_per_second = (received() - frames_before) / seconds;
+  return m;
+}
+
+// The old model: one context and one receive thread per stream
+class ThreadPerStream {
+ public:
+  explicit ThreadPerStream(const std::vector<std::unique_ptr<ZmqPublisher>>& publishers) {
+    for (const auto& publisher : publishers) {
+      threads_.emplace_back(&ThreadPerStream::ReceiveLoop, this, publisher->address());
+    }
+  }
+  ~ThreadPerStream() {
+    running_ = false;
+    for (auto& thread : threads_) thread.join();
+  }
+
+  int64_t received() const { return received_.load(); }
+
+ private:
+  void ReceiveLoop(std::string address) {
+    void* context = zmq_ctx_new();
+    void* socket = zmq_socket(context, ZMQ_SUB);
+    int linger = 0;
+    int timeout = kOldReceiveTimeoutMs;
+    zmq_setsockopt(socket, ZMQ_LINGER, &linger, sizeof(linger));
+    zmq_setsockopt(socket, ZMQ_RCVTIMEO, &timeout, sizeof(timeout));
+    zmq_connect(socket, address.c_str());
+    zmq_setsockopt(socket, ZMQ_SUBSCRIBE, "", 0);
+
+    std::vector<uint8_t> buffer(kOldBufferBytes);
+    while (running_) {
+      if (zmq_recv(socket, buffer.data(), buffer.size(), 0) < 0) continue;
+      int more = 0;
+      size_t more_size = sizeof(more);
+      zmq_getsockopt(socket, ZMQ_RCVMORE, &more, &more_size);
+      if (!more) ++received_;
+    }
+    zmq_close(socket);
+    zmq_ctx_term(context);
+  }
+
+  std::atomic<bool> running_{true};
+  std::atomic<int64_t> received_{0};
+  std::vector<std::thread> threads_;
+};
+
+void PrintRow(const char* model, int streams, const Measurement& m, const Measurement& base,
+              double seconds) {
+  if (base.threads < 0 || m.threads < 0) {
+    std::printf("%-16s %7d %8s %10s %9s %10.0f\n", model, streams, "-", "-", "-",
+                m.frames_per_second);
+    return;
+  }
+  std::printf("%-16s %7d %8d %10.0f %8.1f%% %10.0f\n", model, streams, m.threads - base.threads,
+              (m.context_switches - base.context_switches) / seconds,
+              100.0 * (m.cpu_seconds - base.cpu_seconds) / seconds, m.frames_per_second);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  double seconds = argc > 1 ? std::atof(argv[1]) : 3.0;
+  int max_streams = argc > 2 ? std::atoi(argv[2]) : 64;
+  if (seconds <= 0.0) seconds = 3.0;
+
+  std::printf("%u hardware threads, %.1f s per run\n", std::thread::hardware_concurrency(), seconds);
+  std::printf("model            streams  threads  csw/s      CPU      frames/s\n");
+
+  for (int streams : {4, 16, 64}) {
+    if (streams > max_streams) break;
+
+    std::vector<std::unique_ptr<ZmqPublisher>> publishers;
+    for (int i = 0; i < streams; ++i) {
+      publishers.push_back(std::make_unique<ZmqPublisher>());
+      if (!publishers.back()->Start()) {
+        std::printf("FAIL: publisher %d did not start\n", i);
+        return 1;
+      }
+    }
+
+    // Publishers alone, sampled after the start-up settles
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    Measurement base = Measure(seconds, []() { return int64_t{0}; });
+
+    Measurement old_model;
+    {
+      ThreadPerStream receivers(publishers);
+      std::this_thread::sleep_for(std::chrono::milliseconds(500));  // connect
+      old_model = Measure(seconds, [&]() { return receivers.received(); });
+    }
+
+    Measurement reactor_model;
+    {
+      ZmqReactor reactor(kIoThreads, kPollerThreads);
+      std::atomic<int64_t> received{0};
+      for (int i = 0; i < streams; ++i) {
+        std::string error;
+        if (!reactor.Subscribe(i, publishers[i]->address(), IngestPolicy::kEveryFrame,
+                               [&](ZmqFrame&, int) {
+                                 ++received;
+                                 return true;
+                               },
+                               nullptr, &error)) {
+          std::printf("FAIL: subscribe %d: %s\n", i, error.c_str());
+          return 1;
+        }
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(500));
+      reactor_model = Measure(seconds, [&]() { return received.load(); });
+
+      std::vector<int64_t> keys;
+      for (int i = 0; i < streams; ++i) keys.push_back(i);
+      reactor.Unsubscribe(keys);
+    }
+
+    PrintRow("thread/stream", streams, old_model, base, seconds);
+    PrintRow("reactor", streams, reactor_model, base, seconds);
+  }
+  return 0;
+}
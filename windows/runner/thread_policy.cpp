@@ -0,0 +1,140 @@
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "thread_policy.h"
+
+namespace {
+
+// Generation of the placement this thread last took, and for which role
+thread_local uint64_t t_generation = 0;
+thread_local int t_role = -1;
+
+#ifndef _WIN32
+// Nice values per priority (kLow..kHighest); Linux threads have their own
+int NiceFor(ThreadPriority priority) {
+  switch (priority) {
+    case ThreadPriority::kLow: return 10;
+    case ThreadPriority::kHigh: return -5;
+    case ThreadPriority::kHighest: return -10;
+    default: return 0;
+  }
+}
+#endif
+
+int PopCount(uint64_t mask) {
+  int count = 0;
+  for (; mask; mask &= mask - 1) {
+    ++count;
+  }
+  return count;
+}
+
+}  // namespace
+
+ThreadPolicy& ThreadPolicy::Instance() {
+  static ThreadPolicy instance;
+  return instance;
+}
+
+ThreadPolicy::ThreadPolicy() : available_cores_(AvailableCores()) {}
+
+bool ThreadPolicy::Set(ThreadRole role, const Rule& rule) {
+  int index = static_cast<int>(role);
+  if (index < 0 || index >= kThreadRoleCount) return false;
+  if (rule.core_mask != 0 && (rule.core_mask & available_cores_) == 0) return false;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (rules_[index].core_mask == rule.core_mask && rules_[index].priority == rule.priority &&
+      generations_[index].load(std::memory_order_relaxed) != 0) {
+    return true;  // threads have it already
+  }
+  rules_[index] = rule;
+  generations_[index].fetch_add(1, std::memory_order_release);
+  return true;
+}
+
+ThreadPolicy::Rule ThreadPolicy::Get(ThreadRole role) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return rules_[static_cast<int>(role)];
+}
+
+size_t ThreadPolicy::CoreCount(ThreadRole role) const {
+  uint64_t mask = Get(role).core_mask & available_cores_;
+  return static_cast<size_t>(PopCount(mask ? mask : available_cores_));
+}
+
+bool ThreadPolicy::Apply(ThreadRole role) {
+  int index = static_cast<int>(role);
+  uint64_t generation = generations_[index].load(std::memory_order_acquire);
+  if (generation == t_generation && index == t_role) return true;
+  t_generation = generation;
+  t_role = index;
+  if (generation == 0) return true;  // nothing configured for this role
+
+  Rule rule = Get(role);
+  uint64_t mask = rule.core_mask & available_cores_;
+  return ApplyToCurrentThread(mask ? mask : available_cores_, rule.priority);
+}
+
+#ifdef _WIN32
+
+uint64_t ThreadPolicy::AvailableCores() {
+  // Cores of the process's processor group (up to 64)
+  DWORD_PTR process_mask = 0;
+  DWORD_PTR system_mask = 0;
+  if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask) || process_mask == 0) {
+    return 1;
+  }
+  return static_cast<uint64_t>(process_mask);
+}
+
+bool ThreadPolicy::ApplyToCurrentThread(uint64_t core_mask, ThreadPriority priority) {
+  bool ok = SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(core_mask)) != 0;
+
+  int level = THREAD_PRIORITY_NORMAL;
+  switch (priority) {
+    case ThreadPriority::kUnchanged: return ok;
+    case ThreadPriority::kLow: level = THREAD_PRIORITY_BELOW_NORMAL; break;
+    case ThreadPriority::kNormal: level = THREAD_PRIORITY_NORMAL; break;
+    case ThreadPriority::kHigh: level = THREAD_PRIORITY_ABOVE_NORMAL; break;
+    case ThreadPriority::kHighest: level = THREAD_PRIORITY_HIGHEST; break;
+  }
+  return SetThreadPriority(GetCurrentThread(), level) && ok;
+}
+
+#else
+
+uint64_t ThreadPolicy::AvailableCores() {
+  // The main thread's set: the one the process was started with
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(getpid(), sizeof(set), &set) != 0) return 1;
+  uint64_t mask = 0;
+  for (int core = 0; core < 64; ++core) {
+    if (CPU_ISSET(core, &set)) mask |= uint64_t{1} << core;
+  }
+  return mask ? mask : 1;
+}
+
+bool ThreadPolicy::ApplyToCurrentThread(uint64_t core_mask, ThreadPriority priority) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int core = 0; core < 64; ++core) {
+    if (core_mask & (uint64_t{1} << core)) CPU_SET(core, &set);
+  }
+  bool ok = pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+
+  // Negative nice values need CAP_SYS_NICE (or a raised RLIMIT_NICE)
+  if (priority == ThreadPriority::kUnchanged) return ok;
+  pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+  return setpriority(PRIO_PROCESS, static_cast<id_t>(tid), NiceFor(priority)) == 0 && ok;
+}
+
+#endif
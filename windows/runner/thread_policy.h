@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// Threads of the video pipeline that share a placement
+enum class ThreadRole : int {
+  kNetwork = 0,  // ZMQ pollers, HTTP event loop, HTTPS receive threads
+  kDecode = 1,   // decode pool workers
+  kDisplay = 2,  // engine raster thread, entered through the texture callbacks
+  kUi = 3,       // platform thread (window messages, host API calls)
+};
+
+constexpr int kThreadRoleCount = 4;
+
+enum class ThreadPriority : int {
+  kUnchanged = 0,  // leave what the OS or the engine set
+  kLow = 1,
+  kNormal = 2,
+  kHigh = 3,
+  kHighest = 4,
+};
+
+// Process-wide core set and priority per thread role, so decode workers and
+// network threads can be kept off the cores the display work runs on.
+// Threads take their role's placement themselves (Apply at the top of their
+// loops), so a change reaches running threads within one loop iteration.
+// Best effort: raising a priority may need a privilege the process lacks.
+class ThreadPolicy {
+ public:
+  struct Rule {
+    uint64_t core_mask = 0;  // bit i = logical core i; 0 = every core available
+    ThreadPriority priority = ThreadPriority::kUnchanged;
+  };
+
+  static ThreadPolicy& Instance();
+
+  // False if the mask has no core the process may run on
+  bool Set(ThreadRole role, const Rule& rule);
+  Rule Get(ThreadRole role) const;
+
+  // Cores the role may use (all available ones if it isn't pinned)
+  size_t CoreCount(ThreadRole role) const;
+
+  // The calling thread takes role's placement if it changed since the
+  // thread's last call; otherwise just one atomic load. False if the OS
+  // refused part of it.
+  bool Apply(ThreadRole role);
+
+ private:
+  ThreadPolicy();
+
+  static uint64_t AvailableCores();
+  static bool ApplyToCurrentThread(uint64_t core_mask, ThreadPriority priority);
+
+  const uint64_t available_cores_;
+  mutable std::mutex mutex_;
+  Rule rules_[kThreadRoleCount];
+  std::atomic<uint64_t> generations_[kThreadRoleCount] = {};  // 0 = never set
+};
@@ -0,0 +1,304 @@
+#include "yuv_convert.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define YUV_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define YUV_TARGET(arch)
+#else
+#include <cpuid.h>
+#define YUV_TARGET(arch) __attribute__((target(arch)))
+#endif
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#define YUV_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// JFIF YCbCr -> RGB in 16.16 fixed point, the same constants as libjpeg
+constexpr int kCrToR = 91881;    // 1.40200
+constexpr int kCbToG = -22554;   // -0.34414
+constexpr int kCrToG = -46802;   // -0.71414
+constexpr int kCbToB = 116130;   // 1.77200
+constexpr int kHalf = 1 << 15;
+
+// Converts one row of full-resolution Y/Cb/Cr to RGBA; returns the luma sum
+using RowKernel = uint32_t (*)(const uint8_t* y, const uint8_t* cb, const uint8_t* cr,
+                               uint8_t* rgba, int width);
+
+inline uint8_t Clamp255(int v) {
+  return static_cast<uint8_t>(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+inline void ConvertPixel(int y, int cb, int cr, uint8_t* out) {
+  cb -= 128;
+  cr -= 128;
+  out[0] = Clamp255(y + ((kCrToR * cr + kHalf) >> 16));
+  out[1] = Clamp255(y + ((kCbToG * cb + kCrToG * cr + kHalf) >> 16));
+  out[2] = Clamp255(y + ((kCbToB * cb + kHalf) >> 16));
+  out[3] = 255;
+}
+
+uint32_t RowScalar(const uint8_t* y, const uint8_t* cb, const uint8_t* cr, uint8_t* rgba,
+                   int width) {
+  uint32_t luma = 0;
+  for (int i = 0; i < width; ++i) {
+    ConvertPixel(y[i], cb[i], cr[i], rgba + 4 * i);
+    luma += y[i];
+  }
+  return luma;
+}
+
+#if defined(YUV_X86)
+
+YUV_TARGET("sse4.1")
+uint32_t RowSse41(const uint8_t* y, const uint8_t* cb, const uint8_t* cr, uint8_t* rgba,
+                  int width) {
+  const __m128i k128 = _mm_set1_epi32(128);
+  const __m128i k255 = _mm_set1_epi32(255);
+  const __m128i half = _mm_set1_epi32(kHalf);
+  const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+  __m128i acc = _mm_setzero_si128();
+
+  int i = 0;
+  for (; i + 4 <= width; i += 4) {
+    int32_t y4, cb4, cr4;
+    std::memcpy(&y4, y + i, 4);
+    std::memcpy(&cb4, cb + i, 4);
+    std::memcpy(&cr4, cr + i, 4);
+    __m128i yv = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(y4));
+    __m128i cbv = _mm_sub_epi32(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(cb4)), k128);
+    __m128i crv = _mm_sub_epi32(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(cr4)), k128);
+
+    __m128i r = _mm_add_epi32(yv, _mm_srai_epi32(
+        _mm_add_epi32(_mm_mullo_epi32(crv, _mm_set1_epi32(kCrToR)), half), 16));
+    __m128i g = _mm_add_epi32(yv, _mm_srai_epi32(
+        _mm_add_epi32(_mm_add_epi32(_mm_mullo_epi32(cbv, _mm_set1_epi32(kCbToG)),
+                                    _mm_mullo_epi32(crv, _mm_set1_epi32(kCrToG))),
+                      half), 16));
+    __m128i b = _mm_add_epi32(yv, _mm_srai_epi32(
+        _mm_add_epi32(_mm_mullo_epi32(cbv, _mm_set1_epi32(kCbToB)), half), 16));
+    r = _mm_min_epi32(_mm_max_epi32(r, _mm_setzero_si128()), k255);
+    g = _mm_min_epi32(_mm_max_epi32(g, _mm_setzero_si128()), k255);
+    b = _mm_min_epi32(_mm_max_epi32(b, _mm_setzero_si128()), k255);
+
+    __m128i px = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, 8)),
+                              _mm_or_si128(_mm_slli_epi32(b, 16), alpha));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + 4 * i), px);
+    acc = _mm_add_epi32(acc, yv);
+  }
+
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+  uint32_t luma = static_cast<uint32_t>(_mm_cvtsi128_si32(acc));
+  return luma + RowScalar(y + i, cb + i, cr + i, rgba + 4 * i, width - i);
+}
+
+YUV_TARGET("avx2")
+uint32_t RowAvx2(const uint8_t* y, const uint8_t* cb, const uint8_t* cr, uint8_t* rgba,
+                 int width) {
+  const __m256i k128 = _mm256_set1_epi32(128);
+  const __m256i k255 = _mm256_set1_epi32(255);
+  const __m256i half = _mm256_set1_epi32(kHalf);
+  const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+  __m256i acc = _mm256_setzero_si256();
+
+  int i = 0;
+  for (; i + 8 <= width; i += 8) {
+    __m256i yv = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + i)));
+    __m256i cbv = _mm256_sub_epi32(
+        _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(cb + i))), k128);
+    __m256i crv = _mm256_sub_epi32(
+        _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(cr + i))), k128);
+
+    __m256i r = _mm256_add_epi32(yv, _mm256_srai_epi32(
+        _mm256_add_epi32(_mm256_mullo_epi32(crv, _mm256_set1_epi32(kCrToR)), half), 16));
+    __m256i g = _mm256_add_epi32(yv, _mm256_srai_epi32(
+        _mm256_add_epi32(_mm256_add_epi32(_mm256_mullo_epi32(cbv, _mm256_set1_epi32(kCbToG)),
+                                          _mm256_mullo_epi32(crv, _mm256_set1_epi32(kCrToG))),
+                         half), 16));
+    __m256i b = _mm256_add_epi32(yv, _mm256_srai_epi32(
+        _mm256_add_epi32(_mm256_mullo_epi32(cbv, _mm256_set1_epi32(kCbToB)), half), 16));
+    r = _mm256_min_epi32(_mm256_max_epi32(r, _mm256_setzero_si256()), k255);
+    g = _mm256_min_epi32(_mm256_max_epi32(g, _mm256_setzero_si256()), k255);
+    b = _mm256_min_epi32(_mm256_max_epi32(b, _mm256_setzero_si256()), k255);
+
+    __m256i px = _mm256_or_si256(_mm256_or_si256(r, _mm256_slli_epi32(g, 8)),
+                                 _mm256_or_si256(_mm256_slli_epi32(b, 16), alpha));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba + 4 * i), px);
+    acc = _mm256_add_epi32(acc, yv);
+  }
+
+  __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  uint32_t luma = static_cast<uint32_t>(_mm_cvtsi128_si32(sum));
+  return luma + RowScalar(y + i, cb + i, cr + i, rgba + 4 * i, width - i);
+}
+
+void Cpuid(int leaf, int subleaf, unsigned regs[4]) {
+#if defined(_MSC_VER)
+  int out[4];
+  __cpuidex(out, leaf, subleaf);
+  for (int i = 0; i < 4; ++i) regs[i] = static_cast<unsigned>(out[i]);
+#else
+  __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+uint64_t XgetbvXcr0() {
+#if defined(_MSC_VER)
+  return _xgetbv(0);
+#else
+  unsigned lo, hi;
+  __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+  return (static_cast<uint64_t>(hi) << 32) | lo;
+#endif
+}
+
+#elif defined(YUV_NEON)
+
+inline uint32x4_t ConvertNeon4(uint16x4_t y16, uint16x4_t cb16, uint16x4_t cr16) {
+  const int32x4_t k128 = vdupq_n_s32(128);
+  const int32x4_t half = vdupq_n_s32(kHalf);
+  int32x4_t yv = vreinterpretq_s32_u32(vmovl_u16(y16));
+  int32x4_t cbv = vsubq_s32(vreinterpretq_s32_u32(vmovl_u16(cb16)), k128);
+  int32x4_t crv = vsubq_s32(vreinterpretq_s32_u32(vmovl_u16(cr16)), k128);
+
+  int32x4_t r = vaddq_s32(yv, vshrq_n_s32(vmlaq_n_s32(half, crv, kCrToR), 16));
+  int32x4_t g = vaddq_s32(yv, vshrq_n_s32(vmlaq_n_s32(vmlaq_n_s32(half, cbv, kCbToG), crv, kCrToG), 16));
+  int32x4_t b = vaddq_s32(yv, vshrq_n_s32(vmlaq_n_s32(half, cbv, kCbToB), 16));
+  const int32x4_t zero = vdupq_n_s32(0);
+  const int32x4_t k255 = vdupq_n_s32(255);
+  uint32x4_t ur = vreinterpretq_u32_s32(vminq_s32(vmaxq_s32(r, zero), k255));
+  uint32x4_t ug = vreinterpretq_u32_s32(vminq_s32(vmaxq_s32(g, zero), k255));
+  uint32x4_t ub = vreinterpretq_u32_s32(vminq_s32(vmaxq_s32(b, zero), k255));
+  return vorrq_u32(vorrq_u32(ur, vshlq_n_u32(ug, 8)),
+                   vorrq_u32(vshlq_n_u32(ub, 16), vdupq_n_u32(0xFF000000u)));
+}
+
+uint32_t RowNeon(const uint8_t* y, const uint8_t* cb, const uint8_t* cr, uint8_t* rgba,
+                 int width) {
+  uint32x4_t acc = vdupq_n_u32(0);
+  int i = 0;
+  for (; i + 8 <= width; i += 8) {
+    uint16x8_t y16 = vmovl_u8(vld1_u8(y + i));
+    uint16x8_t cb16 = vmovl_u8(vld1_u8(cb + i));
+    uint16x8_t cr16 = vmovl_u8(vld1_u8(cr + i));
+    uint32_t* out = reinterpret_cast<uint32_t*>(rgba + 4 * i);
+    vst1q_u32(out, ConvertNeon4(vget_low_u16(y16), vget_low_u16(cb16), vget_low_u16(cr16)));
+    vst1q_u32(out + 4, ConvertNeon4(vget_high_u16(y16), vget_high_u16(cb16), vget_high_u16(cr16)));
+    acc = vpadalq_u16(acc, y16);
+  }
+  return vaddvq_u32(acc) + RowScalar(y + i, cb + i, cr + i, rgba + 4 * i, width - i);
+}
+
+#endif
+
+struct Kernel {
+  RowKernel row;
+  const char* name;
+};
+
+Kernel SelectKernel() {
+#if defined(YUV_X86)
+  unsigned regs[4];
+  Cpuid(0, 0, regs);
+  unsigned max_leaf = regs[0];
+  Cpuid(1, 0, regs);
+  bool sse41 = (regs[2] & (1u << 19)) != 0;
+  bool avx = (regs[2] & (1u << 28)) != 0;
+  bool osxsave = (regs[2] & (1u << 27)) != 0;
+  if (avx && osxsave && (XgetbvXcr0() & 0x6) == 0x6 && max_leaf >= 7) {
+    Cpuid(7, 0, regs);
+    if (regs[1] & (1u << 5)) return {RowAvx2, "avx2"};
+  }
+  if (sse41) return {RowSse41, "sse4.1"};
+#elif defined(YUV_NEON)
+  return {RowNeon, "neon"};
+#endif
+  return {RowScalar, "scalar"};
+}
+
+const Kernel& ActiveKernel() {
+  static const Kernel kernel = SelectKernel();
+  return kernel;
+}
+
+// Nearest-neighbour chroma upsampling of one row
+void ExpandChromaRow(const uint8_t* src, int width, int shift, uint8_t* dst) {
+  if (shift == 1) {
+    int pairs = width >> 1;
+    for (int i = 0; i < pairs; ++i) {
+      dst[2 * i] = src[i];
+      dst[2 * i + 1] = src[i];
+    }
+    if (width & 1) dst[width - 1] = src[pairs];
+    return;
+  }
+  for (int i = 0; i < width; ++i) {
+    dst[i] = src[i >> shift];
+  }
+}
+
+}  // namespace
+
+uint64_t ConvertYuvToRgba(const YuvImage& image, uint8_t* rgba, size_t rgba_stride) {
+  const RowKernel row_kernel = ActiveKernel().row;
+  const int width = image.width;
+  const int height = image.height;
+
+  // Per decode thread, so upsampled chroma rows never allocate after warm-up
+  thread_local std::vector<uint8_t> cb_row;
+  thread_local std::vector<uint8_t> cr_row;
+
+  bool gray = !image.planes[1] || !image.planes[2];
+  if (gray || image.chroma_shift_x > 0) {
+    if (cb_row.size() < static_cast<size_t>(width)) {
+      cb_row.resize(width);
+      cr_row.resize(width);
+    }
+    if (gray) {
+      std::fill(cb_row.begin(), cb_row.begin() + width, static_cast<uint8_t>(128));
+    }
+  }
+
+  uint64_t luma = 0;
+  int expanded_row = -1;
+  for (int row = 0; row < height; ++row) {
+    const uint8_t* y_row = image.planes[0] + static_cast<size_t>(row) * image.strides[0];
+    const uint8_t* cb = cb_row.data();
+    const uint8_t* cr = cb_row.data();
+
+    if (!gray) {
+      int chroma_y = row >> image.chroma_shift_y;
+      const uint8_t* cb_src = image.planes[1] + static_cast<size_t>(chroma_y) * image.strides[1];
+      const uint8_t* cr_src = image.planes[2] + static_cast<size_t>(chroma_y) * image.strides[2];
+      if (image.chroma_shift_x == 0) {
+        cb = cb_src;
+        cr = cr_src;
+      } else {
+        // Vertically subsampled rows share the upsampled chroma
+        if (chroma_y != expanded_row) {
+          ExpandChromaRow(cb_src, width, image.chroma_shift_x, cb_row.data());
+          ExpandChromaRow(cr_src, width, image.chroma_shift_x, cr_row.data());
+          expanded_row = chroma_y;
+        }
+        cr = cr_row.data();
+      }
+    }
+
+    luma += row_kernel(y_row, cb, cr, rgba + static_cast<size_t>(row) * rgba_stride, width);
+  }
+  return luma;
+}
+
+const char* YuvKernelName() {
+  return ActiveKernel().name;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Planar YCbCr image as decoded by tj3DecompressToYUVPlanes8
+struct YuvImage {
+  const uint8_t* planes[3] = {};  // Y, Cb, Cr; Cb/Cr null for grayscale
+  int strides[3] = {};
+  int width = 0;  // luma size
+  int height = 0;
+  int chroma_shift_x = 0;  // log2 of the chroma subsampling, e.g. 4:2:0 = 1, 1
+  int chroma_shift_y = 0;
+};
+
+// Converts image to RGBA (JFIF full-range BT.601) and, in the same pass,
+// returns the sum of its luma samples. Chroma is upsampled by replication, so
+// colour edges differ slightly from libjpeg-turbo's smooth upsampling. The
+// SIMD kernel is picked once from the CPU (AVX2, SSE4.1, NEON or scalar); all
+// of them give identical output.
+uint64_t ConvertYuvToRgba(const YuvImage& image, uint8_t* rgba, size_t rgba_stride);
+
+// Name of the kernel ConvertYuvToRgba uses on this CPU, for logging
+const char* YuvKernelName();
@@ -0,0 +1,108 @@
+#include "zmq_message.h"
+
+#include "frame_header.h"
+#include <cstring>
+
+ZmqMessage::ZmqMessage() {
+  zmq_msg_init(&msg_);
+}
+
+ZmqMessage::~ZmqMessage() {
+  zmq_msg_close(&msg_);
+}
+
+ZmqMessage::ZmqMessage(ZmqMessage&& other) noexcept {
+  zmq_msg_init(&msg_);
+  zmq_msg_move(&msg_, &other.msg_);
+}
+
+ZmqMessage& ZmqMessage::operator=(ZmqMessage&& other) noexcept {
+  if (this != &other) {
+    // zmq_msg_move releases the current payload of the destination
+    zmq_msg_move(&msg_, &other.msg_);
+  }
+  return *this;
+}
+
+bool ZmqMessage::Receive(void* socket, int flags) {
+  // zmq_msg_recv releases any payload previously held by msg_
+  return zmq_msg_recv(&msg_, socket, flags) >= 0;
+}
+
+const uint8_t* ZmqMessage::data() const {
+  return static_cast<const uint8_t*>(zmq_msg_data(const_cast<zmq_msg_t*>(&msg_)));
+}
+
+size_t ZmqMessage::size() const {
+  return zmq_msg_size(&msg_);
+}
+
+bool ZmqMessage::more() const {
+  return zmq_msg_more(&msg_) != 0;
+}
+
+void ZmqMessage::ShareFrom(const ZmqMessage& other) {
+  zmq_msg_copy(&msg_, const_cast<zmq_msg_t*>(&other.msg_));
+}
+
+void ZmqMessage::Reset() {
+  zmq_msg_close(&msg_);
+  zmq_msg_init(&msg_);
+}
+
+void ZmqFrame::ShareFrom(const ZmqFrame& other) {
+  for (int i = 0; i < other.part_count; ++i) {
+    parts[i].ShareFrom(other.parts[i]);
+  }
+  part_count = other.part_count;
+}
+
+void ZmqFrame::Reset() {
+  for (auto& part : parts) {
+    part.Reset();
+  }
+  part_count = 0;
+}
+
+FrameView SplitLengthPrefixedFrame(const uint8_t* data, size_t size) {
+  FrameView view;
+  if (data == nullptr || size == 0) {
+    return view;
+  }
+
+  uint32_t header_len = 0;
+  if (size >= sizeof(header_len)) {
+    memcpy(&header_len, data, sizeof(header_len));
+  }
+
+  if (size < sizeof(header_len) || header_len == 0 || header_len > kMaxFrameHeaderBytes ||
+      header_len > size - sizeof(header_len)) {
+    // Raw JPEG (no header)
+    view.jpeg = data;
+    view.jpeg_size = size;
+    return view;
+  }
+
+  view.header = data + sizeof(header_len);
+  view.header_size = header_len;
+  view.jpeg = view.header + header_len;
+  view.jpeg_size = size - sizeof(header_len) - header_len;
+  return view;
+}
+
+FrameView SplitFrame(const ZmqFrame& frame) {
+  if (frame.part_count < 2) {
+    return SplitLengthPrefixedFrame(frame.parts[0].data(), frame.parts[0].size());
+  }
+
+  FrameView view;
+  const ZmqMessage& header = frame.parts[0];
+  const ZmqMessage& jpeg = frame.parts[1];
+  if (header.size() > 0 && header.size() <= kMaxFrameHeaderBytes) {
+    view.header = header.data();
+    view.header_size = header.size();
+  }
+  view.jpeg = jpeg.data();
+  view.jpeg_size = jpeg.size();
+  return view;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <zmq.h>
+#include <cstddef>
+#include <cstdint>
+
+// Owns one received ZMQ message part (zmq_msg_t).
+// The payload stays valid until the next Receive() or destruction, so header
+// parsing and JPEG decoding can read libzmq's buffer directly instead of a copy.
+// There is no size limit: libzmq sizes the message to whatever was sent.
+class ZmqMessage {
+ public:
+  ZmqMessage();
+  ~ZmqMessage();
+
+  ZmqMessage(ZmqMessage&& other) noexcept;
+  ZmqMessage& operator=(ZmqMessage&& other) noexcept;
+  ZmqMessage(const ZmqMessage&) = delete;
+  ZmqMessage& operator=(const ZmqMessage&) = delete;
+
+  // Receives the next message part from socket, releasing the previous payload.
+  // Returns false on failure; zmq_errno() holds the reason (EAGAIN, ETERM, ...).
+  bool Receive(void* socket, int flags);
+
+  const uint8_t* data() const;
+  size_t size() const;
+
+  // True if more parts of the same multipart message follow.
+  bool more() const;
+
+  // Makes this message share other's payload (zmq_msg_copy). Large payloads
+  // are reference counted by libzmq, so no bytes are copied.
+  void ShareFrom(const ZmqMessage& other);
+
+  // Releases the payload, leaving an empty message.
+  void Reset();
+
+ private:
+  zmq_msg_t msg_;
+};
+
+// One complete ZMQ message as delivered by the reactor: either a single part
+// or the first two parts of a multipart message. Any further parts are
+// received and dropped so the socket stays aligned on message boundaries.
+struct ZmqFrame {
+  ZmqMessage parts[2];
+  int part_count = 0;
+
+  void ShareFrom(const ZmqFrame& other);
+  void Reset();
+};
+
+// Views into a received frame's header and JPEG spans.
+// Pointers alias the message buffers; no bytes are copied.
+struct FrameView {
+  const uint8_t* header = nullptr;
+  size_t header_size = 0;
+  const uint8_t* jpeg = nullptr;
+  size_t jpeg_size = 0;
+};
+
+// Splits a length-prefixed message into header and JPEG spans.
+// A header length of 0, > kMaxFrameHeaderBytes or past the end of the message
+// means the publisher sent a raw JPEG, in which case the whole message is the JPEG.
+FrameView SplitLengthPrefixedFrame(const uint8_t* data, size_t size);
+
+// Splits either wire format, detected by part count:
+// - 1 part:  "[4-byte header_len][JSON header][JPEG]" (SplitLengthPrefixedFrame)
+// - 2 parts: "[JSON header]" "[JPEG]"; an empty or oversized header part means no header
+FrameView SplitFrame(const ZmqFrame& frame);
@@ -0,0 +1,628 @@
+#include "zmq_reactor.h"
+
+#include "thread_policy.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+// Upper bound of messages taken from one socket per wakeup, so a busy camera
+// can't starve the other sockets on the same poller
+constexpr int kMaxMessagesPerWakeup = 8;
+
+// Upper bound of messages drained per wakeup in kLatestOnly mode
+constexpr int kMaxDrainPerWakeup = 256;
+
+// Receive high-water mark for kLatestOnly subscriptions. Anything beyond a
+// couple of frames queued in libzmq is latency the viewer would have to skip.
+constexpr int kLatestOnlyReceiveHwm = 2;
+
+// Same for topic-mode sockets, which carry frames of several cameras
+constexpr int kSharedLatestOnlyReceiveHwm = 16;
+
+// Heartbeats: PING every interval, drop the connection (and reconnect) if the
+// publisher doesn't answer within the timeout
+constexpr int kHeartbeatIntervalMs = 1000;
+constexpr int kHeartbeatTimeoutMs = 3000;
+
+// Reconnect backoff applied by libzmq: starts at the interval, doubles up to max
+constexpr int kReconnectIntervalMs = 100;
+constexpr int kReconnectIntervalMaxMs = 5000;
+
+// Separates the endpoint from the topic in "tcp://host:port#topic"
+constexpr char kTopicSeparator = '#';
+
+// ZMQ SUBSCRIBE semantics: a route topic matches any topic it prefixes
+bool TopicMatches(const std::string& route_topic, const ZmqMessage& topic) {
+  return topic.size() >= route_topic.size() &&
+         memcmp(topic.data(), route_topic.data(), route_topic.size()) == 0;
+}
+
+}  // namespace
+
+ZmqReactor::ZmqReactor(int io_threads, int poller_threads) {
+  context_ = zmq_ctx_new();
+  if (!context_) {
+    // No pollers; Subscribe reports the failure
+    return;
+  }
+  // Must be set before the first socket is created
+  zmq_ctx_set(context_, ZMQ_IO_THREADS, (std::max)(1, io_threads));
+
+  int count = poller_threads;
+  if (count <= 0) {
+    count = (std::max)(1, static_cast<int>(std::thread::hardware_concurrency()) / 2);
+  }
+
+  for (int i = 0; i < count; ++i) {
+    auto poller = std::make_unique<Poller>();
+    char endpoint[64];
+    snprintf(endpoint, sizeof(endpoint), "inproc://zmq-reactor-wake-%p",
+             static_cast<void*>(poller.get()));
+    poller->wake_recv = zmq_socket(context_, ZMQ_PAIR);
+    poller->wake_send = zmq_socket(context_, ZMQ_PAIR);
+    zmq_bind(poller->wake_recv, endpoint);
+    zmq_connect(poller->wake_send, endpoint);
+    pollers_.push_back(std::move(poller));
+  }
+  for (auto& poller : pollers_) {
+    poller->thread = std::thread(&ZmqReactor::PollLoop, this, poller.get());
+  }
+}
+
+ZmqReactor::~ZmqReactor() {
+  for (auto& poller : pollers_) {
+    std::lock_guard<std::mutex> lock(poller->mutex);
+    poller->stopping = true;
+    Wake(poller.get());
+  }
+
+  // Pollers close their own sockets on the way out
+  for (auto& poller : pollers_) {
+    if (poller->thread.joinable()) {
+      poller->thread.join();
+    }
+    if (poller->wake_send) {
+      zmq_close(poller->wake_send);
+    }
+  }
+  pollers_.clear();
+
+  if (context_) {
+    zmq_ctx_destroy(context_);
+    context_ = nullptr;
+  }
+}
+
+bool ZmqReactor::Subscribe(int64_t key, const std::string& address, IngestPolicy policy,
+                           MessageHandler handler, StatusHandler status_handler,
+                           std::string* error) {
+  if (!context_ || pollers_.empty()) {
+    if (error) *error = "Failed to create ZMQ context";
+    return false;
+  }
+
+  size_t separator = address.find(kTopicSeparator);
+  bool topic_mode = separator != std::string::npos;
+  std::string endpoint = address.substr(0, separator);
+
+  auto route = std::make_unique<Route>();
+  route->key = key;
+  route->topic = topic_mode ? address.substr(separator + 1) : std::string();
+  route->policy = policy;
+  route->handler = std::move(handler);
+  route->status_handler = std::move(status_handler);
+
+  bool latest_only = policy == IngestPolicy::kLatestOnly;
+
+  if (!topic_mode) {
+    void* monitor = nullptr;
+    void* socket = OpenSocket(endpoint, latest_only ? kLatestOnlyReceiveHwm : 0, &monitor, error);
+    if (!socket) return false;
+    zmq_setsockopt(socket, ZMQ_SUBSCRIBE, "", 0);
+
+    auto connection = std::make_unique<Connection>();
+    connection->endpoint = endpoint;
+    connection->socket = socket;
+    connection->monitor = monitor;
+    connection->routes.push_back(std::move(route));
+
+    Poller* target = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      target = LeastLoadedPoller();
+      ++target->load;
+      owners_[key] = Owner{target, std::string()};
+    }
+
+    // The socket migrates to the poller thread; the mutex provides the
+    // full memory barrier ZMQ requires for that
+    std::lock_guard<std::mutex> lock(target->mutex);
+    target->pending_add.push_back(std::move(connection));
+    ++target->commands_posted;
+    Wake(target);
+    return true;
+  }
+
+  // Topic mode. mutex_ stays held so two tiles on the same publisher can't
+  // both open a socket for it.
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto shared = shared_.find(endpoint);
+  if (shared != shared_.end()) {
+    // The poller owns the socket and adds the topic subscription itself
+    Poller* poller = shared->second.poller;
+    ++shared->second.users;
+    owners_[key] = Owner{poller, endpoint};
+
+    std::lock_guard<std::mutex> poller_lock(poller->mutex);
+    poller->pending_routes.emplace_back(endpoint, std::move(route));
+    ++poller->commands_posted;
+    Wake(poller);
+    return true;
+  }
+
+  void* monitor = nullptr;
+  void* socket = OpenSocket(endpoint, latest_only ? kSharedLatestOnlyReceiveHwm : 0, &monitor, error);
+  if (!socket) return false;
+  zmq_setsockopt(socket, ZMQ_SUBSCRIBE, route->topic.data(), route->topic.size());
+
+  auto connection = std::make_unique<Connection>();
+  connection->endpoint = endpoint;
+  connection->topic_mode = true;
+  connection->socket = socket;
+  connection->monitor = monitor;
+  connection->routes.push_back(std::move(route));
+
+  Poller* target = LeastLoadedPoller();
+  ++target->load;
+  shared_[endpoint] = SharedSocket{target, 1};
+  owners_[key] = Owner{target, endpoint};
+
+  std::lock_guard<std::mutex> poller_lock(target->mutex);
+  target->pending_add.push_back(std::move(connection));
+  ++target->commands_posted;
+  Wake(target);
+  return true;
+}
+
+void ZmqReactor::Unsubscribe(int64_t key) {
+  Unsubscribe(std::vector<int64_t>{key});
+}
+
+void ZmqReactor::Unsubscribe(const std::vector<int64_t>& keys) {
+  std::vector<std::pair<Poller*, int64_t>> removals;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int64_t key : keys) {
+      auto it = owners_.find(key);
+      if (it == owners_.end()) {
+        continue;
+      }
+      Poller* poller = it->second.poller;
+
+      if (it->second.shared_endpoint.empty()) {
+        --poller->load;
+      } else {
+        auto shared = shared_.find(it->second.shared_endpoint);
+        if (shared != shared_.end() && --shared->second.users == 0) {
+          --poller->load;
+          shared_.erase(shared);
+        }
+      }
+      owners_.erase(it);
+      removals.emplace_back(poller, key);
+    }
+  }
+
+  // Post to every poller first, then wait: the pollers work in parallel
+  std::vector<Poller*> posted;
+  for (auto& removal : removals) {
+    Poller* poller = removal.first;
+    std::lock_guard<std::mutex> lock(poller->mutex);
+    poller->pending_remove.push_back(removal.second);
+    ++poller->commands_posted;
+    Wake(poller);
+    if (std::find(posted.begin(), posted.end(), poller) == posted.end()) {
+      posted.push_back(poller);
+    }
+  }
+  for (Poller* poller : posted) {
+    std::unique_lock<std::mutex> lock(poller->mutex);
+    WaitForCommands(poller, lock);
+  }
+}
+
+void ZmqReactor::SetPolicy(int64_t key, IngestPolicy policy) {
+  Poller* poller = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = owners_.find(key);
+    if (it == owners_.end()) {
+      return;
+    }
+    poller = it->second.poller;
+  }
+
+  std::lock_guard<std::mutex> lock(poller->mutex);
+  poller->pending_policy.emplace_back(key, policy);
+  ++poller->commands_posted;
+  Wake(poller);
+}
+
+void ZmqReactor::Resume(int64_t key) {
+  Poller* poller = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = owners_.find(key);
+    if (it == owners_.end()) {
+      return;
+    }
+    poller = it->second.poller;
+  }
+
+  // Every wakeup retries the refused frames, so no command is needed
+  std::lock_guard<std::mutex> lock(poller->mutex);
+  Wake(poller);
+}
+
+void* ZmqReactor::OpenSocket(const std::string& endpoint, int receive_hwm, void** monitor,
+                             std::string* error) {
+  void* socket = zmq_socket(context_, ZMQ_SUB);
+  if (!socket) {
+    if (error) *error = "Failed to create ZMQ socket";
+    return nullptr;
+  }
+
+  int linger = 0;
+  zmq_setsockopt(socket, ZMQ_LINGER, &linger, sizeof(linger));
+
+  // ZMQ_CONFLATE is not used: it drops all but one part of multipart messages.
+  // kLatestOnly drains to the newest message in PollLoop instead.
+  if (receive_hwm > 0) {
+    zmq_setsockopt(socket, ZMQ_RCVHWM, &receive_hwm, sizeof(receive_hwm));
+  }
+
+  int heartbeat_ivl = kHeartbeatIntervalMs;
+  int heartbeat_timeout = kHeartbeatTimeoutMs;
+  int reconnect_ivl = kReconnectIntervalMs;
+  int reconnect_ivl_max = kReconnectIntervalMaxMs;
+  zmq_setsockopt(socket, ZMQ_HEARTBEAT_IVL, &heartbeat_ivl, sizeof(heartbeat_ivl));
+  zmq_setsockopt(socket, ZMQ_HEARTBEAT_TIMEOUT, &heartbeat_timeout, sizeof(heartbeat_timeout));
+  zmq_setsockopt(socket, ZMQ_RECONNECT_IVL, &reconnect_ivl, sizeof(reconnect_ivl));
+  zmq_setsockopt(socket, ZMQ_RECONNECT_IVL_MAX, &reconnect_ivl_max, sizeof(reconnect_ivl_max));
+
+  // Monitor first: a fast connect could otherwise come and go unreported,
+  // leaving a later disconnect looking like no change
+  *monitor = OpenMonitor(socket);
+  if (zmq_connect(socket, endpoint.c_str()) != 0) {
+    if (*monitor) {
+      zmq_socket_monitor(socket, nullptr, 0);
+      zmq_close(*monitor);
+      *monitor = nullptr;
+    }
+    zmq_close(socket);
+    if (error) *error = "Failed to connect to ZMQ address";
+    return nullptr;
+  }
+  return socket;
+}
+
+void* ZmqReactor::OpenMonitor(void* socket) {
+  // Numbered, not named after the socket: a closed socket's address comes
+  // back for a new one while libzmq may still hold the old monitor endpoint
+  char endpoint[64];
+  snprintf(endpoint, sizeof(endpoint), "inproc://zmq-reactor-monitor-%llu",
+           static_cast<unsigned long long>(monitor_count_.fetch_add(1, std::memory_order_relaxed)));
+  if (zmq_socket_monitor(socket, endpoint, ZMQ_EVENT_CONNECTED | ZMQ_EVENT_DISCONNECTED) != 0) {
+    return nullptr;
+  }
+
+  void* monitor = zmq_socket(context_, ZMQ_PAIR);
+  if (monitor && zmq_connect(monitor, endpoint) != 0) {
+    zmq_close(monitor);
+    monitor = nullptr;
+  }
+  if (!monitor) {
+    zmq_socket_monitor(socket, nullptr, 0);
+  }
+  return monitor;
+}
+
+void ZmqReactor::ReadMonitorEvents(Connection* connection, ZmqMessage* scratch) {
+  // Each event is two parts: [uint16 event][uint32 value], then the endpoint
+  while (scratch->Receive(connection->monitor, ZMQ_DONTWAIT)) {
+    uint16_t event = 0;
+    if (scratch->size() >= sizeof(event)) {
+      memcpy(&event, scratch->data(), sizeof(event));
+    }
+    while (scratch->more() && scratch->Receive(connection->monitor, 0)) {
+    }
+
+    bool connected;
+    if (event == ZMQ_EVENT_CONNECTED) {
+      connected = true;
+    } else if (event == ZMQ_EVENT_DISCONNECTED) {
+      connected = false;
+    } else {
+      continue;
+    }
+    if (connected == connection->connected) continue;
+
+    connection->connected = connected;
+    for (auto& route : connection->routes) {
+      if (route->status_handler) {
+        route->status_handler(connected);
+      }
+    }
+  }
+}
+
+void ZmqReactor::CloseConnection(Connection* connection) {
+  if (connection->monitor) {
+    zmq_socket_monitor(connection->socket, nullptr, 0);
+    zmq_close(connection->monitor);
+    connection->monitor = nullptr;
+  }
+  zmq_close(connection->socket);
+  connection->socket = nullptr;
+}
+
+ZmqReactor::Poller* ZmqReactor::LeastLoadedPoller() {
+  Poller* target = nullptr;
+  for (auto& poller : pollers_) {
+    if (!target || poller->load < target->load) {
+      target = poller.get();
+    }
+  }
+  return target;
+}
+
+bool ZmqReactor::ReceiveFrame(void* socket, ZmqMessage* topic, ZmqFrame* frame,
+                              ZmqMessage* scratch) {
+  frame->part_count = 0;
+
+  // libzmq delivers all parts of a message atomically, so once the first part
+  // arrived the rest are already queued and a blocking read returns at once
+  if (topic) {
+    if (!topic->Receive(socket, ZMQ_DONTWAIT)) return false;
+    if (!topic->more() || !frame->parts[0].Receive(socket, 0)) return true;
+  } else if (!frame->parts[0].Receive(socket, ZMQ_DONTWAIT)) {
+    return false;
+  }
+  frame->part_count = 1;
+
+  bool more = frame->parts[0].more();
+  if (more && frame->parts[1].Receive(socket, 0)) {
+    frame->part_count = 2;
+    more = frame->parts[1].more();
+  }
+
+  // Parts beyond header + JPEG are discarded to stay aligned on message boundaries
+  while (more && scratch->Receive(socket, 0)) {
+    more = scratch->more();
+  }
+  return true;
+}
+
+bool ZmqReactor::Deliver(Route* route, ZmqFrame& frame, int discarded) {
+  if (route->handler(frame, discarded)) return true;
+  route->refused.ShareFrom(frame);
+  route->refused_discarded = discarded;
+  return false;
+}
+
+bool ZmqReactor::RetryRefused(Connection* connection) {
+  bool clear = true;
+  for (auto& route : connection->routes) {
+    if (route->refused.part_count == 0) continue;
+    if (route->handler(route->refused, route->refused_discarded)) {
+      route->refused.Reset();
+      route->refused_discarded = 0;
+    } else {
+      clear = false;
+    }
+  }
+  return clear;
+}
+
+bool ZmqReactor::Dispatch(Connection* connection, const ZmqMessage& topic, ZmqFrame& frame) {
+  if (frame.part_count == 0) return true;
+
+  bool taken = true;
+  for (auto& route : connection->routes) {
+    if (connection->topic_mode && !TopicMatches(route->topic, topic)) continue;
+
+    if (route->policy == IngestPolicy::kEveryFrame) {
+      taken = Deliver(route.get(), frame, 0) && taken;
+      continue;
+    }
+
+    // Keep only the newest frame; it shares libzmq's buffer, so several
+    // routes on the same topic don't copy the payload
+    if (route->latest.part_count > 0) {
+      ++route->discarded;
+    }
+    route->latest.ShareFrom(frame);
+  }
+  return taken;
+}
+
+void ZmqReactor::Wake(Poller* poller) {
+  // A full pipe means a wakeup is already pending, so EAGAIN is fine
+  if (poller->wake_send) {
+    zmq_send(poller->wake_send, "", 0, ZMQ_DONTWAIT);
+  }
+}
+
+void ZmqReactor::WaitForCommands(Poller* poller, std::unique_lock<std::mutex>& lock) {
+  uint64_t target = poller->commands_posted;
+  poller->commands_done.wait(lock, [poller, target]() {
+    return poller->commands_applied >= target || poller->stopping;
+  });
+}
+
+bool ZmqReactor::ApplyCommands(Poller* poller, std::vector<std::unique_ptr<Connection>>* active) {
+  {
+    std::lock_guard<std::mutex> lock(poller->mutex);
+    for (auto& connection : poller->pending_add) {
+      active->push_back(std::move(connection));
+    }
+    poller->pending_add.clear();
+
+    for (auto& pending : poller->pending_routes) {
+      auto it = std::find_if(active->begin(), active->end(),
+                             [&pending](const std::unique_ptr<Connection>& c) {
+                               return c->topic_mode && c->endpoint == pending.first;
+                             });
+      if (it == active->end()) continue;
+
+      Connection* connection = it->get();
+      const std::string& topic = pending.second->topic;
+      bool subscribed = std::any_of(connection->routes.begin(), connection->routes.end(),
+                                    [&topic](const std::unique_ptr<Route>& r) { return r->topic == topic; });
+      if (!subscribed) {
+        zmq_setsockopt(connection->socket, ZMQ_SUBSCRIBE, topic.data(), topic.size());
+      }
+      // A route joining a live connection won't see its CONNECTED event
+      if (connection->connected && pending.second->status_handler) {
+        pending.second->status_handler(true);
+      }
+      connection->routes.push_back(std::move(pending.second));
+    }
+    poller->pending_routes.clear();
+
+    for (int64_t key : poller->pending_remove) {
+      for (auto it = active->begin(); it != active->end(); ++it) {
+        Connection* connection = it->get();
+        auto route = std::find_if(connection->routes.begin(), connection->routes.end(),
+                                  [key](const std::unique_ptr<Route>& r) { return r->key == key; });
+        if (route == connection->routes.end()) continue;
+
+        std::string topic = (*route)->topic;
+        connection->routes.erase(route);
+
+        if (connection->routes.empty()) {
+          CloseConnection(connection);
+          active->erase(it);
+        } else if (connection->topic_mode &&
+                   std::none_of(connection->routes.begin(), connection->routes.end(),
+                                [&topic](const std::unique_ptr<Route>& r) { return r->topic == topic; })) {
+          zmq_setsockopt(connection->socket, ZMQ_UNSUBSCRIBE, topic.data(), topic.size());
+        }
+        break;
+      }
+    }
+    poller->pending_remove.clear();
+
+    for (const auto& change : poller->pending_policy) {
+      for (auto& connection : *active) {
+        for (auto& route : connection->routes) {
+          if (route->key == change.first) {
+            route->policy = change.second;
+          }
+        }
+      }
+    }
+    poller->pending_policy.clear();
+
+    poller->commands_applied = poller->commands_posted;
+    if (poller->stopping) return false;
+  }
+  poller->commands_done.notify_all();
+  return true;
+}
+
+void ZmqReactor::PollLoop(Poller* poller) {
+  std::vector<std::unique_ptr<Connection>> active;
+  std::vector<zmq_pollitem_t> items;
+  ZmqMessage topic;
+  ZmqFrame frame;
+  ZmqMessage scratch;
+
+  while (ApplyCommands(poller, &active)) {
+    ThreadPolicy::Instance().Apply(ThreadRole::kNetwork);
+
+    // items[0] is the wake socket, then each connection's socket and monitor:
+    // items[1 + 2i] is active[i]->socket, items[2 + 2i] its monitor
+    items.resize(1 + 2 * active.size());
+    for (auto& item : items) {
+      item.fd = 0;
+      item.events = ZMQ_POLLIN;
+      item.revents = 0;
+    }
+    items[0].socket = poller->wake_recv;
+    for (size_t i = 0; i < active.size(); ++i) {
+      items[1 + 2 * i].socket = active[i]->socket;
+      // A route still refusing its frame holds the whole socket back
+      if (!RetryRefused(active[i].get())) {
+        items[1 + 2 * i].events = 0;
+      }
+      items[2 + 2 * i].socket = active[i]->monitor;
+      if (!active[i]->monitor) {
+        items[2 + 2 * i].events = 0;
+      }
+    }
+
+    // No timeout: commands arrive through the wake socket
+    int rc = zmq_poll(items.data(), static_cast<int>(items.size()), -1);
+    if (rc < 0) {
+      if (zmq_errno() == ETERM) break;
+      continue;
+    }
+
+    if (items[0].revents & ZMQ_POLLIN) {
+      while (scratch.Receive(poller->wake_recv, ZMQ_DONTWAIT)) {
+      }
+    }
+
+    for (size_t i = 0; i < active.size(); ++i) {
+      Connection* connection = active[i].get();
+      if (items[2 + 2 * i].revents & ZMQ_POLLIN) {
+        ReadMonitorEvents(connection, &scratch);
+      }
+      if (!(items[1 + 2 * i].revents & ZMQ_POLLIN)) continue;
+
+      bool latest_only = std::any_of(
+          connection->routes.begin(), connection->routes.end(),
+          [](const std::unique_ptr<Route>& r) { return r->policy == IngestPolicy::kLatestOnly; });
+
+      // kLatestOnly routes drain the whole backlog; kEveryFrame routes are
+      // bounded so a busy camera can't starve the poller's other sockets
+      int limit = latest_only ? kMaxDrainPerWakeup : kMaxMessagesPerWakeup;
+      for (int n = 0; n < limit; ++n) {
+        if (!ReceiveFrame(connection->socket, connection->topic_mode ? &topic : nullptr, &frame,
+                          &scratch)) {
+          break;
+        }
+        if (!Dispatch(connection, topic, frame)) break;
+      }
+
+      for (auto& route : connection->routes) {
+        if (route->latest.part_count == 0) continue;
+        Deliver(route.get(), route->latest, route->discarded);
+        route->latest.Reset();
+        route->discarded = 0;
+      }
+    }
+  }
+
+  // Wake any Unsubscribe still waiting, then close every socket we own
+  poller->commands_done.notify_all();
+  for (auto& connection : active) {
+    CloseConnection(connection.get());
+  }
+
+  std::lock_guard<std::mutex> lock(poller->mutex);
+  for (auto& connection : poller->pending_add) {
+    CloseConnection(connection.get());
+  }
+  poller->pending_add.clear();
+  poller->pending_routes.clear();
+
+  if (poller->wake_recv) {
+    zmq_close(poller->wake_recv);
+    poller->wake_recv = nullptr;
+  }
+}
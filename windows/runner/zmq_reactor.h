@@ -0,0 +1,184 @@
+#pragma once
+
+#include "zmq_message.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// How a subscription consumes its socket backlog
+enum class IngestPolicy {
+  kEveryFrame,  // deliver every queued message in order
+  kLatestOnly,  // drain the queue and deliver only the newest message
+};
+
+// One process-wide ZMQ context and a fixed set of poller threads that serve
+// every SUB socket with zmq_poll. Thread count depends on the machine, not on
+// the number of cameras. Pollers block without a timeout; commands wake them
+// through an inproc socket pair, so Unsubscribe and teardown return as soon as
+// the poller has run one loop iteration.
+//
+// Addresses of the form "tcp://host:port#topic" select topic mode: all
+// subscriptions to the same host:port share one SUB socket that subscribes to
+// each topic prefix, and frames are routed by their first (topic) part.
+// Plain addresses get a socket of their own.
+//
+// A message handler that returns false applies backpressure: the reactor
+// keeps the frame and stops reading the route's socket (libzmq then queues up
+// to RCVHWM and drops beyond it) until Resume(key) gets the frame taken. A
+// topic-mode socket pauses for all of its routes, so it runs at the pace of
+// its slowest paused route.
+class ZmqReactor {
+ public:
+  // Runs on a poller thread for each delivered message. discarded is the
+  // number of older messages dropped in its favour (kLatestOnly only).
+  // Returns true once the frame is taken (or dropped by the handler itself),
+  // false to have it offered again after Resume.
+  using MessageHandler = std::function<bool(ZmqFrame& frame, int discarded)>;
+
+  // Runs on a poller thread when the socket's TCP connection comes up or is
+  // lost (from a socket monitor). libzmq reconnects by itself with backoff;
+  // heartbeats detect a dead peer that never closed the connection.
+  using StatusHandler = std::function<void(bool connected)>;
+
+  // io_threads: ZMQ_IO_THREADS of the shared context
+  // poller_threads: zmq_poll threads, <= 0 picks one per two hardware threads
+  ZmqReactor(int io_threads, int poller_threads);
+  ~ZmqReactor();
+
+  ZmqReactor(const ZmqReactor&) = delete;
+  ZmqReactor& operator=(const ZmqReactor&) = delete;
+
+  // Subscribes key to address (plain or "endpoint#topic"). A new socket goes to
+  // the least loaded poller; a topic joining an existing shared socket stays on
+  // that socket's poller. Returns false (and fills error) if it can't connect.
+  // kLatestOnly also shrinks ZMQ_RCVHWM so little backlog builds up in libzmq.
+  bool Subscribe(int64_t key, const std::string& address, IngestPolicy policy,
+                 MessageHandler handler, StatusHandler status_handler, std::string* error);
+
+  // Switches key's policy; takes effect on the next wakeup. The socket's
+  // RCVHWM keeps the value it was connected with.
+  void SetPolicy(int64_t key, IngestPolicy policy);
+
+  // Removes key's subscription and closes its socket once no other topic uses
+  // it. Once this returns, key's handler is not running and will not be
+  // called again.
+  void Unsubscribe(int64_t key);
+  // Same for several keys at once: every poller involved applies its part in
+  // the same wakeup, so this takes one poller round trip, not one per key
+  void Unsubscribe(const std::vector<int64_t>& keys);
+
+  // Any thread, doesn't wait: wakes key's poller to offer the refused frame
+  // again. No-op for a key that isn't paused.
+  void Resume(int64_t key);
+
+  void* context() const { return context_; }
+  size_t poller_count() const { return pollers_.size(); }
+
+ private:
+  // One consumer of a connection
+  struct Route {
+    int64_t key = -1;
+    std::string topic;
+    IngestPolicy policy = IngestPolicy::kEveryFrame;
+    MessageHandler handler;
+    StatusHandler status_handler;
+
+    // kLatestOnly: newest frame seen during the current wakeup
+    ZmqFrame latest;
+    int discarded = 0;
+
+    // Frame the handler refused; its socket isn't read while one is held
+    ZmqFrame refused;
+    int refused_discarded = 0;
+  };
+
+  // One SUB socket and the routes fed by it
+  struct Connection {
+    std::string endpoint;
+    bool topic_mode = false;
+    void* socket = nullptr;
+    void* monitor = nullptr;  // PAIR receiving socket events, may be null
+    bool connected = false;
+    std::vector<std::unique_ptr<Route>> routes;
+  };
+
+  struct Poller {
+    std::thread thread;
+
+    // inproc PAIR: API threads send on wake_send (under mutex), the poller
+    // polls wake_recv alongside its SUB sockets
+    void* wake_send = nullptr;
+    void* wake_recv = nullptr;
+
+    // Commands from API threads, applied by the poller thread in this order
+    std::mutex mutex;
+    std::condition_variable commands_done;
+    std::vector<std::unique_ptr<Connection>> pending_add;
+    std::vector<std::pair<std::string, std::unique_ptr<Route>>> pending_routes;  // endpoint, route
+    std::vector<int64_t> pending_remove;
+    std::vector<std::pair<int64_t, IngestPolicy>> pending_policy;
+    uint64_t commands_posted = 0;
+    uint64_t commands_applied = 0;
+    bool stopping = false;
+
+    // Number of sockets assigned (guarded by ZmqReactor::mutex_)
+    size_t load = 0;
+  };
+
+  // Owner of a subscribed key (guarded by mutex_)
+  struct Owner {
+    Poller* poller = nullptr;
+    std::string shared_endpoint;  // empty unless topic mode
+  };
+
+  // A topic-mode socket shared by several keys (guarded by mutex_)
+  struct SharedSocket {
+    Poller* poller = nullptr;
+    int users = 0;
+  };
+
+  void PollLoop(Poller* poller);
+  // Applies pending commands to active; returns false once the poller is stopping
+  bool ApplyCommands(Poller* poller, std::vector<std::unique_ptr<Connection>>* active);
+  // Hands one received frame to the matching routes of connection; false if
+  // a route refused it (stop reading the socket)
+  static bool Dispatch(Connection* connection, const ZmqMessage& topic, ZmqFrame& frame);
+  // Offers each route's refused frame again; true if none is left
+  static bool RetryRefused(Connection* connection);
+  // Hands frame to route; keeps a share of it if the handler refuses
+  static bool Deliver(Route* route, ZmqFrame& frame, int discarded);
+  // Reads one complete (possibly multipart) message, including the leading
+  // topic part when topic is non-null; false if none is queued
+  static bool ReceiveFrame(void* socket, ZmqMessage* topic, ZmqFrame* frame,
+                           ZmqMessage* scratch);
+  // Wakes the poller to apply queued commands; call with poller->mutex held
+  static void Wake(Poller* poller);
+  // Reads pending monitor events and reports connect/disconnect to routes
+  static void ReadMonitorEvents(Connection* connection, ZmqMessage* scratch);
+  static void CloseConnection(Connection* connection);
+  // Waits until the poller has applied every command posted so far
+  void WaitForCommands(Poller* poller, std::unique_lock<std::mutex>& lock);
+  // Sets *monitor (may be null) before connecting, so the first connect is
+  // never missed
+  void* OpenSocket(const std::string& endpoint, int receive_hwm, void** monitor, std::string* error);
+  // Attaches a monitor for connect/disconnect events; returns the PAIR end
+  void* OpenMonitor(void* socket);
+  Poller* LeastLoadedPoller();
+
+  void* context_ = nullptr;
+  std::vector<std::unique_ptr<Poller>> pollers_;
+
+  std::mutex mutex_;
+  std::map<int64_t, Owner> owners_;          // key -> owning poller
+  std::map<std::string, SharedSocket> shared_;  // endpoint -> topic-mode socket
+
+  std::atomic<uint64_t> monitor_count_{0};  // numbers the monitor endpoints
+};